@@ -0,0 +1,161 @@
+/*!
+  \file BinaryFile.cc
+  \brief Implementazione di BinaryWriter e BinaryReader
+  \author Andrea Zanelli
+  \date 17-10-2026
+*/
+
+#ifndef BINARYFILE_CC_INCLUSION_GUARD
+#define BINARYFILE_CC_INCLUSION_GUARD
+
+#include <string.h>
+
+#include "BinaryFile.h"
+
+
+/* void put_char(const char& value) *******************************************/
+void
+BinaryWriter::put_char(const char& value) {
+  data.push_back(value);
+  return;
+}
+
+
+/* void put_u32(const uint32_t& value) ****************************************/
+void
+BinaryWriter::put_u32(const uint32_t& value) {
+  put_bytes(&value, sizeof(value));
+  return;
+}
+
+
+/* void put_i64(const int64_t& value) *****************************************/
+void
+BinaryWriter::put_i64(const int64_t& value) {
+  put_bytes(&value, sizeof(value));
+  return;
+}
+
+
+/* void put_string(const string& str) *****************************************/
+void
+BinaryWriter::put_string(const string& str) {
+  put_u32(static_cast<uint32_t>(str.size()));
+  data.append(str);
+  return;
+}
+
+
+/* void put_bytes(const void* bytes, const size_t& n) *************************/
+void
+BinaryWriter::put_bytes(const void* bytes, const size_t& n) {
+  data.append(static_cast<const char*>(bytes), n);
+  return;
+}
+
+
+/* void align(const size_t& n) ************************************************/
+void
+BinaryWriter::align(const size_t& n) {
+  while(data.size() % n != 0)
+    data.push_back('\0');
+  return;
+}
+
+
+/* const string& get_data() const *********************************************/
+const string&
+BinaryWriter::get_data() const {
+  return data;
+}
+
+
+/* BinaryReader(const char* data, const size_t& size) *************************/
+BinaryReader::BinaryReader(const char* data, const size_t& size)
+  : data(data), size(size), pos(0) {
+}
+
+
+/* char get_char() ************************************************************/
+char
+BinaryReader::get_char() {
+  require(1);
+  return data[pos++];
+}
+
+
+/* uint32_t get_u32() *********************************************************/
+uint32_t
+BinaryReader::get_u32() {
+  uint32_t value;
+  get_bytes(&value, sizeof(value));
+  return value;
+}
+
+
+/* int64_t get_i64() **********************************************************/
+int64_t
+BinaryReader::get_i64() {
+  int64_t value;
+  get_bytes(&value, sizeof(value));
+  return value;
+}
+
+
+/* string get_string() ********************************************************/
+string
+BinaryReader::get_string() {
+  uint32_t n = get_u32();
+  require(n);
+  string str(data + pos, n);
+  pos += n;
+  return str;
+}
+
+
+/* void get_bytes(void* bytes, const size_t& n) *******************************/
+void
+BinaryReader::get_bytes(void* bytes, const size_t& n) {
+  require(n);
+  memcpy(bytes, data + pos, n);
+  pos += n;
+  return;
+}
+
+
+/* const char* get_span(const size_t& n) **************************************/
+const char*
+BinaryReader::get_span(const size_t& n) {
+  require(n);
+  const char* span = data + pos;
+  pos += n;
+  return span;
+}
+
+
+/* void align(const size_t& n) ************************************************/
+void
+BinaryReader::align(const size_t& n) {
+  size_t padding = (n - pos % n) % n;
+  require(padding);
+  pos += padding;
+  return;
+}
+
+
+/* bool at_end() const ********************************************************/
+bool
+BinaryReader::at_end() const {
+  return pos == size;
+}
+
+
+/* void require(const size_t& n) const ****************************************/
+void
+BinaryReader::require(const size_t& n) const {
+  if(n > size - pos)
+    throw string("file bytecode troncato");
+}
+
+
+#endif // BINARYFILE_CC_INCLUSION_GUARD
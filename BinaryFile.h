@@ -0,0 +1,157 @@
+/*!
+  \file BinaryFile.h
+  \brief Interfaccia di BinaryWriter e BinaryReader
+  \author Andrea Zanelli
+  \date 17-10-2026
+*/
+
+#ifndef BINARYFILE_H_INCLUSION_GUARD
+#define BINARYFILE_H_INCLUSION_GUARD
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string>
+
+using std::string;
+
+
+/*!
+  \class BinaryWriter
+  \brief Costruisce in memoria il contenuto di un file binario
+
+  I valori vengono scritti nell'ordine dei byte della macchina, percio` il file
+  puo` essere letto solo da una macchina con la stessa architettura (vedi
+  BinaryReader). Le stringhe sono precedute dalla loro lunghezza.
+*/
+class BinaryWriter {
+
+  public:
+    /* METODI PUBBLICI */
+
+    /**
+     * Scrive il carattere (byte) <tt>value</tt>.
+     */
+    void put_char(const char& value);
+
+    /**
+     * Scrive l'intero senza segno a 32 bit <tt>value</tt>.
+     */
+    void put_u32(const uint32_t& value);
+
+    /**
+     * Scrive l'intero con segno a 64 bit <tt>value</tt>.
+     */
+    void put_i64(const int64_t& value);
+
+    /**
+     * Scrive la stringa <tt>str</tt>, preceduta dalla lunghezza.
+     */
+    void put_string(const string& str);
+
+    /**
+     * Scrive gli <tt>n</tt> byte puntati da <tt>bytes</tt>.
+     */
+    void put_bytes(const void* bytes, const size_t& n);
+
+    /**
+     * Aggiunge byte nulli fino ad una posizione multipla di <tt>n</tt>.
+     */
+    void align(const size_t& n);
+
+    /**
+     * Restituisce il contenuto scritto.
+     */
+    const string& get_data() const;
+
+  private:
+    /* VARIABILI PRIVATE */
+
+    //! contenuto del file
+    string data;
+
+};
+
+
+/*!
+  \class BinaryReader
+  \brief Legge i valori scritti da BinaryWriter da un'area di memoria
+
+  Legge in sequenza i valori, nello stesso ordine in cui sono stati scritti
+  con BinaryWriter, dall'area di memoria passata al costruttore (che non
+  viene copiata e deve restare valida durante la lettura). Se si tenta di
+  leggere oltre la fine dell'area viene lanciata un'eccezione di tipo
+  std::string con la descrizione dell'errore.
+*/
+class BinaryReader {
+
+  public:
+    /* METODI PUBBLICI */
+
+    /**
+     * Costruttore: legge dagli <tt>size</tt> byte puntati da <tt>data</tt>.
+     */
+    BinaryReader(const char* data, const size_t& size);
+
+    /**
+     * Legge un carattere (byte).
+     */
+    char get_char();
+
+    /**
+     * Legge un intero senza segno a 32 bit.
+     */
+    uint32_t get_u32();
+
+    /**
+     * Legge un intero con segno a 64 bit.
+     */
+    int64_t get_i64();
+
+    /**
+     * Legge una stringa (preceduta dalla lunghezza).
+     */
+    string get_string();
+
+    /**
+     * Legge <tt>n</tt> byte e li copia in <tt>bytes</tt>.
+     */
+    void get_bytes(void* bytes, const size_t& n);
+
+    /**
+     * Salta <tt>n</tt> byte e restituisce il puntatore al primo, nell'area
+     * passata al costruttore (senza copiarli).
+     */
+    const char* get_span(const size_t& n);
+
+    /**
+     * Salta i byte aggiunti da BinaryWriter::align() con lo stesso
+     * <tt>n</tt>.
+     */
+    void align(const size_t& n);
+
+    /**
+     * Restituisce <tt>true</tt> se tutti i byte sono stati letti.
+     */
+    bool at_end() const;
+
+  private:
+    /* VARIABILI PRIVATE */
+
+    //! inizio dell'area da leggere
+    const char* data;
+
+    //! byte dell'area da leggere
+    size_t size;
+
+    //! posizione del prossimo byte da leggere
+    size_t pos;
+
+    /* METODI PRIVATI */
+
+    // controlla che ci siano ancora almeno n byte da leggere
+    void require(const size_t& n) const;
+
+};
+
+
+#endif // BINARYFILE_H_INCLUSION_GUARD
@@ -0,0 +1,723 @@
+/*!
+  \file CppCode.cc
+  \brief Implementazione di CppCode
+  \author Andrea Zanelli
+  \date 17-10-2026
+*/
+
+#ifndef CPPCODE_CC_INCLUSION_GUARD
+#define CPPCODE_CC_INCLUSION_GUARD
+
+#include <ctype.h>
+#include <set>
+#include <stdio.h>
+#include <stdlib.h>
+#include <vector>
+
+#include "CppCode.h"
+#include "Instruction.h"
+#include "NativeMethod.h"
+#include "Slot.h"
+#include "Verifier.h"
+
+using std::set;
+using std::vector;
+
+
+// Tipo di uno Slot calcolato dalla verifica (vedi Verifier)
+typedef Verifier::Type Tipo;
+static const Tipo RIF = Verifier::REF;
+
+// Funzioni di supporto del sorgente prodotto, prima delle costanti: uscita
+// e lettura come nell'esecutore (il buffer dello standard output e`
+// svuotato prima di ogni lettura e in caso di errore)
+static const char* const SUPPORTO =
+  "#include <inttypes.h>\n"
+  "#include <stdint.h>\n"
+  "#include <stdio.h>\n"
+  "#include <stdlib.h>\n"
+  "#include <iostream>\n"
+  "#include <string>\n"
+  "\n"
+  "using std::string;\n"
+  "\n"
+  "namespace {\n"
+  "\n"
+  "// termina il programma con un errore, come la macchina astratta\n"
+  "inline void errore(const char* messaggio) {\n"
+  "  fflush(stdout);\n"
+  "  fprintf(stderr, \"Errore: %s\\n\", messaggio);\n"
+  "  exit(1);\n"
+  "}\n"
+  "\n"
+  "inline void stampa_long(const int64_t valore) {\n"
+  "  printf(\"%\" PRId64, valore);\n"
+  "}\n"
+  "\n"
+  "inline void stampa_carattere(const int32_t valore) {\n"
+  "  putchar(static_cast<unsigned char>(static_cast<char>(valore)));\n"
+  "}\n"
+  "\n"
+  "inline void stampa_stringa(const string& valore) {\n"
+  "  fwrite(valore.data(), 1, valore.size(), stdout);\n"
+  "}\n"
+  "\n"
+  "// BufferedReader.read(): legge un carattere e scarta il resto della riga\n"
+  "inline int32_t leggi_carattere() {\n"
+  "  fflush(stdout);\n"
+  "  char c = getchar();\n"
+  "  if(c != '\\n') {\n"
+  "    char t = getchar();\n"
+  "    while(t != '\\n')\n"
+  "      t = getchar();\n"
+  "  }\n"
+  "  return static_cast<int32_t>(c);\n"
+  "}\n"
+  "\n"
+  "// BufferedReader.readLine()\n"
+  "inline string leggi_riga() {\n"
+  "  fflush(stdout);\n"
+  "  string riga;\n"
+  "  std::getline(std::cin, riga);\n"
+  "  return riga;\n"
+  "}\n";
+
+
+// numero in base 10
+static string numero(const int64_t& valore) {
+  char testo[32];
+  sprintf(testo, "%lld", static_cast<long long>(valore));
+  return testo;
+}
+
+// costante int nel sorgente C++ (il valore minimo non e` un letterale)
+static string letterale_int(const int32_t& valore) {
+  if(valore == -2147483647 - 1)
+    return "(-2147483647 - 1)";
+  return numero(valore);
+}
+
+// costante long nel sorgente C++
+static string letterale_long(const int64_t& valore) {
+  if(valore == -9223372036854775807LL - 1)
+    return "(-9223372036854775807LL - 1)";
+  return numero(valore) + "LL";
+}
+
+// stringa nel sorgente C++: i caratteri non stampabili, le virgolette, la
+// barra rovesciata e il punto interrogativo (trigrafi) come sequenze ottali
+static string letterale_stringa(const string& valore) {
+  string testo = "\"";
+  for(string::size_type k = 0; k < valore.size(); ++k) {
+    unsigned char c = static_cast<unsigned char>(valore[k]);
+    if(c < 0x20 || c >= 0x7F || c == '"' || c == '\\' || c == '?') {
+      char ottale[8];
+      sprintf(ottale, "\\%03o", c);
+      testo += ottale;
+    }
+    else
+      testo += static_cast<char>(c);
+  }
+  return testo + "\"";
+}
+
+
+/*!
+  \class TraduzioneCpp
+  \brief Traduzione di una funzione in una funzione C++ (vedi CppCode)
+*/
+class TraduzioneCpp {
+
+  public:
+    TraduzioneCpp(const ProgramArea& program, const uint32_t& index);
+
+    // simula e traduce la funzione; se non puo` essere tradotta restituisce
+    // false e mette in motivo la spiegazione
+    bool esegui(string& motivo);
+
+    // intestazione della funzione, con i nomi dei parametri usati se
+    // nomi e` true
+    string intestazione(const bool& nomi) const;
+
+    // definizione della funzione (dopo esegui())
+    string definizione() const;
+
+    // true se nel corpo la variabile nome compare solo a sinistra di un
+    // assegnamento
+    bool solo_scritta(const string& nome) const;
+
+    // true se la funzione usa il pool delle costanti o le variabili globali
+    bool usa_costanti() const { return costanti; }
+    bool usa_globali() const { return globali; }
+
+  private:
+    const ProgramArea& programma;
+    const uint32_t indice;
+    const Function& funzione;
+    const Instruction* istruzioni;
+
+    // verifica della funzione: tipi all'inizio di ogni istruzione
+    Verifier verifica;
+
+    // corpo della funzione e variabili C++ usate
+    string corpo;
+    set<string> variabili;
+    bool costanti;
+    bool globali;
+    // per ogni posizione dello stack: indice della stringa costante che la
+    // occupa senza essere stata copiata nella sua variabile, oppure -1
+    vector<long> stringhe;
+
+    /* traduzione */
+    void traduci();
+    void traduci_istruzione(const unsigned int& i);
+    string variabile(const char* prefisso, const unsigned int& n);
+    string stringa(const unsigned int& pos);
+    void riga(const string& testo);
+    void scarica();
+    void sposta(const Tipo& tipo, const unsigned int& da,
+        const unsigned int& a);
+    static string etichetta(const unsigned int& i);
+    static const char* tipo_cpp(const string& nome);
+
+};
+
+
+/* CppCode() ******************************************************************/
+CppCode::CppCode() {
+}
+
+
+/* void translate(...) ********************************************************/
+void
+CppCode::translate(const ProgramArea& program,
+    const GlobalVariablesArea& globals, const string& name) {
+  string prototipi;
+  string definizioni;
+  bool costanti = false;
+  bool globali = false;
+  long principale = -1;
+  long inizializzazione = -1;
+  for(unsigned int f = 0; f < program.get_functions_size(); ++f) {
+    const Function& funzione = program.get_function(f);
+    TraduzioneCpp traduzione(program, f);
+    string motivo;
+    if(!traduzione.esegui(motivo)) {
+      throw string("la funzione " + funzione.name +
+          " non puo` essere tradotta in C++ (" + motivo + ")");
+    }
+    prototipi += traduzione.intestazione(false) + ";\n";
+    definizioni += "\n// " + funzione.name + "\n" +
+      traduzione.definizione();
+    costanti = costanti || traduzione.usa_costanti();
+    globali = globali || traduzione.usa_globali();
+    if(funzione.name == "main([Ljava/lang/String;)V")
+      principale = f;
+    else if(funzione.name == "<clinit>()V")
+      inizializzazione = f;
+  }
+  if(principale < 0)
+    throw string("funzione inesistente: main([Ljava/lang/String;)V");
+
+  source = "// " + name + ": tradotto in C++ da macchina-astratta "
+    "--emit-cpp\n\n";
+  source += SUPPORTO;
+  if(costanti) {
+    // il pool delle costanti stringa, con la lunghezza (ammette '\0')
+    source += "\n// pool delle costanti stringa\nconst string costanti[] = {\n";
+    for(uint32_t k = 0; k < program.get_constants_size(); ++k) {
+      const string& costante = program.get_constant(k);
+      source += "  string(" + letterale_stringa(costante) + ", " +
+        numero(costante.size()) + "),\n";
+    }
+    source += "};\n";
+  }
+  if(globali) {
+    // valori delle variabili globali, nelle posizioni di GlobalVariablesArea
+    source += "\n// variabili globali\nint64_t globali[] = {\n";
+    for(unsigned int k = 0; k < globals.get_variables_size(); ++k)
+      source += "  " + letterale_long(globals.get_value(k)) + ",\n";
+    source += "};\n";
+  }
+  source += "\n" + prototipi + definizioni + "\n} // namespace\n\n";
+  source += "int main() {\n";
+  source += "  static char buffer[1 << 16];\n";
+  source += "  setvbuf(stdout, buffer, _IOFBF, sizeof(buffer));\n";
+  if(inizializzazione >= 0)
+    source += "  f" + numero(inizializzazione) + "();\n";
+  source += "  f" + numero(principale) + "();\n";
+  source += "  return 0;\n}\n";
+  return;
+}
+
+
+/* const string& get_source() const *******************************************/
+const string&
+CppCode::get_source() const {
+  return source;
+}
+
+
+/* TraduzioneCpp(...) *********************************************************/
+TraduzioneCpp::TraduzioneCpp(const ProgramArea& program,
+    const uint32_t& index)
+  : programma(program), indice(index), funzione(program.get_function(index)),
+    istruzioni(program.get_code()), verifica(program, funzione),
+    costanti(false), globali(false) {
+}
+
+
+/* bool esegui(string& motivo) ************************************************/
+bool
+TraduzioneCpp::esegui(string& motivo) {
+  if(funzione.return_type != 'V' && funzione.return_type != 'I' &&
+      funzione.return_type != 'J') {
+    motivo = "funzione che restituisce un riferimento";
+    return false;
+  }
+  if(!verifica.verify(motivo))
+    return false;
+  // i metodi nativi registrati non esistono nel programma compilato
+  for(unsigned int i = funzione.start; i <= funzione.end; ++i) {
+    const Instruction& istr = programma.get_code()[i];
+    if(verifica.get_state(i - funzione.start).reached && istr.type == 'N' &&
+        istr.index >= INTR_NUMERO) {
+      motivo = "metodo nativo " + native_method(istr.index).name;
+      return false;
+    }
+  }
+  traduci();
+  return true;
+}
+
+
+/* string intestazione(const bool& nomi) const ********************************/
+string
+TraduzioneCpp::intestazione(const bool& nomi) const {
+  string testo = (funzione.return_type == 'I') ? "int32_t" :
+    (funzione.return_type == 'J') ? "int64_t" : "void";
+  testo += " f" + numero(indice) + "(";
+  // i parametri int e long (i riferimenti non possono essere letti)
+  bool primo = true;
+  for(string::size_type k = 0; k < funzione.arguments.size(); ++k) {
+    const char tipo = funzione.arguments[k];
+    if(tipo != 'I' && tipo != 'J')
+      continue;
+    if(!primo)
+      testo += ", ";
+    primo = false;
+    string nome = (tipo == 'I' ? "li" : "lj") + numero(k);
+    testo += (tipo == 'I') ? "int32_t" : "int64_t";
+    if(nomi && variabili.count(nome) != 0)
+      testo += " " + nome;
+  }
+  return testo + ")";
+}
+
+
+/* string definizione() const *************************************************/
+string
+TraduzioneCpp::definizione() const {
+  string testo = intestazione(true) + " {\n";
+  // variabili locali e posizioni dello stack, tranne i parametri
+  for(set<string>::const_iterator v = variabili.begin();
+      v != variabili.end(); ++v) {
+    const unsigned long n = strtoul(v->c_str() + (v->at(0) == 'l' ? 2 : 1),
+        0, 10);
+    if(v->at(0) == 'l' && n < funzione.arguments.size() &&
+        funzione.arguments[n] == v->at(1) - 'i' + 'I')
+      continue;
+    testo += string("  ") + tipo_cpp(*v) + " " + *v +
+      (v->at(0) == 's' ? ";\n" : " = 0;\n");
+    // una variabile locale solo scritta darebbe un avviso del compilatore
+    if(v->at(0) == 'l' && solo_scritta(*v))
+      testo += "  static_cast<void>(" + *v + ");\n";
+  }
+  return testo + corpo + "}\n";
+}
+
+
+/* bool solo_scritta(const string& nome) const ********************************/
+bool
+TraduzioneCpp::solo_scritta(const string& nome) const {
+  for(string::size_type i = corpo.find(nome); i != string::npos;
+      i = corpo.find(nome, i + 1)) {
+    const string::size_type fine = i + nome.size();
+    if((i > 0 && (isalnum(corpo[i - 1]) || corpo[i - 1] == '_')) ||
+        (fine < corpo.size() && (isalnum(corpo[fine]) || corpo[fine] == '_')))
+      continue;
+    if(corpo.compare(fine, 3, " = ") != 0)
+      return false;
+  }
+  return true;
+}
+
+
+/* void traduci() *************************************************************/
+void
+TraduzioneCpp::traduci() {
+  const unsigned int n = funzione.end - funzione.start + 1;
+  bool raggiungibile = true;
+  for(unsigned int i = 0; i < n; ++i) {
+    if(!verifica.get_state(i).reached) {
+      raggiungibile = false;
+      continue;
+    }
+    if(verifica.is_target(i) || !raggiungibile) {
+      // inizio di un blocco: i valori sono nelle variabili delle posizioni
+      if(raggiungibile)
+        scarica();
+      stringhe.assign(verifica.get_state(i).stack.size(), -1);
+      if(verifica.is_target(i))
+        corpo += etichetta(i) + ":\n";
+    }
+    traduci_istruzione(i);
+    // le posizioni che non contengono stringhe non hanno stringhe costanti
+    Verifier::State dopo = verifica.get_state(i);
+    string motivo;
+    verifica.simulate(i, dopo, motivo);
+    stringhe.resize(dopo.stack.size(), -1);
+    for(vector<Tipo>::size_type k = 0; k < dopo.stack.size(); ++k) {
+      if(dopo.stack[k] != RIF + REF_STRING)
+        stringhe[k] = -1;
+    }
+    const uint16_t op = istruzioni[funzione.start + i].opcode;
+    raggiungibile = op != OP_GOTO && op != OP_RETURN && op != OP_IRETURN &&
+      op != OP_LRETURN;
+  }
+  return;
+}
+
+
+/* void traduci_istruzione(const unsigned int& i) *****************************/
+void
+TraduzioneCpp::traduci_istruzione(const unsigned int& i) {
+  const Instruction& istr = istruzioni[funzione.start + i];
+  const vector<Tipo>& s = verifica.get_state(i).stack;
+  const unsigned int n = static_cast<unsigned int>(s.size());
+  // operandi int e long in cima allo stack (a il primo, b il secondo)
+  #define IA variabile("i", n - 1)
+  #define IB variabile("i", n - 2)
+  #define JA variabile("j", n - 2)
+  #define JB variabile("j", n - 4)
+  static const char* const confronti[] = {"==", ">=", ">", "<=", "<", "!="};
+  switch(istr.opcode) {
+    case OP_NOP:
+      break;
+    case OP_LDC_W:
+      if(istr.type == 'L') {
+        // la stringa costante viene copiata solo se serve (vedi scarica())
+        stringhe.push_back(istr.index);
+        costanti = true;
+      }
+      else
+        riga(variabile("i", n) + " = " +
+            letterale_int(static_cast<int32_t>(istr.value)) + ";");
+      break;
+    case OP_LDC2_W:
+      riga(variabile("j", n) + " = " + letterale_long(istr.value) + ";");
+      break;
+    case OP_SIPUSH:
+      riga(variabile("i", n) + " = " +
+          letterale_int(static_cast<int32_t>(istr.value)) + ";");
+      break;
+    case OP_GOTO:
+      scarica();
+      riga("goto " + etichetta(istr.index - funzione.start) + ";");
+      break;
+    case OP_IF_ICMPEQ: case OP_IF_ICMPGE: case OP_IF_ICMPGT:
+    case OP_IF_ICMPLE: case OP_IF_ICMPLT: case OP_IF_ICMPNE:
+      scarica();
+      riga("if(" + IB + " " + confronti[istr.opcode - OP_IF_ICMPEQ] + " " +
+          IA + ") goto " + etichetta(istr.index - funzione.start) + ";");
+      break;
+    case OP_IFEQ: case OP_IFGE: case OP_IFGT:
+    case OP_IFLE: case OP_IFLT: case OP_IFNE:
+      scarica();
+      riga("if(" + IA + " " + confronti[istr.opcode - OP_IFEQ] + " 0) goto " +
+          etichetta(istr.index - funzione.start) + ";");
+      break;
+    case OP_GETSTATIC:
+      if(istr.type == 'J')
+        riga(variabile("j", n) + " = globali[" + numero(istr.index) + "];");
+      else if(istr.type != 'L')
+        riga(variabile("i", n) + " = static_cast<int32_t>(globali[" +
+            numero(istr.index) + "]);");
+      globali = globali || istr.type != 'L';
+      break;
+    case OP_PUTSTATIC: {
+      const string variabile_globale = "globali[" + numero(istr.index) + "]";
+      if(istr.type == 'J')
+        riga(variabile_globale + " = " + JA + ";");
+      else if(istr.type == 'S')
+        riga(variabile_globale + " = static_cast<int16_t>(" + IA + ");");
+      else if(istr.type == 'C')
+        riga(variabile_globale + " = static_cast<uint16_t>(" + IA + ");");
+      else
+        riga(variabile_globale + " = " + IA + ";");
+      globali = true;
+      break;
+    }
+    case OP_INVOKESTATIC: {
+      if(istr.type != 'M') {
+        if(istr.index == INTR_PARSE_INT)
+          riga(variabile("i", n - 1) + " = static_cast<int32_t>(atol(" +
+              stringa(n - 1) + ".c_str()));");
+        else if(istr.index == INTR_PARSE_LONG)
+          riga(variabile("j", n - 1) + " = atoll(" + stringa(n - 1) +
+              ".c_str());");
+        break;
+      }
+      const Function& chiamata = programma.get_function(istr.index);
+      const string& argomenti = chiamata.arguments;
+      const unsigned int base = n - static_cast<unsigned int>(
+          argomenti.size());
+      string testo = "f" + numero(istr.index) + "(";
+      bool primo = true;
+      for(string::size_type k = 0; k < argomenti.size(); ++k) {
+        if(argomenti[k] != 'I' && argomenti[k] != 'J')
+          continue;
+        if(!primo)
+          testo += ", ";
+        primo = false;
+        testo += variabile(argomenti[k] == 'I' ? "i" : "j", base + k);
+      }
+      testo += ");";
+      if(chiamata.return_type == 'I')
+        testo = variabile("i", base) + " = " + testo;
+      else if(chiamata.return_type == 'J')
+        testo = variabile("j", base) + " = " + testo;
+      riga(testo);
+      break;
+    }
+    case OP_RETURN:
+      riga("return;");
+      break;
+    case OP_IRETURN:
+      riga("return " + IA + ";");
+      break;
+    case OP_LRETURN:
+      riga("return " + JA + ";");
+      break;
+    case OP_LCMP:
+      riga(variabile("i", n - 4) + " = (" + JB + " == " + JA + ") ? 0 : ((" +
+          JB + " > " + JA + ") ? 1 : -1);");
+      break;
+    case OP_IADD:
+      riga(IB + " = static_cast<int32_t>(static_cast<uint32_t>(" + IB +
+          ") + static_cast<uint32_t>(" + IA + "));");
+      break;
+    case OP_ISUB:
+      riga(IB + " = static_cast<int32_t>(static_cast<uint32_t>(" + IB +
+          ") - static_cast<uint32_t>(" + IA + "));");
+      break;
+    case OP_IMUL:
+      riga(IB + " = static_cast<int32_t>(static_cast<uint32_t>(" + IB +
+          ") * static_cast<uint32_t>(" + IA + "));");
+      break;
+    case OP_IDIV:
+    case OP_IREM:
+      riga("if(" + IA + " == 0) errore(\"divisione per 0\");");
+      riga(IB + " = " + IB + (istr.opcode == OP_IDIV ? " / " : " % ") + IA +
+          ";");
+      break;
+    case OP_ISHL:
+      // shift con il numero di posizioni modulo 32, come il processore
+      riga(IB + " = static_cast<int32_t>(static_cast<uint32_t>(" + IB +
+          ") << (" + IA + " & 31));");
+      break;
+    case OP_ISHR:
+      riga(IB + " = " + IB + " >> (" + IA + " & 31);");
+      break;
+    case OP_INEG:
+      riga(IA + " = static_cast<int32_t>(0u - static_cast<uint32_t>(" + IA +
+          "));");
+      break;
+    case OP_LADD:
+      riga(JB + " = static_cast<int64_t>(static_cast<uint64_t>(" + JB +
+          ") + static_cast<uint64_t>(" + JA + "));");
+      break;
+    case OP_LSUB:
+      riga(JB + " = static_cast<int64_t>(static_cast<uint64_t>(" + JB +
+          ") - static_cast<uint64_t>(" + JA + "));");
+      break;
+    case OP_LMUL:
+      riga(JB + " = static_cast<int64_t>(static_cast<uint64_t>(" + JB +
+          ") * static_cast<uint64_t>(" + JA + "));");
+      break;
+    case OP_LDIV:
+    case OP_LREM:
+      riga("if(" + JA + " == 0) errore(\"divisione per 0\");");
+      riga(JB + " = " + JB + (istr.opcode == OP_LDIV ? " / " : " % ") + JA +
+          ";");
+      break;
+    case OP_LSHL:
+      riga(variabile("j", n - 3) + " = static_cast<int64_t>(static_cast<"
+          "uint64_t>(" + variabile("j", n - 3) + ") << (" + IA + " & 63));");
+      break;
+    case OP_LSHR:
+      riga(variabile("j", n - 3) + " = " + variabile("j", n - 3) + " >> (" +
+          IA + " & 63);");
+      break;
+    case OP_LNEG:
+      riga(JA + " = static_cast<int64_t>(0u - static_cast<uint64_t>(" + JA +
+          "));");
+      break;
+    case OP_ILOAD:
+      riga(variabile("i", n) + " = " + variabile("li", istr.index) + ";");
+      break;
+    case OP_LLOAD:
+      riga(variabile("j", n) + " = " + variabile("lj", istr.index) + ";");
+      break;
+    case OP_ISTORE:
+      riga(variabile("li", istr.index) + " = " + IA + ";");
+      break;
+    case OP_LSTORE:
+      riga(variabile("lj", istr.index) + " = " + JA + ";");
+      break;
+    case OP_I2C:
+      riga(IA + " = static_cast<uint16_t>(" + IA + ");");
+      break;
+    case OP_I2S:
+      riga(IA + " = static_cast<int16_t>(" + IA + ");");
+      break;
+    case OP_I2L:
+      riga(variabile("j", n - 1) + " = " + IA + ";");
+      break;
+    case OP_L2I:
+      riga(variabile("i", n - 2) + " = static_cast<int32_t>(" + JA + ");");
+      break;
+    case OP_DUP:
+      stringhe.push_back(-1);
+      sposta(s[n - 1], n - 1, n);
+      break;
+    case OP_DUP2:
+      riga(variabile("j", n) + " = " + JA + ";");
+      break;
+    case OP_POP:
+    case OP_POP2:
+      break;
+    case OP_SWAP:
+      if(s[n - 1] == 'I' && s[n - 2] == 'I')
+        riga("{ const int32_t t = " + IA + "; " + IA + " = " + IB + "; " +
+            IB + " = t; }");
+      else if(s[n - 1] == RIF + REF_STRING && s[n - 2] == RIF + REF_STRING) {
+        if(stringhe[n - 1] < 0 || stringhe[n - 2] < 0)
+          riga(variabile("s", n - 1) + ".swap(" + variabile("s", n - 2) +
+              ");");
+      }
+      else {
+        // tipi diversi: le variabili delle due posizioni sono distinte
+        sposta(s[n - 1], n - 1, n - 2);
+        sposta(s[n - 2], n - 2, n - 1);
+      }
+      {
+        const long t = stringhe[n - 1];
+        stringhe[n - 1] = stringhe[n - 2];
+        stringhe[n - 2] = t;
+      }
+      break;
+    case OP_NEW:
+      break;
+    case OP_INVOKEVIRTUAL:
+      if(istr.index == INTR_PRINT_INT)
+        riga("stampa_long(" + IA + ");");
+      else if(istr.index == INTR_PRINT_CHAR)
+        riga("stampa_carattere(" + IA + ");");
+      else if(istr.index == INTR_PRINT_LONG)
+        riga("stampa_long(" + JA + ");");
+      else if(istr.index == INTR_PRINT_STRING)
+        riga("stampa_stringa(" + stringa(n - 1) + ");");
+      else if(istr.index == INTR_READ)
+        riga(variabile("i", n - 1) + " = leggi_carattere();");
+      else if(istr.index == INTR_READLINE)
+        riga(variabile("s", n - 1) + " = leggi_riga();");
+      break;
+    case OP_INVOKESPECIAL:
+      break;
+  }
+  #undef IA
+  #undef IB
+  #undef JA
+  #undef JB
+  return;
+} // end of method traduci_istruzione(...)
+
+
+/* string variabile(const char* prefisso, const unsigned int& n) **************/
+string
+TraduzioneCpp::variabile(const char* prefisso, const unsigned int& n) {
+  string nome = prefisso + numero(n);
+  variabili.insert(nome);
+  return nome;
+}
+
+
+/* string stringa(const unsigned int& pos) ************************************/
+string
+TraduzioneCpp::stringa(const unsigned int& pos) {
+  if(stringhe[pos] >= 0)
+    return "costanti[" + numero(stringhe[pos]) + "]";
+  return variabile("s", pos);
+}
+
+
+/* void riga(const string& testo) *********************************************/
+void
+TraduzioneCpp::riga(const string& testo) {
+  corpo += "  " + testo + "\n";
+  return;
+}
+
+
+/* void scarica() *************************************************************/
+void
+TraduzioneCpp::scarica() {
+  // le stringhe costanti passano nelle variabili delle loro posizioni
+  for(vector<long>::size_type k = 0; k < stringhe.size(); ++k) {
+    if(stringhe[k] >= 0) {
+      riga(variabile("s", k) + " = costanti[" + numero(stringhe[k]) + "];");
+      stringhe[k] = -1;
+    }
+  }
+  return;
+}
+
+
+/* void sposta(const Tipo& tipo, const unsigned int& da, ...) *****************/
+void
+TraduzioneCpp::sposta(const Tipo& tipo, const unsigned int& da,
+    const unsigned int& a) {
+  // copia il valore (int o riferimento) della posizione da nella posizione a;
+  // i riferimenti "finti" non hanno variabili
+  if(tipo == 'I')
+    riga(variabile("i", a) + " = " + variabile("i", da) + ";");
+  else if(tipo == RIF + REF_STRING) {
+    if(stringhe[da] >= 0)
+      stringhe[a] = stringhe[da];
+    else
+      riga(variabile("s", a) + " = " + variabile("s", da) + ";");
+  }
+  return;
+}
+
+
+/* string etichetta(const unsigned int& i) ************************************/
+string
+TraduzioneCpp::etichetta(const unsigned int& i) {
+  return "L" + numero(i);
+}
+
+
+/* const char* tipo_cpp(const string& nome) ***********************************/
+const char*
+TraduzioneCpp::tipo_cpp(const string& nome) {
+  const char tipo = (nome[0] == 'l') ? nome[1] : nome[0];
+  if(tipo == 'i')
+    return "int32_t";
+  if(tipo == 'j')
+    return "int64_t";
+  return "string";
+}
+
+#endif // CPPCODE_CC_INCLUSION_GUARD
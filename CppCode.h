@@ -0,0 +1,81 @@
+/*!
+  \file CppCode.h
+  \brief Interfaccia di CppCode
+  \author Andrea Zanelli
+  \date 17-10-2026
+*/
+
+#ifndef CPPCODE_H_INCLUSION_GUARD
+#define CPPCODE_H_INCLUSION_GUARD
+
+#include <string>
+
+#include "GlobalVariablesArea.h"
+#include "ProgramArea.h"
+
+using std::string;
+
+
+/*!
+  \class CppCode
+  \brief Traduzione del programma in un sorgente C++ (compilazione AOT)
+
+  Traduce un programma caricato in un'unica unita` di traduzione C++ che non
+  dipende dalla macchina astratta: compilata con lo stesso compilatore del
+  makefile da` un eseguibile che stampa, legge e termina con gli stessi
+  errori dell'esecuzione sullo stack.\\
+  Ogni funzione del programma diventa una funzione C++ con i parametri int e
+  long come argomenti e il valore di ritorno come risultato; le etichette
+  diventano etichette di <tt>goto</tt>. Come in RegisterCode il tipo di ogni
+  posizione dello stack degli operandi e di ogni variabile locale letta
+  dev'essere noto in ogni istruzione raggiungibile: cosi` ogni posizione e
+  ogni variabile locale diventa una variabile C++ del suo tipo (una per
+  tipo, se ne assume piu` d'uno), i controlli sui tipi non servono e i
+  riferimenti "finti" (System.out, System.in, BufferedReader) scompaiono.
+  Le stringhe lette restano oggetti std::string, quelle costanti sono prese
+  dal pool delle costanti copiato nel sorgente.\\
+  Le variabili globali sono un array di valori con le stesse posizioni di
+  GlobalVariablesArea. La profondita` delle chiamate e` limitata dallo stack
+  del processo, non da quello della macchina astratta.
+*/
+class CppCode {
+
+  public:
+    /* METODI PUBBLICI */
+
+    /**
+     * Costruttore di default: sorgente vuoto.
+     */
+    CppCode();
+
+    /**
+     * Traduce <tt>program</tt>, gia` collegato e senza superistruzioni (vedi
+     * ProgramArea::fuse()), con le variabili globali <tt>globals</tt>;
+     * <tt>name</tt> e` il nome del programma, riportato nel commento
+     * iniziale. Se una funzione non puo` essere tradotta lancia
+     * un'eccezione di tipo std::string con la descrizione dell'errore.
+     */
+    void translate(const ProgramArea& program,
+        const GlobalVariablesArea& globals, const string& name);
+
+    /**
+     * Restituisce il sorgente C++ prodotto da translate().
+     */
+    const string& get_source() const;
+
+  private:
+    /* VARIABILI PRIVATE */
+
+    //! sorgente C++ del programma
+    string source;
+
+    /* METODI PRIVATI */
+
+    // il sorgente non puo` essere copiato
+    CppCode(const CppCode&);
+    CppCode& operator=(const CppCode&);
+
+};
+
+
+#endif // CPPCODE_H_INCLUSION_GUARD
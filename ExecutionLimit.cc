@@ -0,0 +1,99 @@
+/*!
+  \file ExecutionLimit.cc
+  \brief Implementazione di ExecutionLimit
+  \author Andrea Zanelli
+  \date 17-10-2026
+*/
+
+#ifndef EXECUTIONLIMIT_CC_INCLUSION_GUARD
+#define EXECUTIONLIMIT_CC_INCLUSION_GUARD
+
+#include <stdio.h>
+#include <time.h>
+#include <string>
+
+#include "ExecutionLimit.h"
+
+using std::string;
+
+
+const uint64_t ExecutionLimit::PERIOD;
+
+
+/* ExecutionLimit() ***********************************************************/
+ExecutionLimit::ExecutionLimit()
+  : instructions(0), milliseconds(0), executed(0), period(PERIOD),
+    left(PERIOD), deadline(0) {
+}
+
+
+/* void set_instructions(const uint64_t& instructions) ************************/
+void
+ExecutionLimit::set_instructions(const uint64_t& instructions) {
+  this->instructions = instructions;
+  return;
+}
+
+
+/* void set_time(const uint64_t& milliseconds) ********************************/
+void
+ExecutionLimit::set_time(const uint64_t& milliseconds) {
+  this->milliseconds = milliseconds;
+  return;
+}
+
+
+/* void start() ***************************************************************/
+void
+ExecutionLimit::start() {
+  executed = 0;
+  if(milliseconds > 0)
+    deadline = now() + milliseconds;
+  next_period();
+  return;
+}
+
+
+/* void check(const unsigned int& n) ******************************************/
+void
+ExecutionLimit::check(const unsigned int& n) {
+  char limite[64];
+  // il periodo termina con le istruzioni che stanno per essere eseguite
+  executed += period - left + n;
+  if(instructions > 0 && executed > instructions) {
+    sprintf(limite, "%llu istruzioni",
+        static_cast<unsigned long long>(instructions));
+    throw string("superato il limite di ") + limite;
+  }
+  if(milliseconds > 0 && now() >= deadline) {
+    sprintf(limite, "%llu ms", static_cast<unsigned long long>(milliseconds));
+    throw string("superato il limite di tempo di ") + limite;
+  }
+  next_period();
+  return;
+}
+
+
+/* void next_period() *********************************************************/
+void
+ExecutionLimit::next_period() {
+  // l'ultimo periodo finisce con la prima istruzione oltre il limite
+  period = PERIOD;
+  if(instructions > 0 && instructions + 1 - executed < period)
+    period = instructions + 1 - executed;
+  left = period;
+  return;
+}
+
+
+/* static uint64_t now() ******************************************************/
+uint64_t
+ExecutionLimit::now() {
+  struct timespec istante;
+  clock_gettime(CLOCK_MONOTONIC, &istante);
+  return static_cast<uint64_t>(istante.tv_sec) * 1000 +
+    static_cast<uint64_t>(istante.tv_nsec) / 1000000;
+}
+
+
+#endif // EXECUTIONLIMIT_CC_INCLUSION_GUARD
@@ -0,0 +1,131 @@
+/*!
+  \file ExecutionLimit.h
+  \brief Interfaccia di ExecutionLimit
+  \author Andrea Zanelli
+  \date 17-10-2026
+*/
+
+#ifndef EXECUTIONLIMIT_H_INCLUSION_GUARD
+#define EXECUTIONLIMIT_H_INCLUSION_GUARD
+
+#include <stdint.h>
+
+
+/*!
+  \class ExecutionLimit
+  \brief Limiti di istruzioni e di tempo di un'esecuzione
+
+  Limita il numero di istruzioni eseguite e il tempo trascorso (tempo reale,
+  in millisecondi) da ogni chiamata di una funzione del programma da parte
+  della macchina (vedi Machine::call()); superato un limite l'esecuzione
+  viene interrotta con un'eccezione. Come per Profiler, le istruzioni
+  vengono contate dall'esecutore solo nella sua versione con i limiti (vedi
+  esecutore()), percio` senza limiti l'esecuzione non ha nessun costo
+  aggiuntivo. Una superistruzione (vedi ProgramArea::fuse()) conta per tutte
+  le istruzioni della sequenza che sostituisce, percio` il limite di
+  istruzioni e` lo stesso con e senza la fusione; se il limite cade dentro
+  la sequenza, l'esecuzione viene interrotta prima della superistruzione.\\
+  Per ogni istruzione count() decrementa soltanto un contatore: il numero di
+  istruzioni eseguite e l'orologio vengono controllati ogni PERIOD
+  istruzioni (o prima, per fermarsi esattamente al limite di istruzioni).
+  Il tempo passato in attesa dello standard input non interrompe la lettura,
+  ma viene contato.
+*/
+class ExecutionLimit {
+
+  public:
+    /* METODI PUBBLICI */
+
+    //! numero massimo di istruzioni tra due controlli dell'orologio
+    static const uint64_t PERIOD = 1 << 14;
+
+    /**
+     * Costruttore di default: nessun limite.
+     */
+    ExecutionLimit();
+
+    /**
+     * Imposta a <tt>instructions</tt> il numero massimo di istruzioni
+     * eseguite da ogni chiamata (0: nessun limite).
+     */
+    void set_instructions(const uint64_t& instructions);
+
+    /**
+     * Imposta a <tt>milliseconds</tt> il tempo massimo di ogni chiamata
+     * (0: nessun limite).
+     */
+    void set_time(const uint64_t& milliseconds);
+
+    /**
+     * Restituisce true se c'e` almeno un limite.
+     */
+    inline
+    bool is_enabled() const {
+      return instructions > 0 || milliseconds > 0;
+    }
+
+    /**
+     * Inizia a contare le istruzioni e il tempo di una chiamata.
+     */
+    void start();
+
+    /**
+     * Conta l'esecuzione di <tt>n</tt> istruzioni (piu` di una per una
+     * superistruzione); se e` superato un limite lancia un'eccezione di tipo
+     * std::string con la descrizione dell'errore.
+     */
+    inline
+    void count(const unsigned int& n) {
+      if(left <= n)
+        check(n);
+      else
+        left -= n;
+      return;
+    }
+
+  private:
+    /* VARIABILI PRIVATE */
+
+    //! numero massimo di istruzioni (0: nessun limite)
+    uint64_t instructions;
+
+    //! tempo massimo in millisecondi (0: nessun limite)
+    uint64_t milliseconds;
+
+    //! istruzioni contate fino all'ultimo controllo
+    uint64_t executed;
+
+    //! istruzioni da contare tra l'ultimo controllo e il successivo
+    uint64_t period;
+
+    //! istruzioni che mancano al prossimo controllo
+    uint64_t left;
+
+    //! istante (in millisecondi, vedi now()) in cui scade il tempo
+    uint64_t deadline;
+
+    /* METODI PRIVATI */
+
+    /**
+     * Controlla i limiti alla fine di un periodo, che termina con le
+     * <tt>n</tt> istruzioni che stanno per essere eseguite, e inizia il
+     * successivo; se e` superato un limite lancia un'eccezione di tipo
+     * std::string con la descrizione dell'errore.
+     */
+    void check(const unsigned int& n);
+
+    /**
+     * Imposta la lunghezza del prossimo periodo: PERIOD istruzioni, o meno
+     * se il limite di istruzioni e` piu` vicino.
+     */
+    void next_period();
+
+    /**
+     * Restituisce l'istante attuale in millisecondi (orologio monotono).
+     */
+    static uint64_t now();
+
+};
+
+
+#endif // EXECUTIONLIMIT_H_INCLUSION_GUARD
@@ -0,0 +1,53 @@
+/*!
+  \file Function.h
+  \brief Elemento della tabella delle funzioni
+  \author Andrea Zanelli
+  \date 17-10-2026
+*/
+
+#ifndef FUNCTION_H_INCLUSION_GUARD
+#define FUNCTION_H_INCLUSION_GUARD
+
+#include <string>
+
+using std::string;
+
+
+/*!
+  \struct Function
+  \brief Funzione del programma, con le informazioni necessarie a chiamarla
+
+  Ogni funzione del programma ha un elemento nella tabella delle funzioni di
+  ProgramArea; al collegamento ogni istruzione <tt>invokestatic</tt> viene
+  risolta con l'indice dell'elemento della funzione chiamata, cosi` che
+  durante l'esecuzione una chiamata non richieda nessuna ricerca per nome.
+*/
+struct Function {
+  string name;           //!< descrittore "nome(argomenti)ritorno"
+  unsigned int start;    //!< indice della prima istruzione
+  unsigned int end;      //!< indice dell'ultima istruzione
+  unsigned int locals;   //!< posizioni delle variabili locali (con i
+                         //!< parametri), calcolate dalle istruzioni o date
+                         //!< con la direttiva <tt>.limit locals</tt>
+  unsigned int stack_limit; //!< posizioni dello stack degli operandi date
+                         //!< con <tt>.limit stack</tt>, o NO_LIMIT
+  unsigned int max_stack; //!< posizioni dello stack degli operandi
+                         //!< riservate nel RdA: quelle calcolate dalla
+                         //!< verifica, altrimenti stack_limit (o 0)
+  string arguments;      //!< tipo degli Slot dei parametri (es. "IJ$")
+  char return_type;      //!< tipo di ritorno: 'V', 'I' (int, short, char),
+                         //!< 'J' (long) o 'L' (riferimento)
+  unsigned int entry;    //!< PC con cui inizia una chiamata: start, oppure
+                         //!< l'inizio del codice a registri (vedi
+                         //!< RegisterCode)
+  bool verified;         //!< true se i tipi della funzione sono stati
+                         //!< verificati (vedi ProgramArea::verify())
+  //! valore di stack_limit senza la direttiva <tt>.limit stack</tt>
+  static const unsigned int NO_LIMIT = 0xFFFFFFFFu;
+  Function()
+    : start(0), end(0), locals(0), stack_limit(NO_LIMIT), max_stack(0),
+      return_type('V'), entry(0), verified(false) {}
+};
+
+
+#endif // FUNCTION_H_INCLUSION_GUARD
@@ -14,15 +14,15 @@
 /* void add_variable_S(const string& name, const int16_t& value) **************/
 void
 GlobalVariablesArea::add_variable_S(const string& name, const int16_t& value) {
-  variables_s.insert(make_pair(name,value));
+  add_variable(name, 'S', value);
   return;
 }
 
 
 /* void add_variable_C(const string& name, const uint16_t& value) *************/
-void 
+void
 GlobalVariablesArea::add_variable_C(const string& name, const uint16_t& value) {
-  variables_c.insert(make_pair(name,value));
+  add_variable(name, 'C', value);
   return;
 }
 
@@ -30,7 +30,7 @@ GlobalVariablesArea::add_variable_C(const string& name, const uint16_t& value) {
 /* void add_variable_I(const string& name, const int32_t& value) **************/
 void
 GlobalVariablesArea::add_variable_I(const string& name, const int32_t& value) {
-  variables_i.insert(make_pair(name,value));
+  add_variable(name, 'I', value);
   return;
 }
 
@@ -38,7 +38,7 @@ GlobalVariablesArea::add_variable_I(const string& name, const int32_t& value) {
 /* void add_variable_J(const string& name, const int64_t& value) **************/
 void
 GlobalVariablesArea::add_variable_J(const string& name, const int64_t& value) {
-  variables_j.insert(make_pair(name,value));
+  add_variable(name, 'J', value);
   return;
 }
 
@@ -46,23 +46,15 @@ GlobalVariablesArea::add_variable_J(const string& name, const int64_t& value) {
 /* void set_variable_S(const string& name, const int16_t& value) **************/
 void 
 GlobalVariablesArea::set_variable_S(const string& name, const int16_t& value) {
-  map<string,int16_t>::iterator iter = variables_s.find(name);
-  if(iter == variables_s.end())
-    throw string("variabile globale inesistente: " + name + " S");
-  else
-    iter->second = value;
+  values[find_slot(name, 'S')] = value;
   return;
 }
 
 
-/* void set_variable_C(const string& name, const uint16_t& value) **************/
+/* void set_variable_C(const string& name, const uint16_t& value) *************/
 void 
 GlobalVariablesArea::set_variable_C(const string& name, const uint16_t& value) {
-  map<string,uint16_t>::iterator iter = variables_c.find(name);
-  if(iter == variables_c.end())
-    throw string("variabile globale inesistente: " + name + " C");
-  else
-    iter->second = value;
+  values[find_slot(name, 'C')] = value;
   return;
 }
 
@@ -70,11 +62,7 @@ GlobalVariablesArea::set_variable_C(const string& name, const uint16_t& value) {
 /* void set_variable_I(const string& name, const int32_t& value) **************/
 void 
 GlobalVariablesArea::set_variable_I(const string& name, const int32_t& value) {
-  map<string,int32_t>::iterator iter = variables_i.find(name);
-  if(iter == variables_i.end())
-    throw string("variabile globale inesistente: " + name + " I");
-  else
-    iter->second = value;
+  values[find_slot(name, 'I')] = value;
   return;
 }
 
@@ -82,11 +70,7 @@ GlobalVariablesArea::set_variable_I(const string& name, const int32_t& value) {
 /* void set_variable_J(const string& name, const int64_t& value) **************/
 void 
 GlobalVariablesArea::set_variable_J(const string& name, const int64_t& value) {
-  map<string,int64_t>::iterator iter = variables_j.find(name);
-  if(iter == variables_j.end())
-    throw string("variabile globale inesistente: " + name + " J");
-  else
-    iter->second = value;
+  values[find_slot(name, 'J')] = value;
   return;
 }
 
@@ -94,41 +78,103 @@ GlobalVariablesArea::set_variable_J(const string& name, const int64_t& value) {
 /* int16_t get_variable_S(const string& name) const ***************************/
 int16_t 
 GlobalVariablesArea::get_variable_S(const string& name) const {
-  map<string,int16_t>::const_iterator iter = variables_s.find(name);
-  if(iter == variables_s.end())
-    throw string("variabile globale inesistente: " + name + " S");
-  return iter->second;
+  return static_cast<int16_t>(values[find_slot(name, 'S')]);
 }
 
 
 /* uint16_t get_variable_C(const string& name) const **************************/
 uint16_t 
 GlobalVariablesArea::get_variable_C(const string& name) const {
-  map<string,uint16_t>::const_iterator iter = variables_c.find(name);
-  if(iter == variables_c.end())
-    throw string("variabile globale inesistente: " + name + " C");
-  return iter->second;
+  return static_cast<uint16_t>(values[find_slot(name, 'C')]);
 }
 
 
 /* int32_t get_variable_I(const string& name) const ***************************/
 int32_t 
 GlobalVariablesArea::get_variable_I(const string& name) const {
-  map<string,int32_t>::const_iterator iter = variables_i.find(name);
-  if(iter == variables_i.end())
-    throw string("variabile globale inesistente: " + name + " I");
-  return iter->second;
+  return static_cast<int32_t>(values[find_slot(name, 'I')]);
 }
 
 
 /* int64_t get_variable_J(const string& name) const ***************************/
-int64_t
+int64_t 
 GlobalVariablesArea::get_variable_J(const string& name) const {
-  map<string,int64_t>::const_iterator iter = variables_j.find(name);
-  if(iter == variables_j.end())
-    throw string("variabile globale inesistente: " + name + " J");
-  return iter->second;
+  return static_cast<int64_t>(values[find_slot(name, 'J')]);
+}
+
+
+/* uint32_t get_slot(const string& name, const char& type) const **************/
+uint32_t
+GlobalVariablesArea::get_slot(const string& name, const char& type) const {
+  return find_slot(name, type);
+}
+
+
+/* unsigned int get_variables_size() const ************************************/
+unsigned int
+GlobalVariablesArea::get_variables_size() const {
+  return static_cast<unsigned int>(values.size());
+}
+
+
+/* void write_binary(BinaryWriter& out) const *********************************/
+void
+GlobalVariablesArea::write_binary(BinaryWriter& out) const {
+  // nome e tipo di ogni posizione, dalla chiave "nome tipo"
+  vector<string> keys(values.size());
+  map<string,uint32_t>::const_iterator iter;
+  for(iter = slots.begin(); iter != slots.end(); ++iter)
+    keys[iter->second] = iter->first;
+  out.put_u32(static_cast<uint32_t>(values.size()));
+  for(vector<string>::size_type i = 0; i < keys.size(); ++i) {
+    out.put_string(keys[i].substr(0, keys[i].size()-2));
+    out.put_char(keys[i][keys[i].size()-1]);
+    out.put_i64(values[i]);
+  }
+  return;
+}
+
+
+/* void read_binary(BinaryReader& in) *****************************************/
+void
+GlobalVariablesArea::read_binary(BinaryReader& in) {
+  if(!values.empty())
+    throw string("le variabili globali sono gia` state caricate");
+  uint32_t n = in.get_u32();
+  for(uint32_t i = 0; i < n; ++i) {
+    string name = in.get_string();
+    char type = in.get_char();
+    int64_t value = in.get_i64();
+    if(type != 'S' && type != 'C' && type != 'I' && type != 'J')
+      throw string("tipo sconosciuto nella variabile globale: " + name);
+    add_variable(name, type, value);
+    if(values.size() != i+1)
+      throw string("variabile globale definita piu` volte: " + name);
+  }
+  return;
 }
 
 
+/* void add_variable(const string& name, const char& type, ...) ***************/
+void
+GlobalVariablesArea::add_variable(const string& name, const char& type,
+    const int64_t& value) {
+  string key = name + ' ' + type;
+  if(slots.find(key) != slots.end())
+    return;
+  slots.insert(make_pair(key, static_cast<uint32_t>(values.size())));
+  values.push_back(value);
+  return;
+}
+
+
+/* uint32_t find_slot(const string& name, const char& type) const *************/
+uint32_t
+GlobalVariablesArea::find_slot(const string& name, const char& type) const {
+  map<string,uint32_t>::const_iterator iter = slots.find(name + ' ' + type);
+  if(iter == slots.end())
+    throw string("variabile globale inesistente: " + name + " " + type);
+  return iter->second;
+}
+
 #endif // GLOBALVARIABLESAREA_CC_INCLUSION_GUARD
@@ -10,9 +10,13 @@
 
 #include <stdint.h>
 #include <string>
+#include <vector>
 #include <map>
 
+#include "BinaryFile.h"
+
 using std::string;
+using std::vector;
 using std::map;
 
 
@@ -22,6 +26,12 @@ using std::map;
 
   Permette di aggiungere variabili globali di tipo S (short), C (char), I (int),
   J (long) e di impostare e leggere i valori associati al nome della variabile.
+  Ogni variabile occupa una posizione (slot) in un array contiguo di valori;
+  la posizione viene assegnata quando la variabile viene aggiunta e puo`
+  essere richiesta con get_slot(), cosi` che l'esecutore, a cui il
+  collegamento del programma fornisce la posizione di ogni variabile usata,
+  acceda ai valori per indice senza nessuna ricerca per nome. Le funzioni
+  con il nome della variabile restano per il caricamento e gli strumenti.
 */
 class GlobalVariablesArea {
   public:
@@ -31,7 +41,7 @@ class GlobalVariablesArea {
      * Aggiunge la variabile di tipo S (short: intero con segno a 16 bit) con 
      * nome <tt>name</tt> e valore iniziale <tt>value</tt> (di default 0). 
      * Il valore di questa variabile va da -32.768 a +32.767. Se la variabile 
-     * esiste gia` viene sovrascritta.
+     * esiste gia` non viene modificata.
      */
     void add_variable_S(const string& name, const int16_t& value = 0);
 
@@ -39,7 +49,7 @@ class GlobalVariablesArea {
      * Aggiunge la variabile di tipo C (char: intero senza segno a 16 bit) con 
      * nome <tt>name</tt> e valore iniziale <tt>value</tt> (di default 0). 
      * Il valore di questa variabile va da 0 a +65.535. Se la variabile 
-     * esiste gia` viene sovrascritta.
+     * esiste gia` non viene modificata.
      */
     void add_variable_C(const string& name, const uint16_t& value = 0);
 
@@ -47,7 +57,7 @@ class GlobalVariablesArea {
      * Aggiunge la variabile di tipo I (int: intero con segno a 32 bit) con 
      * nome <tt>name</tt> e valore iniziale <tt>value</tt> (di default 0). 
      * Il valore di questa variabile va da -2.147.483.648  a +2.147.483.647. 
-     * Se la variabile esiste gia` viene sovrascritta.
+     * Se la variabile esiste gia` non viene modificata.
      */
     void add_variable_I(const string& name, const int32_t& value = 0);
 
@@ -55,7 +65,7 @@ class GlobalVariablesArea {
      * Aggiunge la variabile di tipo J (long: intero con segno a 64 bit) cons
      * nome <tt>name</tt> e valore iniziale <tt>value</tt> (di default 0). 
      * Il valore di questa variabile va da -(2^63)  a +(2^63 - 1). 
-     * Se la variabile esiste gia` viene sovrascritta.
+     * Se la variabile esiste gia` non viene modificata.
      */
     void add_variable_J(const string& name, const int64_t& value = 0);
 
@@ -115,20 +125,84 @@ class GlobalVariablesArea {
      */
     int64_t get_variable_J(const string& name) const;
 
+    /**
+     * Restituisce la posizione della variabile con nome <tt>name</tt> e tipo
+     * <tt>type</tt> (S, C, I o J). Se la variabile non esiste lancia
+     * un'eccezione di tipo std::string con la descrizione dell'errore.
+     */
+    uint32_t get_slot(const string& name, const char& type) const;
+
+    /**
+     * Restituisce il valore della variabile nella posizione <tt>slot</tt>
+     * (ottenuta con get_slot()), gia` nell'intervallo del tipo della
+     * variabile.
+     */
+    inline
+    int64_t get_value(const uint32_t& slot) const {
+      return values[slot];
+    }
+
+    /**
+     * Cambia il valore della variabile nella posizione <tt>slot</tt>
+     * (ottenuta con get_slot()) impostandolo a <tt>value</tt>, che deve
+     * essere gia` nell'intervallo del tipo della variabile.
+     */
+    inline
+    void set_value(const uint32_t& slot, const int64_t& value) {
+      values[slot] = value;
+      return;
+    }
+
+    /**
+     * Restituisce l'indirizzo del valore della variabile nella posizione
+     * <tt>slot</tt>, usato dal codice nativo (vedi NativeCode) per leggere e
+     * scrivere la variabile direttamente; l'indirizzo resta valido finche`
+     * non vengono inserite altre variabili.
+     */
+    inline
+    int64_t* get_value_address(const uint32_t& slot) {
+      return &values[slot];
+    }
+
+    /**
+     * Ritorna il numero di variabili globali memorizzate
+     */
+    unsigned int get_variables_size() const;
+
+    /**
+     * Scrive in <tt>out</tt> le variabili (nome, tipo e valore) nell'ordine
+     * delle loro posizioni, per il file bytecode (vedi read_binary()).
+     */
+    void write_binary(BinaryWriter& out) const;
+
+    /**
+     * Legge da <tt>in</tt> le variabili scritte con write_binary() e le
+     * aggiunge, nelle stesse posizioni, all'area che dev'essere vuota. Se le
+     * variabili non sono valide lancia un'eccezione di tipo std::string con
+     * la descrizione dell'errore.
+     */
+    void read_binary(BinaryReader& in);
+
   private:
     /* VARIABILI PRIVATE */
 
-    //! usato per memorizzare le variabili di tipo S (short)
-    map<string,int16_t> variables_s;
+    //! valori delle variabili, uno per posizione
+    vector<int64_t> values;
+
+    //! usato per memorizzare il nome e il tipo delle variabili (nella forma
+    //! "nome tipo") con la loro posizione
+    map<string,uint32_t> slots;
 
-    //! usato per memorizzare le variabili di tipo C (char)
-    map<string,uint16_t> variables_c; 
+    /* METODI PRIVATI */
 
-    //! usato per memorizzare le variabili di tipo I (int)
-    map<string,int32_t> variables_i; 
+    // aggiunge, se non esiste, la variabile name di tipo type con valore
+    // iniziale value
+    void add_variable(const string& name, const char& type,
+        const int64_t& value);
 
-    //! usato per memorizzare le variabili di tipo J (long)
-    map<string,int64_t> variables_j;
+    // restituisce la posizione della variabile name di tipo type; se non
+    // esiste lancia un'eccezione
+    uint32_t find_slot(const string& name, const char& type) const;
 
 };
 
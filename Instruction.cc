@@ -0,0 +1,142 @@
+/*!
+  \file Instruction.cc
+  \brief Tabella dei mnemonici delle istruzioni
+  \author Andrea Zanelli
+  \date 17-10-2026
+*/
+
+#ifndef INSTRUCTION_CC_INCLUSION_GUARD
+#define INSTRUCTION_CC_INCLUSION_GUARD
+
+#include <string.h>
+
+#include "Instruction.h"
+
+
+// mnemonici, nello stesso ordine dei codici operativi in Opcode; quelli delle
+// superistruzioni sono i mnemonici della sequenza sostituita
+static const char* const nomi_opcode[OP_NUMERO_OPCODE] = {
+  "nop",
+  "ldc_w",
+  "ldc2_w",
+  "sipush",
+  "goto",
+  "if_icmpeq",
+  "if_icmpge",
+  "if_icmpgt",
+  "if_icmple",
+  "if_icmplt",
+  "if_icmpne",
+  "ifeq",
+  "ifge",
+  "ifgt",
+  "ifle",
+  "iflt",
+  "ifne",
+  "getstatic",
+  "putstatic",
+  "invokestatic",
+  "return",
+  "ireturn",
+  "lreturn",
+  "lcmp",
+  "iadd",
+  "idiv",
+  "imul",
+  "ineg",
+  "irem",
+  "ishl",
+  "ishr",
+  "isub",
+  "ladd",
+  "ldiv",
+  "lmul",
+  "lneg",
+  "lrem",
+  "lshl",
+  "lshr",
+  "lsub",
+  "iload",
+  "istore",
+  "lload",
+  "lstore",
+  "i2c",
+  "i2s",
+  "i2l",
+  "l2i",
+  "dup",
+  "dup2",
+  "pop",
+  "pop2",
+  "swap",
+  "new",
+  "invokevirtual",
+  "invokespecial",
+  "ldc_w+iload+iadd+istore",
+  "iload+ldc_w+iadd+istore",
+  "iload+ldc_w+isub+istore",
+  "iload+ldc_w+if_icmpeq",
+  "iload+ldc_w+if_icmpge",
+  "iload+ldc_w+if_icmpgt",
+  "iload+ldc_w+if_icmple",
+  "iload+ldc_w+if_icmplt",
+  "iload+ldc_w+if_icmpne",
+  "getstatic+iload+invokevirtual",
+  "getstatic+lload+invokevirtual",
+  "getstatic+ldc_w+invokevirtual"
+};
+
+
+/* const char* opcode_name(const uint16_t& opcode) ****************************/
+const char*
+opcode_name(const uint16_t& opcode) {
+  if(opcode >= OP_NUMERO_OPCODE)
+    return "?";
+  return nomi_opcode[opcode];
+}
+
+
+// numero di istruzioni di ogni codice operativo (1 per le istruzioni
+// normali), contato una volta sola nei mnemonici: nelle superistruzioni c'e`
+// un '+' tra ogni coppia di mnemonici della sequenza
+struct LunghezzeOpcode {
+  unsigned char lunghezza[OP_NUMERO_OPCODE];
+  LunghezzeOpcode() {
+    for(uint16_t op = 0; op < OP_NUMERO_OPCODE; ++op) {
+      lunghezza[op] = 1;
+      for(const char* c = nomi_opcode[op];
+          is_superinstruction(op) && *c != '\0'; ++c) {
+        if(*c == '+')
+          ++lunghezza[op];
+      }
+    }
+  }
+};
+
+
+/* unsigned int superinstruction_length(const uint16_t& opcode) ***************/
+unsigned int
+superinstruction_length(const uint16_t& opcode) {
+  // usata per ogni superistruzione eseguita con i limiti (vedi
+  // ExecutionLimit), percio` le lunghezze vengono contate una volta sola
+  static const LunghezzeOpcode lunghezze;
+  if(!is_superinstruction(opcode))
+    return 1;
+  return lunghezze.lunghezza[opcode];
+}
+
+
+/* uint16_t opcode_from_name(const char* name) ********************************/
+uint16_t
+opcode_from_name(const char* name) {
+  // il confronto sul primo carattere evita quasi tutte le chiamate a strcmp;
+  // le superistruzioni non possono comparire nel sorgente
+  for(uint16_t op = 0; op < OP_PRIMA_SUPERISTRUZIONE; ++op) {
+    if(nomi_opcode[op][0] == name[0] && strcmp(nomi_opcode[op], name) == 0)
+      return op;
+  }
+  return OP_NUMERO_OPCODE;
+}
+
+
+#endif // INSTRUCTION_CC_INCLUSION_GUARD
@@ -0,0 +1,209 @@
+/*!
+  \file Instruction.h
+  \brief Rappresentazione decodificata delle istruzioni
+  \author Andrea Zanelli
+  \date 17-10-2026
+*/
+
+#ifndef INSTRUCTION_H_INCLUSION_GUARD
+#define INSTRUCTION_H_INCLUSION_GUARD
+
+#include <stdint.h>
+
+
+/*!
+  \enum Opcode
+  \brief Codici operativi delle istruzioni riconosciute dalla macchina
+
+  Ogni mnemonico dell'instruction-set ha un proprio codice operativo; le
+  istruzioni vuote (righe con la sola etichetta) vengono decodificate come
+  <tt>OP_NOP</tt>. I codici da <tt>OP_PRIMA_SUPERISTRUZIONE</tt> in poi sono
+  superistruzioni, che non compaiono nel sorgente ne` nei file bytecode ma
+  vengono create da ProgramArea::fuse() al posto della prima istruzione di
+  una sequenza frequente (vedi is_superinstruction()).
+  <tt>OP_NUMERO_OPCODE</tt> non e` un'istruzione ma il numero di codici
+  operativi, utile per dimensionare le tabelle indicizzate per codice
+  operativo.
+*/
+enum Opcode {
+  OP_NOP = 0,
+  OP_LDC_W,
+  OP_LDC2_W,
+  OP_SIPUSH,
+  OP_GOTO,
+  OP_IF_ICMPEQ,
+  OP_IF_ICMPGE,
+  OP_IF_ICMPGT,
+  OP_IF_ICMPLE,
+  OP_IF_ICMPLT,
+  OP_IF_ICMPNE,
+  OP_IFEQ,
+  OP_IFGE,
+  OP_IFGT,
+  OP_IFLE,
+  OP_IFLT,
+  OP_IFNE,
+  OP_GETSTATIC,
+  OP_PUTSTATIC,
+  OP_INVOKESTATIC,
+  OP_RETURN,
+  OP_IRETURN,
+  OP_LRETURN,
+  OP_LCMP,
+  OP_IADD,
+  OP_IDIV,
+  OP_IMUL,
+  OP_INEG,
+  OP_IREM,
+  OP_ISHL,
+  OP_ISHR,
+  OP_ISUB,
+  OP_LADD,
+  OP_LDIV,
+  OP_LMUL,
+  OP_LNEG,
+  OP_LREM,
+  OP_LSHL,
+  OP_LSHR,
+  OP_LSUB,
+  OP_ILOAD,
+  OP_ISTORE,
+  OP_LLOAD,
+  OP_LSTORE,
+  OP_I2C,
+  OP_I2S,
+  OP_I2L,
+  OP_L2I,
+  OP_DUP,
+  OP_DUP2,
+  OP_POP,
+  OP_POP2,
+  OP_SWAP,
+  OP_NEW,
+  OP_INVOKEVIRTUAL,
+  OP_INVOKESPECIAL,
+  // superistruzioni
+  OP_LDC_W_ILOAD_IADD_ISTORE,
+  OP_PRIMA_SUPERISTRUZIONE = OP_LDC_W_ILOAD_IADD_ISTORE,
+  OP_ILOAD_LDC_W_IADD_ISTORE,
+  OP_ILOAD_LDC_W_ISUB_ISTORE,
+  OP_ILOAD_LDC_W_IF_ICMPEQ,
+  OP_ILOAD_LDC_W_IF_ICMPGE,
+  OP_ILOAD_LDC_W_IF_ICMPGT,
+  OP_ILOAD_LDC_W_IF_ICMPLE,
+  OP_ILOAD_LDC_W_IF_ICMPLT,
+  OP_ILOAD_LDC_W_IF_ICMPNE,
+  OP_GETSTATIC_ILOAD_PRINT_INT,
+  OP_GETSTATIC_LLOAD_PRINT_LONG,
+  OP_GETSTATIC_LDC_W_PRINT_STRING,
+  OP_NUMERO_OPCODE
+};
+
+
+/*!
+  \enum Intrinsic
+  \brief Metodi di libreria predefiniti, chiamati da invokestatic,
+  invokevirtual e invokespecial
+
+  I metodi della libreria Java usati per stampa e lettura non esistono nel
+  programma: sono i primi metodi della tabella dei metodi nativi (vedi
+  NativeMethod), con questi indici, e vengono riconosciuti al caricamento
+  come gli altri metodi nativi. <tt>INTR_NESSUNO</tt> indica un metodo
+  sconosciuto, che viene ignorato durante l'esecuzione; i metodi registrati
+  dal programma che usa la macchina hanno indice maggiore o uguale a
+  <tt>INTR_NUMERO</tt>.
+*/
+enum Intrinsic {
+  INTR_NESSUNO = 0,
+  INTR_PRINT_INT,
+  INTR_PRINT_CHAR,
+  INTR_PRINT_LONG,
+  INTR_PRINT_STRING,
+  INTR_READ,
+  INTR_READLINE,
+  INTR_PARSE_INT,
+  INTR_PARSE_LONG,
+  INTR_INIT_INPUTSTREAMREADER,
+  INTR_INIT_BUFFEREDREADER,
+  INTR_NUMERO
+};
+
+
+/*!
+  \struct Instruction
+  \brief Istruzione decodificata al caricamento del programma
+
+  Contiene il codice operativo e gli argomenti gia` estratti dalla stringa
+  dell'istruzione, in modo che durante l'esecuzione non sia necessario
+  analizzare nessuna stringa. Il significato dei campi dipende dal codice
+  operativo:
+    - <tt>ldc_w</tt>: <tt>type</tt> 'I' con la costante in <tt>value</tt>,
+      oppure 'L' con l'indice della stringa (gia` senza virgolette e
+      caratteri di escape) nel pool delle costanti stringa in <tt>index</tt>
+      (vedi ProgramArea::get_constant()).
+    - <tt>ldc2_w</tt>, <tt>sipush</tt>: costante in <tt>value</tt>.
+    - salti: indice del simbolo dell'etichetta in <tt>index</tt>; dopo il
+      collegamento (ProgramArea::link()) <tt>index</tt> e` l'indice
+      dell'istruzione "puntata" dall'etichetta.
+    - <tt>iload</tt>, <tt>istore</tt>, <tt>lload</tt>, <tt>lstore</tt>:
+      indice della variabile locale in <tt>index</tt>.
+    - <tt>getstatic</tt>, <tt>putstatic</tt>: tipo della variabile globale
+      ('I', 'J', 'S' o 'C') in <tt>type</tt> e indice del simbolo del nome in
+      <tt>index</tt> (dopo il collegamento la posizione della variabile in
+      GlobalVariablesArea); per gli oggetti <em>out</em> e <em>in</em> di System
+      <tt>type</tt> vale 'L' e <tt>index</tt> e` l'indice del tipo nella
+      tabella dei tipi (vedi ref_type_id()).
+    - <tt>new</tt>: indice del tipo (nella forma "Lnome;") nella tabella dei
+      tipi.
+    - <tt>invokestatic</tt>, <tt>invokevirtual</tt>, <tt>invokespecial</tt>:
+      <tt>type</tt> 'M' per le funzioni del programma, con l'indice del
+      simbolo "nome(argomenti)ritorno" in <tt>index</tt> (dopo il
+      collegamento l'indice della funzione nella tabella delle funzioni, vedi
+      Function), oppure 'N' per i metodi di libreria, con l'indice del
+      metodo nella tabella dei metodi nativi (vedi NativeMethod e
+      Intrinsic) in <tt>index</tt>.
+    - superistruzioni: sostituiscono solo il codice operativo della prima
+      istruzione della sequenza; gli argomenti restano nelle istruzioni della
+      sequenza, che non vengono modificate (un salto verso una di queste
+      esegue la sequenza originale).
+*/
+struct Instruction {
+  uint16_t opcode; //!< codice operativo (Opcode)
+  char     type;   //!< tipo dell'argomento, dipende dal codice operativo
+  uint32_t index;  //!< indice: variabile locale, simbolo o metodo di libreria
+  int64_t  value;  //!< costante intera
+  Instruction() : opcode(OP_NOP), type(0), index(0), value(0) {}
+};
+
+
+/**
+ * Restituisce <tt>true</tt> se <tt>opcode</tt> e` una superistruzione (vedi
+ * Opcode).
+ */
+inline
+bool is_superinstruction(const uint16_t& opcode) {
+  return opcode >= OP_PRIMA_SUPERISTRUZIONE && opcode < OP_NUMERO_OPCODE;
+}
+
+/**
+ * Restituisce il numero di istruzioni della sequenza sostituita dalla
+ * superistruzione <tt>opcode</tt>, oppure 1 se <tt>opcode</tt> non e` una
+ * superistruzione.
+ */
+unsigned int superinstruction_length(const uint16_t& opcode);
+
+/**
+ * Restituisce il mnemonico corrispondente al codice operativo
+ * <tt>opcode</tt>, oppure "?" se il codice non e` valido.
+ */
+const char* opcode_name(const uint16_t& opcode);
+
+/**
+ * Restituisce il codice operativo corrispondente al mnemonico
+ * <tt>name</tt>. Se il mnemonico non esiste, o e` quello di una
+ * superistruzione, restituisce <tt>OP_NUMERO_OPCODE</tt>.
+ */
+uint16_t opcode_from_name(const char* name);
+
+
+#endif // INSTRUCTION_H_INCLUSION_GUARD
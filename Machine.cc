@@ -0,0 +1,92 @@
+/*!
+  \file Machine.cc
+  \brief Implementazione di Machine
+  \author Andrea Zanelli
+  \date 17-10-2026
+*/
+
+#ifndef MACHINE_CC_INCLUSION_GUARD
+#define MACHINE_CC_INCLUSION_GUARD
+
+#include <iostream>
+
+#include "Machine.h"
+
+
+// Dichiarazione di funzioni
+
+extern void esecutore(Machine& m);
+extern void esecutore_a_registri(Machine& m);
+
+
+/* Machine(const shared_ptr<const ProgramImage>& image) ***********************/
+Machine::Machine(const shared_ptr<const ProgramImage>& image)
+  : image(image),
+    program(image->program),
+    globals(image->globals),
+    input(&std::cin),
+    registers(image->registers),
+    result(0) {
+}
+
+
+/* void call(const string& name, const vector<int64_t>& arguments) ************/
+void
+Machine::call(const string& name, const vector<int64_t>& arguments) {
+  if(!stack.empty())
+    throw string("la macchina sta gia` eseguendo una funzione");
+  if(limit.is_enabled() && registers.get_size() > 0)
+    throw string("i limiti di istruzioni e di tempo non si usano con il "
+        "codice a registri");
+  const Function& funzione = program.find_function(name);
+  // i parametri int e long, nella disposizione delle variabili locali
+  vector<int64_t>::size_type n_parametri = 0;
+  for(string::size_type i = 0; i < funzione.arguments.size(); ++i) {
+    if(funzione.arguments[i] == 'I' || funzione.arguments[i] == 'J')
+      ++n_parametri;
+  }
+  if(n_parametri != arguments.size())
+    throw string("numero di parametri errato nella chiamata di " + name);
+  stack.push_ar(funzione.locals, funzione.max_stack);
+  for(uint16_t i = 0, k = 0; i < funzione.arguments.size(); ++i) {
+    if(funzione.arguments[i] == 'I')
+      stack.local_variable_set_int(i, static_cast<int32_t>(arguments[k++]));
+    else if(funzione.arguments[i] == 'J')
+      stack.local_variable_set_long(i, arguments[k++]);
+  }
+  stack.pc_set(funzione.entry);
+  result = 0;
+  try {
+    if(limit.is_enabled())
+      limit.start();
+    if(profiler.is_enabled())
+      profiler.call_at(stack.pc_get());
+    // il codice a registri (se c'e`) e` eseguito da esecutore_a_registri(),
+    // che passa a esecutore() nelle funzioni non tradotte
+    if(registers.get_size() > 0)
+      esecutore_a_registri(*this);
+    else
+      esecutore(*this);
+  }
+  catch(...) {
+    // i RdA rimasti dall'errore
+    while(!stack.empty())
+      stack.pop_ar();
+    throw;
+  }
+  return;
+}
+
+
+/* void run() *****************************************************************/
+void
+Machine::run() {
+  // la funzione <clinit>()V inizializza le variabili globali
+  if(program.has_function("<clinit>()V"))
+    call("<clinit>()V");
+  call("main([Ljava/lang/String;)V");
+  return;
+}
+
+
+#endif // MACHINE_CC_INCLUSION_GUARD
@@ -0,0 +1,136 @@
+/*!
+  \file Machine.h
+  \brief Interfaccia di Machine
+  \author Andrea Zanelli
+  \date 17-10-2026
+*/
+
+#ifndef MACHINE_H_INCLUSION_GUARD
+#define MACHINE_H_INCLUSION_GUARD
+
+#include <stdint.h>
+#include <istream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "ExecutionLimit.h"
+#include "GlobalVariablesArea.h"
+#include "NativeCode.h"
+#include "OutputBuffer.h"
+#include "Profiler.h"
+#include "ProgramImage.h"
+#include "SystemStack.h"
+
+using std::shared_ptr;
+using std::string;
+using std::vector;
+
+
+/*!
+  \class Machine
+  \brief Istanza della macchina astratta
+
+  Esegue un programma gia` caricato e preparato (vedi ProgramImage), che la
+  macchina condivide senza copiarlo: del programma ha solo i riferimenti
+  all'area del programma e al codice a registri dell'immagine, che non
+  vengono modificati. Lo stato dell'esecuzione e` invece della macchina: le
+  variabili globali (inizializzate con i valori dell'immagine), lo stack di
+  sistema, l'uscita con il suo buffer, l'ingresso da cui il programma legge
+  e, se attivi, il codice nativo e il profilo. Percio` una sola immagine
+  puo` essere eseguita da molte macchine, e la memoria di ogni macchina in
+  piu` e` quella dei suoi RdA e dei suoi buffer.\\
+  L'esecutore (vedi esecutore() e esecutore_a_registri()) riceve la
+  macchina da eseguire come argomento e non usa nessuna variabile globale,
+  percio` piu` macchine possono eseguire contemporaneamente, ciascuna in un
+  thread diverso (una stessa macchina puo` essere usata da un solo thread
+  alla volta).\\
+  Gli oggetti che compongono la macchina sono pubblici, perche` l'esecutore
+  li usa direttamente in ogni istruzione; run() esegue il programma.
+*/
+class Machine {
+
+  public:
+    /* VARIABILI PUBBLICHE */
+
+    //! immagine del programma eseguito, condivisa con le altre macchine
+    const shared_ptr<const ProgramImage> image;
+
+    //! insieme delle istruzioni da eseguire, suddivise per funzione
+    //! (quello dell'immagine)
+    const ProgramArea& program;
+
+    //! variabili globali del programma
+    GlobalVariablesArea globals;
+
+    //! stack di sistema, contiene i record di attivazione
+    SystemStack stack;
+
+    //! uscita del programma, con il buffer delle stampe
+    OutputBuffer output;
+
+    //! ingresso del programma (std::cin se non viene cambiato)
+    std::istream* input;
+
+    //! codice a registri delle funzioni tradotte (quello dell'immagine,
+    //! vuoto se non usato)
+    const RegisterCode& registers;
+
+    //! codice nativo delle funzioni compilate (se attivo)
+    NativeCode native;
+
+    //! profilo dell'esecuzione (se attivo)
+    Profiler profiler;
+
+    //! limiti di istruzioni e di tempo di ogni chiamata (se attivi)
+    ExecutionLimit limit;
+
+    //! valore restituito dall'ultima funzione chiamata con call() (0 se la
+    //! funzione e` di tipo void); un int e` esteso a 64 bit con il segno
+    int64_t result;
+
+    /* METODI PUBBLICI */
+
+    /**
+     * Costruttore: macchina che esegue il programma di <tt>image</tt>, gia`
+     * preparato, con le variabili globali al loro valore iniziale; legge
+     * dallo standard input e stampa sullo standard output.
+     */
+    Machine(const shared_ptr<const ProgramImage>& image);
+
+    /**
+     * Esegue la funzione <tt>name</tt> (ad esempio "fact(I)I" o
+     * "main([Ljava/lang/String;)V") con i parametri <tt>arguments</tt>, uno
+     * per ogni parametro int, short, char o long della funzione, nell'ordine
+     * (i parametri di tipo riferimento, come l'array di main, non vengono
+     * passati e restano non inizializzati): crea il suo RdA sullo stack di
+     * sistema, con i parametri nelle prime variabili locali, e ritorna
+     * quando la funzione e` terminata, con il valore restituito in
+     * <tt>result</tt>. Il numero di istruzioni e il tempo della chiamata
+     * sono limitati da <tt>limit</tt>, se attivo (solo nell'esecuzione
+     * sullo stack, senza codice a registri). In caso di errore, anche
+     * durante l'esecuzione, lo stack di sistema viene svuotato, cosi` che
+     * la macchina possa eseguire altre chiamate, e viene lanciata
+     * un'eccezione di tipo std::string con la descrizione dell'errore.
+     */
+    void call(const string& name,
+        const vector<int64_t>& arguments = vector<int64_t>());
+
+    /**
+     * Esegue il programma caricato: la funzione "<clinit>()V", se esiste,
+     * e poi la funzione main. In caso di errore lancia un'eccezione di tipo
+     * std::string con la descrizione dell'errore.
+     */
+    void run();
+
+  private:
+    /* METODI PRIVATI */
+
+    // la macchina non puo` essere copiata
+    Machine(const Machine&);
+    Machine& operator=(const Machine&);
+
+};
+
+
+#endif // MACHINE_H_INCLUSION_GUARD
@@ -0,0 +1,125 @@
+/*!
+  \file MappedFile.cc
+  \brief Implementazione di MappedFile
+  \author Andrea Zanelli
+  \date 17-10-2026
+*/
+
+#ifndef MAPPEDFILE_CC_INCLUSION_GUARD
+#define MAPPEDFILE_CC_INCLUSION_GUARD
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdlib.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "MappedFile.h"
+
+
+/* MappedFile() ***************************************************************/
+MappedFile::MappedFile()
+  : data(0), size(0), mapped(false) {
+}
+
+
+/* ~MappedFile() **************************************************************/
+MappedFile::~MappedFile() {
+  close();
+}
+
+
+/* void open(const string& name) **********************************************/
+void
+MappedFile::open(const string& name) {
+  close();
+  int fd = ::open(name.c_str(), O_RDONLY);
+  if(fd < 0)
+    throw string("impossibile aprire il file " + name);
+  struct stat info;
+  if(fstat(fd, &info) == 0 && S_ISREG(info.st_mode)) {
+    if(info.st_size == 0) {
+      // file vuoto: niente da mappare
+      ::close(fd);
+      return;
+    }
+    void* area = mmap(0, info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    if(area != MAP_FAILED) {
+      ::close(fd);
+      data = static_cast<char*>(area);
+      size = info.st_size;
+      mapped = true;
+      // il file viene letto dall'inizio alla fine
+      madvise(area, size, MADV_SEQUENTIAL);
+      return;
+    }
+  }
+  // il file non puo` essere mappato: viene letto in un buffer
+  try {
+    read_all(fd, name);
+  }
+  catch(...) {
+    ::close(fd);
+    throw;
+  }
+  ::close(fd);
+  return;
+}
+
+
+/* void close() ***************************************************************/
+void
+MappedFile::close() {
+  if(mapped)
+    munmap(data, size);
+  else
+    free(data);
+  data = 0;
+  size = 0;
+  mapped = false;
+  return;
+}
+
+
+/* const char* get_data() const ***********************************************/
+const char*
+MappedFile::get_data() const {
+  return data;
+}
+
+
+/* size_t get_size() const ****************************************************/
+size_t
+MappedFile::get_size() const {
+  return size;
+}
+
+
+/* void read_all(const int& fd, const string& name) ***************************/
+void
+MappedFile::read_all(const int& fd, const string& name) {
+  size_t capacity = 0;
+  for(;;) {
+    if(size == capacity) {
+      capacity = capacity ? capacity * 2 : 65536;
+      char* new_data = static_cast<char*>(realloc(data, capacity));
+      if(new_data == 0)
+        throw string("memoria insufficiente per leggere il file " + name);
+      data = new_data;
+    }
+    ssize_t n = ::read(fd, data + size, capacity - size);
+    if(n < 0) {
+      if(errno == EINTR)
+        continue;
+      throw string("errore nella lettura del file " + name);
+    }
+    if(n == 0)
+      break;
+    size += n;
+  }
+  return;
+}
+
+
+#endif // MAPPEDFILE_CC_INCLUSION_GUARD
@@ -0,0 +1,90 @@
+/*!
+  \file MappedFile.h
+  \brief Interfaccia di MappedFile
+  \author Andrea Zanelli
+  \date 17-10-2026
+*/
+
+#ifndef MAPPEDFILE_H_INCLUSION_GUARD
+#define MAPPEDFILE_H_INCLUSION_GUARD
+
+#include <stddef.h>
+#include <string>
+
+using std::string;
+
+
+/*!
+  \class MappedFile
+  \brief Contenuto di un file, accessibile in memoria senza copiarlo
+
+  Mappa in memoria (in sola lettura) il file aperto con open(), cosi` che il
+  suo contenuto possa essere letto direttamente, senza copiarlo in stringhe o
+  buffer intermedi. Se il file non puo` essere mappato (ad esempio perche`
+  non e` un file regolare) il contenuto viene letto in un buffer allocato una
+  sola volta. Il contenuto resta valido fino alla chiamata successiva di
+  open() o close(), o fino alla distruzione dell'oggetto; l'inizio del
+  contenuto e` allineato almeno a 8 byte.
+*/
+class MappedFile {
+
+  public:
+    /* METODI PUBBLICI */
+
+    /**
+     * Costruttore di default: nessun file aperto.
+     */
+    MappedFile();
+
+    /**
+     * Distruttore: chiude il file.
+     */
+    ~MappedFile();
+
+    /**
+     * Apre il file <tt>name</tt>, dopo aver chiuso quello aperto in
+     * precedenza. In caso di errore lancia un'eccezione di tipo std::string
+     * con la descrizione dell'errore.
+     */
+    void open(const string& name);
+
+    /**
+     * Chiude il file aperto (il suo contenuto non e` piu` accessibile).
+     */
+    void close();
+
+    /**
+     * Restituisce il puntatore al contenuto del file.
+     */
+    const char* get_data() const;
+
+    /**
+     * Restituisce la dimensione del contenuto del file in byte.
+     */
+    size_t get_size() const;
+
+  private:
+    /* VARIABILI PRIVATE */
+
+    //! contenuto del file
+    char* data;
+
+    //! dimensione del contenuto in byte
+    size_t size;
+
+    //! true se il contenuto e` mappato, false se e` in un buffer allocato
+    bool mapped;
+
+    /* METODI PRIVATI */
+
+    // il file non puo` essere copiato
+    MappedFile(const MappedFile&);
+    MappedFile& operator=(const MappedFile&);
+
+    // legge il contenuto del descrittore fd in un buffer allocato
+    void read_all(const int& fd, const string& name);
+
+};
+
+
+#endif // MAPPEDFILE_H_INCLUSION_GUARD
@@ -0,0 +1,818 @@
+/*!
+  \file NativeCode.cc
+  \brief Implementazione di NativeCode
+  \author Andrea Zanelli
+  \date 17-10-2026
+*/
+
+#ifndef NATIVECODE_CC_INCLUSION_GUARD
+#define NATIVECODE_CC_INCLUSION_GUARD
+
+#include <exception>
+#include <stdio.h>
+#include <string.h>
+#include <sys/mman.h>
+
+#include "NativeCode.h"
+#include "Machine.h"
+#include "NativeMethod.h"
+
+
+// Macchina astratta che sta eseguendo il codice nativo in questo thread
+// (impostata da NativeCode::run(), usata dalle funzioni di supporto)
+static thread_local Machine* macchina_nativa = 0;
+
+// descrizione dell'errore incontrato da una funzione di supporto
+static thread_local string errore_nativo;
+
+// eccezione di altro tipo (ad esempio std::bad_alloc, o lanciata da un
+// metodo nativo), rilanciata da NativeCode::run() dopo il codice nativo
+static thread_local std::exception_ptr eccezione_nativa;
+
+
+// Funzioni di supporto chiamate dal codice nativo: non lasciano passare
+// eccezioni (che non possono attraversare il codice nativo) ma salvano la
+// descrizione dell'errore (o l'eccezione, se non e` di tipo std::string) e
+// restituiscono NativeCode::ERROR
+
+// R_CALL: crea il RdA della funzione chiamata, come esecutore_a_registri()
+static uint32_t nativo_chiamata(uint32_t indice) {
+  Machine& m = *macchina_nativa;
+  try {
+    const RegisterInstruction& istr = m.registers.get_code()[indice];
+    const Function& funzione = m.program.get_function(istr.index);
+    m.stack.op_stack_set_size(istr.dst);
+    m.stack.pc_set(m.program.get_instructions_size() + indice + 1);
+    m.stack.push_ar(funzione.locals, funzione.arguments,
+        funzione.max_stack);
+    m.stack.pc_set(funzione.entry);
+  }
+  catch(string e) {
+    errore_nativo = e;
+    return NativeCode::ERROR;
+  }
+  catch(...) {
+    eccezione_nativa = std::current_exception();
+    return NativeCode::ERROR;
+  }
+  return NativeCode::RESUME;
+}
+
+// R_RETURN, R_IRETURN, R_LRETURN: toglie il RdA e passa il valore al chiamante
+// (il tipo restituito e` gia` quello dichiarato, vedi RegisterCode::compile())
+static uint32_t nativo_ritorno() {
+  Machine& m = *macchina_nativa;
+  try {
+    m.stack.pop_ar();
+  }
+  catch(string e) {
+    errore_nativo = e;
+    return NativeCode::ERROR;
+  }
+  catch(...) {
+    eccezione_nativa = std::current_exception();
+    return NativeCode::ERROR;
+  }
+  return m.stack.empty() ? NativeCode::END : NativeCode::RESUME;
+}
+
+static uint32_t nativo_ritorno_int(int32_t valore) {
+  Machine& m = *macchina_nativa;
+  try {
+    m.stack.pop_ar();
+    if(m.stack.empty()) {
+      m.result = valore;
+      return NativeCode::END;
+    }
+    m.stack.op_stack_push_int(valore);
+  }
+  catch(string e) {
+    errore_nativo = e;
+    return NativeCode::ERROR;
+  }
+  catch(...) {
+    eccezione_nativa = std::current_exception();
+    return NativeCode::ERROR;
+  }
+  return NativeCode::RESUME;
+}
+
+static uint32_t nativo_ritorno_long(int64_t valore) {
+  Machine& m = *macchina_nativa;
+  try {
+    m.stack.pop_ar();
+    if(m.stack.empty()) {
+      m.result = valore;
+      return NativeCode::END;
+    }
+    m.stack.op_stack_push_long(valore);
+  }
+  catch(string e) {
+    errore_nativo = e;
+    return NativeCode::ERROR;
+  }
+  catch(...) {
+    eccezione_nativa = std::current_exception();
+    return NativeCode::ERROR;
+  }
+  return NativeCode::RESUME;
+}
+
+// R_NATIVE: chiama il metodo nativo come esecutore_a_registri(); restituisce
+// 0 (i parametri e il risultato sono nel RdA, che non si sposta)
+static uint32_t nativo_metodo(uint32_t indice) {
+  Machine& m = *macchina_nativa;
+  try {
+    const RegisterInstruction& istr = m.registers.get_code()[indice];
+    m.stack.op_stack_set_size(istr.dst);
+    native_method(istr.index).function(m);
+  }
+  catch(string e) {
+    errore_nativo = e;
+    return NativeCode::ERROR;
+  }
+  catch(...) {
+    eccezione_nativa = std::current_exception();
+    return NativeCode::ERROR;
+  }
+  return 0;
+}
+
+// R_PRINT_I, R_PRINT_C, R_PRINT_J, R_PRINT_CONST: restituiscono 0
+static uint32_t nativo_stampa_int(int32_t valore) {
+  Machine& m = *macchina_nativa;
+  try {
+    m.output.put_int(valore);
+  }
+  catch(string e) {
+    errore_nativo = e;
+    return NativeCode::ERROR;
+  }
+  catch(...) {
+    eccezione_nativa = std::current_exception();
+    return NativeCode::ERROR;
+  }
+  return 0;
+}
+
+static uint32_t nativo_stampa_char(int32_t valore) {
+  Machine& m = *macchina_nativa;
+  try {
+    m.output.put_char(static_cast<char>(valore));
+  }
+  catch(string e) {
+    errore_nativo = e;
+    return NativeCode::ERROR;
+  }
+  catch(...) {
+    eccezione_nativa = std::current_exception();
+    return NativeCode::ERROR;
+  }
+  return 0;
+}
+
+static uint32_t nativo_stampa_long(int64_t valore) {
+  Machine& m = *macchina_nativa;
+  try {
+    m.output.put_long(valore);
+  }
+  catch(string e) {
+    errore_nativo = e;
+    return NativeCode::ERROR;
+  }
+  catch(...) {
+    eccezione_nativa = std::current_exception();
+    return NativeCode::ERROR;
+  }
+  return 0;
+}
+
+static uint32_t nativo_stampa_stringa(const string* stringa) {
+  Machine& m = *macchina_nativa;
+  try {
+    m.output.put_string(*stringa);
+  }
+  catch(string e) {
+    errore_nativo = e;
+    return NativeCode::ERROR;
+  }
+  catch(...) {
+    eccezione_nativa = std::current_exception();
+    return NativeCode::ERROR;
+  }
+  return 0;
+}
+
+
+// Registri x86-64 usati dai modelli (rbx contiene il puntatore agli Slot)
+enum Registro {
+  EAX = 0,
+  ECX = 1,
+  EDX = 2,
+  ESI = 6,
+  EDI = 7
+};
+
+// Condizioni dei salti condizionati (secondo byte di jcc rel32)
+enum Condizione {
+  JE = 0x84,
+  JNE = 0x85,
+  JL = 0x8C,
+  JGE = 0x8D,
+  JLE = 0x8E,
+  JG = 0x8F
+};
+
+// posizione del valore, del tipo del riferimento e del tipo in uno Slot
+static const int32_t VALORE = offsetof(Slot, value);
+static const int32_t RIFERIMENTO = offsetof(Slot, ref_type);
+static const int32_t TIPO = offsetof(Slot, tag);
+
+
+/*!
+  \class Emettitore
+  \brief Scrittura del codice macchina di una funzione (vedi NativeCode)
+*/
+class Emettitore {
+
+  public:
+    vector<unsigned char> codice;
+
+    // salti da completare: posizione dello spostamento e istruzione
+    // destinazione del codice a registri
+    vector<size_t> salti;
+    vector<uint32_t> destinazioni;
+
+    void byte(const unsigned int& b) {
+      codice.push_back(static_cast<unsigned char>(b));
+    }
+
+    void word(const unsigned int& w) {
+      byte(w & 0xFF);
+      byte((w >> 8) & 0xFF);
+    }
+
+    void dword(const uint32_t& d) {
+      for(unsigned int i = 0; i < 4; ++i)
+        byte((d >> (8 * i)) & 0xFF);
+    }
+
+    void qword(const uint64_t& q) {
+      for(unsigned int i = 0; i < 8; ++i)
+        byte(static_cast<unsigned int>(q >> (8 * i)) & 0xFF);
+    }
+
+    // posizione in memoria del registro r (Slot del RdA), piu` spostamento
+    static int32_t slot(const unsigned int& r, const int32_t& spostamento) {
+      return static_cast<int32_t>(r * sizeof(Slot)) + spostamento;
+    }
+
+    // byte ModRM (e spostamento a 32 bit) per l'operando [rbx + spostamento]
+    void memoria(const unsigned int& reg, const int32_t& spostamento) {
+      byte(0x80 | (reg << 3) | 3);
+      dword(static_cast<uint32_t>(spostamento));
+    }
+
+    // mov reg32, [r] e mov reg64, [r]
+    void carica32(const Registro& reg, const unsigned int& r) {
+      byte(0x8B);
+      memoria(reg, slot(r, VALORE));
+    }
+
+    void carica64(const Registro& reg, const unsigned int& r) {
+      byte(0x48);
+      carica32(reg, r);
+    }
+
+    // mov [r], reg32 e mov [r], reg64
+    void salva32(const Registro& reg, const unsigned int& r) {
+      byte(0x89);
+      memoria(reg, slot(r, VALORE));
+    }
+
+    void salva64(const Registro& reg, const unsigned int& r) {
+      byte(0x48);
+      salva32(reg, r);
+    }
+
+    // mov byte [r].tag, tipo
+    void tipo(const unsigned int& r, const char& t) {
+      byte(0xC6);
+      memoria(0, slot(r, TIPO));
+      byte(static_cast<unsigned char>(t));
+    }
+
+    // operazione reg, [r] con il codice operativo op (uno o due byte)
+    void operazione(const unsigned int& op, const Registro& reg,
+        const unsigned int& r) {
+      if(op > 0xFF)
+        byte(op >> 8);
+      byte(op & 0xFF);
+      memoria(reg, slot(r, VALORE));
+    }
+
+    // scrive il risultato in eax (int) o rax (long) nel registro r
+    void risultato_int(const unsigned int& r) {
+      salva32(EAX, r);
+      tipo(r, 'I');
+    }
+
+    void risultato_long(const unsigned int& r) {
+      salva64(EAX, r);
+      tipo(r, 'J');
+      tipo(r + 1, '$');
+    }
+
+    // copia lo Slot a nello Slot d
+    void copia(const unsigned int& d, const unsigned int& a) {
+      byte(0x48); byte(0x8B); memoria(EAX, slot(a, 0));
+      byte(0x48); byte(0x8B); memoria(ECX, slot(a, 8));
+      byte(0x48); byte(0x89); memoria(EAX, slot(d, 0));
+      byte(0x48); byte(0x89); memoria(ECX, slot(d, 8));
+    }
+
+    // mov eax, indice; pop rbx; ret: torna all'interprete
+    void esci(const uint32_t& indice) {
+      byte(0xB8);
+      dword(indice);
+      ritorno();
+    }
+
+    // pop rbx; ret (esito gia` in eax)
+    void ritorno() {
+      byte(0x5B);
+      byte(0xC3);
+    }
+
+    // mov rax, funzione; call rax
+    void chiama(const void* funzione) {
+      byte(0x48);
+      byte(0xB8);
+      qword(reinterpret_cast<uint64_t>(funzione));
+      byte(0xFF);
+      byte(0xD0);
+    }
+
+    // test eax, eax; jz +2; pop rbx; ret: esce se la funzione di supporto
+    // ha restituito un errore
+    void controlla_esito() {
+      byte(0x85); byte(0xC0);
+      byte(0x74); byte(0x02);
+      ritorno();
+    }
+
+    // divisore (ecx o rcx) uguale a 0: l'interprete lancia l'eccezione
+    void controlla_divisore(const bool& lungo, const uint32_t& indice) {
+      if(lungo)
+        byte(0x48);
+      byte(0x85); byte(0xC9);
+      byte(0x75); byte(0x07);
+      esci(indice);
+    }
+
+    // salto (jmp o jcc) all'istruzione destinazione del codice a registri
+    void salto(const unsigned int& condizione, const uint32_t& destinazione) {
+      if(condizione == 0)
+        byte(0xE9);
+      else {
+        byte(0x0F);
+        byte(condizione);
+      }
+      salti.push_back(codice.size());
+      destinazioni.push_back(destinazione);
+      dword(0);
+    }
+
+};
+
+
+const uint32_t NativeCode::RESUME;
+const uint32_t NativeCode::END;
+const uint32_t NativeCode::ERROR;
+
+
+/* NativeCode() ***************************************************************/
+NativeCode::NativeCode()
+  : active(false), machine(0), registers(0), program(0), threshold(0),
+    area(0), capacity(0), used(0) {
+}
+
+
+/* ~NativeCode() **************************************************************/
+NativeCode::~NativeCode() {
+  if(area != 0)
+    munmap(area, capacity);
+}
+
+
+/* static bool available() ****************************************************/
+bool
+NativeCode::available() {
+#if defined(__x86_64__)
+  return true;
+#else
+  return false;
+#endif
+}
+
+
+/* void enable(...) ***********************************************************/
+void
+NativeCode::enable(Machine& machine, const unsigned int& threshold,
+    const size_t& capacity) {
+  const RegisterCode& code = machine.registers;
+  if(!available())
+    throw string("il compilatore JIT richiede un processore x86-64");
+  void* memoria = mmap(0, capacity, PROT_READ | PROT_WRITE,
+      MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+  if(memoria == MAP_FAILED)
+    throw string("impossibile allocare l'area del codice nativo");
+  this->area = static_cast<unsigned char*>(memoria);
+  this->capacity = capacity;
+  this->used = 0;
+  this->machine = &machine;
+  this->registers = &code;
+  this->program = &machine.program;
+  this->threshold = threshold;
+  entries.assign(code.get_size(), static_cast<const void*>(0));
+  counters.assign(code.get_size(), 0);
+  compiled.assign(code.get_functions_size(), false);
+
+  // ingresso comune: push rbx; mov rbx, rdi (Slot); jmp rsi (codice)
+  static const unsigned char ingresso[] = {0x53, 0x48, 0x89, 0xFB, 0xFF, 0xE6};
+  memcpy(area, ingresso, sizeof(ingresso));
+  used = sizeof(ingresso);
+  if(mprotect(area, capacity, PROT_READ | PROT_EXEC) != 0)
+    throw string("impossibile rendere eseguibile l'area del codice nativo");
+  active = true;
+  return;
+}
+
+
+/* void compile(const unsigned int& index) ************************************/
+void
+NativeCode::compile(const unsigned int& index) {
+  const unsigned int k = registers->find_function(index);
+  if(compiled[k])
+    return;
+  compiled[k] = true;
+  const RegisterInstruction* codice = registers->get_code();
+  const unsigned int inizio = registers->get_function_start(k);
+  const unsigned int fine = registers->get_function_end(k);
+  Emettitore e;
+  vector<size_t> etichette(fine - inizio);
+  vector<bool> nativa(fine - inizio, true);
+
+  for(unsigned int i = inizio; i < fine; ++i) {
+    const RegisterInstruction& istr = codice[i];
+    const int32_t k32 = static_cast<int32_t>(istr.value);
+    etichette[i - inizio] = e.codice.size();
+    switch(istr.opcode) {
+      case R_MOV:
+        e.copia(istr.dst, istr.a);
+        break;
+      case R_MOV_J:
+        e.copia(istr.dst, istr.a);
+        e.tipo(istr.dst + 1, '$');
+        break;
+      case R_SWAP:
+        e.byte(0x48); e.byte(0x8B); e.memoria(EAX, Emettitore::slot(istr.a, 0));
+        e.byte(0x48); e.byte(0x8B); e.memoria(ECX, Emettitore::slot(istr.a, 8));
+        e.byte(0x48); e.byte(0x8B); e.memoria(EDX, Emettitore::slot(istr.dst, 0));
+        e.byte(0x48); e.byte(0x8B); e.memoria(ESI, Emettitore::slot(istr.dst, 8));
+        e.byte(0x48); e.byte(0x89); e.memoria(EAX, Emettitore::slot(istr.dst, 0));
+        e.byte(0x48); e.byte(0x89); e.memoria(ECX, Emettitore::slot(istr.dst, 8));
+        e.byte(0x48); e.byte(0x89); e.memoria(EDX, Emettitore::slot(istr.a, 0));
+        e.byte(0x48); e.byte(0x89); e.memoria(ESI, Emettitore::slot(istr.a, 8));
+        break;
+      case R_CONST_I:
+        e.byte(0xC7);
+        e.memoria(0, Emettitore::slot(istr.dst, VALORE));
+        e.dword(static_cast<uint32_t>(k32));
+        e.tipo(istr.dst, 'I');
+        break;
+      case R_CONST_J:
+        e.byte(0x48); e.byte(0xB8);
+        e.qword(static_cast<uint64_t>(istr.value));
+        e.risultato_long(istr.dst);
+        break;
+      case R_CONST_STR:
+      case R_CONST_REF:
+        if(istr.opcode == R_CONST_STR) {
+          e.byte(0x48); e.byte(0xB8);
+          e.qword(reinterpret_cast<uint64_t>(
+                &program->get_constant(istr.index)));
+        }
+        else {
+          // xor eax, eax
+          e.byte(0x31); e.byte(0xC0);
+        }
+        e.salva64(EAX, istr.dst);
+        e.byte(0x66); e.byte(0xC7);
+        e.memoria(0, Emettitore::slot(istr.dst, RIFERIMENTO));
+        e.word(istr.opcode == R_CONST_STR ? static_cast<uint32_t>(REF_STRING)
+                                          : istr.index);
+        e.tipo(istr.dst, 'L');
+        break;
+      case R_IADD:
+      case R_ISUB:
+      case R_IMUL:
+        e.carica32(EAX, istr.a);
+        e.operazione(istr.opcode == R_IADD ? 0x03 :
+            (istr.opcode == R_ISUB ? 0x2B : 0x0FAF), EAX, istr.b);
+        e.risultato_int(istr.dst);
+        break;
+      case R_IDIV:
+      case R_IREM:
+        e.carica32(ECX, istr.b);
+        e.controlla_divisore(false, i);
+        e.carica32(EAX, istr.a);
+        e.byte(0x99);                         // cdq
+        e.byte(0xF7); e.byte(0xF9);           // idiv ecx
+        if(istr.opcode == R_IREM) {
+          e.byte(0x89); e.byte(0xD0);         // mov eax, edx
+        }
+        e.risultato_int(istr.dst);
+        break;
+      case R_ISHL:
+      case R_ISHR:
+        e.carica32(ECX, istr.b);
+        e.carica32(EAX, istr.a);
+        e.byte(0xD3); e.byte(istr.opcode == R_ISHL ? 0xE0 : 0xF8);
+        e.risultato_int(istr.dst);
+        break;
+      case R_IADD_K:
+      case R_ISUB_K:
+        e.carica32(EAX, istr.a);
+        e.byte(istr.opcode == R_IADD_K ? 0x05 : 0x2D);
+        e.dword(static_cast<uint32_t>(k32));
+        e.risultato_int(istr.dst);
+        break;
+      case R_IMUL_K:
+        e.carica32(EAX, istr.a);
+        e.byte(0x69); e.byte(0xC0);           // imul eax, eax, k
+        e.dword(static_cast<uint32_t>(k32));
+        e.risultato_int(istr.dst);
+        break;
+      case R_IDIV_K:
+      case R_IREM_K:
+      case R_ISHL_K:
+      case R_ISHR_K:
+        e.byte(0xB9);                         // mov ecx, k
+        e.dword(static_cast<uint32_t>(k32));
+        e.carica32(EAX, istr.a);
+        if(istr.opcode == R_ISHL_K || istr.opcode == R_ISHR_K) {
+          e.byte(0xD3); e.byte(istr.opcode == R_ISHL_K ? 0xE0 : 0xF8);
+        }
+        else {
+          e.byte(0x99);
+          e.byte(0xF7); e.byte(0xF9);
+          if(istr.opcode == R_IREM_K) {
+            e.byte(0x89); e.byte(0xD0);
+          }
+        }
+        e.risultato_int(istr.dst);
+        break;
+      case R_INEG:
+        e.carica32(EAX, istr.a);
+        e.byte(0xF7); e.byte(0xD8);
+        e.risultato_int(istr.dst);
+        break;
+      case R_I2C:
+      case R_I2S:
+        e.carica32(EAX, istr.a);
+        e.byte(0x0F); e.byte(istr.opcode == R_I2C ? 0xB7 : 0xBF);
+        e.byte(0xC0);
+        e.risultato_int(istr.dst);
+        break;
+      case R_I2L:
+        e.byte(0x48);                         // movsxd rax, [a]
+        e.operazione(0x63, EAX, istr.a);
+        e.risultato_long(istr.dst);
+        break;
+      case R_L2I:
+        e.carica32(EAX, istr.a);
+        e.risultato_int(istr.dst);
+        break;
+      case R_LADD:
+      case R_LSUB:
+      case R_LMUL:
+        e.carica64(EAX, istr.a);
+        e.byte(0x48);
+        e.operazione(istr.opcode == R_LADD ? 0x03 :
+            (istr.opcode == R_LSUB ? 0x2B : 0x0FAF), EAX, istr.b);
+        e.risultato_long(istr.dst);
+        break;
+      case R_LDIV:
+      case R_LREM:
+        e.carica64(ECX, istr.b);
+        e.controlla_divisore(true, i);
+        e.carica64(EAX, istr.a);
+        e.byte(0x48); e.byte(0x99);           // cqo
+        e.byte(0x48); e.byte(0xF7); e.byte(0xF9);
+        if(istr.opcode == R_LREM) {
+          e.byte(0x48); e.byte(0x89); e.byte(0xD0);
+        }
+        e.risultato_long(istr.dst);
+        break;
+      case R_LSHL:
+      case R_LSHR:
+        e.carica32(ECX, istr.b);
+        e.carica64(EAX, istr.a);
+        e.byte(0x48);
+        e.byte(0xD3); e.byte(istr.opcode == R_LSHL ? 0xE0 : 0xF8);
+        e.risultato_long(istr.dst);
+        break;
+      case R_LNEG:
+        e.carica64(EAX, istr.a);
+        e.byte(0x48); e.byte(0xF7); e.byte(0xD8);
+        e.risultato_long(istr.dst);
+        break;
+      case R_LCMP:
+        e.carica64(EAX, istr.a);
+        e.byte(0x48);
+        e.operazione(0x3B, EAX, istr.b);
+        e.byte(0x0F); e.byte(0x9F); e.byte(0xC0);   // setg al
+        e.byte(0x0F); e.byte(0x9C); e.byte(0xC1);   // setl cl
+        e.byte(0x28); e.byte(0xC8);                 // sub al, cl
+        e.byte(0x0F); e.byte(0xBE); e.byte(0xC0);   // movsx eax, al
+        e.risultato_int(istr.dst);
+        break;
+      case R_GETSTATIC_I:
+      case R_GETSTATIC_J:
+        e.byte(0x48); e.byte(0xB8);
+        e.qword(reinterpret_cast<uint64_t>(
+              machine->globals.get_value_address(istr.index)));
+        if(istr.opcode == R_GETSTATIC_J)
+          e.byte(0x48);
+        e.byte(0x8B); e.byte(0x00);           // mov eax, [rax]
+        if(istr.opcode == R_GETSTATIC_J)
+          e.risultato_long(istr.dst);
+        else
+          e.risultato_int(istr.dst);
+        break;
+      case R_PUTSTATIC_I:
+      case R_PUTSTATIC_J:
+      case R_PUTSTATIC_S:
+      case R_PUTSTATIC_C:
+        if(istr.opcode == R_PUTSTATIC_J)
+          e.carica64(ECX, istr.a);
+        else {
+          e.carica32(ECX, istr.a);
+          if(istr.opcode == R_PUTSTATIC_S) {
+            e.byte(0x0F); e.byte(0xBF); e.byte(0xC9);   // movsx ecx, cx
+          }
+          else if(istr.opcode == R_PUTSTATIC_C) {
+            e.byte(0x0F); e.byte(0xB7); e.byte(0xC9);   // movzx ecx, cx
+          }
+          if(istr.opcode != R_PUTSTATIC_C) {
+            e.byte(0x48); e.byte(0x63); e.byte(0xC9);   // movsxd rcx, ecx
+          }
+        }
+        e.byte(0x48); e.byte(0xB8);
+        e.qword(reinterpret_cast<uint64_t>(
+              machine->globals.get_value_address(istr.index)));
+        e.byte(0x48); e.byte(0x89); e.byte(0x08);       // mov [rax], rcx
+        break;
+      case R_GOTO:
+        e.salto(0, istr.index);
+        break;
+      case R_IF_ICMPEQ: case R_IF_ICMPGE: case R_IF_ICMPGT:
+      case R_IF_ICMPLE: case R_IF_ICMPLT: case R_IF_ICMPNE: {
+        static const Condizione condizioni[] = {JE, JGE, JG, JLE, JL, JNE};
+        e.carica32(EAX, istr.a);
+        e.operazione(0x3B, EAX, istr.b);
+        e.salto(condizioni[istr.opcode - R_IF_ICMPEQ], istr.index);
+        break;
+      }
+      case R_IF_ICMPEQ_K: case R_IF_ICMPGE_K: case R_IF_ICMPGT_K:
+      case R_IF_ICMPLE_K: case R_IF_ICMPLT_K: case R_IF_ICMPNE_K: {
+        static const Condizione condizioni[] = {JE, JGE, JG, JLE, JL, JNE};
+        e.byte(0x81);                         // cmp dword [a], k
+        e.memoria(7, Emettitore::slot(istr.a, VALORE));
+        e.dword(static_cast<uint32_t>(k32));
+        e.salto(condizioni[istr.opcode - R_IF_ICMPEQ_K], istr.index);
+        break;
+      }
+      case R_CALL:
+        e.byte(0xBF);                         // mov edi, indice
+        e.dword(i);
+        e.chiama(reinterpret_cast<const void*>(&nativo_chiamata));
+        e.ritorno();
+        break;
+      case R_RETURN:
+        e.chiama(reinterpret_cast<const void*>(&nativo_ritorno));
+        e.ritorno();
+        break;
+      case R_IRETURN:
+        e.carica32(EDI, istr.a);
+        e.chiama(reinterpret_cast<const void*>(&nativo_ritorno_int));
+        e.ritorno();
+        break;
+      case R_LRETURN:
+        e.carica64(EDI, istr.a);
+        e.chiama(reinterpret_cast<const void*>(&nativo_ritorno_long));
+        e.ritorno();
+        break;
+      case R_PRINT_I:
+      case R_PRINT_C:
+        e.carica32(EDI, istr.a);
+        e.chiama(istr.opcode == R_PRINT_I
+            ? reinterpret_cast<const void*>(&nativo_stampa_int)
+            : reinterpret_cast<const void*>(&nativo_stampa_char));
+        e.controlla_esito();
+        break;
+      case R_PRINT_J:
+        e.carica64(EDI, istr.a);
+        e.chiama(reinterpret_cast<const void*>(&nativo_stampa_long));
+        e.controlla_esito();
+        break;
+      case R_PRINT_CONST:
+        e.byte(0x48); e.byte(0xBF);           // mov rdi, stringa
+        e.qword(reinterpret_cast<uint64_t>(
+              &program->get_constant(istr.index)));
+        e.chiama(reinterpret_cast<const void*>(&nativo_stampa_stringa));
+        e.controlla_esito();
+        break;
+      case R_NATIVE:
+        e.byte(0xBF);                         // mov edi, indice
+        e.dword(i);
+        e.chiama(reinterpret_cast<const void*>(&nativo_metodo));
+        e.controlla_esito();
+        break;
+      default:
+        // R_ENTER, R_ISTORE, R_LSTORE, R_PRINT_STR: eseguite dall'interprete
+        e.esci(i);
+        nativa[i - inizio] = false;
+        break;
+    }
+  } // end for(unsigned int i = inizio; i < fine; ++i)
+
+  // destinazione dei salti (spostamento relativo alla fine del salto)
+  for(vector<size_t>::size_type s = 0; s < e.salti.size(); ++s) {
+    const int32_t spostamento = static_cast<int32_t>(
+        etichette[e.destinazioni[s] - inizio] - (e.salti[s] + 4));
+    memcpy(&e.codice[e.salti[s]], &spostamento, 4);
+  }
+
+  const string& nome = program->get_function(
+      registers->get_function_index(k)).name;
+  unsigned char* nativo = install(&e.codice[0], e.codice.size());
+  if(nativo == 0) {
+    report += nome + ": non compilata (area del codice nativo piena)\n";
+    return;
+  }
+  for(unsigned int i = inizio; i < fine; ++i) {
+    if(nativa[i - inizio])
+      entries[i] = nativo + etichette[i - inizio];
+  }
+  char numero[32];
+  sprintf(numero, "%u byte\n", static_cast<unsigned int>(e.codice.size()));
+  report += nome + ": " + numero;
+  return;
+} // end of method compile(const unsigned int& index)
+
+
+/* uint32_t run(Slot* slots, const void* entry) *******************************/
+uint32_t
+NativeCode::run(Slot* slots, const void* entry) {
+  typedef uint32_t (*Ingresso)(Slot*, const void*);
+  // le funzioni di supporto usano la macchina di questo codice nativo
+  macchina_nativa = machine;
+  uint32_t esito = reinterpret_cast<Ingresso>(area)(slots, entry);
+  if(esito == ERROR && eccezione_nativa) {
+    std::exception_ptr eccezione = eccezione_nativa;
+    eccezione_nativa = std::exception_ptr();
+    std::rethrow_exception(eccezione);
+  }
+  if(esito == ERROR)
+    throw errore_nativo;
+  return esito;
+}
+
+
+/* string get_report() const **************************************************/
+string
+NativeCode::get_report() const {
+  return report;
+}
+
+
+/* unsigned char* install(const unsigned char* code, const size_t& size) ******/
+unsigned char*
+NativeCode::install(const unsigned char* code, const size_t& size) {
+  const size_t inizio = (used + 15) & ~static_cast<size_t>(15);
+  if(inizio + size > capacity)
+    return 0;
+  // l'area e` scrivibile solo durante la copia
+  if(mprotect(area, capacity, PROT_READ | PROT_WRITE) != 0)
+    return 0;
+  memcpy(area + inizio, code, size);
+  used = inizio + size;
+  if(mprotect(area, capacity, PROT_READ | PROT_EXEC) != 0)
+    throw string("impossibile rendere eseguibile l'area del codice nativo");
+  return area + inizio;
+}
+
+
+#endif // NATIVECODE_CC_INCLUSION_GUARD
@@ -0,0 +1,191 @@
+/*!
+  \file NativeCode.h
+  \brief Interfaccia di NativeCode
+  \author Andrea Zanelli
+  \date 17-10-2026
+*/
+
+#ifndef NATIVECODE_H_INCLUSION_GUARD
+#define NATIVECODE_H_INCLUSION_GUARD
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+#include "ProgramArea.h"
+#include "RegisterCode.h"
+#include "Slot.h"
+
+using std::string;
+using std::vector;
+
+class Machine;
+
+
+/*!
+  \class NativeCode
+  \brief Compilatore a modelli (JIT) del codice a registri in codice x86-64
+
+  Traduce in codice macchina x86-64 il codice a registri (vedi RegisterCode)
+  delle funzioni "calde": ogni istruzione a registri diventa una sequenza
+  fissa di istruzioni macchina (un modello) che legge e scrive direttamente
+  gli Slot del RdA, con l'indirizzo del primo Slot nel registro rbx. Il
+  codice viene scritto in un'area di memoria ottenuta con mmap(), resa
+  eseguibile (e non piu` scrivibile) dopo ogni compilazione.\\
+  Tutto lo stato resta negli Slot del RdA, percio` l'esecuzione puo` passare
+  tra il codice nativo e esecutore_a_registri() all'inizio di qualsiasi
+  istruzione: le istruzioni senza modello (i controlli di istore e lstore e
+  la stampa di stringhe lette) e i casi che devono lanciare un'eccezione
+  (divisione per 0) escono dal codice nativo restituendo l'indice
+  dell'istruzione, che viene eseguita dall'interprete. Le chiamate, i
+  ritorni e le stampe chiamano funzioni di supporto in C++, che non lasciano
+  passare eccezioni attraverso il codice nativo.\\
+  Le funzioni vengono compilate quando un contatore raggiunge la soglia:
+  esecutore_a_registri() conta le chiamate (all'istruzione R_ENTER) e i
+  salti all'indietro (sull'istruzione destinazione). Il compilatore e`
+  disponibile solo su x86-64 (vedi available()).
+*/
+class NativeCode {
+
+  public:
+    /* METODI PUBBLICI */
+
+    //! esito di run(): il RdA in cima allo stack e` cambiato (chiamata o
+    //! ritorno), l'esecuzione riprende dal suo PC
+    static const uint32_t RESUME = 0xFFFFFFFFu;
+    //! esito di run(): lo stack di sistema e` vuoto
+    static const uint32_t END = 0xFFFFFFFEu;
+    //! esito interno: errore in una funzione di supporto (run() lancia
+    //! l'eccezione)
+    static const uint32_t ERROR = 0xFFFFFFFDu;
+
+    /**
+     * Costruttore di default: compilatore non attivo.
+     */
+    NativeCode();
+
+    /**
+     * Distruttore: libera l'area del codice nativo.
+     */
+    ~NativeCode();
+
+    /**
+     * Restituisce true se il compilatore e` disponibile su questa
+     * architettura.
+     */
+    static bool available();
+
+    /**
+     * Attiva il compilatore per il codice a registri del programma della
+     * macchina astratta <tt>machine</tt> (gia` tradotto con
+     * RegisterCode::compile()): le funzioni vengono compilate quando un
+     * contatore supera <tt>threshold</tt>. L'area del codice nativo e` di
+     * <tt>capacity</tt> byte. In caso di errore lancia un'eccezione di tipo
+     * std::string con la descrizione dell'errore.
+     */
+    void enable(Machine& machine, const unsigned int& threshold,
+        const size_t& capacity);
+
+    /**
+     * Restituisce true se il compilatore e` attivo.
+     */
+    inline
+    bool enabled() const {
+      return active;
+    }
+
+    /**
+     * Restituisce l'indirizzo del codice nativo dell'istruzione
+     * <tt>index</tt> del codice a registri, oppure 0 se l'istruzione non e`
+     * stata compilata.
+     */
+    inline
+    const void* get_entry(const unsigned int& index) const {
+      return entries[index];
+    }
+
+    /**
+     * Incrementa il contatore dell'istruzione <tt>index</tt> del codice a
+     * registri; restituisce true se ha raggiunto la soglia.
+     */
+    inline
+    bool count(const unsigned int& index) {
+      if(counters[index] < threshold) {
+        ++counters[index];
+        return false;
+      }
+      return true;
+    }
+
+    /**
+     * Compila, se non e` gia` stata compilata, la funzione a cui appartiene
+     * l'istruzione <tt>index</tt> del codice a registri.
+     */
+    void compile(const unsigned int& index);
+
+    /**
+     * Esegue il codice nativo da <tt>entry</tt> (ottenuto con get_entry())
+     * sul RdA con il primo Slot <tt>slots</tt>. Restituisce l'indice
+     * dell'istruzione del codice a registri da cui l'interprete deve
+     * proseguire nello stesso RdA, oppure RESUME o END. Se una funzione di
+     * supporto ha incontrato un errore lancia un'eccezione di tipo
+     * std::string con la descrizione dell'errore.
+     */
+    uint32_t run(Slot* slots, const void* entry);
+
+    /**
+     * Restituisce le funzioni compilate, una riga per funzione nella forma
+     * "nome(argomenti)ritorno: N byte".
+     */
+    string get_report() const;
+
+  private:
+    /* VARIABILI PRIVATE */
+
+    //! true se il compilatore e` attivo
+    bool active;
+
+    //! macchina astratta (con le variabili globali e lo stack di sistema
+    //! usati dal codice nativo), suo codice a registri e programma
+    Machine* machine;
+    const RegisterCode* registers;
+    const ProgramArea* program;
+
+    //! soglia dei contatori
+    unsigned int threshold;
+
+    //! area del codice nativo, sua dimensione e byte occupati
+    unsigned char* area;
+    size_t capacity;
+    size_t used;
+
+    //! per ogni istruzione del codice a registri: indirizzo del codice
+    //! nativo e contatore
+    vector<const void*> entries;
+    vector<unsigned int> counters;
+
+    //! per ogni funzione tradotta: true se e` gia` stata compilata (o se la
+    //! compilazione non e` riuscita)
+    vector<bool> compiled;
+
+    //! funzioni compilate, una riga per funzione
+    string report;
+
+    /* METODI PRIVATI */
+
+    // il codice nativo non puo` essere copiato
+    NativeCode(const NativeCode&);
+    NativeCode& operator=(const NativeCode&);
+
+    /**
+     * Copia nell'area del codice nativo <tt>size</tt> byte da
+     * <tt>code</tt>; restituisce l'indirizzo della copia, oppure 0 se
+     * l'area e` piena.
+     */
+    unsigned char* install(const unsigned char* code, const size_t& size);
+
+};
+
+
+#endif // NATIVECODE_H_INCLUSION_GUARD
@@ -0,0 +1,525 @@
+/*!
+  \file NativeMethod.cc
+  \brief Tabella dei metodi nativi e metodi di libreria predefiniti
+  \author Andrea Zanelli
+  \date 17-10-2026
+*/
+
+#ifndef NATIVEMETHOD_CC_INCLUSION_GUARD
+#define NATIVEMETHOD_CC_INCLUSION_GUARD
+
+#include <ctype.h>
+#include <stdlib.h>
+#include <algorithm>
+#include <mutex>
+#include <string>
+
+#include "Machine.h"
+#include "NativeMethod.h"
+#include "Slot.h"
+#include "Verifier.h"
+
+using std::string;
+
+extern void libera_stringa(Machine& m, string* str);
+
+
+const NativeMethod* native_method_table = 0;
+
+// la tabella e` condivisa da tutte le macchine astratte del processo, che
+// possono caricare programmi contemporaneamente in thread diversi; durante
+// l'esecuzione viene solo letta, senza il mutex: i metodi non vengono mai
+// spostati ne` tolti
+static std::mutex mutex_metodi;
+
+// numero di metodi nella tabella
+static uint32_t numero_metodi = 0;
+
+
+/**
+ * Metodo sconosciuto (INTR_NESSUNO): non fa nulla.
+ */
+static void nessuno(Machine&) {
+  return;
+}
+
+
+/**
+ * Stampa l'elemento di tipo int sullo stack degli operandi
+ * (<tt>java/io/PrintStream/print(I)V</tt>).
+ */
+template<bool CONTROLLI>
+void stampa_int(Machine& m) {
+  // Se sullo stack degli operandi non c'e` un int, "m.stack"
+  // lancia un'eccezione
+  int32_t print_value = m.stack.op_stack_top_int<CONTROLLI>();
+  m.stack.op_stack_pop<CONTROLLI>();
+
+  // Se non c'e` un riferimento in cima allo stack degli operandi,
+  // "m.stack" lancia un'eccezione
+  if(CONTROLLI &&
+      m.stack.op_stack_top_ref_type_id() != REF_PRINTSTREAM) {
+    throw string("si ci aspettava un oggetto di tipo java/io/PrintStream "
+          + string("sullo stack degli operandi") );
+  }
+  m.stack.op_stack_pop<CONTROLLI>();
+
+  // stampa il valore
+  m.output.put_int(print_value);
+  return;
+}
+
+
+/**
+ * Stampa l'elemento di tipo int sullo stack degli operandi convertendolo
+ * in un carattere (<tt>java/io/PrintStream/print(C)V</tt>).
+ */
+template<bool CONTROLLI>
+void stampa_char(Machine& m) {
+  // Se sullo stack degli operandi non c'e` un int, "m.stack"
+  // lancia un'eccezione
+  int32_t print_value = m.stack.op_stack_top_int<CONTROLLI>();
+  m.stack.op_stack_pop<CONTROLLI>();
+
+  // Se non c'e` un riferimento in cima allo stack degli operandi,
+  // "m.stack" lancia un'eccezione
+  if(CONTROLLI &&
+      m.stack.op_stack_top_ref_type_id() != REF_PRINTSTREAM) {
+    throw string("si ci aspettava un oggetto di tipo java/io/PrintStream "
+          + string("sullo stack degli operandi") );
+  }
+  m.stack.op_stack_pop<CONTROLLI>();
+
+  // stampa il valore
+  m.output.put_char(static_cast<char>(print_value));
+  return;
+}
+
+
+/**
+ * Stampa l'elemento di tipo long sullo stack degli operandi
+ * (<tt>java/io/PrintStream/print(J)V</tt>).
+ */
+template<bool CONTROLLI>
+void stampa_long(Machine& m) {
+  // Se sullo stack degli operandi non c'e` un long, "m.stack"
+  // lancia un'eccezione
+  int64_t print_value = m.stack.op_stack_top_long<CONTROLLI>();
+  m.stack.op_stack_pop2<CONTROLLI>();
+
+  // Se non c'e` un riferimento in cima allo stack degli operandi,
+  // "m.stack" lancia un'eccezione
+  if(CONTROLLI &&
+      m.stack.op_stack_top_ref_type_id() != REF_PRINTSTREAM) {
+    throw string("si ci aspettava un oggetto di tipo java/io/PrintStream "
+          + string("sullo stack degli operandi") );
+  }
+  m.stack.op_stack_pop<CONTROLLI>();
+
+  // stampa il valore
+  m.output.put_long(print_value);
+  return;
+}
+
+
+/**
+ * Stampa l'elemento di tipo string sullo stack degli operandi
+ * (<tt>java/io/PrintStream/print(Ljava/lang/String;)V</tt>).
+ */
+template<bool CONTROLLI>
+void stampa_stringa(Machine& m) {
+  // Se non c'e` un riferimento in cima allo stack degli operandi,
+  // "m.stack" lancia un'eccezione
+  if(CONTROLLI &&
+      m.stack.op_stack_top_ref_type_id() != REF_STRING) {
+    throw string("si ci aspettava un oggetto di tipo java/lang/String "
+          + string("sullo stack degli operandi") );
+  }
+  string* print_str;
+  print_str = static_cast<string*>(
+      m.stack.op_stack_top_ref<CONTROLLI>());
+  m.stack.op_stack_pop<CONTROLLI>();
+
+  // Se non c'e` un riferimento in cima allo stack degli operandi,
+  // "m.stack" lancia un'eccezione
+  if(CONTROLLI &&
+      m.stack.op_stack_top_ref_type_id() != REF_PRINTSTREAM) {
+    // errore sullo stack degli operandi
+    throw string("si ci aspettava un oggetto di tipo java/io/PrintStream "
+          + string("sullo stack degli operandi") );
+  }
+  m.stack.op_stack_pop<CONTROLLI>();
+
+  // stampa la stringa
+  m.output.put_string(*print_str);
+  libera_stringa(m, print_str);
+  return;
+}
+
+
+/**
+ * Legge un carattere (<tt>java/io/BufferedReader/read()I</tt>): sullo stack
+ * degli operandi ci dev'essere il "finto" riferimento al BufferedReader, che
+ * viene sostituito dal carattere letto; il resto della riga viene scartato.
+ */
+template<bool CONTROLLI>
+void leggi_carattere(Machine& m) {
+  // nota: se non c'e` un riferimento in cima allo stack degli operandi,
+  // "m.stack" lancia un'eccezione
+  if(CONTROLLI &&
+      m.stack.op_stack_top_ref_type_id() != REF_BUFFEREDREADER) {
+    throw string("si ci aspettava un oggetto di tipo java/io/BufferedReader "
+        + string("sullo stack degli operandi") );
+  }
+  m.stack.op_stack_pop<CONTROLLI>();
+  // legge un carattere e lo mette sullo stack, dopo aver stampato quanto
+  // e` nel buffer di uscita (ad esempio la richiesta all'utente)
+  m.output.flush();
+  char c;
+  c = m.input->get();
+  if(c != '\n') {
+    char t = m.input->get();
+    while(t != '\n')
+      t = m.input->get();
+  }
+  m.stack.op_stack_push_int<CONTROLLI>(static_cast<int32_t>(c));
+  return;
+}
+
+
+/**
+ * Legge una riga
+ * (<tt>java/io/BufferedReader/readLine()Ljava/lang/String;</tt>, usata
+ * anche per int e long): sullo stack degli operandi ci dev'essere il
+ * "finto" riferimento al BufferedReader, che viene sostituito dalla stringa
+ * letta.
+ */
+template<bool CONTROLLI>
+void leggi_riga(Machine& m) {
+  // nota: se non c'e` un riferimento in cima allo stack degli operandi,
+  // "m.stack" lancia un'eccezione
+  if(CONTROLLI &&
+      m.stack.op_stack_top_ref_type_id() != REF_BUFFEREDREADER) {
+    throw string("si ci aspettava un oggetto di tipo java/io/BufferedReader "
+        + string("sullo stack degli operandi") );
+  }
+  m.stack.op_stack_pop<CONTROLLI>();
+  // legge una stringa e la mette sullo stack, dopo aver stampato quanto
+  // e` nel buffer di uscita
+  m.output.flush();
+  string* str = new string("");
+  std::getline(*m.input, *str);
+  m.stack.op_stack_push_ref<CONTROLLI>(REF_STRING,str);
+  return;
+}
+
+
+/**
+ * Converte la stringa in cima allo stack degli operandi in un int
+ * (<tt>java/lang/Integer/parseInt(Ljava/lang/String;)I</tt>); se la stringa
+ * non contiene un numero il risultato e` 0.
+ */
+template<bool CONTROLLI>
+void converti_int(Machine& m) {
+  // nota: se non c'e` un riferimento in cima allo stack degli operandi,
+  // "m.stack" lancia un'eccezione
+  if(CONTROLLI &&
+      m.stack.op_stack_top_ref_type_id() != REF_STRING) {
+    throw string("si ci aspettava un oggetto di tipo java/lang/String " +
+        string("sullo stack degli operandi") );
+  }
+  string* str = static_cast<string*>(
+      m.stack.op_stack_top_ref<CONTROLLI>());
+  m.stack.op_stack_pop<CONTROLLI>();
+  m.stack.op_stack_push_int<CONTROLLI>( atol(str->c_str()) );
+  libera_stringa(m, str);
+  return;
+}
+
+
+/**
+ * Converte la stringa in cima allo stack degli operandi in un long
+ * (<tt>java/lang/Long/parseLong(Ljava/lang/String;)J</tt>); se la stringa
+ * non contiene un numero il risultato e` 0.
+ */
+template<bool CONTROLLI>
+void converti_long(Machine& m) {
+  // nota: se non c'e` un riferimento in cima allo stack degli operandi,
+  // "m.stack" lancia un'eccezione
+  if(CONTROLLI &&
+      m.stack.op_stack_top_ref_type_id() != REF_STRING) {
+    throw string("si ci aspettava un oggetto di tipo java/lang/String " +
+        string("sullo stack degli operandi") );
+  }
+  string* str = static_cast<string*>(
+      m.stack.op_stack_top_ref<CONTROLLI>());
+  m.stack.op_stack_pop<CONTROLLI>();
+  m.stack.op_stack_push_long<CONTROLLI>( atoll(str->c_str()) );
+  libera_stringa(m, str);
+  return;
+}
+
+
+/**
+ * Finge di costruire un InputStreamReader
+ * (<tt>java/io/InputStreamReader/\<init\>(Ljava/io/InputStream;)V</tt>):
+ * toglie dallo stack degli operandi il riferimento (finto) all'InputStream
+ * <em>in</em> e quello all'InputStreamReader creato con <em>new</em>.
+ */
+template<bool CONTROLLI>
+void costruisci_inputstreamreader(Machine& m) {
+  // nota: se non c'e` un riferimento in cima allo stack degli operandi,
+  // "m.stack" lancia un'eccezione
+  if(CONTROLLI &&
+      m.stack.op_stack_top_ref_type_id() != REF_INPUTSTREAM) {
+    throw string("si ci aspettava un oggetto di tipo java/io/InputStream "
+        + string("sullo stack degli operandi") );
+  }
+  m.stack.op_stack_pop<CONTROLLI>();
+  if(CONTROLLI &&
+      m.stack.op_stack_top_ref_type_id() != REF_INPUTSTREAMREADER) {
+    throw string("si ci aspettava un oggetto di tipo " +
+        string("java/io/InputStreamReader sullo stack degli operandi") );
+  }
+  m.stack.op_stack_pop<CONTROLLI>();
+  // oggetto InputStreamReader costruito
+  return;
+}
+
+
+/**
+ * Finge di costruire un BufferedReader
+ * (<tt>java/io/BufferedReader/\<init\>(Ljava/io/Reader;)V</tt>): toglie
+ * dallo stack degli operandi il riferimento (finto) all'InputStreamReader
+ * appena "costruito" e quello al BufferedReader creato con <em>new</em>, di
+ * cui verranno poi chiamati i metodi di lettura.
+ */
+template<bool CONTROLLI>
+void costruisci_bufferedreader(Machine& m) {
+  // nota: se non c'e` un riferimento in cima allo stack degli operandi,
+  // "m.stack" lancia un'eccezione
+  if(CONTROLLI &&
+      m.stack.op_stack_top_ref_type_id() != REF_INPUTSTREAMREADER) {
+    throw string("si ci aspettava un oggetto di tipo " +
+        string("java/io/InputStreamReader sullo stack degli operandi") );
+  }
+  m.stack.op_stack_pop<CONTROLLI>();
+  if(CONTROLLI &&
+      m.stack.op_stack_top_ref_type_id() != REF_BUFFEREDREADER) {
+    throw string("si ci aspettava un oggetto di tipo java/io/BufferedReader "
+        + string("sullo stack degli operandi") );
+  }
+  m.stack.op_stack_pop<CONTROLLI>();
+  // oggetto BufferedReader costruito
+  return;
+}
+
+
+/**
+ * Aggiunge in fondo a <tt>tipi</tt> i tipi dello stack degli operandi
+ * (convenzione di Verifier::Type) del tipo <tt>descrittore</tt> del
+ * descrittore di un metodo, a partire da <tt>pos</tt>, e porta
+ * <tt>pos</tt> dopo il tipo. Restituisce false se il tipo non e` valido.
+ */
+static bool aggiungi_tipo(const string& descrittore, string::size_type& pos,
+    vector<uint16_t>& tipi) {
+  const char c = descrittore[pos];
+  if(c == 'I' || c == 'S' || c == 'C' || c == 'B' || c == 'Z') {
+    tipi.push_back('I');
+    ++pos;
+  }
+  else if(c == 'J') {
+    tipi.push_back('J');
+    tipi.push_back('$');
+    ++pos;
+  }
+  else if(c == 'L') {
+    const string::size_type fine = descrittore.find(';', pos);
+    if(fine == string::npos)
+      return false;
+    tipi.push_back(static_cast<uint16_t>(Verifier::REF +
+          ref_type_id(descrittore.substr(pos, fine + 1 - pos))));
+    pos = fine + 1;
+  }
+  else
+    return false;
+  return true;
+}
+
+
+/**
+ * Aggiunge in fondo alla tabella il metodo <tt>metodo</tt> e ne restituisce
+ * l'indice; va chiamata con il mutex.
+ */
+static uint32_t aggiungi_metodo(NativeMethod* tabella,
+    const NativeMethod& metodo) {
+  if(numero_metodi >= MAX_NATIVE_METHODS)
+    throw string("troppi metodi nativi");
+  tabella[numero_metodi] = metodo;
+  return numero_metodi++;
+}
+
+
+/**
+ * Aggiunge alla tabella un metodo predefinito; va chiamata con il mutex.
+ */
+static void predefinito(NativeMethod* tabella, const char* nome,
+    const bool& statico, NativeFunction function, NativeFunction checked,
+    const uint16_t* argomenti, const unsigned int& n_argomenti,
+    const uint16_t* risultato, const unsigned int& n_risultato) {
+  NativeMethod metodo;
+  metodo.name = nome;
+  metodo.is_static = statico;
+  metodo.arguments.assign(argomenti, argomenti + n_argomenti);
+  metodo.result.assign(risultato, risultato + n_risultato);
+  metodo.function = function;
+  metodo.checked = checked;
+  aggiungi_metodo(tabella, metodo);
+  return;
+}
+
+
+/**
+ * Restituisce la tabella dei metodi, con i metodi predefiniti di Intrinsic
+ * nello stesso ordine; va chiamata con il mutex.
+ */
+static NativeMethod* metodi_nativi() {
+  static NativeMethod tabella[MAX_NATIVE_METHODS];
+  if(numero_metodi > 0)
+    return tabella;
+  const uint16_t R = Verifier::REF;
+  const uint16_t printstream_int[] = { R + REF_PRINTSTREAM, 'I' };
+  const uint16_t printstream_long[] = { R + REF_PRINTSTREAM, 'J', '$' };
+  const uint16_t printstream_string[] = { R + REF_PRINTSTREAM,
+    R + REF_STRING };
+  const uint16_t bufferedreader[] = { R + REF_BUFFEREDREADER };
+  const uint16_t stringa[] = { R + REF_STRING };
+  const uint16_t intero[] = { 'I' };
+  const uint16_t lungo[] = { 'J', '$' };
+  const uint16_t inputstreamreader[] = { R + REF_INPUTSTREAMREADER,
+    R + REF_INPUTSTREAM };
+  const uint16_t bufferedreader_reader[] = { R + REF_BUFFEREDREADER,
+    R + REF_INPUTSTREAMREADER };
+  predefinito(tabella, "", false, nessuno, nessuno, 0, 0, 0, 0);
+  predefinito(tabella, "java/io/PrintStream/print(I)V", false,
+      stampa_int<false>, stampa_int<true>, printstream_int, 2, 0, 0);
+  predefinito(tabella, "java/io/PrintStream/print(C)V", false,
+      stampa_char<false>, stampa_char<true>, printstream_int, 2, 0, 0);
+  predefinito(tabella, "java/io/PrintStream/print(J)V", false,
+      stampa_long<false>, stampa_long<true>, printstream_long, 3, 0, 0);
+  predefinito(tabella, "java/io/PrintStream/print(Ljava/lang/String;)V",
+      false, stampa_stringa<false>, stampa_stringa<true>, printstream_string,
+      2, 0, 0);
+  predefinito(tabella, "java/io/BufferedReader/read()I", false,
+      leggi_carattere<false>, leggi_carattere<true>, bufferedreader, 1,
+      intero, 1);
+  predefinito(tabella, "java/io/BufferedReader/readLine()Ljava/lang/String;",
+      false, leggi_riga<false>, leggi_riga<true>, bufferedreader, 1,
+      stringa, 1);
+  predefinito(tabella, "java/lang/Integer/parseInt(Ljava/lang/String;)I",
+      true, converti_int<false>, converti_int<true>, stringa, 1, intero, 1);
+  predefinito(tabella, "java/lang/Long/parseLong(Ljava/lang/String;)J",
+      true, converti_long<false>, converti_long<true>, stringa, 1, lungo, 2);
+  predefinito(tabella,
+      "java/io/InputStreamReader/<init>(Ljava/io/InputStream;)V", false,
+      costruisci_inputstreamreader<false>, costruisci_inputstreamreader<true>,
+      inputstreamreader, 2, 0, 0);
+  predefinito(tabella, "java/io/BufferedReader/<init>(Ljava/io/Reader;)V",
+      false, costruisci_bufferedreader<false>,
+      costruisci_bufferedreader<true>, bufferedreader_reader, 2, 0, 0);
+  native_method_table = tabella;
+  return tabella;
+}
+
+
+/**
+ * Restituisce l'indice del metodo <tt>name</tt> con <tt>is_static</tt>, o
+ * INTR_NESSUNO; va chiamata con il mutex.
+ */
+static uint32_t cerca_metodo(const NativeMethod* tabella, const string& name,
+    const bool& is_static) {
+  for(uint32_t i = INTR_NESSUNO + 1; i < numero_metodi; ++i) {
+    if(tabella[i].is_static == is_static && tabella[i].name == name)
+      return i;
+  }
+  return INTR_NESSUNO;
+}
+
+
+/* uint32_t find_native_method(const string& name, const bool& is_static) *****/
+uint32_t
+find_native_method(const string& name, const bool& is_static) {
+  std::lock_guard<std::mutex> blocco(mutex_metodi);
+  return cerca_metodo(metodi_nativi(), name, is_static);
+}
+
+
+/* uint32_t register_native_method(string name, ...) **************************/
+uint32_t
+register_native_method(string name, NativeFunction function,
+    const bool& is_static) {
+  name.erase(std::remove_if(name.begin(), name.end(), ::isspace),
+      name.end());
+  NativeMethod metodo;
+  metodo.name = name;
+  metodo.is_static = is_static;
+  metodo.function = function;
+  // "classe/metodo(argomenti)ritorno"
+  const string::size_type aperta = name.find('(');
+  const string::size_type chiusa = name.find(')');
+  const string::size_type barra = name.rfind('/', aperta);
+  bool valido = function != 0 && aperta != string::npos &&
+    chiusa != string::npos && aperta < chiusa && barra != string::npos &&
+    barra > 0 && barra + 1 < aperta && chiusa + 1 < name.size();
+  if(valido && !is_static)
+    metodo.arguments.push_back(static_cast<uint16_t>(Verifier::REF +
+          ref_type_id("L" + name.substr(0, barra) + ";")));
+  string::size_type pos = aperta + 1;
+  while(valido && pos < chiusa)
+    valido = aggiungi_tipo(name, pos, metodo.arguments);
+  pos = chiusa + 1;
+  if(valido && name[pos] != 'V')
+    valido = aggiungi_tipo(name, pos, metodo.result);
+  else
+    ++pos;
+  if(!valido || pos != name.size())
+    throw string("nome del metodo nativo non valido: " + name);
+  std::lock_guard<std::mutex> blocco(mutex_metodi);
+  NativeMethod* tabella = metodi_nativi();
+  if(cerca_metodo(tabella, name, is_static) != INTR_NESSUNO)
+    throw string("metodo nativo gia` registrato: " + name);
+  return aggiungi_metodo(tabella, metodo);
+}
+
+
+/* uint32_t native_methods_size() *********************************************/
+uint32_t
+native_methods_size() {
+  std::lock_guard<std::mutex> blocco(mutex_metodi);
+  metodi_nativi();
+  return numero_metodi;
+}
+
+
+/* void check_native_stack(SystemStack& stack, const NativeMethod& method) ****/
+void
+check_native_stack(SystemStack& stack, const NativeMethod& method) {
+  const vector<uint16_t>& tipi = method.arguments;
+  bool validi = stack.op_stack_size() >= tipi.size();
+  for(vector<uint16_t>::size_type k = 0; validi && k < tipi.size(); ++k) {
+    const Slot& slot = stack.op_stack_peek(
+        static_cast<unsigned int>(tipi.size() - 1 - k));
+    if(tipi[k] >= Verifier::REF)
+      validi = slot.tag == 'L' && slot.ref_type == tipi[k] - Verifier::REF;
+    else
+      validi = slot.tag == static_cast<char>(tipi[k]);
+  }
+  if(!validi)
+    throw string("tipi sullo stack degli operandi non validi per il "
+        "metodo nativo " + method.name);
+  stack.op_stack_reserve(static_cast<unsigned int>(method.result.size()));
+  return;
+}
+
+
+#endif // NATIVEMETHOD_CC_INCLUSION_GUARD
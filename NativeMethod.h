@@ -0,0 +1,127 @@
+/*!
+  \file NativeMethod.h
+  \brief Tabella dei metodi nativi
+  \author Andrea Zanelli
+  \date 17-10-2026
+*/
+
+#ifndef NATIVEMETHOD_H_INCLUSION_GUARD
+#define NATIVEMETHOD_H_INCLUSION_GUARD
+
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+using std::string;
+using std::vector;
+
+class Machine;
+class SystemStack;
+
+
+/*!
+  \typedef NativeFunction
+  \brief Funzione che esegue un metodo nativo
+
+  Prende i parametri (e l'oggetto, per i metodi non statici) dalla cima
+  dello stack degli operandi di <tt>m.stack</tt> e vi mette il valore
+  restituito, secondo i tipi dichiarati nel NativeMethod. In caso di errore
+  lancia un'eccezione di tipo std::string con la descrizione dell'errore.
+*/
+typedef void (*NativeFunction)(Machine& m);
+
+
+/*!
+  \struct NativeMethod
+  \brief Metodo di libreria eseguito da una funzione C++
+
+  I metodi che il programma chiama con <tt>invokestatic</tt>,
+  <tt>invokevirtual</tt> e <tt>invokespecial</tt> e che non sono funzioni
+  del programma (la stampa e la lettura della libreria Java, o i metodi
+  registrati con register_native_method()) sono cercati per nome nella
+  tabella dei metodi nativi durante il collegamento: l'istruzione contiene
+  l'indice del metodo (vedi Instruction), percio` durante l'esecuzione la
+  chiamata e` una sola chiamata indiretta a <tt>function</tt>, senza
+  confrontare nessuna stringa.\\
+  I tipi presi e messi sullo stack degli operandi sono dichiarati con la
+  convenzione di Verifier::Type ('I', 'J' seguito da '$', oppure
+  Verifier::REF piu` l'indice del tipo di riferimento): la verifica li
+  controlla al caricamento, cosi` che <tt>function</tt> possa usare lo stack
+  senza controlli (e senza ingrandirlo, perche` lo spazio e` gia` stato
+  riservato). Nelle funzioni non verificate l'esecutore usa
+  <tt>checked</tt>, se c'e`, altrimenti controlla i tipi dichiarati prima di
+  chiamare <tt>function</tt> (vedi check_native_stack()).
+*/
+struct NativeMethod {
+  string name;                //!< "classe/metodo(argomenti)ritorno", senza
+                              //!< spazi
+  bool is_static;             //!< true se chiamato da invokestatic, false
+                              //!< da invokevirtual e invokespecial
+  vector<uint16_t> arguments; //!< tipi presi dallo stack degli operandi,
+                              //!< dal piu` profondo alla cima (compreso
+                              //!< l'oggetto dei metodi non statici)
+  vector<uint16_t> result;    //!< tipi messi sullo stack degli operandi
+  NativeFunction function;    //!< esecuzione con i tipi gia` controllati
+  NativeFunction checked;     //!< esecuzione con i controlli sui tipi (o 0)
+  NativeMethod() : is_static(false), function(0), checked(0) {}
+};
+
+
+//! numero massimo di metodi nativi nella tabella
+static const uint32_t MAX_NATIVE_METHODS = 1024;
+
+//! tabella dei metodi nativi: i primi sono quelli di Intrinsic, nello stesso
+//! ordine (vedi native_method())
+extern const NativeMethod* native_method_table;
+
+
+/**
+ * Restituisce il metodo nativo con indice <tt>id</tt>, ottenuto da
+ * find_native_method() o da register_native_method().
+ */
+inline
+const NativeMethod& native_method(const uint32_t& id) {
+  return native_method_table[id];
+}
+
+/**
+ * Restituisce l'indice del metodo nativo <tt>name</tt> (senza spazi)
+ * chiamato da <tt>invokestatic</tt> se <tt>is_static</tt>, altrimenti da
+ * <tt>invokevirtual</tt> o <tt>invokespecial</tt>; se il metodo non esiste
+ * restituisce INTR_NESSUNO, un metodo che viene ignorato.
+ */
+uint32_t find_native_method(const string& name, const bool& is_static);
+
+/**
+ * Aggiunge alla tabella il metodo nativo <tt>name</tt> (nella forma
+ * "classe/metodo(argomenti)ritorno", ad esempio "util/Math/isqrt(I)I"),
+ * eseguito da <tt>function</tt>, e ne restituisce l'indice. Se
+ * <tt>is_static</tt> il metodo e` chiamato da <tt>invokestatic</tt>,
+ * altrimenti da <tt>invokevirtual</tt> e <tt>invokespecial</tt>, con sotto
+ * i parametri un riferimento ad un oggetto della classe. I tipi sullo stack
+ * degli operandi sono quelli del descrittore: int, short, char, byte e
+ * boolean occupano uno Slot di tipo 'I', long due Slot, gli oggetti un
+ * riferimento del loro tipo. Il metodo dev'essere registrato prima di
+ * caricare i programmi che lo usano (gli altri lo ignorano) e resta nella
+ * tabella, condivisa da tutte le macchine del processo, fino alla fine del
+ * processo. Se il nome non e` valido o il metodo esiste gia` lancia
+ * un'eccezione di tipo std::string con la descrizione dell'errore.
+ */
+uint32_t register_native_method(string name, NativeFunction function,
+    const bool& is_static = true);
+
+/**
+ * Restituisce il numero di metodi nativi nella tabella.
+ */
+uint32_t native_methods_size();
+
+/**
+ * Controlla che in cima allo stack degli operandi di <tt>stack</tt> ci siano
+ * i tipi presi dal metodo <tt>method</tt> e riserva lo spazio per quelli che
+ * mette; se i tipi sono diversi lancia un'eccezione di tipo std::string con
+ * la descrizione dell'errore.
+ */
+void check_native_stack(SystemStack& stack, const NativeMethod& method);
+
+
+#endif // NATIVEMETHOD_H_INCLUSION_GUARD
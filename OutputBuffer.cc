@@ -0,0 +1,148 @@
+/*!
+  \file OutputBuffer.cc
+  \brief Implementazione di OutputBuffer
+  \author Andrea Zanelli
+  \date 17-10-2026
+*/
+
+#ifndef OUTPUTBUFFER_CC_INCLUSION_GUARD
+#define OUTPUTBUFFER_CC_INCLUSION_GUARD
+
+#include <errno.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+#include "OutputBuffer.h"
+
+
+// definizione della costante (passata per riferimento)
+const unsigned int OutputBuffer::DEFAULT_SIZE;
+
+/* OutputBuffer(const unsigned int& size) *************************************/
+OutputBuffer::OutputBuffer(const unsigned int& size)
+  : data(0), used(0), capacity(0) {
+  set_size(size);
+}
+
+
+/* ~OutputBuffer() ************************************************************/
+OutputBuffer::~OutputBuffer() {
+  try {
+    flush();
+  }
+  catch(...) {
+    // l'errore di scrittura non puo` essere segnalato
+  }
+  free(data);
+}
+
+
+/* void set_size(const unsigned int& size) ************************************/
+void
+OutputBuffer::set_size(const unsigned int& size) {
+  flush();
+  size_t new_capacity = (size == 0) ? 1 : size;
+  char* new_data = static_cast<char*>(realloc(data, new_capacity));
+  if(new_data == 0)
+    throw string("memoria insufficiente per il buffer di uscita");
+  data = new_data;
+  capacity = new_capacity;
+  return;
+}
+
+
+/* void capture(string* target) ***********************************************/
+void
+OutputBuffer::capture(string* target) {
+  if(target != 0)
+    redirect([target](const char* str, size_t n) { target->append(str, n); });
+  else
+    redirect(function<void (const char*, size_t)>());
+  return;
+}
+
+
+/* void redirect(const function<void (const char*, size_t)>& writer) **********/
+void
+OutputBuffer::redirect(const function<void (const char*, size_t)>& writer) {
+  flush();
+  this->writer = writer;
+  return;
+}
+
+
+/* unsigned int get_size() const **********************************************/
+unsigned int
+OutputBuffer::get_size() const {
+  return (capacity == 1) ? 0 : static_cast<unsigned int>(capacity);
+}
+
+
+/* void put_long(const int64_t& value) ****************************************/
+void
+OutputBuffer::put_long(const int64_t& value) {
+  // le cifre vengono scritte dalla meno significativa, dalla fine di numero
+  char numero[20];
+  char* pos = numero + sizeof(numero);
+  // il valore assoluto e` calcolato senza segno, per il minimo int64_t
+  uint64_t n = (value < 0) ? (~static_cast<uint64_t>(value) + 1)
+                           : static_cast<uint64_t>(value);
+  do {
+    *--pos = static_cast<char>('0' + n % 10);
+    n = n / 10;
+  } while(n != 0);
+  if(value < 0)
+    *--pos = '-';
+  put_chars(pos, numero + sizeof(numero) - pos);
+  return;
+}
+
+
+/* void flush() ***************************************************************/
+void
+OutputBuffer::flush() {
+  if(used == 0)
+    return;
+  size_t n = used;
+  used = 0;
+  write_all(data, n);
+  return;
+}
+
+
+/* void write_large(const char* str, const size_t& n) *************************/
+void
+OutputBuffer::write_large(const char* str, const size_t& n) {
+  flush();
+  if(n < capacity && capacity > 1) {
+    memcpy(data, str, n);
+    used = n;
+  }
+  else
+    write_all(str, n);
+  return;
+}
+
+
+/* void write_all(const char* str, size_t n) **********************************/
+void
+OutputBuffer::write_all(const char* str, size_t n) {
+  if(writer) {
+    writer(str, n);
+    return;
+  }
+  while(n > 0) {
+    ssize_t written = ::write(STDOUT_FILENO, str, n);
+    if(written < 0) {
+      if(errno == EINTR)
+        continue;
+      throw string("errore di scrittura sullo standard output");
+    }
+    str += written;
+    n -= written;
+  }
+  return;
+}
+
+
+#endif // OUTPUTBUFFER_CC_INCLUSION_GUARD
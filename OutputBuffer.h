@@ -0,0 +1,166 @@
+/*!
+  \file OutputBuffer.h
+  \brief Interfaccia di OutputBuffer
+  \author Andrea Zanelli
+  \date 17-10-2026
+*/
+
+#ifndef OUTPUTBUFFER_H_INCLUSION_GUARD
+#define OUTPUTBUFFER_H_INCLUSION_GUARD
+
+#include <stdint.h>
+#include <string.h>
+#include <functional>
+#include <string>
+
+using std::function;
+using std::string;
+
+
+/*!
+  \class OutputBuffer
+  \brief Uscita del programma (standard output) con un buffer in memoria
+
+  Accumula i caratteri stampati dal programma in un buffer e li scrive sullo
+  standard output, con una sola chiamata di sistema, quando il buffer e`
+  pieno o quando viene chiamato flush(). I numeri vengono convertiti in
+  caratteri direttamente nel buffer, senza passare dagli stream della
+  libreria standard e senza allocazioni. Con dimensione del buffer 0 ogni
+  stampa viene scritta subito (modalita` senza buffer, per l'uso
+  interattivo).\\
+  Il buffer va svuotato con flush() prima di ogni lettura dallo standard
+  input e prima della fine del programma; il distruttore lo svuota comunque.
+*/
+class OutputBuffer {
+
+  public:
+    /* METODI PUBBLICI */
+
+    //! Dimensione predefinita del buffer (in byte)
+    static const unsigned int DEFAULT_SIZE = 1 << 16;
+
+    /**
+     * Costruttore: crea un buffer di <tt>size</tt> byte (0: senza buffer).
+     */
+    explicit OutputBuffer(const unsigned int& size = DEFAULT_SIZE);
+
+    /**
+     * Distruttore: svuota il buffer.
+     */
+    ~OutputBuffer();
+
+    /**
+     * Cambia la dimensione del buffer in <tt>size</tt> byte (0: senza
+     * buffer), dopo averlo svuotato.
+     */
+    void set_size(const unsigned int& size);
+
+    /**
+     * Dopo aver svuotato il buffer, scrive le stampe successive in fondo
+     * alla stringa <tt>target</tt> invece che sullo standard output (con
+     * <tt>target</tt> 0 di nuovo sullo standard output).
+     */
+    void capture(string* target);
+
+    /**
+     * Dopo aver svuotato il buffer, passa le stampe successive alla funzione
+     * <tt>writer</tt> (con i caratteri e il loro numero) invece di
+     * scriverle sullo standard output: come per lo standard output, la
+     * funzione viene chiamata quando il buffer e` pieno o con flush(). Con
+     * <tt>writer</tt> vuota le stampe tornano sullo standard output.
+     */
+    void redirect(const function<void (const char*, size_t)>& writer);
+
+    /**
+     * Restituisce la dimensione del buffer in byte (0: senza buffer).
+     */
+    unsigned int get_size() const;
+
+    /**
+     * Stampa il carattere <tt>c</tt>.
+     */
+    inline
+    void put_char(const char& c) {
+      if(used == capacity)
+        flush();
+      data[used++] = c;
+      if(capacity == 1)
+        flush();
+      return;
+    }
+
+    /**
+     * Stampa i <tt>n</tt> caratteri in <tt>str</tt>.
+     */
+    inline
+    void put_chars(const char* str, const size_t& n) {
+      if(capacity - used >= n && capacity > 1) {
+        memcpy(data + used, str, n);
+        used += n;
+      }
+      else
+        write_large(str, n);
+      return;
+    }
+
+    /**
+     * Stampa la stringa <tt>str</tt>.
+     */
+    inline
+    void put_string(const string& str) {
+      put_chars(str.data(), str.size());
+      return;
+    }
+
+    /**
+     * Stampa il valore <tt>value</tt> in base 10.
+     */
+    inline
+    void put_int(const int32_t& value) {
+      put_long(value);
+      return;
+    }
+
+    /**
+     * Stampa il valore <tt>value</tt> in base 10.
+     */
+    void put_long(const int64_t& value);
+
+    /**
+     * Scrive sullo standard output il contenuto del buffer e lo svuota. In
+     * caso di errore di scrittura lancia un'eccezione di tipo std::string
+     * con la descrizione dell'errore.
+     */
+    void flush();
+
+  private:
+    /* VARIABILI PRIVATE */
+
+    //! Buffer (almeno un byte anche senza buffer)
+    char* data;
+
+    //! Byte occupati nel buffer
+    size_t used;
+
+    //! Byte allocati per il buffer (1 senza buffer)
+    size_t capacity;
+
+    //! Funzione a cui vengono passate le stampe (vuota: standard output)
+    function<void (const char*, size_t)> writer;
+
+    /* METODI PRIVATI */
+
+    // il buffer non puo` essere copiato
+    OutputBuffer(const OutputBuffer&);
+    OutputBuffer& operator=(const OutputBuffer&);
+
+    // stampa n caratteri che non stanno nello spazio libero del buffer
+    void write_large(const char* str, const size_t& n);
+
+    // scrive n byte sullo standard output (o li passa a writer)
+    void write_all(const char* str, size_t n);
+
+};
+
+
+#endif // OUTPUTBUFFER_H_INCLUSION_GUARD
@@ -0,0 +1,292 @@
+/*!
+  \file Profiler.cc
+  \brief Implementazione di Profiler
+  \author Andrea Zanelli
+  \date 17-10-2026
+*/
+
+#ifndef PROFILER_CC_INCLUSION_GUARD
+#define PROFILER_CC_INCLUSION_GUARD
+
+#include <stdio.h>
+#include <algorithm>
+#include <functional>
+#include <utility>
+
+#include "Function.h"
+#include "Instruction.h"
+#include "Profiler.h"
+
+using std::pair;
+
+
+// numero di istruzioni riportate nel profilo testuale
+static const unsigned int ISTRUZIONI_RIPORTATE = 20;
+
+// restituisce la stringa str tra virgolette, con i caratteri di escape del
+// formato JSON
+static string stringa_json(const string& str) {
+  string risultato("\"");
+  for(string::size_type i = 0; i < str.size(); ++i) {
+    const unsigned char c = static_cast<unsigned char>(str[i]);
+    if(c == '"' || c == '\\') {
+      risultato += '\\';
+      risultato += str[i];
+    }
+    else if(c < 0x20) {
+      char codice[8];
+      sprintf(codice, "\\u%04x", c);
+      risultato += codice;
+    }
+    else
+      risultato += str[i];
+  }
+  return risultato + "\"";
+}
+
+
+/* Profiler() *****************************************************************/
+Profiler::Profiler()
+  : program(0) {
+  return;
+}
+
+
+/* void enable(const ProgramArea& program) ************************************/
+void
+Profiler::enable(const ProgramArea& program) {
+  this->program = &program;
+  executions.assign(program.get_instructions_size(), 0);
+  functions.assign(program.get_functions_size(), FunctionProfile());
+  calls.clear();
+  return;
+}
+
+
+/* void call_at(const unsigned int& index) ************************************/
+void
+Profiler::call_at(const unsigned int& index) {
+  for(uint32_t f = 0; f < functions.size(); ++f) {
+    const Function& funzione = program->get_function(f);
+    if(funzione.start <= index && index <= funzione.end) {
+      call(f);
+      return;
+    }
+  }
+  return;
+}
+
+
+/* void finish() **************************************************************/
+void
+Profiler::finish() {
+  while(!calls.empty())
+    ret();
+  return;
+}
+
+
+/* string get_report() const **************************************************/
+string
+Profiler::get_report() const {
+  string report;
+  char riga[256];
+  if(program == 0)
+    return report;
+  uint64_t totale = 0;
+  for(unsigned int i = 0; i < executions.size(); ++i)
+    totale += executions[i];
+  const vector<uint64_t> conteggi = source_executions();
+
+  // funzioni, per tempo esclusivo
+  vector< pair<uint64_t, uint32_t> > ordine;
+  for(uint32_t f = 0; f < functions.size(); ++f) {
+    if(functions[f].calls > 0)
+      ordine.push_back(std::make_pair(functions[f].exclusive, f));
+  }
+  std::stable_sort(ordine.begin(), ordine.end(),
+      std::greater< pair<uint64_t, uint32_t> >());
+  sprintf(riga, "Funzioni (chiamate, istruzioni, %s esclusivi e "
+      "inclusivi):\n", get_unit());
+  report += riga;
+  for(unsigned int k = 0; k < ordine.size(); ++k) {
+    const uint32_t f = ordine[k].second;
+    sprintf(riga, "  %12llu %14llu %16llu %16llu  ",
+        static_cast<unsigned long long>(functions[f].calls),
+        static_cast<unsigned long long>(function_executions(f, conteggi)),
+        static_cast<unsigned long long>(functions[f].exclusive),
+        static_cast<unsigned long long>(functions[f].inclusive));
+    report += riga + program->get_function(f).name + "\n";
+  }
+
+  // codici operativi, per numero di esecuzioni
+  const Instruction* codice = program->get_code();
+  vector<uint64_t> per_opcode(OP_NUMERO_OPCODE, 0);
+  for(unsigned int i = 0; i < executions.size(); ++i)
+    per_opcode[codice[i].opcode] += executions[i];
+  vector< pair<uint64_t, uint32_t> > opcode;
+  for(uint32_t op = 0; op < per_opcode.size(); ++op) {
+    if(per_opcode[op] > 0)
+      opcode.push_back(std::make_pair(per_opcode[op], op));
+  }
+  std::stable_sort(opcode.begin(), opcode.end(),
+      std::greater< pair<uint64_t, uint32_t> >());
+  sprintf(riga, "Codici operativi (%llu istruzioni eseguite, ogni "
+      "superistruzione contata una volta):\n",
+      static_cast<unsigned long long>(totale));
+  report += riga;
+  for(unsigned int k = 0; k < opcode.size(); ++k) {
+    sprintf(riga, "  %14llu %6.2f%%  %s\n",
+        static_cast<unsigned long long>(opcode[k].first),
+        100.0 * opcode[k].first / totale,
+        opcode_name(static_cast<uint16_t>(opcode[k].second)));
+    report += riga;
+  }
+
+  // istruzioni piu` eseguite, comprese quelle delle superistruzioni
+  vector< pair<uint64_t, uint32_t> > istruzioni;
+  for(uint32_t i = 0; i < conteggi.size(); ++i) {
+    if(conteggi[i] > 0)
+      istruzioni.push_back(std::make_pair(conteggi[i], i));
+  }
+  std::stable_sort(istruzioni.begin(), istruzioni.end(),
+      std::greater< pair<uint64_t, uint32_t> >());
+  if(istruzioni.size() > ISTRUZIONI_RIPORTATE)
+    istruzioni.resize(ISTRUZIONI_RIPORTATE);
+  report += "Istruzioni piu` eseguite (anche nelle superistruzioni):\n";
+  for(unsigned int k = 0; k < istruzioni.size(); ++k) {
+    sprintf(riga, "  %14llu  ",
+        static_cast<unsigned long long>(istruzioni[k].first));
+    report += riga + describe(istruzioni[k].second) + "\n";
+  }
+  return report;
+} // end of method get_report() const
+
+
+/* string get_json() const ****************************************************/
+string
+Profiler::get_json() const {
+  string json;
+  char numero[64];
+  if(program == 0)
+    return json;
+  const Instruction* codice = program->get_code();
+  const vector<uint64_t> conteggi = source_executions();
+
+  json += "{\n  \"unit\": ";
+  json += string(get_unit()) == "ns" ? "\"ns\"" : "\"cycles\"";
+  json += ",\n  \"functions\": [";
+  bool primo = true;
+  for(uint32_t f = 0; f < functions.size(); ++f) {
+    if(functions[f].calls == 0)
+      continue;
+    json += primo ? "\n" : ",\n";
+    primo = false;
+    json += "    {\"name\": " + stringa_json(program->get_function(f).name);
+    sprintf(numero, ", \"calls\": %llu",
+        static_cast<unsigned long long>(functions[f].calls));
+    json += numero;
+    sprintf(numero, ", \"instructions\": %llu",
+        static_cast<unsigned long long>(function_executions(f, conteggi)));
+    json += numero;
+    sprintf(numero, ", \"inclusive\": %llu",
+        static_cast<unsigned long long>(functions[f].inclusive));
+    json += numero;
+    sprintf(numero, ", \"exclusive\": %llu}",
+        static_cast<unsigned long long>(functions[f].exclusive));
+    json += numero;
+  }
+  json += "\n  ],\n  \"opcodes\": {";
+  vector<uint64_t> per_opcode(OP_NUMERO_OPCODE, 0);
+  for(unsigned int i = 0; i < executions.size(); ++i)
+    per_opcode[codice[i].opcode] += executions[i];
+  primo = true;
+  for(uint16_t op = 0; op < per_opcode.size(); ++op) {
+    if(per_opcode[op] == 0)
+      continue;
+    json += primo ? "\n" : ",\n";
+    primo = false;
+    sprintf(numero, ": %llu", static_cast<unsigned long long>(per_opcode[op]));
+    json += "    " + stringa_json(opcode_name(op)) + numero;
+  }
+  json += "\n  },\n  \"instructions\": [";
+  primo = true;
+  for(uint32_t f = 0; f < functions.size(); ++f) {
+    const Function& funzione = program->get_function(f);
+    for(unsigned int i = funzione.start; i <= funzione.end; ++i) {
+      if(conteggi[i] == 0)
+        continue;
+      json += primo ? "\n" : ",\n";
+      primo = false;
+      sprintf(numero, "    {\"index\": %u, \"function\": ", i);
+      json += numero + stringa_json(funzione.name);
+      sprintf(numero, ", \"offset\": %u, \"opcode\": ", i - funzione.start);
+      json += numero + stringa_json(opcode_name(codice[i].opcode));
+      sprintf(numero, ", \"count\": %llu}",
+          static_cast<unsigned long long>(conteggi[i]));
+      json += numero;
+    }
+  }
+  json += "\n  ]\n}\n";
+  return json;
+} // end of method get_json() const
+
+
+/* const char* get_unit() *****************************************************/
+const char*
+Profiler::get_unit() {
+#if defined(__x86_64__) || defined(__i386__)
+  return "cicli";
+#else
+  return "ns";
+#endif
+}
+
+
+/* vector<uint64_t> source_executions() const *********************************/
+vector<uint64_t>
+Profiler::source_executions() const {
+  vector<uint64_t> conteggi(executions);
+  const Instruction* codice = program->get_code();
+  for(unsigned int i = 0; i < executions.size(); ++i) {
+    if(executions[i] == 0)
+      continue;
+    // le istruzioni della sequenza restano nel codice dopo la prima
+    const unsigned int lunghezza = superinstruction_length(codice[i].opcode);
+    for(unsigned int k = 1; k < lunghezza && i + k < conteggi.size(); ++k)
+      conteggi[i + k] += executions[i];
+  }
+  return conteggi;
+}
+
+
+/* uint64_t function_executions(...) const ************************************/
+uint64_t
+Profiler::function_executions(const uint32_t& function,
+    const vector<uint64_t>& counts) const {
+  const Function& funzione = program->get_function(function);
+  uint64_t totale = 0;
+  for(unsigned int i = funzione.start; i <= funzione.end; ++i)
+    totale += counts[i];
+  return totale;
+}
+
+
+/* string describe(const unsigned int& index) const ***************************/
+string
+Profiler::describe(const unsigned int& index) const {
+  char posizione[64];
+  const char* nome = opcode_name(program->get_code()[index].opcode);
+  for(uint32_t f = 0; f < functions.size(); ++f) {
+    const Function& funzione = program->get_function(f);
+    if(funzione.start <= index && index <= funzione.end) {
+      sprintf(posizione, "+%u  %s", index - funzione.start, nome);
+      return funzione.name + posizione;
+    }
+  }
+  sprintf(posizione, "%u  %s", index, nome);
+  return posizione;
+}
+
+
+#endif // PROFILER_CC_INCLUSION_GUARD
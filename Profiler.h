@@ -0,0 +1,224 @@
+/*!
+  \file Profiler.h
+  \brief Interfaccia di Profiler
+  \author Andrea Zanelli
+  \date 17-10-2026
+*/
+
+#ifndef PROFILER_H_INCLUSION_GUARD
+#define PROFILER_H_INCLUSION_GUARD
+
+#include <stdint.h>
+#include <time.h>
+#include <string>
+#include <vector>
+
+#include "ProgramArea.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+using std::string;
+using std::vector;
+
+
+/*!
+  \class Profiler
+  \brief Profilo dell'esecuzione di un programma
+
+  Conta quante volte viene eseguita ogni istruzione del programma (da cui
+  ricava i conteggi per codice operativo e per funzione) e, per ogni
+  funzione, il numero di chiamate e il tempo trascorso al suo interno:
+  inclusivo (con le funzioni chiamate, contato una volta sola nelle
+  chiamate ricorsive) ed esclusivo (senza le funzioni chiamate). Il tempo e`
+  misurato in cicli del processore con l'istruzione <tt>rdtsc</tt> su x86,
+  altrimenti in nanosecondi con <tt>clock_gettime()</tt> (vedi get_unit()).\\
+  Le istruzioni vengono contate dall'esecutore solo nella sua versione con
+  il profilo (vedi esecutore()), percio` senza l'opzione
+  <tt>--profile</tt> l'esecuzione non ha nessun costo aggiuntivo. Le
+  superistruzioni (vedi ProgramArea::fuse()) vengono eseguite, e contate
+  dall'esecutore, come una sola istruzione: i conteggi per codice
+  operativo sono quelli delle istruzioni eseguite dall'esecutore (con le
+  superistruzioni), mentre i conteggi per istruzione e per funzione
+  attribuiscono ogni esecuzione di una superistruzione anche alle istruzioni
+  della sequenza che ha sostituito (vedi source_executions()).
+*/
+class Profiler {
+
+  public:
+    /* METODI PUBBLICI */
+
+    /**
+     * Costruttore di default: profilo non attivo.
+     */
+    Profiler();
+
+    /**
+     * Attiva il profilo per il programma <tt>program</tt>, gia` caricato.
+     */
+    void enable(const ProgramArea& program);
+
+    /**
+     * Restituisce true se il profilo e` attivo.
+     */
+    inline
+    bool is_enabled() const {
+      return program != 0;
+    }
+
+    /**
+     * Conta un'esecuzione dell'istruzione con indice <tt>index</tt>.
+     */
+    inline
+    void count(const unsigned int& index) {
+      ++executions[index];
+      return;
+    }
+
+    /**
+     * Registra l'inizio di una chiamata alla funzione con indice
+     * <tt>function</tt> nella tabella delle funzioni.
+     */
+    inline
+    void call(const uint32_t& function) {
+      ++functions[function].calls;
+      ++functions[function].active;
+      calls.push_back(Call(function, now()));
+      return;
+    }
+
+    /**
+     * Come call(), per la funzione che contiene l'istruzione con indice
+     * <tt>index</tt> (usato per la prima funzione eseguita).
+     */
+    void call_at(const unsigned int& index);
+
+    /**
+     * Registra la fine dell'ultima chiamata iniziata.
+     */
+    inline
+    void ret() {
+      if(calls.empty())
+        return;
+      const Call chiamata = calls.back();
+      calls.pop_back();
+      const uint64_t durata = now() - chiamata.start;
+      FunctionProfile& funzione = functions[chiamata.function];
+      funzione.exclusive += durata - chiamata.children;
+      if(--funzione.active == 0)
+        funzione.inclusive += durata;
+      if(!calls.empty())
+        calls.back().children += durata;
+      return;
+    }
+
+    /**
+     * Chiude le chiamate non ancora terminate (ad esempio dopo un errore).
+     */
+    void finish();
+
+    /**
+     * Restituisce il profilo come testo: le funzioni ordinate per tempo
+     * esclusivo, i codici operativi e le istruzioni piu` eseguite.
+     */
+    string get_report() const;
+
+    /**
+     * Restituisce il profilo in formato JSON, con tutti i contatori diversi
+     * da 0: "opcodes" conta le istruzioni eseguite dall'esecutore, mentre
+     * "instructions" e "functions" contano anche le istruzioni sostituite
+     * dalle superistruzioni.
+     */
+    string get_json() const;
+
+    /**
+     * Restituisce l'unita` di misura del tempo: "cicli" o "ns".
+     */
+    static const char* get_unit();
+
+  private:
+    /* VARIABILI PRIVATE */
+
+    /*!
+      \struct FunctionProfile
+      \brief Contatori di una funzione
+    */
+    struct FunctionProfile {
+      uint64_t calls;       //!< numero di chiamate
+      uint64_t inclusive;   //!< tempo con le funzioni chiamate
+      uint64_t exclusive;   //!< tempo senza le funzioni chiamate
+      unsigned int active;  //!< chiamate in corso (ricorsione)
+      FunctionProfile() : calls(0), inclusive(0), exclusive(0), active(0) {}
+    };
+
+    /*!
+      \struct Call
+      \brief Chiamata in corso
+    */
+    struct Call {
+      uint32_t function;    //!< indice della funzione
+      uint64_t start;       //!< istante della chiamata
+      uint64_t children;    //!< tempo trascorso nelle funzioni chiamate
+      Call(const uint32_t& f, const uint64_t& s)
+        : function(f), start(s), children(0) {}
+    };
+
+    //! programma del profilo (0 se il profilo non e` attivo)
+    const ProgramArea* program;
+
+    //! numero di esecuzioni di ogni istruzione
+    vector<uint64_t> executions;
+
+    //! contatori di ogni funzione, con lo stesso indice della tabella delle
+    //! funzioni
+    vector<FunctionProfile> functions;
+
+    //! chiamate in corso, l'ultima in cima
+    vector<Call> calls;
+
+    /* METODI PRIVATI */
+
+    // il profilo non puo` essere copiato
+    Profiler(const Profiler&);
+    Profiler& operator=(const Profiler&);
+
+    /**
+     * Restituisce l'istante attuale, nell'unita` di get_unit().
+     */
+    static inline
+    uint64_t now() {
+#if defined(__x86_64__) || defined(__i386__)
+      return __rdtsc();
+#else
+      struct timespec t;
+      clock_gettime(CLOCK_MONOTONIC, &t);
+      return static_cast<uint64_t>(t.tv_sec) * 1000000000u + t.tv_nsec;
+#endif
+    }
+
+    /**
+     * Restituisce il numero di esecuzioni di ogni istruzione del programma,
+     * come executions ma con le esecuzioni di ogni superistruzione
+     * attribuite anche alle altre istruzioni della sequenza sostituita.
+     */
+    vector<uint64_t> source_executions() const;
+
+    /**
+     * Restituisce il numero di istruzioni eseguite nella funzione con
+     * indice <tt>function</tt>, secondo i conteggi <tt>counts</tt> di
+     * source_executions().
+     */
+    uint64_t function_executions(const uint32_t& function,
+        const vector<uint64_t>& counts) const;
+
+    /**
+     * Restituisce la descrizione dell'istruzione con indice <tt>index</tt>:
+     * funzione, posizione nella funzione e codice operativo.
+     */
+    string describe(const unsigned int& index) const;
+
+};
+
+
+#endif // PROFILER_H_INCLUSION_GUARD
@@ -8,14 +8,28 @@
 #ifndef PROGRAMAREA_CC_INCLUSION_GUARD
 #define PROGRAMAREA_CC_INCLUSION_GUARD
 
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "NativeMethod.h"
 #include "ProgramArea.h"
+#include "Slot.h"
+#include "Verifier.h"
 
 
 /* ProgramArea() **************************************************************/
 ProgramArea::ProgramArea() 
-  : is_start_function(false),
+  : mapped_code(0),
+    mapped_code_size(0),
+    is_start_function(false),
     current_function(""),
-    inside_function(false) {
+    inside_function(false),
+    locals_limit(Function::NO_LIMIT),
+    stack_limit(Function::NO_LIMIT),
+    linked(false),
+    fused(false),
+    verified(false) {
   return;
 }
 
@@ -23,33 +37,120 @@ ProgramArea::ProgramArea()
 /* string get_instruction(const vector<string>::size_type& index) const *******/
 string
 ProgramArea::get_instruction(const unsigned int& index) const {
-  if(index >= program.size())
+  if(index >= program_offsets.size())
     throw string("l'istruzione richiesta e` fuori dall'area del programma");
-  return program[index];
+  string::size_type end = (index+1 < program_offsets.size()) ?
+    program_offsets[index+1] : program_text.size();
+  return program_text.substr(program_offsets[index],
+      end - program_offsets[index]);
+}
+
+
+/* const Instruction& get_decoded_instruction(const unsigned int& index) const */
+const Instruction&
+ProgramArea::get_decoded_instruction(const unsigned int& index) const {
+  if(index >= get_instructions_size())
+    throw string("l'istruzione richiesta e` fuori dall'area del programma");
+  return get_code()[index];
+}
+
+
+/* const Instruction* get_code() const ****************************************/
+const Instruction*
+ProgramArea::get_code() const {
+  if(mapped_code != 0)
+    return mapped_code;
+  if(code.empty())
+    return 0;
+  return &code[0];
+}
+
+
+/* const string& get_symbol(const uint32_t& index) const **********************/
+const string&
+ProgramArea::get_symbol(const uint32_t& index) const {
+  if(index >= symbols.size())
+    throw string("il simbolo richiesto non esiste");
+  return symbols[index];
 }
 
 
 /* unsigned int get_function_index(const string& name) const ******************/
 unsigned int
 ProgramArea::get_function_index(string name) const {
-  map<string, pair<unsigned int,unsigned int> >::const_iterator iter;
-  delete_space(name);
-  iter = functions.find(name);
-  if(iter == functions.end())
-    throw string("la funzione richiesta non esiste: " + name);
-  return (iter->second).first;
+  return find_function(name).start;
 }
 
 
 /* unsigned int get_function_end_index(const string& name) const **************/
 unsigned int
 ProgramArea::get_function_end_index(string name) const {
-  map<string, pair<unsigned int, unsigned int> >::const_iterator iter;
-  delete_space(name);
-  iter = functions.find(name);
-  if(iter == functions.end())
-    throw string("la funzione richiesta non esiste: " + name);
-  return (iter->second).second;
+  return find_function(name).end;
+}
+
+
+/* unsigned int get_function_locals(string name) const ************************/
+unsigned int
+ProgramArea::get_function_locals(string name) const {
+  return find_function(name).locals;
+}
+
+
+/* unsigned int get_function_max_stack(string name) const *********************/
+unsigned int
+ProgramArea::get_function_max_stack(string name) const {
+  return find_function(name).max_stack;
+}
+
+
+/* unsigned int get_function_entry(string name) const *************************/
+unsigned int
+ProgramArea::get_function_entry(string name) const {
+  return find_function(name).entry;
+}
+
+
+/* void set_function_entry(const uint32_t& index, ...) ************************/
+void
+ProgramArea::set_function_entry(const uint32_t& index,
+    const unsigned int& entry) {
+  if(index >= function_table.size())
+    throw string("la funzione richiesta non esiste");
+  function_table[index].entry = entry;
+  return;
+}
+
+
+/* const Function& get_function(const uint32_t& index) const ******************/
+const Function&
+ProgramArea::get_function(const uint32_t& index) const {
+  if(index >= function_table.size())
+    throw string("la funzione richiesta non esiste");
+  return function_table[index];
+}
+
+
+/* const Function& get_function_at(const unsigned int& index) const ***********/
+const Function&
+ProgramArea::get_function_at(const unsigned int& index) const {
+  // le funzioni sono di solito nella tabella nell'ordine del codice: ricerca
+  // binaria, poi lineare per i file bytecode con un altro ordine
+  vector<Function>::size_type basso = 0, alto = function_table.size();
+  while(alto - basso > 1) {
+    const vector<Function>::size_type medio = (basso + alto) / 2;
+    if(function_table[medio].start <= index)
+      basso = medio;
+    else
+      alto = medio;
+  }
+  if(basso < function_table.size() && function_table[basso].start <= index &&
+      index <= function_table[basso].end)
+    return function_table[basso];
+  for(vector<Function>::size_type f = 0; f < function_table.size(); ++f) {
+    if(function_table[f].start <= index && index <= function_table[f].end)
+      return function_table[f];
+  }
+  throw string("l'istruzione richiesta e` fuori dall'area del programma");
 }
 
 
@@ -73,24 +174,52 @@ ProgramArea::add_instruction(const string& instruction) {
     if(instruction == ".end method") {
       inside_function = false;
       is_start_function = false;
-      // mette l'indice dell'ultima istruzione in functions
-      map<string, pair<unsigned int,unsigned int> >::iterator iter;
+      // mette l'indice dell'ultima istruzione nella tabella delle funzioni
+      map<string, uint32_t>::iterator iter;
       iter = functions.find(current_function);
       if(iter == functions.end())
         throw string("direttiva .end method di fine funzione senza " +
             string("una direttiva .method di inizio funzione") );
-      else
-        (iter->second).second = program.size()-1;
+      Function& funzione = function_table[iter->second];
+      funzione.end = code.size()-1;
+      // calcola lo spazio per le variabili locali, che non puo` superare
+      // quello dichiarato con .limit locals
+      funzione.locals = count_locals(funzione.arguments.size(),
+          funzione.start, funzione.end);
+      if(locals_limit != Function::NO_LIMIT) {
+        if(locals_limit < funzione.locals)
+          throw string("la funzione " + current_function + " usa piu` " +
+              "variabili locali di quelle dichiarate con .limit locals");
+        funzione.locals = locals_limit;
+      }
+      funzione.stack_limit = stack_limit;
+      funzione.max_stack = stack_limit != Function::NO_LIMIT ? stack_limit : 0;
       current_function = "";
     }
+    // dimensione delle variabili locali o dello stack degli operandi
+    else if(instruction.substr(0,7) == ".limit ") {
+      add_limit(instruction);
+    }
     else {
-      // istruzione normale
-      program.push_back(instruction);
+      // istruzione normale: viene memorizzata senza etichetta e decodificata
+      current_instruction = instruction;
       control_label();
+      program_offsets.push_back(program_text.size());
+      program_text.append(current_instruction);
+      decode_instruction();
       // prima istruzione della funzione
       if(is_start_function) {
-        functions.insert(std::make_pair( current_function, 
-                std::make_pair(program.size()-1, int()) ));
+        if(functions.find(current_function) != functions.end())
+          throw string("funzione definita piu` volte: " + current_function);
+        Function funzione;
+        funzione.name = current_function;
+        funzione.start = code.size()-1;
+        funzione.entry = funzione.start;
+        funzione.arguments = argument_layout(current_function);
+        funzione.return_type = return_type(current_function);
+        functions.insert(std::make_pair(current_function,
+              static_cast<uint32_t>(function_table.size())) );
+        function_table.push_back(funzione);
         is_start_function = false;
       }
     }
@@ -100,6 +229,7 @@ ProgramArea::add_instruction(const string& instruction) {
   else if(instruction.substr(0,22) == ".method public static ") {
     is_start_function = true;
     inside_function = true;
+    locals_limit = stack_limit = Function::NO_LIMIT;
     current_function = instruction.substr(22);
     delete_space(current_function);
   } // end else if(instruction.substr(0,22) == ...)
@@ -113,17 +243,387 @@ ProgramArea::add_instruction(const string& instruction) {
 } // end of method add_instruction(const string& instruction)
 
 
+/* void add_limit(const string& directive) ************************************/
+void
+ProgramArea::add_limit(const string& directive) {
+  string::size_type spazio = directive.find(' ', 7);
+  if(spazio == string::npos)
+    throw string("direttiva sconosciuta: " + directive);
+  const string nome = directive.substr(7, spazio - 7);
+  const string valore = directive.substr(spazio + 1);
+  if(valore.empty() || valore.size() > 5 ||
+      valore.find_first_not_of("0123456789") != string::npos ||
+      atol(valore.c_str()) > 0xFFFF)
+    throw string("valore non valido nella direttiva " + directive);
+  if(nome == "locals")
+    locals_limit = static_cast<unsigned int>(atol(valore.c_str()));
+  else if(nome == "stack")
+    stack_limit = static_cast<unsigned int>(atol(valore.c_str()));
+  else
+    throw string("direttiva sconosciuta: " + directive);
+  return;
+} // end of method add_limit(const string& directive)
+
+
+/* void link(const GlobalVariablesArea& globals) ******************************/
+void
+ProgramArea::link(const GlobalVariablesArea& globals) {
+  if(linked)
+    return;
+  for(vector<Instruction>::size_type i = 0; i < code.size(); ++i) {
+    // chiamata ad una funzione del programma
+    if(code[i].opcode == OP_INVOKESTATIC && code[i].type == 'M') {
+      map<string, uint32_t>::const_iterator f_iter;
+      f_iter = functions.find(symbols[code[i].index]);
+      if(f_iter == functions.end())
+        throw string("la funzione richiesta non esiste: " +
+            symbols[code[i].index]);
+      code[i].index = f_iter->second;
+      continue;
+    }
+    // variabile globale
+    if((code[i].opcode == OP_GETSTATIC || code[i].opcode == OP_PUTSTATIC) &&
+        (code[i].type == 'I' || code[i].type == 'J' || code[i].type == 'S' ||
+         code[i].type == 'C')) {
+      code[i].index = globals.get_slot(symbols[code[i].index], code[i].type);
+      continue;
+    }
+    if(code[i].opcode < OP_GOTO || code[i].opcode > OP_IFNE)
+      continue;
+    const string& label = symbols[code[i].index];
+    map<string, unsigned int>::const_iterator iter = labels.find(label);
+    if(iter == labels.end()) {
+      // toglie dal nome dell'etichetta il suffisso con il numero della
+      // funzione, aggiunto al caricamento
+      string::size_type pos = label.rfind('_');
+      string name = (pos == string::npos) ? label : label.substr(0, pos);
+      // cerca la funzione che contiene il salto
+      for(vector<Function>::size_type f = 0; f < function_table.size(); ++f) {
+        if(function_table[f].start <= i && i <= function_table[f].end)
+          throw string("etichetta inesistente nella funzione " +
+              function_table[f].name + ": " + name);
+      }
+      throw string("etichetta inesistente nel programma: " + name);
+    }
+    code[i].index = iter->second;
+  }
+  linked = true;
+  return;
+} // end of method link()
+
+
+/* void verify() **************************************************************/
+void
+ProgramArea::verify() {
+  if(!linked)
+    throw string("il programma da verificare non e` collegato");
+  if(fused)
+    throw string("il programma da verificare contiene superistruzioni");
+  if(verified)
+    return;
+  verified_code.assign(get_instructions_size(), 0);
+  for(vector<Function>::size_type f = 0; f < function_table.size(); ++f) {
+    Function& funzione = function_table[f];
+    Verifier verifica(*this, funzione);
+    string motivo;
+    funzione.verified = verifica.verify(motivo);
+    if(funzione.verified) {
+      // il RdA della funzione avra` lo spazio esatto per il suo stack degli
+      // operandi
+      funzione.max_stack = verifica.get_max_stack();
+      char numero[32];
+      sprintf(numero, "verificata (stack %u)\n", verifica.get_max_stack());
+      verification_report += funzione.name + ": " + numero;
+      for(unsigned int i = funzione.start; i <= funzione.end; ++i)
+        verified_code[i] = 1;
+    }
+    else
+      verification_report += funzione.name + ": non verificata (" + motivo +
+        ")\n";
+  }
+  verified = true;
+  return;
+} // end of method verify()
+
+
+/* string get_verification_report() const *************************************/
+string
+ProgramArea::get_verification_report() const {
+  return verification_report;
+}
+
+
+/* void fuse() ****************************************************************/
+void
+ProgramArea::fuse() {
+  if(!linked)
+    throw string("il programma da ottimizzare non e` collegato");
+  if(fused)
+    return;
+  if(mapped_code != 0) {
+    // le istruzioni lette dal file mappato non possono essere modificate
+    code.assign(mapped_code, mapped_code + mapped_code_size);
+    mapped_code = 0;
+    mapped_code_size = 0;
+  }
+  fusions.assign(function_table.size(), map<uint16_t, unsigned int>());
+  for(vector<Function>::size_type f = 0; f < function_table.size(); ++f) {
+    const unsigned int end = function_table[f].end;
+    unsigned int i = function_table[f].start;
+    while(i <= end) {
+      unsigned int length = 1;
+      uint16_t opcode = match_superinstruction(i, end, length);
+      if(opcode != OP_NUMERO_OPCODE) {
+        code[i].opcode = opcode;
+        ++fusions[f][opcode];
+      }
+      i += length;
+    }
+  }
+  fused = true;
+  return;
+} // end of method fuse()
+
+
+/* string get_fusion_report() const *******************************************/
+string
+ProgramArea::get_fusion_report() const {
+  string report;
+  for(vector<Function>::size_type f = 0; f < function_table.size(); ++f) {
+    report += function_table[f].name + ":";
+    if(f >= fusions.size() || fusions[f].empty())
+      report += " nessuna";
+    else {
+      map<uint16_t, unsigned int>::const_iterator iter;
+      for(iter = fusions[f].begin(); iter != fusions[f].end(); ++iter) {
+        char numero[16];
+        sprintf(numero, " x%u", iter->second);
+        if(iter != fusions[f].begin())
+          report += ",";
+        report += string(" ") + opcode_name(iter->first) + numero;
+      }
+    }
+    report += "\n";
+  }
+  return report;
+}
+
+
+/* void write_binary(BinaryWriter& out) const *********************************/
+void
+ProgramArea::write_binary(BinaryWriter& out) const {
+  if(!linked)
+    throw string("il programma da scrivere non e` collegato");
+  if(fused)
+    throw string("il programma da scrivere contiene superistruzioni");
+
+  // tipi di riferimento, fino al piu` alto usato nelle istruzioni (il tipo 0
+  // e` sempre "nessuno")
+  const Instruction* istr = get_code();
+  const unsigned int n_code = get_instructions_size();
+  uint32_t n_ref_types = 1;
+  for(unsigned int i = 0; i < n_code; ++i) {
+    if(istr[i].type == 'L' && istr[i].opcode != OP_LDC_W &&
+        istr[i].index >= n_ref_types)
+      n_ref_types = istr[i].index + 1;
+  }
+  out.put_u32(n_ref_types);
+  for(uint32_t i = 1; i < n_ref_types; ++i)
+    out.put_string(ref_type_name(static_cast<uint16_t>(i)));
+
+  // metodi nativi, fino al piu` alto usato nelle istruzioni (il metodo 0 e`
+  // sempre "nessuno"), con il nome e se sono statici
+  uint32_t n_natives = 1;
+  for(unsigned int i = 0; i < n_code; ++i) {
+    if(istr[i].type == 'N' && istr[i].index >= n_natives)
+      n_natives = istr[i].index + 1;
+  }
+  out.put_u32(n_natives);
+  for(uint32_t i = 1; i < n_natives; ++i) {
+    out.put_string(native_method(i).name);
+    out.put_char(native_method(i).is_static ? 'S' : 'V');
+  }
+
+  // pool delle costanti stringa
+  out.put_u32(static_cast<uint32_t>(constants.size()));
+  for(vector<string>::size_type i = 0; i < constants.size(); ++i)
+    out.put_string(constants[i]);
+
+  // tabella delle funzioni
+  out.put_u32(static_cast<uint32_t>(function_table.size()));
+  for(vector<Function>::size_type i = 0; i < function_table.size(); ++i) {
+    const Function& funzione = function_table[i];
+    out.put_string(funzione.name);
+    out.put_u32(funzione.start);
+    out.put_u32(funzione.end);
+    out.put_u32(funzione.locals);
+    out.put_u32(funzione.stack_limit);
+    out.put_string(funzione.arguments);
+    out.put_char(funzione.return_type);
+  }
+
+  // istruzioni decodificate, allineate come in memoria; i byte di
+  // riempimento della struttura vengono azzerati
+  out.put_u32(static_cast<uint32_t>(sizeof(Instruction)));
+  out.put_u32(static_cast<uint32_t>(n_code));
+  out.align(sizeof(int64_t));
+  for(unsigned int i = 0; i < n_code; ++i) {
+    Instruction istruzione;
+    memset(static_cast<void*>(&istruzione), 0, sizeof(istruzione));
+    istruzione.opcode = istr[i].opcode;
+    istruzione.type = istr[i].type;
+    istruzione.index = istr[i].index;
+    istruzione.value = istr[i].value;
+    out.put_bytes(&istruzione, sizeof(istruzione));
+  }
+  return;
+} // end of method write_binary(BinaryWriter& out) const
+
+
+/* void read_binary(BinaryReader& in, const GlobalVariablesArea& globals) *****/
+void
+ProgramArea::read_binary(BinaryReader& in, const GlobalVariablesArea& globals) {
+  if(get_instructions_size() != 0 || !function_table.empty() ||
+      inside_function)
+    throw string("il programma e` gia` stato caricato");
+
+  // tipi di riferimento: l'indice nel file diventa l'indice nella tabella
+  // dei tipi di questa esecuzione (di solito lo stesso)
+  uint32_t n_ref_types = in.get_u32();
+  if(n_ref_types == 0 || n_ref_types > 0x10000)
+    throw string("file bytecode non valido: tabella dei tipi errata");
+  vector<uint16_t> ref_types(n_ref_types, 0);
+  bool same_indices = true;
+  for(uint32_t i = 1; i < n_ref_types; ++i) {
+    ref_types[i] = ref_type_id(in.get_string());
+    if(ref_types[i] != i)
+      same_indices = false;
+  }
+
+  // metodi nativi: l'indice nel file diventa l'indice nella tabella dei
+  // metodi nativi di questa esecuzione, in cui devono essere gia` registrati
+  uint32_t n_natives = in.get_u32();
+  if(n_natives == 0 || n_natives > MAX_NATIVE_METHODS)
+    throw string("file bytecode non valido: tabella dei metodi nativi errata");
+  vector<uint32_t> natives(n_natives, INTR_NESSUNO);
+  for(uint32_t i = 1; i < n_natives; ++i) {
+    const string nome = in.get_string();
+    natives[i] = find_native_method(nome, in.get_char() == 'S');
+    if(natives[i] == INTR_NESSUNO)
+      throw string("metodo nativo non registrato: " + nome);
+    if(natives[i] != i)
+      same_indices = false;
+  }
+
+  // pool delle costanti stringa
+  uint32_t n_constants = in.get_u32();
+  for(uint32_t i = 0; i < n_constants; ++i)
+    add_constant(in.get_string());
+  if(constants.size() != n_constants)
+    throw string("file bytecode non valido: costante ripetuta");
+
+  // tabella delle funzioni
+  uint32_t n_functions = in.get_u32();
+  for(uint32_t i = 0; i < n_functions; ++i) {
+    Function funzione;
+    funzione.name = in.get_string();
+    funzione.start = in.get_u32();
+    funzione.end = in.get_u32();
+    funzione.locals = in.get_u32();
+    funzione.stack_limit = in.get_u32();
+    funzione.max_stack = funzione.stack_limit != Function::NO_LIMIT ?
+      funzione.stack_limit : 0;
+    funzione.arguments = in.get_string();
+    funzione.return_type = in.get_char();
+    funzione.entry = funzione.start;
+    if(!functions.insert(std::make_pair(funzione.name, i)).second)
+      throw string("funzione definita piu` volte: " + funzione.name);
+    function_table.push_back(funzione);
+  }
+
+  // istruzioni decodificate
+  if(in.get_u32() != sizeof(Instruction))
+    throw string("file bytecode scritto da una macchina astratta diversa");
+  uint32_t n_code = in.get_u32();
+  in.align(sizeof(int64_t));
+  const char* istruzioni = in.get_span(
+      static_cast<size_t>(n_code) * sizeof(Instruction));
+  if(same_indices &&
+      reinterpret_cast<uintptr_t>(istruzioni) % sizeof(int64_t) == 0) {
+    // le istruzioni vengono usate dove sono, senza copiarle
+    mapped_code = reinterpret_cast<const Instruction*>(istruzioni);
+    mapped_code_size = n_code;
+  }
+  else {
+    // le istruzioni vengono copiate, per cambiare gli indici dei tipi e dei
+    // metodi nativi
+    code.resize(n_code);
+    if(n_code > 0)
+      memcpy(static_cast<void*>(&code[0]), istruzioni,
+          static_cast<size_t>(n_code) * sizeof(Instruction));
+  }
+
+  // controllo della tabella delle funzioni e delle istruzioni
+  for(uint32_t i = 0; i < n_functions; ++i) {
+    const Function& funzione = function_table[i];
+    if(funzione.start > funzione.end || funzione.end >= n_code ||
+        funzione.locals < funzione.arguments.size() ||
+        funzione.locals < count_locals(funzione.arguments.size(),
+          funzione.start, funzione.end) ||
+        funzione.arguments != argument_layout(funzione.name) ||
+        funzione.return_type != return_type(funzione.name))
+      throw string("file bytecode non valido nella funzione " +
+          funzione.name);
+  }
+  const Instruction* istr = get_code();
+  for(uint32_t i = 0; i < n_code; ++i) {
+    check_instruction(i, globals.get_variables_size());
+    if(istr[i].type == 'L' && istr[i].opcode != OP_LDC_W) {
+      if(istr[i].index >= n_ref_types)
+        throw string("file bytecode non valido: tipo inesistente");
+      if(mapped_code == 0)
+        code[i].index = ref_types[code[i].index];
+    }
+    else if(istr[i].type == 'N') {
+      if(istr[i].index >= n_natives)
+        throw string("file bytecode non valido: metodo nativo inesistente");
+      if(mapped_code == 0)
+        code[i].index = natives[code[i].index];
+    }
+  }
+  linked = true;
+  return;
+} // end of method read_binary(BinaryReader&, const GlobalVariablesArea&)
+
+
+/* bool has_function(string name) const ***************************************/
+bool
+ProgramArea::has_function(string name) const {
+  delete_space(name);
+  return functions.find(name) != functions.end();
+}
+
+
 /* unsigned int get_instructions_size() const *********************************/
 unsigned int 
 ProgramArea::get_instructions_size() const {
-  return static_cast<unsigned int>(program.size());
+  if(mapped_code != 0)
+    return mapped_code_size;
+  return static_cast<unsigned int>(code.size());
 }
 
 
 /* unsigned int get_functions_size() const ************************************/
 unsigned int 
 ProgramArea::get_functions_size() const {
-  return static_cast<unsigned int>(functions.size());
+  return static_cast<unsigned int>(function_table.size());
+}
+
+
+/* unsigned int get_constants_size() const ************************************/
+unsigned int
+ProgramArea::get_constants_size() const {
+  return static_cast<unsigned int>(constants.size());
 }
 
 
@@ -135,25 +635,284 @@ ProgramArea::control_label() {
   // percio`, se c'e` un'istruzione che nell'argomento ha "due punti" (ad
   // esempio, una stringa contentente i :), e` sempre preceduta da uno spazio,
   // cosi` si puo` distinguere l'etichetta dall'argomento.
-  string::size_type loc = program.back().find(':');
-  string::size_type loc_space = program.back().find(' ');
+  string& instruction = current_instruction;
+  string::size_type loc = instruction.find(':');
+  string::size_type loc_space = instruction.find(' ');
   if(loc != string::npos && (loc_space == string::npos || loc < loc_space)) {
-    // inserisce in labels l'etichetta
+    // inserisce in labels l'etichetta, con l'indice che avra` l'istruzione
     labels.insert( std::make_pair(
-        program.back().substr(0, loc), 
-        program.size()-1 ) );
+        instruction.substr(0, loc), 
+        code.size() ) );
     // elimina l'etichetta dall'istruzione
-    if(loc == program.back().size()-1)
-      program.back().erase(0, loc+1);
-    else if(program.back().at(loc+1) == ' ')
-      program.back().erase(0, loc+2);
+    if(loc == instruction.size()-1)
+      instruction.erase(0, loc+1);
+    else if(instruction.at(loc+1) == ' ')
+      instruction.erase(0, loc+2);
     else
-      program.back().erase(0, loc+1);
+      instruction.erase(0, loc+1);
   }
   return;
 }
 
 
+/* void decode_instruction() **************************************************/
+void
+ProgramArea::decode_instruction() {
+  // per ipotesi l'istruzione non ha spazi iniziali e finali e ha un solo
+  // spazio tra il nome e gli argomenti
+  // nome e argomento vengono copiati nei buffer riutilizzati
+  const string& instruction = current_instruction;
+  string& name = current_name;
+  string& arg = current_arg;
+  string::size_type pos = instruction.find(' ');
+  if(pos != string::npos) {
+    name.assign(instruction, 0, pos);
+    arg.assign(instruction, pos+1, string::npos);
+  }
+  else {
+    name = instruction;
+    arg.clear();
+  }
+
+  Instruction decoded;
+  if(name.empty()) {
+    // istruzione vuota (era presente solo un'etichetta)
+    code.push_back(decoded);
+    return;
+  }
+  decoded.opcode = opcode_from_name(name.c_str());
+  if(decoded.opcode == OP_NUMERO_OPCODE)
+    throw string("istruzione sconosciuta: " + name);
+
+  switch(decoded.opcode) {
+    case OP_LDC_W:
+      if(!arg.empty() && arg[0] == '"') {
+        // costante di tipo String: toglie le virgolette e sostituisce i
+        // "caratteri particolari" (es: \" diventa "), prendendo come ipotesi
+        // che la stringa sia corretta
+        arg.erase(arg.size()-1);
+        arg.erase(0,1);
+        for(string::size_type i = 0; i < arg.size(); ++i) {
+          if(arg[i] == '\\')
+            arg.erase(i,1);
+        }
+        decoded.type = 'L';
+        decoded.index = add_constant(arg);
+      }
+      else {
+        // costante di tipo int
+        decoded.type = 'I';
+        decoded.value = static_cast<int32_t>(atol(arg.c_str()));
+      }
+      break;
+
+    case OP_LDC2_W:
+      decoded.value = static_cast<int64_t>(atoll(arg.c_str()));
+      break;
+
+    case OP_SIPUSH:
+      decoded.value = static_cast<int16_t>(atol(arg.c_str()));
+      break;
+
+    case OP_GOTO:
+    case OP_IF_ICMPEQ:
+    case OP_IF_ICMPGE:
+    case OP_IF_ICMPGT:
+    case OP_IF_ICMPLE:
+    case OP_IF_ICMPLT:
+    case OP_IF_ICMPNE:
+    case OP_IFEQ:
+    case OP_IFGE:
+    case OP_IFGT:
+    case OP_IFLE:
+    case OP_IFLT:
+    case OP_IFNE:
+      decoded.index = add_symbol(arg);
+      break;
+
+    case OP_ILOAD:
+    case OP_ISTORE:
+    case OP_LLOAD:
+    case OP_LSTORE:
+      decoded.index = static_cast<uint16_t>(atol(arg.c_str()));
+      break;
+
+    case OP_GETSTATIC:
+      if(arg.substr(0,5) == "Main/") {
+        // variabile globale: "Main/nome tipo"
+        pos = arg.find(' ');
+        decoded.type = arg[arg.size()-1];
+        decoded.index = add_symbol(arg.substr(5,pos-5));
+      }
+      else if(arg == "java/lang/System/out Ljava/io/PrintStream;") {
+        decoded.type = 'L';
+        decoded.index = REF_PRINTSTREAM;
+      }
+      else if(arg == "java/lang/System/in Ljava/io/InputStream;") {
+        decoded.type = 'L';
+        decoded.index = REF_INPUTSTREAM;
+      }
+      break;
+
+    case OP_PUTSTATIC:
+      // "Main/nome tipo"
+      pos = arg.find(' ');
+      decoded.type = arg.empty() ? char() : arg[arg.size()-1];
+      decoded.index = add_symbol(arg.substr(arg.size() < 5 ? arg.size() : 5,
+            pos == string::npos ? pos : pos-5));
+      break;
+
+    case OP_NEW:
+      decoded.type = 'L';
+      decoded.index = ref_type_id("L" + arg + ";");
+      break;
+
+    case OP_INVOKESTATIC:
+      delete_space(arg);
+      if(arg.substr(0,5) == "Main/") {
+        decoded.type = 'M';
+        decoded.index = add_symbol(arg.substr(5));
+      }
+      else {
+        // metodo di libreria (INTR_NESSUNO se sconosciuto)
+        decoded.type = 'N';
+        decoded.index = find_native_method(arg, true);
+      }
+      break;
+
+    case OP_INVOKEVIRTUAL:
+    case OP_INVOKESPECIAL:
+      // metodo di libreria con l'oggetto sotto i parametri
+      delete_space(arg);
+      decoded.type = 'N';
+      decoded.index = find_native_method(arg, false);
+      break;
+
+    default:
+      // istruzioni senza argomenti
+      break;
+  } // end switch(decoded.opcode)
+
+  code.push_back(decoded);
+  return;
+} // end of method decode_instruction()
+
+
+/* uint32_t add_symbol(const string& symbol) **********************************/
+uint32_t
+ProgramArea::add_symbol(const string& symbol) {
+  map<string, uint32_t>::const_iterator iter = symbols_index.find(symbol);
+  if(iter != symbols_index.end())
+    return iter->second;
+  uint32_t index = static_cast<uint32_t>(symbols.size());
+  symbols.push_back(symbol);
+  symbols_index.insert(std::make_pair(symbol, index));
+  return index;
+}
+
+
+/* uint32_t add_constant(const string& constant) ******************************/
+uint32_t
+ProgramArea::add_constant(const string& constant) {
+  map<string, uint32_t>::const_iterator iter = constants_index.find(constant);
+  if(iter != constants_index.end())
+    return iter->second;
+  uint32_t index = static_cast<uint32_t>(constants.size());
+  constants.push_back(constant);
+  constants_index.insert(std::make_pair(constant, index));
+  return index;
+}
+
+
+/* unsigned int count_locals(const unsigned int& n_args, ...) const ***********/
+unsigned int
+ProgramArea::count_locals(const unsigned int& n_args,
+    const unsigned int& start, const unsigned int& end) const {
+  // parametri
+  unsigned int n_locals = n_args;
+  // variabili usate dalle istruzioni della funzione
+  const Instruction* istr = get_code();
+  const unsigned int n_code = get_instructions_size();
+  for(unsigned int i = start; i <= end && i < n_code; ++i) {
+    unsigned int last = 0;
+    if(istr[i].opcode == OP_ILOAD || istr[i].opcode == OP_ISTORE)
+      last = istr[i].index + 1;
+    else if(istr[i].opcode == OP_LLOAD || istr[i].opcode == OP_LSTORE)
+      last = istr[i].index + 2;
+    if(last > n_locals)
+      n_locals = last;
+  }
+  return n_locals;
+} // end of method count_locals(...)
+
+
+/* string argument_layout(const string& name) const **************************/
+string
+ProgramArea::argument_layout(const string& name) const {
+  string layout;
+  string::size_type pos = name.find('(');
+  if(pos == string::npos)
+    return layout;
+  for(++pos; pos < name.size() && name[pos] != ')'; ++pos) {
+    switch(name[pos]) {
+      case 'I': case 'C': case 'S': case 'B': case 'Z':
+        layout += 'I';
+        break;
+      case 'J':
+        layout += "J$";
+        break;
+      case '[':
+        // array: un riferimento, qualunque sia il tipo degli elementi
+        while(pos+1 < name.size() && name[pos+1] == '[')
+          ++pos;
+        if(pos+1 < name.size() && name[pos+1] != 'L')
+          ++pos;
+        else if(pos+1 < name.size())
+          pos = name.find(';', pos);
+        layout += 'L';
+        break;
+      case 'L':
+        pos = name.find(';', pos);
+        layout += 'L';
+        break;
+    }
+    if(pos == string::npos)
+      break;
+  }
+  return layout;
+} // end of method argument_layout(const string& name)
+
+
+/* char return_type(const string& name) const *********************************/
+char
+ProgramArea::return_type(const string& name) const {
+  string::size_type pos = name.rfind(')');
+  if(pos == string::npos || pos+1 >= name.size())
+    return 'V';
+  switch(name[pos+1]) {
+    case 'I': case 'C': case 'S': case 'B': case 'Z':
+      return 'I';
+    case 'J':
+      return 'J';
+    case 'L': case '[':
+      return 'L';
+  }
+  return 'V';
+}
+
+
+/* const Function& find_function(string name) const ***************************/
+const Function&
+ProgramArea::find_function(string name) const {
+  map<string, uint32_t>::const_iterator iter;
+  delete_space(name);
+  iter = functions.find(name);
+  if(iter == functions.end())
+    throw string("la funzione richiesta non esiste: " + name);
+  return function_table[iter->second];
+}
+
+
 /* void delete_space(string& str) const ***************************************/
 void 
 ProgramArea::delete_space(string& str) const {
@@ -166,4 +925,88 @@ ProgramArea::delete_space(string& str) const {
 }
 
 
+/* uint16_t match_superinstruction(const unsigned int& index, ...) const ******/
+uint16_t
+ProgramArea::match_superinstruction(const unsigned int& index,
+    const unsigned int& end, unsigned int& length) const {
+  const Instruction* istr = &code[index];
+  const unsigned int n = end - index + 1;
+
+  // ldc_w k; iload n; iadd; istore n
+  if(n >= 4 && istr[0].opcode == OP_LDC_W && istr[0].type != 'L' &&
+      istr[1].opcode == OP_ILOAD && istr[2].opcode == OP_IADD &&
+      istr[3].opcode == OP_ISTORE && istr[3].index == istr[1].index) {
+    length = 4;
+    return OP_LDC_W_ILOAD_IADD_ISTORE;
+  }
+
+  if(n >= 3 && istr[0].opcode == OP_ILOAD && istr[1].opcode == OP_LDC_W &&
+      istr[1].type != 'L') {
+    // iload n; ldc_w k; iadd|isub; istore n
+    if(n >= 4 && istr[3].opcode == OP_ISTORE &&
+        istr[3].index == istr[0].index) {
+      length = 4;
+      if(istr[2].opcode == OP_IADD)
+        return OP_ILOAD_LDC_W_IADD_ISTORE;
+      if(istr[2].opcode == OP_ISUB)
+        return OP_ILOAD_LDC_W_ISUB_ISTORE;
+    }
+    // iload n; ldc_w k; if_icmp* label
+    length = 3;
+    switch(istr[2].opcode) {
+      case OP_IF_ICMPEQ: return OP_ILOAD_LDC_W_IF_ICMPEQ;
+      case OP_IF_ICMPGE: return OP_ILOAD_LDC_W_IF_ICMPGE;
+      case OP_IF_ICMPGT: return OP_ILOAD_LDC_W_IF_ICMPGT;
+      case OP_IF_ICMPLE: return OP_ILOAD_LDC_W_IF_ICMPLE;
+      case OP_IF_ICMPLT: return OP_ILOAD_LDC_W_IF_ICMPLT;
+      case OP_IF_ICMPNE: return OP_ILOAD_LDC_W_IF_ICMPNE;
+    }
+  }
+
+  // getstatic java/lang/System/out ...; iload|lload|ldc_w; invokevirtual
+  if(n >= 3 && istr[0].opcode == OP_GETSTATIC && istr[0].type == 'L' &&
+      istr[0].index == REF_PRINTSTREAM &&
+      istr[2].opcode == OP_INVOKEVIRTUAL && istr[2].type == 'N') {
+    length = 3;
+    if(istr[1].opcode == OP_ILOAD && istr[2].index == INTR_PRINT_INT)
+      return OP_GETSTATIC_ILOAD_PRINT_INT;
+    if(istr[1].opcode == OP_LLOAD && istr[2].index == INTR_PRINT_LONG)
+      return OP_GETSTATIC_LLOAD_PRINT_LONG;
+    if(istr[1].opcode == OP_LDC_W && istr[1].type == 'L' &&
+        istr[2].index == INTR_PRINT_STRING)
+      return OP_GETSTATIC_LDC_W_PRINT_STRING;
+  }
+
+  length = 1;
+  return OP_NUMERO_OPCODE;
+} // end of method match_superinstruction(...)
+
+
+/* void check_instruction(const unsigned int& index, ...) const ***************/
+void
+ProgramArea::check_instruction(const unsigned int& index,
+    const unsigned int& n_globals) const {
+  const Instruction& istr = get_code()[index];
+  bool valida = istr.opcode < OP_PRIMA_SUPERISTRUZIONE;
+  if(valida && istr.opcode >= OP_GOTO && istr.opcode <= OP_IFNE)
+    valida = istr.index < get_instructions_size();
+  else if(valida && istr.opcode == OP_LDC_W && istr.type == 'L')
+    valida = istr.index < constants.size();
+  else if(valida && istr.opcode == OP_INVOKESTATIC && istr.type == 'M')
+    valida = istr.index < function_table.size();
+  else if(valida &&
+      (istr.opcode == OP_GETSTATIC || istr.opcode == OP_PUTSTATIC) &&
+      (istr.type == 'I' || istr.type == 'J' || istr.type == 'S' ||
+       istr.type == 'C'))
+    valida = istr.index < n_globals;
+  if(!valida) {
+    char numero[16];
+    sprintf(numero, "%u", index);
+    throw string("file bytecode non valido: istruzione errata all'indice ") +
+      numero;
+  }
+  return;
+}
+
+
 #endif // PROGRAMAREA_CC_INCLUSION_GUARD
@@ -8,11 +8,17 @@
 #ifndef PROGRAMAREA_H_INCLUSION_GUARD
 #define PROGRAMAREA_H_INCLUSION_GUARD
 
+#include <stdint.h>
 #include <string>
 #include <vector>
 #include <map>
 #include <utility>
 
+#include "BinaryFile.h"
+#include "Function.h"
+#include "GlobalVariablesArea.h"
+#include "Instruction.h"
+
 using std::string;
 using std::vector;
 using std::map;
@@ -28,6 +34,15 @@ using std::pair;
   e consecutivo all'istruzione che le precede. \\
   Le etichette vengono tolte e, attraverso una funzione apposta, puo` restituire
   l'istruzione "puntata" da una certa etichetta. \\
+  Ogni istruzione inserita viene anche decodificata in una Instruction, con il
+  codice operativo e gli argomenti gia` estratti, cosi` che l'esecutore possa
+  lavorare sull'array delle istruzioni decodificate senza analizzare stringhe.
+  I nomi presenti negli argomenti (etichette, funzioni, variabili globali e
+  tipi) vengono memorizzati una sola volta nella tabella dei simboli e
+  indicati nelle istruzioni decodificate con il loro indice. Allo stesso modo
+  le stringhe costanti di <tt>ldc_w</tt> vengono memorizzate, gia` senza
+  virgolette e caratteri di escape, una sola volta nel pool delle costanti
+  stringa, che non cambia durante l'esecuzione.
 */
 class ProgramArea {
   public:
@@ -47,6 +62,50 @@ class ProgramArea {
      */
     string get_instruction(const unsigned int& index) const;
 
+    /**
+     * Restituisce l'istruzione decodificata con indice <tt>index</tt>. Se
+     * l'indice e` errato lancia un'eccezione di tipo std::string con la
+     * descrizione dell'errore.
+     */
+    const Instruction& get_decoded_instruction(const unsigned int& index) const;
+
+    /**
+     * Restituisce il puntatore alla prima istruzione decodificata del
+     * programma: le istruzioni sono memorizzate in modo contiguo, nello stesso
+     * ordine (e con lo stesso indice) delle istruzioni inserite. Se non e`
+     * stata inserita nessuna istruzione restituisce 0.
+     */
+    const Instruction* get_code() const;
+
+    /**
+     * Restituisce il simbolo con indice <tt>index</tt> (vedi Instruction). Se
+     * l'indice e` errato lancia un'eccezione di tipo std::string con la
+     * descrizione dell'errore.
+     */
+    const string& get_symbol(const uint32_t& index) const;
+
+    /**
+     * Restituisce la stringa costante con indice <tt>index</tt> nel pool
+     * delle costanti stringa (vedi Instruction). La stringa non va
+     * modificata ne` deallocata; l'indice non viene controllato, percio`
+     * dev'essere quello di un'istruzione <tt>ldc_w</tt> del programma.
+     */
+    inline
+    const string& get_constant(const uint32_t& index) const {
+      return constants[index];
+    }
+
+    /**
+     * Restituisce <tt>true</tt> se <tt>str</tt> punta ad una stringa del
+     * pool delle costanti stringa, <tt>false</tt> se e` un'altra stringa
+     * (ad esempio letta dallo standard input).
+     */
+    inline
+    bool is_constant(const string* str) const {
+      return !constants.empty() && str >= &constants[0] &&
+        str < &constants[0] + constants.size();
+    }
+
     /**
      * Restituisce l'indice della prima istruzione della funzione con 
      * descrittore <tt>name</tt> che deve avere questa forma: 
@@ -65,6 +124,68 @@ class ProgramArea {
      */
     unsigned int get_function_end_index(string name) const;
 
+    /**
+     * Restituisce il numero di posizioni occupate dalle variabili locali
+     * (compresi i parametri) della funzione con descrittore <tt>name</tt>
+     * che deve avere questa forma: "NomeFunzione(TipoArgomenti)TipoRitorno",
+     * con eventualmente degli spazi. Il valore viene calcolato alla fine della
+     * funzione, dall'indice piu` alto usato nelle istruzioni iload, istore,
+     * lload e lstore (un long occupa due posizioni), oppure e` quello della
+     * direttiva <tt>.limit locals</tt>. Se la funzione non esiste
+     * lancia un'eccezione di tipo std::string con la descrizione dell'errore.
+     */
+    unsigned int get_function_locals(string name) const;
+
+    /**
+     * Restituisce il numero di posizioni dello stack degli operandi da
+     * riservare nel RdA della funzione con descrittore <tt>name</tt>, che
+     * puo` contenere degli spazi (vedi Function::max_stack). Se la funzione
+     * non esiste lancia un'eccezione di tipo std::string con la descrizione
+     * dell'errore.
+     */
+    unsigned int get_function_max_stack(string name) const;
+
+    /**
+     * Restituisce il PC con cui inizia l'esecuzione della funzione con
+     * descrittore <tt>name</tt> (vedi Function::entry), che puo` contenere
+     * degli spazi: l'indice della prima istruzione, a meno che la funzione
+     * non sia stata tradotta nel codice a registri. Se la funzione non esiste
+     * lancia un'eccezione di tipo std::string con la descrizione dell'errore.
+     */
+    unsigned int get_function_entry(string name) const;
+
+    /**
+     * Imposta a <tt>entry</tt> il PC con cui inizia l'esecuzione della
+     * funzione con indice <tt>index</tt> nella tabella delle funzioni (vedi
+     * Function::entry). Se l'indice e` errato lancia un'eccezione di tipo
+     * std::string con la descrizione dell'errore.
+     */
+    void set_function_entry(const uint32_t& index, const unsigned int& entry);
+
+    /**
+     * Restituisce l'elemento con indice <tt>index</tt> della tabella delle
+     * funzioni (vedi Function), cioe` l'indice con cui il collegamento
+     * risolve le istruzioni <tt>invokestatic</tt>. Se l'indice e` errato
+     * lancia un'eccezione di tipo std::string con la descrizione dell'errore.
+     */
+    const Function& get_function(const uint32_t& index) const;
+
+    /**
+     * Restituisce l'elemento della tabella delle funzioni della funzione che
+     * contiene l'istruzione con indice <tt>index</tt>. Se l'istruzione non
+     * appartiene a nessuna funzione lancia un'eccezione di tipo std::string
+     * con la descrizione dell'errore.
+     */
+    const Function& get_function_at(const unsigned int& index) const;
+
+    /**
+     * Restituisce l'elemento della tabella delle funzioni della funzione
+     * con descrittore <tt>name</tt>, che puo` contenere degli spazi. Se la
+     * funzione non esiste lancia un'eccezione di tipo std::string con la
+     * descrizione dell'errore.
+     */
+    const Function& find_function(string name) const;
+
     /**
      * Restituisce l'indice dell'istruzione a cui corrispondeva l'etichetta
      * <tt>label</tt>. Se l'etichetta non esiste lancia un'eccezione di tipo
@@ -83,6 +204,11 @@ class ProgramArea {
      * argomenti e tra il nome e gli argomenti. Ogni funzione deve iniziare con
      * un'istruzione ".method public static " e finire con l'istruzione 
      * ".end method".\\
+     * All'interno di una funzione possono esserci le direttive
+     * ".limit locals n" e ".limit stack n", come in Jasmin: la prima fissa il
+     * numero di posizioni delle variabili locali (non meno di quelle usate
+     * dalle istruzioni), la seconda il numero massimo di posizioni dello
+     * stack degli operandi, controllato da verify().\\
      * Se un'istruzione e` preceduta da un'etichetta, questa viene tolta e 
      * viene memorizzato l'indice dell'istruzione "puntata" dall'ettichetta. Le
      * etichette devono essere all'inizio dell'istruzione (eventualmente senza
@@ -92,6 +218,119 @@ class ProgramArea {
      */
     void add_instruction(const string& instruction);
 
+    /**
+     * Collega il programma, da chiamare dopo aver inserito tutte le
+     * istruzioni: nelle istruzioni decodificate di salto (goto, if_icmp* e
+     * if*) sostituisce l'indice del simbolo dell'etichetta con l'indice
+     * dell'istruzione "puntata" dall'etichetta, e nelle chiamate alle
+     * funzioni del programma (invokestatic) l'indice del simbolo della
+     * funzione con il suo indice nella tabella delle funzioni; nelle
+     * istruzioni getstatic e putstatic sulle variabili globali sostituisce
+     * l'indice del simbolo del nome con la posizione della variabile in
+     * <tt>globals</tt>. Cosi` durante l'esecuzione un salto e` solo un
+     * assegnamento al PC, una chiamata un accesso alla tabella delle
+     * funzioni e una variabile globale un accesso per indice. Se
+     * un'etichetta, una funzione o una variabile globale non esistono lancia
+     * un'eccezione di tipo std::string con la descrizione dell'errore. Le
+     * chiamate successive alla prima non hanno effetto.
+     */
+    void link(const GlobalVariablesArea& globals);
+
+    /**
+     * Verifica i tipi di ogni funzione (vedi Verifier), da chiamare dopo il
+     * collegamento (o la lettura del file bytecode) e prima di fuse(): le
+     * funzioni verificate vengono segnate (vedi Function::verified) e le
+     * loro istruzioni vengono eseguite senza controlli sui tipi (vedi
+     * is_verified()). Le chiamate successive alla prima non hanno effetto;
+     * se il programma non e` collegato o contiene gia` superistruzioni lancia
+     * un'eccezione di tipo std::string con la descrizione dell'errore.
+     */
+    void verify();
+
+    /**
+     * Restituisce true se l'istruzione con indice <tt>index</tt> appartiene
+     * a una funzione verificata da verify(); false se la funzione non e`
+     * stata verificata o se l'indice e` fuori dal programma.
+     */
+    inline
+    bool is_verified(const unsigned int& index) const {
+      return index < verified_code.size() && verified_code[index] != 0;
+    }
+
+    /**
+     * Restituisce l'esito di verify(): una riga per funzione nella forma
+     * "nome(argomenti)ritorno: verificata (stack N)" oppure
+     * "nome(argomenti)ritorno: non verificata (motivo)".
+     */
+    string get_verification_report() const;
+
+    /**
+     * Fonde le sequenze di istruzioni piu` frequenti in superistruzioni (vedi
+     * Opcode), da chiamare dopo il collegamento (o la lettura del file
+     * bytecode) e prima dell'esecuzione. Viene cambiato solo il codice
+     * operativo della prima istruzione di ogni sequenza, percio` gli indici
+     * delle istruzioni, le destinazioni dei salti e le istruzioni successive
+     * restano quelle del programma originale. Vengono fuse:
+     *   - <tt>ldc_w k; iload n; iadd; istore n</tt> e <tt>iload n; ldc_w k;
+     *     iadd|isub; istore n</tt> (incremento di una variabile locale);
+     *   - <tt>iload n; ldc_w k; if_icmp* label</tt> (confronto di una
+     *     variabile locale con una costante e salto);
+     *   - <tt>getstatic java/lang/System/out ...; iload n|lload n|ldc_w
+     *     "str"; invokevirtual java/io/PrintStream/print</tt> (stampa).
+     * Una sequenza viene fusa solo se e` interamente in una funzione. Se il
+     * programma e` stato letto da file bytecode senza copiare le istruzioni,
+     * queste vengono copiate. Le chiamate successive alla prima non hanno
+     * effetto; se il programma non e` collegato lancia un'eccezione di tipo
+     * std::string con la descrizione dell'errore.
+     */
+    void fuse();
+
+    /**
+     * Restituisce le superistruzioni create da fuse(): una riga per funzione
+     * nella forma "nome(argomenti)ritorno: superistruzione xN, ..." (oppure
+     * "nessuna" se nella funzione non e` stata fusa nessuna sequenza).
+     */
+    string get_fusion_report() const;
+
+    /**
+     * Scrive in <tt>out</tt> il programma gia` collegato (vedi link()) per il
+     * file bytecode: la tabella dei tipi di riferimento usati, i nomi dei
+     * metodi nativi usati, il pool delle costanti stringa, la tabella delle
+     * funzioni e l'array delle istruzioni
+     * decodificate, cosi` com'e` in memoria. Le istruzioni nella forma
+     * testuale, le etichette e la tabella dei simboli, che servono solo al
+     * caricamento del sorgente, non vengono scritte. Se il programma non e`
+     * collegato lancia un'eccezione di tipo std::string con la descrizione
+     * dell'errore. Il programma non deve
+     * contenere superistruzioni (vedi fuse()).
+     */
+    void write_binary(BinaryWriter& out) const;
+
+    /**
+     * Legge da <tt>in</tt> un programma scritto con write_binary() e lo
+     * mette nell'area, che dev'essere vuota; il programma letto e` gia`
+     * collegato con le variabili globali in <tt>globals</tt>, che devono
+     * essere gia` state lette dallo stesso file. Quando possibile l'array
+     * delle istruzioni non viene copiato ma usato direttamente dalla memoria
+     * letta da <tt>in</tt>, che percio` deve restare valida fino a quando il
+     * programma viene usato (ad esempio il file mappato, vedi MappedFile).
+     * I metodi nativi vengono cercati per nome, percio` quelli registrati
+     * (vedi register_native_method()) devono esserlo anche in questa
+     * esecuzione. Ogni istruzione viene
+     * controllata (codice operativo, destinazione dei salti, funzioni,
+     * metodi nativi, variabili globali e costanti) cosi` che un file danneggiato non possa
+     * far accedere l'esecutore fuori dalle tabelle; in caso di errore lancia
+     * un'eccezione di tipo std::string con la descrizione dell'errore.
+     */
+    void read_binary(BinaryReader& in, const GlobalVariablesArea& globals);
+
+    /**
+     * Restituisce <tt>true</tt> se esiste la funzione con descrittore
+     * <tt>name</tt> (nella forma "NomeFunzione(TipoArgomenti)TipoRitorno",
+     * con eventualmente degli spazi).
+     */
+    bool has_function(string name) const;
+
     /**
      * Ritorna il numero di istruzioni memorizzate 
      */
@@ -102,15 +341,55 @@ class ProgramArea {
      */
     unsigned int get_functions_size() const;
 
+    /**
+     * Ritorna il numero di stringhe nel pool delle costanti stringa
+     */
+    unsigned int get_constants_size() const;
+
   private:
     /* VARIABILI PRIVATE */
 
-    //! usato per memorizzare le istruzioni
-    vector<string> program;
+    //! testo delle istruzioni (senza etichette), una di seguito all'altra
+    string program_text;
+
+    //! posizione in program_text dell'inizio di ogni istruzione
+    vector<string::size_type> program_offsets;
+
+    //! istruzioni decodificate, con lo stesso indice di quelle in program_text
+    vector<Instruction> code;
 
-    //! usato per memorizzare il nome delle funzioni con gli indici della prima
-    //! e dell'ulitma istruzione
-    map<string, pair<unsigned int, unsigned int> > functions;
+    //! istruzioni decodificate lette da file bytecode senza copiarle (vedi
+    //! read_binary()); se non e` 0 sostituisce code
+    const Instruction* mapped_code;
+
+    //! numero di istruzioni in mapped_code
+    unsigned int mapped_code_size;
+
+    //! istruzione che si sta aggiungendo, con il suo nome e argomento
+    //! durante la decodifica: buffer riutilizzati per ogni istruzione, cosi`
+    //! che il caricamento non richieda allocazioni per ogni riga
+    string current_instruction;
+    string current_name;
+    string current_arg;
+
+    //! tabella dei simboli usati come argomento nelle istruzioni
+    vector<string> symbols;
+
+    //! indice di ogni simbolo nella tabella dei simboli
+    map<string, uint32_t> symbols_index;
+
+    //! pool delle costanti stringa (argomenti di ldc_w)
+    vector<string> constants;
+
+    //! indice di ogni stringa nel pool delle costanti stringa
+    map<string, uint32_t> constants_index;
+
+    //! tabella delle funzioni, nell'ordine in cui sono state inserite
+    vector<Function> function_table;
+
+    //! usato per memorizzare il nome delle funzioni con l'indice nella
+    //! tabella delle funzioni
+    map<string, uint32_t> functions;
 
     //! usato per memorizzare il nome delle etichette con l'indice dell'
     //! istruzione "puntata".
@@ -126,21 +405,114 @@ class ProgramArea {
     // true se si stanno aggiungendo istruzioni all'interno di una funzione
     bool inside_function;
 
+    // valori delle direttive .limit locals e .limit stack della funzione
+    // alla quale si stanno aggiungendo istruzioni (o Function::NO_LIMIT)
+    unsigned int locals_limit;
+    unsigned int stack_limit;
+
+    // true se il programma e` gia` stato collegato (vedi link())
+    bool linked;
+
+    // true se le superistruzioni sono gia` state create (vedi fuse())
+    bool fused;
+
+    // true se i tipi sono gia` stati verificati (vedi verify())
+    bool verified;
+
+    //! per ogni istruzione: 1 se appartiene a una funzione verificata
+    vector<unsigned char> verified_code;
+
+    //! esito di verify(), una riga per funzione
+    string verification_report;
+
+    //! numero di superistruzioni create da fuse() in ogni funzione (con lo
+    //! stesso indice della tabella delle funzioni), per codice operativo
+    vector< map<uint16_t, unsigned int> > fusions;
+
     /* METODI PRIVATI */
 
     /**
-     * Controlla se nella ultima istruzione inserita in program e` presente una
-     * etichetta nella forma <em>label:</em>, in tal caso toglie l'etichetta e
-     * la memorizza in <tt>labels</tt> con il corrispettivo indice dell'
-     * istruzione.
+     * Controlla se nell'istruzione che si sta aggiungendo
+     * (<tt>current_instruction</tt>) e` presente una etichetta nella forma
+     * <em>label:</em>, in tal caso toglie l'etichetta e la memorizza in
+     * <tt>labels</tt> con l'indice che avra` l'istruzione.
      */
     void control_label();
 
+    /**
+     * Decodifica l'istruzione che si sta aggiungendo (gia` senza etichetta)
+     * e aggiunge il risultato in <tt>code</tt>. Se l'istruzione
+     * e` sconosciuta lancia un'eccezione di tipo std::string con la
+     * descrizione dell'errore.
+     */
+    void decode_instruction();
+
+    /**
+     * Restituisce l'indice del simbolo <tt>symbol</tt> nella tabella dei
+     * simboli, aggiungendolo se non e` ancora presente.
+     */
+    uint32_t add_symbol(const string& symbol);
+
+    /**
+     * Restituisce l'indice della stringa <tt>constant</tt> nel pool delle
+     * costanti stringa, aggiungendola se non e` ancora presente.
+     */
+    uint32_t add_constant(const string& constant);
+
+    /**
+     * Memorizza il valore della direttiva <tt>directive</tt> (".limit locals
+     * n" o ".limit stack n") della funzione alla quale si stanno aggiungendo
+     * istruzioni. In caso di errori viene lanciata un'eccezione di tipo
+     * std::string con la descrizione dell'errore.
+     */
+    void add_limit(const string& directive);
+
+    /**
+     * Restituisce il numero di posizioni occupate dalle variabili locali
+     * di una funzione con <tt>n_args</tt> posizioni occupate dai parametri e
+     * le cui istruzioni vanno da <tt>start</tt> a <tt>end</tt> (compresi).
+     */
+    unsigned int count_locals(const unsigned int& n_args,
+        const unsigned int& start, const unsigned int& end) const;
+
+    /**
+     * Restituisce la disposizione dei parametri della funzione con
+     * descrittore <tt>name</tt> nelle variabili locali: un carattere per
+     * posizione, con la stessa convenzione del tipo degli Slot ('I' per
+     * int, short e char, "J$" per long, 'L' per i riferimenti).
+     */
+    string argument_layout(const string& name) const;
+
+    /**
+     * Restituisce il tipo di ritorno della funzione con descrittore
+     * <tt>name</tt> (vedi Function).
+     */
+    char return_type(const string& name) const;
+
+    /**
+     * Restituisce la superistruzione che puo` sostituire la sequenza che
+     * inizia con l'istruzione di indice <tt>index</tt> e finisce entro
+     * l'istruzione di indice <tt>end</tt>, mettendo in <tt>length</tt> il
+     * numero di istruzioni della sequenza; se non c'e` nessuna sequenza da
+     * fondere restituisce <tt>OP_NUMERO_OPCODE</tt>.
+     */
+    uint16_t match_superinstruction(const unsigned int& index,
+        const unsigned int& end, unsigned int& length) const;
+
     /**
      * Elimina gli spazi dalla stringa passata
      */
     void delete_space(string& str) const;
 
+    /**
+     * Controlla l'istruzione decodificata con indice <tt>index</tt> di un
+     * programma letto da file bytecode (vedi read_binary()), con
+     * <tt>n_globals</tt> variabili globali; se non e` valida lancia
+     * un'eccezione di tipo std::string con la descrizione dell'errore.
+     */
+    void check_instruction(const unsigned int& index,
+        const unsigned int& n_globals) const;
+
 };
 
 
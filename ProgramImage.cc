@@ -0,0 +1,498 @@
+/*!
+  \file ProgramImage.cc
+  \brief Implementazione di ProgramImage
+  \author Andrea Zanelli
+  \date 17-10-2026
+*/
+
+#ifndef PROGRAMIMAGE_CC_INCLUSION_GUARD
+#define PROGRAMIMAGE_CC_INCLUSION_GUARD
+
+#include <iostream>
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "BinaryFile.h"
+#include "ProgramImage.h"
+
+
+//! Identificativo all'inizio dei file bytecode
+static const char MAGIC_BYTECODE[8] = {'\177','M','A','J','B','C','\r','\n'};
+
+//! Versione del formato dei file bytecode
+static const uint32_t VERSIONE_BYTECODE = 3;
+
+// Dichiarazione di funzioni
+
+bool bytecode_aggiornato(const string& sorgente, const string& bytecode);
+bool leggi_istruzione(const char*& pos, const char* fine, string& str);
+void pulisci_stringa(string& str);
+void elimina_spazi_iniziali_e_finali(string& str);
+void cancella_carattere(string& str, char c = ' ');
+
+
+/* ProgramImage() *************************************************************/
+ProgramImage::ProgramImage()
+  : functions(0) {
+}
+
+
+/* void load(const string& name) **********************************************/
+void
+ProgramImage::load(const string& name) {
+  string bytecode = bytecode_name(name);
+  if(bytecode_aggiornato(name, bytecode)) {
+    try {
+      file.open(bytecode);
+      read_bytecode(file.get_data(), file.get_size(), bytecode);
+      return;
+    }
+    catch(string e) {
+      std::cerr <<"Attenzione: il file " <<bytecode <<" e` stato ignorato ("
+                <<e <<")" <<std::endl;
+      // riparte dal programma vuoto
+      program = ProgramArea();
+      globals = GlobalVariablesArea();
+    }
+  }
+  file.open(name);
+  if(is_bytecode(file.get_data(), file.get_size()))
+    read_bytecode(file.get_data(), file.get_size(), name);
+  else
+    read_source();
+  return;
+}
+
+
+/* void load_data(const char* data, const size_t& size) ***********************/
+void
+ProgramImage::load_data(const char* data, const size_t& size) {
+  contents.assign(data, size);
+  if(is_bytecode(contents.data(), contents.size())) {
+    read_bytecode(contents.data(), contents.size(), "in memoria");
+    return;
+  }
+  read_text(contents.data(), contents.data() + contents.size());
+  // il testo non serve piu`
+  string().swap(contents);
+  program.link(globals);
+  return;
+}
+
+
+/* void load_source(const string& name) ***************************************/
+void
+ProgramImage::load_source(const string& name) {
+  file.open(name);
+  read_source();
+  return;
+}
+
+
+/* void write_bytecode(const string& name) const ******************************/
+void
+ProgramImage::write_bytecode(const string& name) const {
+  BinaryWriter out;
+  out.put_bytes(MAGIC_BYTECODE, sizeof(MAGIC_BYTECODE));
+  out.put_u32(VERSIONE_BYTECODE);
+  out.put_u32(0x01020304);
+  globals.write_binary(out);
+  program.write_binary(out);
+
+  // il file viene scritto con un nome temporaneo e poi rinominato, cosi`
+  // che una macchina astratta che sta eseguendo (con il file mappato) la
+  // versione precedente non veda mai un file scritto a meta`; il nome
+  // temporaneo e` unico (mkstemp()), percio` piu` thread o processi possono
+  // scrivere lo stesso file contemporaneamente
+  string modello = name + ".XXXXXX";
+  int fd = mkstemp(&modello[0]);
+  if(fd < 0)
+    throw string("impossibile scrivere il file " + name);
+  // mkstemp() crea il file leggibile solo dal proprietario
+  bool scritto = fchmod(fd, 0644) == 0;
+  const char* dati = out.get_data().data();
+  size_t n = out.get_data().size();
+  while(scritto && n > 0) {
+    ssize_t k = write(fd, dati, n);
+    if(k < 0 && errno == EINTR)
+      continue;
+    if(k <= 0)
+      scritto = false;
+    else {
+      dati += k;
+      n -= k;
+    }
+  }
+  if(close(fd) != 0)
+    scritto = false;
+  if(!scritto || rename(modello.c_str(), name.c_str()) != 0) {
+    remove(modello.c_str());
+    throw string("errore nella scrittura del file " + name);
+  }
+  return;
+}
+
+
+/* static string bytecode_name(const string& source) **************************/
+string
+ProgramImage::bytecode_name(const string& source) {
+  if(source.size() > 2 && source.substr(source.size()-2) == ".j")
+    return source + "bc";
+  return source + ".jbc";
+}
+
+
+/* void read_source() *********************************************************/
+void
+ProgramImage::read_source() {
+  read_text(file.get_data(), file.get_data() + file.get_size());
+  file.close();
+  program.link(globals);
+  return;
+}
+
+
+/* void read_bytecode(const char* data, const size_t& size, ...) **************/
+void
+ProgramImage::read_bytecode(const char* data, const size_t& size,
+    const string& name) {
+  BinaryReader in(data, size);
+  char magic[sizeof(MAGIC_BYTECODE)];
+  in.get_bytes(magic, sizeof(magic));
+  if(memcmp(magic, MAGIC_BYTECODE, sizeof(magic)) != 0)
+    throw string("il file " + name + " non e` un file bytecode");
+  if(in.get_u32() != VERSIONE_BYTECODE)
+    throw string("versione del file bytecode non supportata");
+  if(in.get_u32() != 0x01020304)
+    throw string("file bytecode scritto da una macchina astratta diversa");
+  globals.read_binary(in);
+  program.read_binary(in, globals);
+  if(!in.at_end())
+    throw string("file bytecode non valido: dati dopo la fine del programma");
+  return;
+}
+
+
+/* static bool is_bytecode(const char* data, const size_t& size) **************/
+bool
+ProgramImage::is_bytecode(const char* data, const size_t& size) {
+  return size >= sizeof(MAGIC_BYTECODE) &&
+    memcmp(data, MAGIC_BYTECODE, sizeof(MAGIC_BYTECODE)) == 0;
+}
+
+
+/* void read_text(const char* begin, const char* end) *************************/
+void
+ProgramImage::read_text(const char* begin, const char* end) {
+  // la stessa stringa viene riutilizzata per ogni riga
+  string riga;
+  const char* pos = begin;
+  while(leggi_istruzione(pos,end,riga)) {
+    check_label(riga);
+    if(riga == "") {
+      // Riga vuota
+    }
+    else if(riga[0] == '.') {
+      // Direttiva
+      add_directive(riga);
+    }
+    else{
+      // Istruzione
+      program.add_instruction(riga);
+    }
+  } // end while(leggi_istruzione(pos,end,riga))
+  return;
+} // end of method read_text(const char*, const char*)
+
+
+/* void check_label(string& str) const ****************************************/
+void
+ProgramImage::check_label(string& str) const {
+  if(!str.empty()) {
+    // L'etichetta dev'essere sempre all'inizio dell'istruzione, siccome non ci
+    // sono spazi iniziali e finali, se c'e` uno spazio prima dei due-punti
+    // significa che non c'e` un'etichetta.
+    string::size_type pos_label = str.find(':');
+    string::size_type pos_space = str.find(' ');
+    bool etichetta = false;
+    char nf[16];
+    if(pos_label != string::npos &&
+        (pos_space == string::npos || pos_label < pos_space)) {
+      // c'e` un'etichetta
+      etichetta = true;
+      sprintf(nf, "_%d", functions);
+      str.insert(pos_label, nf);
+    }
+    string::size_type pos_istr = 0;
+    if(etichetta) {
+      pos_label = str.find(':');
+      ++pos_label;
+      while(str[pos_label] == ' ')
+        ++pos_label;
+      pos_istr = pos_label;
+    }
+    string::size_type pos_arg = str.find(' ',pos_istr);
+    // le istruzioni di salto iniziano tutte con "goto" o "if": le altre
+    // vengono scartate senza confrontare il nome
+    if(pos_arg != string::npos && (str.compare(pos_istr, 2, "if") == 0 ||
+          str.compare(pos_istr, 4, "goto") == 0)) {
+      string istruzione;
+      istruzione = str.substr(pos_istr,pos_arg-pos_istr);
+      // istruzioni che hanno come argomento una etichetta
+      if( istruzione == "goto" ||
+          istruzione == "if_icmpeq" ||
+          istruzione == "if_icmpge" ||
+          istruzione == "if_icmpgt" ||
+          istruzione == "if_icmple" ||
+          istruzione == "if_icmplt" ||
+          istruzione == "if_icmpne" ||
+          istruzione == "ifeq" ||
+          istruzione == "ifge" ||
+          istruzione == "ifgt" ||
+          istruzione == "ifle" ||
+          istruzione == "iflt" ||
+          istruzione == "ifne"
+        ) {
+        // sostituisce l'etichetta: siccome queste istruzioni hanno come
+        // argomento solo l'etichetta, e non ci sono spazi finali, allora si
+        // aggiunge il numero alla ifne dell'istruzione
+        sprintf(nf, "_%d", functions);
+        str.insert(str.size(), nf);
+      }
+    }
+  } // end if(!str.empty())
+  return;
+} // end of method check_label(string& str) const
+
+
+/* void add_directive(const string& directive) ********************************/
+void
+ProgramImage::add_directive(const string& directive) {
+  if(directive.substr(0,22) == ".method public static ") {
+    // Dichiarazione funzione
+    program.add_instruction(directive);
+    ++functions;
+  }
+  else if(directive == ".end method") {
+    // Fine funzione
+    program.add_instruction(directive);
+  }
+  else if(directive.substr(0,7) == ".limit ") {
+    // Variabili locali o stack degli operandi della funzione
+    program.add_instruction(directive);
+  }
+  else if(directive.substr(0,21) == ".field public static ") {
+    // Variabile globale
+    add_global(directive);
+  }
+  else if(directive == ".class public Main") {
+    // Prima direttiva d'inizio del programma
+  }
+  else if(directive == ".super java/lang/Object") {
+    // Seconda direttiva d'inizio del programma
+  }
+  else if(directive == ".end class") {
+    // Fine del programma
+  }
+  else{
+    throw string("direttiva sconosciuta: " + directive);
+  }
+  return;
+} // end of method add_directive(const string& directive)
+
+
+/* void add_global(const string& directive) ***********************************/
+void
+ProgramImage::add_global(const string& directive) {
+  string fieldname, descriptor;
+  // ricava il nome della variabile
+  string::size_type pos_name = directive.find(' ', 21);
+  if(pos_name != string::npos) {
+    fieldname = directive.substr(21,pos_name-21);
+    // ricava il nome del descrittore
+    descriptor = directive.substr(pos_name+1);
+    if(descriptor == "S")
+      globals.add_variable_S(fieldname);
+    else if(descriptor == "C")
+      globals.add_variable_C(fieldname);
+    else if(descriptor == "I")
+      globals.add_variable_I(fieldname);
+    else if(descriptor == "J")
+      globals.add_variable_J(fieldname);
+    else {
+      throw string("tipo sconosciuto nella variabile globale: " + directive);
+    }
+  } // end if(pos_name != string::npos)
+  else {
+    throw string("manca il tipo nella variabile globale: " + directive);
+  }
+  return;
+} // end of method add_global(const string& directive)
+
+
+/*!
+  \fn bool bytecode_aggiornato(const string& sorgente, const string& bytecode)
+  \brief Controlla se il file bytecode e` piu` recente del sorgente
+  \param sorgente nome del file sorgente
+  \param bytecode nome del file bytecode
+  \return <tt>true</tt>: il file bytecode esiste ed e` stato modificato dopo
+  il sorgente
+  \return <tt>false</tt>: altrimenti
+*/
+bool bytecode_aggiornato(const string& sorgente, const string& bytecode) {
+  struct stat stat_sorgente, stat_bytecode;
+  if(stat(sorgente.c_str(), &stat_sorgente) != 0 ||
+      stat(bytecode.c_str(), &stat_bytecode) != 0)
+    return false;
+  if(stat_bytecode.st_mtim.tv_sec != stat_sorgente.st_mtim.tv_sec)
+    return stat_bytecode.st_mtim.tv_sec > stat_sorgente.st_mtim.tv_sec;
+  return stat_bytecode.st_mtim.tv_nsec > stat_sorgente.st_mtim.tv_nsec;
+}
+
+
+/*!
+  \fn bool leggi_istruzione(const char*& pos, const char* fine, string& str)
+  \brief Legge le istruzioni da file e le mette in str
+  \param pos posizione nel contenuto del file da cui leggere, alla fine
+  posizione successiva all'istruzione letta
+  \param fine fine del contenuto del file
+  \param str stringa in cui mettere le istruzioni lette
+  \return <tt>false</tt>: errore di lettura o fine del file
+  \return <tt>true</tt>: letta e inserita una istruzione in <tt>str</tt> 
+
+  Legge le istruzioni dal contenuto del file, a partire da <tt>pos</tt>, e le
+  inserisce nella stringa <tt>str</tt> (senza cambiarne la capacita`, cosi`
+  che riutilizzando la stessa stringa non servano allocazioni per ogni
+  riga).\\
+  Ogni istruzione dev'essere separata da un "a-capo". Da ogni istruzione vengono
+  eliminati gli "spazi inutili", ovvero gli spazi iniziali e finali e gli spazi
+  doppi (lasciando ovviamente inalterate le stringhe all'interno delle 
+  istruzioni).\\ 
+  Se si vuole cambiare il metodo di lettura delle istruzioni (ad esempio si 
+  vuole permettere che stiano tutte su una riga, separate da spazi) e` 
+  sufficente modificare solo questa funzione.
+*/
+bool leggi_istruzione(const char*& pos, const char* fine, string& str) {
+  // azzera str
+  str.clear();
+
+  char ch; // carattere letto da file
+  bool istr_stringa = false; // dentro o fuori a una stringa nell'istruzione
+
+  // legge l'istruzione da file
+  while(pos != fine) {
+    // copia in una sola volta i caratteri che non richiedono controlli
+    const char* inizio = pos;
+    while(pos != fine && *pos != ' ' && *pos != '\t' && *pos != '"' &&
+        *pos != '\n')
+      ++pos;
+    if(pos != inizio) {
+      str.append(inizio, pos - inizio);
+      continue;
+    }
+    ch = *pos++;
+    if(!istr_stringa && ch == '\t') {
+      // sostituisce le tabulazioni con spazi
+      ch = ' ';
+    }
+    if(ch == ' ') {
+      // spazio: elimina gli spazi inutili
+      if(!str.empty() && !istr_stringa && str[str.size()-1]==' ')
+        str.erase(str.size()-1);
+    }
+    else if(ch == '"') {
+      // virgolette: valuta se nell'istruzione vi e` una stringa
+      if(istr_stringa && str[str.size()-1]=='\\') {
+        // dentro una stringa c'e` la sequenza \"
+        // allora si rimane all'interno della stringa (istr_stringa=true)
+      }
+      else {
+        // dentro o fuori una stringa dell'istruzione
+        istr_stringa?istr_stringa=false:istr_stringa=true;
+      }
+    }
+    else if(ch == '\n') {
+      // a-capo: se e` fuori da una stringa e` la fine dell'istruzione
+      if(!istr_stringa) {
+        // fine istruzione
+        elimina_spazi_iniziali_e_finali(str);
+        return true;
+      }
+    } // end else if(ch=='\n')
+    // inserisce il carattere letto nella stringa
+    str.push_back(ch);
+  } // end while(pos != fine)
+
+  // fine del file
+  return false;
+} // end leggi_istruzione(const char*&, const char*, string&)
+
+
+/*!
+  \fn void pulisci_stringa(string& str)
+  \brief Elimina gli spazi inutili alla stringa passata
+  \param str stringa da "ripulire"
+
+  Elimina gli spazi iniziali e finali (trim) dalla stringa <tt>str</tt> e
+  rimuove tutti gli spazi consecutivi all'interno della stringa lasciando solo
+  spazi singoli.
+*/
+void pulisci_stringa(string& str) {
+  // eliminazione spazi iniziali e finali (trim)
+  elimina_spazi_iniziali_e_finali(str);
+  // eliminazione spazi doppi
+  string::size_type pos = str.find("  ");
+  while(pos != string::npos) {
+    str.erase(pos, 1);
+    pos = str.find("  ", pos);
+  }
+  return;
+} // end pulisci_stringa(string& str)
+
+
+/*!
+  \fn void elimina_spazi_iniziali_e_finali(string& str)
+  \brief Elimina gli spazi iniziali e finali nella stringa (trim)
+  \param str stringa da "ripulire"
+
+  Elimina gli spazi iniziali e finali dalla stringa <tt>str</tt> (funzione 
+  trim).
+*/
+void elimina_spazi_iniziali_e_finali(string& str) {
+  string::size_type pos = str.find_last_not_of(' ');
+  if(pos != string::npos) {
+    str.erase(pos + 1);
+    pos = str.find_first_not_of(' ');
+    if(pos != string::npos) str.erase(0, pos);
+  }
+  else {
+    str.erase(str.begin(), str.end());
+  }
+  return;
+}
+
+
+/*!
+  \fn void cancella_carattere(string& str, char c)
+  \brief Elimina tutte le occorrenze del carattere passato dalla stringa
+  \param str stringa da "ripulire"
+  \param c carattere da eliminare dalla stringa
+
+  Elimina dalla stringa <tt>str</tt> tutte le occorrenze del carattere passato
+  <tt>c</tt>, di default ' ' (spazio bianco).
+*/
+void cancella_carattere(string& str, char c) {
+  string::size_type pos = str.find(c);
+  while(pos != string::npos) {
+    str.erase(pos, 1);
+    pos = str.find(c, pos);
+  }
+  return;
+}
+
+
+#endif // PROGRAMIMAGE_CC_INCLUSION_GUARD
@@ -0,0 +1,181 @@
+/*!
+  \file ProgramImage.h
+  \brief Interfaccia di ProgramImage
+  \author Andrea Zanelli
+  \date 17-10-2026
+*/
+
+#ifndef PROGRAMIMAGE_H_INCLUSION_GUARD
+#define PROGRAMIMAGE_H_INCLUSION_GUARD
+
+#include <string>
+
+#include "GlobalVariablesArea.h"
+#include "MappedFile.h"
+#include "ProgramArea.h"
+#include "RegisterCode.h"
+
+using std::string;
+
+
+/*!
+  \class ProgramImage
+  \brief Programma caricato, condivisibile tra piu` macchine astratte
+
+  Contiene tutto cio` che durante l'esecuzione viene solo letto: l'area del
+  programma (istruzioni decodificate, pool delle costanti stringa, tabella
+  delle funzioni ed etichette), le variabili globali con il loro valore
+  iniziale e, se le funzioni sono state tradotte, il codice a registri.
+  load() carica il programma (sorgente o file bytecode); le preparazioni
+  successive (traduzione nel codice a registri, verifica dei tipi e
+  superistruzioni) si fanno sugli oggetti pubblici prima di iniziare a
+  eseguire.\\
+  Una volta preparata l'immagine non cambia piu`: viene condivisa tramite
+  uno <tt>std::shared_ptr<const ProgramImage></tt> da tutte le macchine
+  che la eseguono (vedi Machine), anche contemporaneamente in thread
+  diversi, senza copiarla; ogni macchina ha solo il suo stato (variabili
+  globali, stack di sistema, uscita e ingresso). L'immagine viene
+  deallocata, e il file bytecode eventualmente mappato viene chiuso, quando
+  termina l'ultima macchina che la usa.
+*/
+class ProgramImage {
+
+  public:
+    /* VARIABILI PUBBLICHE */
+
+    //! insieme delle istruzioni da eseguire, suddivise per funzione
+    ProgramArea program;
+
+    //! variabili globali del programma, con il loro valore iniziale
+    GlobalVariablesArea globals;
+
+    //! codice a registri delle funzioni tradotte (vuoto se non usato)
+    RegisterCode registers;
+
+    /* METODI PUBBLICI */
+
+    /**
+     * Costruttore di default: immagine senza programma.
+     */
+    ProgramImage();
+
+    /**
+     * Carica il programma dal file <tt>name</tt>, sorgente o bytecode. Se
+     * accanto al file c'e` un file bytecode (vedi bytecode_name()) piu`
+     * recente, carica quest'ultimo al posto del sorgente; se questo non e`
+     * valido (ad esempio perche` scritto da una versione diversa della
+     * macchina astratta) viene segnalato sullo standard error e si usa il
+     * sorgente. Altrimenti il file viene letto una sola volta (cosi`
+     * funziona anche con una pipe) e, in base al suo contenuto, viene
+     * caricato come file bytecode o come sorgente, che viene collegato. In
+     * caso di errore lancia un'eccezione di tipo std::string con la
+     * descrizione dell'errore.
+     */
+    void load(const string& name);
+
+    /**
+     * Carica il programma dai <tt>size</tt> byte in <tt>data</tt>, che
+     * contengono un sorgente (che viene collegato) oppure un file bytecode,
+     * come load(). I dati vengono copiati, percio` possono essere
+     * deallocati subito dopo; la copia di un file bytecode resta
+     * nell'immagine, che ne usa direttamente l'array delle istruzioni. In
+     * caso di errore lancia un'eccezione di tipo std::string con la
+     * descrizione dell'errore.
+     */
+    void load_data(const char* data, const size_t& size);
+
+    /**
+     * Carica e collega il programma dal file sorgente <tt>name</tt>, senza
+     * cercare il file bytecode. In caso di errore lancia un'eccezione di
+     * tipo std::string con la descrizione dell'errore.
+     */
+    void load_source(const string& name);
+
+    /**
+     * Scrive il programma caricato nel file bytecode <tt>name</tt>:
+     * l'intestazione, le variabili globali e il programma gia` collegato. In
+     * caso di errore lancia un'eccezione di tipo std::string con la
+     * descrizione dell'errore.
+     */
+    void write_bytecode(const string& name) const;
+
+    /**
+     * Restituisce il nome del file bytecode del sorgente <tt>source</tt>:
+     * l'estensione ".j" sostituita da ".jbc" (o ".jbc" aggiunto se il
+     * sorgente non ha estensione ".j").
+     */
+    static string bytecode_name(const string& source);
+
+  private:
+    /* VARIABILI PRIVATE */
+
+    //! file del programma mappato in memoria durante il caricamento (e,
+    //! per un file bytecode, finche` esiste l'immagine: vedi
+    //! read_bytecode())
+    MappedFile file;
+
+    //! copia del programma caricato con load_data() (per un file bytecode,
+    //! finche` esiste l'immagine)
+    string contents;
+
+    //! numero di funzioni trovate nel sorgente durante la lettura
+    unsigned int functions;
+
+    /* METODI PRIVATI */
+
+    // l'immagine non puo` essere copiata
+    ProgramImage(const ProgramImage&);
+    ProgramImage& operator=(const ProgramImage&);
+
+    /**
+     * Legge e collega il programma dal sorgente in <tt>file</tt>, poi
+     * chiude il file (il testo non serve piu`).
+     */
+    void read_source();
+
+    /**
+     * Legge il programma dai <tt>size</tt> byte del file bytecode in
+     * <tt>data</tt> (di nome <tt>name</tt>, per i messaggi di errore): dopo
+     * l'intestazione, le variabili globali e il programma gia` decodificato
+     * e collegato. L'array delle istruzioni viene usato direttamente da
+     * <tt>data</tt> (il file mappato o <tt>contents</tt>), senza copiarlo,
+     * percio` i dati restano finche` esiste l'immagine.
+     */
+    void read_bytecode(const char* data, const size_t& size,
+        const string& name);
+
+    /**
+     * Restituisce true se i <tt>size</tt> byte in <tt>data</tt> iniziano
+     * con l'identificativo dei file bytecode.
+     */
+    static bool is_bytecode(const char* data, const size_t& size);
+
+    /**
+     * Legge le istruzioni e le direttive del sorgente tra <tt>begin</tt> e
+     * <tt>end</tt> e le mette in <tt>program</tt> e <tt>globals</tt>.
+     */
+    void read_text(const char* begin, const char* end);
+
+    /**
+     * Se nell'istruzione <tt>str</tt> c'e` un'etichetta la rende unica nel
+     * programma, aggiungendoci il numero della funzione che la contiene.
+     */
+    void check_label(string& str) const;
+
+    /**
+     * Esegue l'operazione della direttiva <tt>directive</tt>: inizio e fine
+     * delle funzioni, .limit, variabili globali (.field) e le direttive
+     * della classe Main.
+     */
+    void add_directive(const string& directive);
+
+    /**
+     * Aggiunge a <tt>globals</tt> la variabile globale della direttiva
+     * <tt>.field public static <em>fieldname</em> <em>descriptor</em></tt>.
+     */
+    void add_global(const string& directive);
+
+};
+
+
+#endif // PROGRAMIMAGE_H_INCLUSION_GUARD
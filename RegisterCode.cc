@@ -0,0 +1,826 @@
+/*!
+  \file RegisterCode.cc
+  \brief Implementazione di RegisterCode
+  \author Andrea Zanelli
+  \date 17-10-2026
+*/
+
+#ifndef REGISTERCODE_CC_INCLUSION_GUARD
+#define REGISTERCODE_CC_INCLUSION_GUARD
+
+#include <algorithm>
+#include <stdio.h>
+
+#include "NativeMethod.h"
+#include "RegisterCode.h"
+#include "Slot.h"
+#include "SystemStack.h"
+#include "Verifier.h"
+
+
+// Tipo di uno Slot calcolato dalla verifica (vedi Verifier)
+typedef Verifier::Type Tipo;
+static const Tipo RIF = Verifier::REF;
+static const Tipo SCONOSCIUTO = Verifier::UNKNOWN;
+
+// Elemento dello stack degli operandi simulato durante la traduzione: un
+// registro (variabile locale o posizione dello stack), una costante intera,
+// una stringa costante o un riferimento "finto" (System.out, System.in)
+struct Voce {
+  char tipo;         // 'I', 'J' o 'L'
+  char genere;       // 'R' registro, 'K' costante, 'S' stringa, 'N' finto
+  bool locale;       // il registro e` una variabile locale
+  uint16_t reg;      // registro
+  uint16_t ref_type; // tipo del riferimento
+  int64_t value;     // costante, o indice della stringa costante
+  unsigned int pos;  // posizione sullo stack degli operandi
+};
+
+
+/*!
+  \class Traduzione
+  \brief Traduzione di una funzione in codice a registri (vedi RegisterCode)
+*/
+class Traduzione {
+
+  public:
+    Traduzione(const ProgramArea& program, const Function& function,
+        vector<RegisterInstruction>& code);
+
+    // simula e traduce la funzione; se non puo` essere tradotta restituisce
+    // false e mette in motivo la spiegazione
+    bool esegui(string& motivo);
+
+  private:
+    const ProgramArea& programma;
+    const Function& funzione;
+    const Instruction* istruzioni;
+    vector<RegisterInstruction>& codice;
+
+    // verifica della funzione: tipi all'inizio di ogni istruzione
+    Verifier verifica;
+
+    // stack degli operandi simulato e sua dimensione in Slot
+    vector<Voce> pila;
+    unsigned int dimensione;
+    // indice dell'ultima istruzione che ha scritto il risultato in cima
+    // alla pila (-1 se non c'e`)
+    long ultima;
+    // indice nel codice a registri di ogni istruzione e salti da completare
+    vector<unsigned int> indici;
+    vector<unsigned int> salti;
+
+    // false, con la spiegazione in motivo, se una istruzione raggiungibile
+    // non ha un equivalente nel codice a registri
+    bool supportata(string& motivo) const;
+
+    /* traduzione */
+    bool traduci(string& motivo);
+    void traduci_istruzione(const unsigned int& i);
+    void traduci_nativo(const uint32_t& indice);
+    uint16_t temporaneo(const unsigned int& pos) const;
+    unsigned int emetti(const uint16_t& opcode, const uint16_t& dst,
+        const uint16_t& a = 0, const uint16_t& b = 0,
+        const uint32_t& index = 0, const int64_t& value = 0);
+    void metti_risultato(const char& tipo, const unsigned int& pos);
+    void metti(const Voce& voce);
+    Voce togli();
+    void materializza(Voce& voce);
+    uint16_t registro(Voce& voce);
+    void scarica();
+    void invalida_locale(const uint16_t& n);
+    void memorizza(const unsigned int& i, const char& tipo);
+    void binaria(const uint16_t& op, const uint16_t& op_k, const bool& comm);
+    void binaria_long(const uint16_t& op);
+    void unaria(const uint16_t& op, const char& tipo);
+    void salto_condizionato(const uint16_t& op, const bool& con_zero,
+        const uint32_t& destinazione);
+
+};
+
+
+// confronto con gli operandi scambiati (b OP a diventa a OP' b)
+static uint16_t confronto_inverso(const uint16_t& op) {
+  switch(op) {
+    case R_IF_ICMPGE_K: return R_IF_ICMPLE_K;
+    case R_IF_ICMPGT_K: return R_IF_ICMPLT_K;
+    case R_IF_ICMPLE_K: return R_IF_ICMPGE_K;
+    case R_IF_ICMPLT_K: return R_IF_ICMPGT_K;
+  }
+  return op;
+}
+
+
+// metodo nativo registrato che il codice a registri puo` chiamare: statico,
+// con parametri e valore restituito int o long
+static bool nativo_supportato(const NativeMethod& metodo) {
+  if(!metodo.is_static)
+    return false;
+  for(vector<uint16_t>::size_type k = 0; k < metodo.arguments.size(); ++k) {
+    if(metodo.arguments[k] != 'I' && !Verifier::is_long_part(
+          metodo.arguments[k]))
+      return false;
+  }
+  for(vector<uint16_t>::size_type k = 0; k < metodo.result.size(); ++k) {
+    if(metodo.result[k] != 'I' && !Verifier::is_long_part(metodo.result[k]))
+      return false;
+  }
+  return true;
+}
+
+
+/* RegisterCode() *************************************************************/
+RegisterCode::RegisterCode()
+  : compiled(false) {
+}
+
+
+/* void compile(ProgramArea& program) *****************************************/
+void
+RegisterCode::compile(ProgramArea& program) {
+  if(compiled)
+    return;
+  compiled = true;
+  const unsigned int base = program.get_instructions_size();
+  for(unsigned int f = 0; f < program.get_functions_size(); ++f) {
+    const Function& funzione = program.get_function(f);
+    const vector<RegisterInstruction>::size_type inizio = code.size();
+    string motivo;
+    Traduzione traduzione(program, funzione, code);
+    report += funzione.name + ": ";
+    if(traduzione.esegui(motivo)) {
+      char numero[48];
+      sprintf(numero, "%u istruzioni -> %u\n", funzione.end - funzione.start
+          + 1, static_cast<unsigned int>(code.size() - inizio));
+      report += numero;
+      program.set_function_entry(f, base + inizio);
+      function_start.push_back(inizio);
+      function_end.push_back(code.size());
+      function_index.push_back(f);
+    }
+    else {
+      code.resize(inizio);
+      report += "non tradotta (" + motivo + ")\n";
+    }
+  }
+  return;
+}
+
+
+/* const RegisterInstruction* get_code() const ********************************/
+const RegisterInstruction*
+RegisterCode::get_code() const {
+  return code.empty() ? 0 : &code[0];
+}
+
+
+/* unsigned int get_size() const **********************************************/
+unsigned int
+RegisterCode::get_size() const {
+  return static_cast<unsigned int>(code.size());
+}
+
+
+/* string get_report() const **************************************************/
+string
+RegisterCode::get_report() const {
+  return report;
+}
+
+
+/* unsigned int get_functions_size() const ************************************/
+unsigned int
+RegisterCode::get_functions_size() const {
+  return static_cast<unsigned int>(function_start.size());
+}
+
+
+/* unsigned int get_function_start(const unsigned int& k) const ***************/
+unsigned int
+RegisterCode::get_function_start(const unsigned int& k) const {
+  return function_start[k];
+}
+
+
+/* unsigned int get_function_end(const unsigned int& k) const *****************/
+unsigned int
+RegisterCode::get_function_end(const unsigned int& k) const {
+  return function_end[k];
+}
+
+
+/* uint32_t get_function_index(const unsigned int& k) const *******************/
+uint32_t
+RegisterCode::get_function_index(const unsigned int& k) const {
+  return function_index[k];
+}
+
+
+/* unsigned int find_function(const unsigned int& index) const ****************/
+unsigned int
+RegisterCode::find_function(const unsigned int& index) const {
+  // le funzioni tradotte sono in ordine di inizio
+  vector<unsigned int>::const_iterator i = std::upper_bound(
+      function_start.begin(), function_start.end(), index);
+  if(i == function_start.begin() || index >= function_end[i -
+      function_start.begin() - 1])
+    throw string("l'istruzione richiesta e` fuori dal codice a registri");
+  return static_cast<unsigned int>(i - function_start.begin() - 1);
+}
+
+
+/* Traduzione(...) ************************************************************/
+Traduzione::Traduzione(const ProgramArea& program, const Function& function,
+    vector<RegisterInstruction>& code)
+  : programma(program), funzione(function), istruzioni(program.get_code()),
+    codice(code), verifica(program, function), dimensione(0), ultima(-1) {
+}
+
+
+/* bool esegui(string& motivo) ************************************************/
+bool
+Traduzione::esegui(string& motivo) {
+  return verifica.verify(motivo) && supportata(motivo) && traduci(motivo);
+}
+
+
+/* bool supportata(string& motivo) const **************************************/
+bool
+Traduzione::supportata(string& motivo) const {
+  for(unsigned int i = 0; i < funzione.end - funzione.start + 1; ++i) {
+    if(!verifica.get_state(i).reached)
+      continue;
+    const Instruction& istr = istruzioni[funzione.start + i];
+    if((istr.opcode == OP_INVOKESTATIC && (istr.index == INTR_PARSE_INT ||
+        istr.index == INTR_PARSE_LONG)) ||
+        (istr.opcode == OP_INVOKEVIRTUAL && (istr.index == INTR_READ ||
+        istr.index == INTR_READLINE))) {
+      motivo = "lettura dallo standard input";
+      return false;
+    }
+    if((istr.opcode == OP_INVOKESTATIC || istr.opcode == OP_INVOKEVIRTUAL) &&
+        istr.type == 'N' && istr.index >= INTR_NUMERO &&
+        !nativo_supportato(native_method(istr.index))) {
+      motivo = "metodo nativo " + native_method(istr.index).name;
+      return false;
+    }
+    if(istr.opcode == OP_NEW || istr.opcode == OP_INVOKESPECIAL) {
+      motivo = string("istruzione ") + opcode_name(istr.opcode);
+      return false;
+    }
+    // R_RETURN, R_IRETURN e R_LRETURN non controllano il tipo restituito:
+    // dev'essere quello dichiarato (gia` controllato dalla verifica), su cui
+    // il chiamante fa affidamento
+    const char ritorno = (istr.opcode == OP_IRETURN) ? 'I' :
+      (istr.opcode == OP_LRETURN) ? 'J' : 'V';
+    if((istr.opcode == OP_RETURN || istr.opcode == OP_IRETURN ||
+        istr.opcode == OP_LRETURN) && ritorno != funzione.return_type) {
+      motivo = string(opcode_name(istr.opcode)) +
+        " diverso dal tipo di ritorno";
+      return false;
+    }
+  }
+  return true;
+}
+
+
+/* bool traduci(string& motivo) ***********************************************/
+bool
+Traduzione::traduci(string& motivo) {
+  const unsigned int n = funzione.end - funzione.start + 1;
+  // i registri delle posizioni dello stack devono avere un indice a 16 bit
+  const unsigned int max_stack = verifica.get_max_stack();
+  if(funzione.locals + SystemStack::HEADER_SLOTS + max_stack + 2 > 0xFFFFu) {
+    motivo = "troppe variabili locali";
+    return false;
+  }
+  indici.assign(n, 0);
+  emetti(R_ENTER, 0, 0, 0, 0, max_stack + 2);
+  bool raggiungibile = true;
+  for(unsigned int i = 0; i < n; ++i) {
+    if(!verifica.get_state(i).reached) {
+      raggiungibile = false;
+      continue;
+    }
+    if(verifica.is_target(i) || !raggiungibile || i == 0) {
+      // inizio di un blocco: i valori passano dallo stack degli operandi
+      if(raggiungibile)
+        scarica();
+      pila.clear();
+      dimensione = 0;
+      const vector<Tipo>& tipi = verifica.get_state(i).stack;
+      for(vector<Tipo>::size_type k = 0; k < tipi.size(); ++k) {
+        if(tipi[k] == '$')
+          continue;
+        Voce voce;
+        voce.tipo = (tipi[k] >= RIF) ? 'L' : static_cast<char>(tipi[k]);
+        voce.genere = 'R';
+        voce.locale = false;
+        voce.reg = temporaneo(k);
+        voce.ref_type = (tipi[k] >= RIF) ? tipi[k] - RIF : 0;
+        voce.value = 0;
+        metti(voce);
+      }
+      ultima = -1;
+    }
+    indici[i] = codice.size();
+    traduci_istruzione(i);
+    const uint16_t op = istruzioni[funzione.start + i].opcode;
+    raggiungibile = op != OP_GOTO && op != OP_RETURN && op != OP_IRETURN &&
+      op != OP_LRETURN;
+  }
+  // destinazione dei salti
+  for(vector<unsigned int>::size_type k = 0; k < salti.size(); ++k) {
+    RegisterInstruction& salto = codice[salti[k]];
+    salto.index = indici[salto.index - funzione.start];
+  }
+  return true;
+}
+
+
+/* void traduci_istruzione(const unsigned int& i) *****************************/
+void
+Traduzione::traduci_istruzione(const unsigned int& i) {
+  const Instruction& istr = istruzioni[funzione.start + i];
+  Voce voce;
+  voce.locale = false;
+  voce.reg = 0;
+  voce.ref_type = 0;
+  voce.value = 0;
+  switch(istr.opcode) {
+    case OP_NOP:
+      break;
+    case OP_LDC_W:
+      if(istr.type == 'L') {
+        voce.tipo = 'L';
+        voce.genere = 'S';
+        voce.ref_type = REF_STRING;
+        voce.value = istr.index;
+      }
+      else {
+        voce.tipo = 'I';
+        voce.genere = 'K';
+        voce.value = static_cast<int32_t>(istr.value);
+      }
+      metti(voce);
+      break;
+    case OP_LDC2_W:
+    case OP_SIPUSH:
+      voce.tipo = (istr.opcode == OP_LDC2_W) ? 'J' : 'I';
+      voce.genere = 'K';
+      voce.value = (voce.tipo == 'I') ? static_cast<int32_t>(istr.value)
+                                      : istr.value;
+      metti(voce);
+      break;
+    case OP_ILOAD:
+    case OP_LLOAD:
+      voce.tipo = (istr.opcode == OP_ILOAD) ? 'I' : 'J';
+      voce.genere = 'R';
+      voce.locale = true;
+      voce.reg = static_cast<uint16_t>(istr.index);
+      metti(voce);
+      break;
+    case OP_ISTORE:
+      memorizza(i, 'I');
+      break;
+    case OP_LSTORE:
+      memorizza(i, 'J');
+      break;
+    case OP_GOTO:
+      scarica();
+      salti.push_back(emetti(R_GOTO, 0, 0, 0, istr.index));
+      break;
+    case OP_IF_ICMPEQ: salto_condizionato(R_IF_ICMPEQ, false, istr.index); break;
+    case OP_IF_ICMPGE: salto_condizionato(R_IF_ICMPGE, false, istr.index); break;
+    case OP_IF_ICMPGT: salto_condizionato(R_IF_ICMPGT, false, istr.index); break;
+    case OP_IF_ICMPLE: salto_condizionato(R_IF_ICMPLE, false, istr.index); break;
+    case OP_IF_ICMPLT: salto_condizionato(R_IF_ICMPLT, false, istr.index); break;
+    case OP_IF_ICMPNE: salto_condizionato(R_IF_ICMPNE, false, istr.index); break;
+    case OP_IFEQ: salto_condizionato(R_IF_ICMPEQ, true, istr.index); break;
+    case OP_IFGE: salto_condizionato(R_IF_ICMPGE, true, istr.index); break;
+    case OP_IFGT: salto_condizionato(R_IF_ICMPGT, true, istr.index); break;
+    case OP_IFLE: salto_condizionato(R_IF_ICMPLE, true, istr.index); break;
+    case OP_IFLT: salto_condizionato(R_IF_ICMPLT, true, istr.index); break;
+    case OP_IFNE: salto_condizionato(R_IF_ICMPNE, true, istr.index); break;
+    case OP_IADD: binaria(R_IADD, R_IADD_K, true); break;
+    case OP_ISUB: binaria(R_ISUB, R_ISUB_K, false); break;
+    case OP_IMUL: binaria(R_IMUL, R_IMUL_K, true); break;
+    case OP_IDIV: binaria(R_IDIV, R_IDIV_K, false); break;
+    case OP_IREM: binaria(R_IREM, R_IREM_K, false); break;
+    case OP_ISHL: binaria(R_ISHL, R_ISHL_K, false); break;
+    case OP_ISHR: binaria(R_ISHR, R_ISHR_K, false); break;
+    case OP_LADD: binaria_long(R_LADD); break;
+    case OP_LSUB: binaria_long(R_LSUB); break;
+    case OP_LMUL: binaria_long(R_LMUL); break;
+    case OP_LDIV: binaria_long(R_LDIV); break;
+    case OP_LREM: binaria_long(R_LREM); break;
+    case OP_LSHL: binaria_long(R_LSHL); break;
+    case OP_LSHR: binaria_long(R_LSHR); break;
+    case OP_LCMP: binaria_long(R_LCMP); break;
+    case OP_INEG: unaria(R_INEG, 'I'); break;
+    case OP_I2C: unaria(R_I2C, 'I'); break;
+    case OP_I2S: unaria(R_I2S, 'I'); break;
+    case OP_I2L: unaria(R_I2L, 'J'); break;
+    case OP_L2I: unaria(R_L2I, 'I'); break;
+    case OP_LNEG: unaria(R_LNEG, 'J'); break;
+    case OP_GETSTATIC:
+      if(istr.type == 'L') {
+        voce.tipo = 'L';
+        voce.genere = 'N';
+        voce.ref_type = static_cast<uint16_t>(istr.index);
+        metti(voce);
+      }
+      else {
+        emetti(istr.type == 'J' ? R_GETSTATIC_J : R_GETSTATIC_I,
+            temporaneo(dimensione), 0, 0, istr.index);
+        metti_risultato(istr.type == 'J' ? 'J' : 'I', dimensione);
+      }
+      break;
+    case OP_PUTSTATIC: {
+      const uint16_t reg = registro(pila.back());
+      togli();
+      uint16_t op = R_PUTSTATIC_I;
+      if(istr.type == 'J')
+        op = R_PUTSTATIC_J;
+      else if(istr.type == 'S')
+        op = R_PUTSTATIC_S;
+      else if(istr.type == 'C')
+        op = R_PUTSTATIC_C;
+      emetti(op, 0, reg, 0, istr.index);
+      break;
+    }
+    case OP_INVOKESTATIC: {
+      if(istr.type == 'N') {
+        if(istr.index != INTR_NESSUNO)
+          traduci_nativo(istr.index);
+        break;
+      }
+      // i parametri devono essere sullo stack degli operandi
+      const Function& chiamata = programma.get_function(istr.index);
+      const unsigned int prima = dimensione;
+      unsigned int argomenti = 0;
+      for(vector<Voce>::size_type k = pila.size(); argomenti <
+          chiamata.arguments.size(); --k) {
+        materializza(pila[k - 1]);
+        argomenti += (pila[k - 1].tipo == 'J') ? 2 : 1;
+      }
+      while(dimensione > prima - argomenti)
+        togli();
+      emetti(R_CALL, static_cast<uint16_t>(prima), 0, 0, istr.index);
+      if(chiamata.return_type != 'V') {
+        voce.tipo = chiamata.return_type;
+        voce.genere = 'R';
+        voce.reg = temporaneo(dimensione);
+        metti(voce);
+      }
+      break;
+    }
+    case OP_RETURN:
+      emetti(R_RETURN, 0);
+      break;
+    case OP_IRETURN:
+    case OP_LRETURN:
+      emetti(istr.opcode == OP_IRETURN ? R_IRETURN : R_LRETURN, 0,
+          registro(pila.back()));
+      break;
+    case OP_DUP:
+    case OP_DUP2:
+      // la copia usa lo stesso registro (che ha indice minore o uguale)
+      voce = pila.back();
+      metti(voce);
+      break;
+    case OP_POP:
+    case OP_POP2:
+      togli();
+      break;
+    case OP_SWAP: {
+      Voce& alto = pila[pila.size() - 1];
+      Voce& basso = pila[pila.size() - 2];
+      if((alto.genere == 'R' && !alto.locale) ||
+          (basso.genere == 'R' && !basso.locale)) {
+        // i valori devono scambiarsi di posizione sullo stack
+        materializza(alto);
+        materializza(basso);
+        emetti(R_SWAP, basso.reg, alto.reg);
+      }
+      else {
+        // variabili locali e costanti: basta scambiare gli elementi
+        Voce a = togli();
+        Voce b = togli();
+        metti(a);
+        metti(b);
+      }
+      break;
+    }
+    case OP_INVOKEVIRTUAL: {
+      if(istr.index == INTR_NESSUNO)
+        break;
+      if(istr.index == INTR_PRINT_STRING && pila.back().genere == 'S') {
+        Voce stringa = togli();
+        togli();
+        emetti(R_PRINT_CONST, 0, 0, 0, static_cast<uint32_t>(stringa.value));
+        break;
+      }
+      const uint16_t reg = registro(pila.back());
+      togli();
+      togli();
+      uint16_t op = R_PRINT_STR;
+      if(istr.index == INTR_PRINT_INT)
+        op = R_PRINT_I;
+      else if(istr.index == INTR_PRINT_CHAR)
+        op = R_PRINT_C;
+      else if(istr.index == INTR_PRINT_LONG)
+        op = R_PRINT_J;
+      emetti(op, 0, reg);
+      break;
+    }
+  }
+  return;
+} // end of method traduci_istruzione(const unsigned int& i)
+
+
+/* void traduci_nativo(const uint32_t& indice) ********************************/
+void
+Traduzione::traduci_nativo(const uint32_t& indice) {
+  // come R_CALL: i parametri devono essere sullo stack degli operandi
+  const NativeMethod& metodo = native_method(indice);
+  const unsigned int prima = dimensione;
+  unsigned int argomenti = 0;
+  for(vector<Voce>::size_type k = pila.size(); argomenti <
+      metodo.arguments.size(); --k) {
+    materializza(pila[k - 1]);
+    argomenti += (pila[k - 1].tipo == 'J') ? 2 : 1;
+  }
+  while(dimensione > prima - argomenti)
+    togli();
+  emetti(R_NATIVE, static_cast<uint16_t>(prima), 0, 0, indice);
+  if(!metodo.result.empty()) {
+    Voce voce;
+    voce.tipo = static_cast<char>(metodo.result[0]);
+    voce.genere = 'R';
+    voce.locale = false;
+    voce.reg = temporaneo(dimensione);
+    voce.ref_type = 0;
+    voce.value = 0;
+    metti(voce);
+  }
+  return;
+}
+
+
+/* uint16_t temporaneo(const unsigned int& pos) const *************************/
+uint16_t
+Traduzione::temporaneo(const unsigned int& pos) const {
+  return static_cast<uint16_t>(funzione.locals + SystemStack::HEADER_SLOTS +
+      pos);
+}
+
+
+/* unsigned int emetti(...) ***************************************************/
+unsigned int
+Traduzione::emetti(const uint16_t& opcode, const uint16_t& dst,
+    const uint16_t& a, const uint16_t& b, const uint32_t& index,
+    const int64_t& value) {
+  RegisterInstruction istr;
+  istr.opcode = opcode;
+  istr.dst = dst;
+  istr.a = a;
+  istr.b = b;
+  istr.index = index;
+  istr.value = value;
+  codice.push_back(istr);
+  ultima = -1;
+  return codice.size() - 1;
+}
+
+
+/* void metti_risultato(const char& tipo, const unsigned int& pos) ************/
+void
+Traduzione::metti_risultato(const char& tipo, const unsigned int& pos) {
+  // il risultato dell'ultima istruzione emessa e` nella posizione pos
+  Voce voce;
+  voce.tipo = tipo;
+  voce.genere = 'R';
+  voce.locale = false;
+  voce.reg = temporaneo(pos);
+  voce.ref_type = 0;
+  voce.value = 0;
+  metti(voce);
+  ultima = codice.size() - 1;
+  return;
+}
+
+
+/* void metti(const Voce& voce) ***********************************************/
+void
+Traduzione::metti(const Voce& voce) {
+  pila.push_back(voce);
+  pila.back().pos = dimensione;
+  dimensione += (voce.tipo == 'J') ? 2 : 1;
+  return;
+}
+
+
+/* Voce togli() ***************************************************************/
+Voce
+Traduzione::togli() {
+  Voce voce = pila.back();
+  pila.pop_back();
+  dimensione = voce.pos;
+  return voce;
+}
+
+
+/* void materializza(Voce& voce) **********************************************/
+void
+Traduzione::materializza(Voce& voce) {
+  // mette il valore nel registro della sua posizione sullo stack
+  const uint16_t reg = temporaneo(voce.pos);
+  if(voce.genere == 'R' && !voce.locale && voce.reg == reg)
+    return;
+  if(voce.genere == 'R')
+    emetti(voce.tipo == 'J' ? R_MOV_J : R_MOV, reg, voce.reg);
+  else if(voce.genere == 'K')
+    emetti(voce.tipo == 'J' ? R_CONST_J : R_CONST_I, reg, 0, 0, 0,
+        voce.value);
+  else if(voce.genere == 'S')
+    emetti(R_CONST_STR, reg, 0, 0, static_cast<uint32_t>(voce.value));
+  else
+    emetti(R_CONST_REF, reg, 0, 0, voce.ref_type);
+  voce.genere = 'R';
+  voce.locale = false;
+  voce.reg = reg;
+  return;
+}
+
+
+/* uint16_t registro(Voce& voce) **********************************************/
+uint16_t
+Traduzione::registro(Voce& voce) {
+  // registro con il valore: variabile locale, posizione dello stack o, per
+  // le costanti, la posizione dell'elemento
+  if(voce.genere != 'R')
+    materializza(voce);
+  return voce.reg;
+}
+
+
+/* void scarica() *************************************************************/
+void
+Traduzione::scarica() {
+  for(vector<Voce>::size_type k = 0; k < pila.size(); ++k)
+    materializza(pila[k]);
+  return;
+}
+
+
+/* void invalida_locale(const uint16_t& n) ************************************/
+void
+Traduzione::invalida_locale(const uint16_t& n) {
+  // gli elementi che leggono la variabile n prendono il valore attuale
+  for(vector<Voce>::size_type k = 0; k < pila.size(); ++k) {
+    if(pila[k].genere == 'R' && pila[k].locale && pila[k].reg == n)
+      materializza(pila[k]);
+  }
+  return;
+}
+
+
+/* void memorizza(const unsigned int& i, const char& tipo) ********************/
+void
+Traduzione::memorizza(const unsigned int& i, const char& tipo) {
+  const uint16_t n = static_cast<uint16_t>(
+      istruzioni[funzione.start + i].index);
+  const vector<Tipo>& locali = verifica.get_state(i).locals;
+  // senza long nella variabile (o nella successiva, per un long) basta
+  // scrivere valore e tipo, altrimenti serve la cancellazione di lstore;
+  // un long che sostituisce un long nella stessa variabile non cancella
+  // nient'altro
+  bool semplice = locali[n] != 'J' && locali[n] != '$' &&
+    locali[n] != SCONOSCIUTO;
+  if(tipo == 'J')
+    semplice = (semplice && locali[n + 1] != 'J' && locali[n + 1] != '$' &&
+      locali[n + 1] != SCONOSCIUTO) ||
+      (locali[n] == 'J' && locali[n + 1] == '$');
+  const Voce& cima = pila.back();
+  bool altri = false;
+  for(vector<Voce>::size_type k = 0; k + 1 < pila.size(); ++k) {
+    if(pila[k].genere == 'R' && pila[k].locale &&
+        (pila[k].reg == n || (tipo == 'J' && pila[k].reg == n + 1)))
+      altri = true;
+    // una copia della cima (dup) legge ancora il temporaneo, che dopo la
+    // fusione non verrebbe piu` scritto
+    if(pila[k].genere == 'R' && !pila[k].locale && pila[k].reg == cima.reg)
+      altri = true;
+  }
+  if(semplice && !altri && ultima >= 0 &&
+      static_cast<unsigned long>(ultima) == codice.size() - 1 &&
+      cima.genere == 'R' && !cima.locale && codice[ultima].dst == cima.reg) {
+    // l'ultima istruzione scrive direttamente nella variabile locale
+    codice[ultima].dst = n;
+    togli();
+    return;
+  }
+  invalida_locale(n);
+  if(tipo == 'J')
+    invalida_locale(n + 1);
+  Voce valore = togli();
+  if(semplice && valore.genere == 'K')
+    emetti(tipo == 'J' ? R_CONST_J : R_CONST_I, n, 0, 0, 0, valore.value);
+  else {
+    if(valore.genere != 'R') {
+      metti(valore);
+      materializza(pila.back());
+      valore = togli();
+    }
+    if(!semplice)
+      emetti(tipo == 'J' ? R_LSTORE : R_ISTORE, n, valore.reg);
+    else if(valore.reg != n)
+      emetti(tipo == 'J' ? R_MOV_J : R_MOV, n, valore.reg);
+  }
+  return;
+}
+
+
+/* void binaria(const uint16_t& op, const uint16_t& op_k, const bool& comm) ***/
+void
+Traduzione::binaria(const uint16_t& op, const uint16_t& op_k,
+    const bool& comm) {
+  Voce& a = pila[pila.size() - 1];
+  Voce& b = pila[pila.size() - 2];
+  const unsigned int pos = b.pos;
+  // divisione per una costante 0: l'errore viene dato dall'istruzione rr
+  bool divisione = (op == R_IDIV || op == R_IREM);
+  if(a.genere == 'K' && b.genere == 'R' && !(divisione && a.value == 0)) {
+    emetti(op_k, temporaneo(pos), b.reg, 0, 0, a.value);
+  }
+  else if(comm && b.genere == 'K' && a.genere == 'R') {
+    emetti(op_k, temporaneo(pos), a.reg, 0, 0, b.value);
+  }
+  else {
+    emetti(op, temporaneo(pos), registro(b), registro(a));
+  }
+  togli();
+  togli();
+  metti_risultato('I', pos);
+  return;
+}
+
+
+/* void binaria_long(const uint16_t& op) **************************************/
+void
+Traduzione::binaria_long(const uint16_t& op) {
+  Voce& a = pila[pila.size() - 1];
+  Voce& b = pila[pila.size() - 2];
+  const unsigned int pos = b.pos;
+  emetti(op, temporaneo(pos), registro(b), registro(a));
+  togli();
+  togli();
+  metti_risultato(op == R_LCMP ? 'I' : 'J', pos);
+  return;
+}
+
+
+/* void unaria(const uint16_t& op, const char& tipo) **************************/
+void
+Traduzione::unaria(const uint16_t& op, const char& tipo) {
+  const uint16_t reg = registro(pila.back());
+  Voce a = togli();
+  emetti(op, temporaneo(a.pos), reg);
+  metti_risultato(tipo, a.pos);
+  return;
+}
+
+
+/* void salto_condizionato(...) ***********************************************/
+void
+Traduzione::salto_condizionato(const uint16_t& op, const bool& con_zero,
+    const uint32_t& destinazione) {
+  const uint16_t op_k = op + (R_IF_ICMPEQ_K - R_IF_ICMPEQ);
+  if(con_zero) {
+    // if<cond> label: confronto con 0
+    const uint16_t reg = registro(pila.back());
+    togli();
+    scarica();
+    salti.push_back(emetti(op_k, 0, reg, 0, destinazione, 0));
+    return;
+  }
+  // if_icmp<cond> label: b <cond> a, con a in cima
+  if(pila[pila.size() - 1].genere != 'R' &&
+      pila[pila.size() - 2].genere != 'R')
+    materializza(pila[pila.size() - 2]);
+  Voce a = togli();
+  Voce b = togli();
+  scarica();
+  if(a.genere == 'K')
+    salti.push_back(emetti(op_k, 0, b.reg, 0, destinazione, a.value));
+  else if(b.genere == 'K')
+    salti.push_back(emetti(confronto_inverso(op_k), 0, a.reg, 0,
+          destinazione, b.value));
+  else
+    salti.push_back(emetti(op, 0, b.reg, a.reg, destinazione));
+  return;
+}
+
+
+#endif // REGISTERCODE_CC_INCLUSION_GUARD
@@ -0,0 +1,251 @@
+/*!
+  \file RegisterCode.h
+  \brief Interfaccia di RegisterCode
+  \author Andrea Zanelli
+  \date 17-10-2026
+*/
+
+#ifndef REGISTERCODE_H_INCLUSION_GUARD
+#define REGISTERCODE_H_INCLUSION_GUARD
+
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+#include "Instruction.h"
+#include "ProgramArea.h"
+
+using std::string;
+using std::vector;
+
+
+/*!
+  \enum RegisterOpcode
+  \brief Codici operativi del codice a registri
+
+  Gli operandi sono registri, cioe` Slot del RdA della funzione (vedi
+  RegisterInstruction), oppure costanti. I suffissi indicano il tipo: "_I"
+  int, "_J" long, "_K" un operando costante (in <tt>value</tt>) al posto del
+  secondo registro. <tt>R_NUMERO_OPCODE</tt> non e` un'istruzione ma il
+  numero di codici operativi.
+*/
+enum RegisterOpcode {
+  R_ENTER = 0,    //!< inizio funzione: riserva <tt>value</tt> Slot
+  R_MOV,          //!< dst = a (int o riferimento)
+  R_MOV_J,        //!< dst = a (long)
+  R_SWAP,         //!< scambia dst e a (int o riferimenti)
+  R_CONST_I,      //!< dst = value
+  R_CONST_J,      //!< dst = value
+  R_CONST_STR,    //!< dst = stringa costante con indice index
+  R_CONST_REF,    //!< dst = riferimento "finto" al tipo index
+  R_IADD,
+  R_ISUB,
+  R_IMUL,
+  R_IDIV,
+  R_IREM,
+  R_ISHL,
+  R_ISHR,
+  R_IADD_K,
+  R_ISUB_K,
+  R_IMUL_K,
+  R_IDIV_K,
+  R_IREM_K,
+  R_ISHL_K,
+  R_ISHR_K,
+  R_INEG,
+  R_I2C,
+  R_I2S,
+  R_I2L,
+  R_L2I,
+  R_LADD,
+  R_LSUB,
+  R_LMUL,
+  R_LDIV,
+  R_LREM,
+  R_LSHL,
+  R_LSHR,
+  R_LNEG,
+  R_LCMP,
+  R_ISTORE,       //!< variabile locale dst = a, con i controlli di istore
+  R_LSTORE,       //!< variabile locale dst = a, con i controlli di lstore
+  R_GETSTATIC_I,  //!< dst = variabile globale index (I, S o C)
+  R_GETSTATIC_J,  //!< dst = variabile globale index (J)
+  R_PUTSTATIC_I,  //!< variabile globale index = a
+  R_PUTSTATIC_J,
+  R_PUTSTATIC_S,
+  R_PUTSTATIC_C,
+  R_GOTO,         //!< salta all'istruzione index
+  R_IF_ICMPEQ,    //!< salta all'istruzione index se a == b
+  R_IF_ICMPGE,
+  R_IF_ICMPGT,
+  R_IF_ICMPLE,
+  R_IF_ICMPLT,
+  R_IF_ICMPNE,
+  R_IF_ICMPEQ_K,  //!< salta all'istruzione index se a == value
+  R_IF_ICMPGE_K,
+  R_IF_ICMPGT_K,
+  R_IF_ICMPLE_K,
+  R_IF_ICMPLT_K,
+  R_IF_ICMPNE_K,
+  R_CALL,         //!< chiama la funzione index, con dst Slot sullo stack
+  R_RETURN,
+  R_IRETURN,      //!< ritorna a
+  R_LRETURN,      //!< ritorna a
+  R_PRINT_I,      //!< stampa a
+  R_PRINT_C,
+  R_PRINT_J,
+  R_PRINT_STR,    //!< stampa la stringa puntata da a
+  R_PRINT_CONST,  //!< stampa la stringa costante con indice index
+  R_NATIVE,       //!< chiama il metodo nativo index, con dst Slot sullo
+                  //!< stack
+  R_NUMERO_OPCODE
+};
+
+
+/*!
+  \struct RegisterInstruction
+  \brief Istruzione a tre indirizzi del codice a registri
+
+  I registri <tt>dst</tt>, <tt>a</tt> e <tt>b</tt> sono indici di Slot a
+  partire dalla prima variabile locale del RdA (vedi
+  SystemStack::frame_slots()): gli indici minori del numero di variabili
+  locali <em>n</em> sono le variabili locali, l'indice <em>n</em> +
+  SystemStack::HEADER_SLOTS + <em>d</em> e` la posizione <em>d</em> dello
+  stack degli operandi. Il significato di <tt>index</tt> e <tt>value</tt>
+  dipende dal codice operativo (RegisterOpcode).
+*/
+struct RegisterInstruction {
+  uint16_t opcode; //!< codice operativo (RegisterOpcode)
+  uint16_t dst;    //!< registro destinazione
+  uint16_t a;      //!< primo registro sorgente
+  uint16_t b;      //!< secondo registro sorgente
+  uint32_t index;  //!< destinazione dei salti, funzione, variabile globale
+  int64_t  value;  //!< costante
+  RegisterInstruction()
+    : opcode(R_ENTER), dst(0), a(0), b(0), index(0), value(0) {}
+};
+
+
+/*!
+  \class RegisterCode
+  \brief Traduzione delle funzioni del programma in codice a registri
+
+  Traduce il codice a stack di ogni funzione in istruzioni a tre indirizzi
+  sugli Slot del RdA (RegisterInstruction), eseguite da
+  esecutore_a_registri(). La traduzione simula lo stack degli operandi:
+  <tt>iload</tt>, <tt>lload</tt> e le costanti non producono istruzioni ma
+  diventano direttamente operandi delle istruzioni che li usano, le
+  operazioni scrivono il risultato nella posizione dello stack degli
+  operandi che occuperebbe (o direttamente nella variabile locale, se e`
+  seguita da <tt>istore</tt> o <tt>lstore</tt>) e <tt>dup</tt>, <tt>pop</tt>
+  e <tt>swap</tt> non producono istruzioni, cosi` che i valori non passino
+  dallo stack degli operandi se non ai confini dei blocchi (salti ed
+  etichette) e nelle chiamate.\\
+  Una funzione viene tradotta solo se e` verificata (vedi Verifier), cioe` se
+  il tipo di ogni posizione dello stack degli operandi e di ogni variabile
+  locale letta e` noto in ogni istruzione raggiungibile e corrisponde a
+  quello richiesto, cosi` che il codice a
+  registri non debba controllare i tipi ma dia gli stessi risultati e gli
+  stessi errori dell'esecuzione sullo stack; le funzioni che usano la lettura
+  dallo standard input, o che non rispettano queste condizioni, restano
+  eseguite sullo stack, che rimane il riferimento per la semantica.\\
+  Il codice a registri segue nella numerazione dei PC le istruzioni del
+  programma: il PC di un RdA che esegue codice a registri e` il numero di
+  istruzioni del programma piu` l'indice nel codice a registri.
+*/
+class RegisterCode {
+
+  public:
+    /* METODI PUBBLICI */
+
+    /**
+     * Costruttore di default: nessuna funzione tradotta.
+     */
+    RegisterCode();
+
+    /**
+     * Traduce le funzioni di <tt>program</tt>, gia` collegato e senza
+     * superistruzioni (vedi ProgramArea::fuse()), e imposta come inizio di
+     * ogni funzione tradotta (vedi Function::entry) il suo codice a
+     * registri. Le chiamate successive alla prima non hanno effetto.
+     */
+    void compile(ProgramArea& program);
+
+    /**
+     * Restituisce il puntatore alla prima istruzione del codice a registri
+     * (0 se nessuna funzione e` stata tradotta).
+     */
+    const RegisterInstruction* get_code() const;
+
+    /**
+     * Restituisce il numero di istruzioni del codice a registri.
+     */
+    unsigned int get_size() const;
+
+    /**
+     * Restituisce l'esito della traduzione: una riga per funzione nella
+     * forma "nome(argomenti)ritorno: N istruzioni -> M" oppure
+     * "nome(argomenti)ritorno: non tradotta (motivo)".
+     */
+    string get_report() const;
+
+    /**
+     * Restituisce il numero di funzioni tradotte. Il codice a registri di
+     * ogni funzione tradotta occupa istruzioni consecutive.
+     */
+    unsigned int get_functions_size() const;
+
+    /**
+     * Restituisce l'indice della prima istruzione del codice a registri
+     * della funzione tradotta <tt>k</tt> (tra 0 e get_functions_size() - 1).
+     */
+    unsigned int get_function_start(const unsigned int& k) const;
+
+    /**
+     * Restituisce l'indice successivo all'ultima istruzione del codice a
+     * registri della funzione tradotta <tt>k</tt>.
+     */
+    unsigned int get_function_end(const unsigned int& k) const;
+
+    /**
+     * Restituisce l'indice nella tabella delle funzioni di ProgramArea
+     * della funzione tradotta <tt>k</tt>.
+     */
+    uint32_t get_function_index(const unsigned int& k) const;
+
+    /**
+     * Restituisce la funzione tradotta (tra 0 e get_functions_size() - 1) a
+     * cui appartiene l'istruzione <tt>index</tt> del codice a registri. Se
+     * l'istruzione non esiste lancia un'eccezione di tipo std::string con la
+     * descrizione dell'errore.
+     */
+    unsigned int find_function(const unsigned int& index) const;
+
+  private:
+    /* VARIABILI PRIVATE */
+
+    //! istruzioni del codice a registri di tutte le funzioni tradotte
+    vector<RegisterInstruction> code;
+
+    //! per ogni funzione tradotta: inizio e fine del suo codice a registri
+    //! e indice nella tabella delle funzioni
+    vector<unsigned int> function_start;
+    vector<unsigned int> function_end;
+    vector<uint32_t> function_index;
+
+    //! esito della traduzione, una riga per funzione
+    string report;
+
+    //! true se compile() e` gia` stata chiamata
+    bool compiled;
+
+    /* METODI PRIVATI */
+
+    // il codice non puo` essere copiato
+    RegisterCode(const RegisterCode&);
+    RegisterCode& operator=(const RegisterCode&);
+
+};
+
+
+#endif // REGISTERCODE_H_INCLUSION_GUARD
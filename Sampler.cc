@@ -0,0 +1,227 @@
+/*!
+  \file Sampler.cc
+  \brief Implementazione di Sampler
+  \author Andrea Zanelli
+  \date 17-10-2026
+*/
+
+#ifndef SAMPLER_CC_INCLUSION_GUARD
+#define SAMPLER_CC_INCLUSION_GUARD
+
+#include <errno.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/time.h>
+#include <algorithm>
+
+#include "Function.h"
+#include "Sampler.h"
+
+
+// numero di elementi della tabella degli stack (una potenza di 2)
+static const uint32_t DIMENSIONE_TABELLA = 1u << 16;
+
+// numero di funzioni memorizzabili per tutti gli stack della tabella
+static const uint32_t DIMENSIONE_FUNZIONI = 1u << 21;
+
+
+const unsigned int Sampler::MAX_DEPTH;
+const uint32_t Sampler::UNKNOWN;
+const uint32_t Sampler::TRUNCATED;
+Sampler* volatile Sampler::active = 0;
+
+
+/* Sampler() ******************************************************************/
+Sampler::Sampler()
+  : program(0), stack(0), frames_used(0), samples(0), lost(0) {
+  memset(&previous_action, 0, sizeof(previous_action));
+}
+
+
+/* ~Sampler() *****************************************************************/
+Sampler::~Sampler() {
+  stop();
+}
+
+
+/* void start(const ProgramArea& program, ...) ********************************/
+void
+Sampler::start(const ProgramArea& program, const RegisterCode& registers,
+    const SystemStack& stack, const unsigned int& interval) {
+  if(active != 0)
+    throw string("il campionamento e` gia` attivo");
+  this->program = &program;
+  this->stack = &stack;
+
+  // funzione di ogni PC, anche nel codice a registri
+  const unsigned int base = program.get_instructions_size();
+  functions.assign(base + registers.get_size(), UNKNOWN);
+  for(uint32_t f = 0; f < program.get_functions_size(); ++f) {
+    const Function& funzione = program.get_function(f);
+    for(unsigned int i = funzione.start; i <= funzione.end && i < base; ++i)
+      functions[i] = f;
+  }
+  for(unsigned int k = 0; k < registers.get_functions_size(); ++k) {
+    for(unsigned int i = registers.get_function_start(k);
+        i < registers.get_function_end(k); ++i)
+      functions[base + i] = registers.get_function_index(k);
+  }
+
+  // tutta la memoria usata dal gestore del segnale viene allocata qui
+  pcs.assign(MAX_DEPTH, 0);
+  frames.assign(DIMENSIONE_FUNZIONI, 0);
+  frames_used = 0;
+  Stack vuoto;
+  memset(&vuoto, 0, sizeof(vuoto));
+  table.assign(DIMENSIONE_TABELLA, vuoto);
+  samples = lost = 0;
+
+  struct sigaction azione;
+  memset(&azione, 0, sizeof(azione));
+  azione.sa_handler = handler;
+  sigemptyset(&azione.sa_mask);
+  // le letture dallo standard input interrotte dal segnale riprendono
+  azione.sa_flags = SA_RESTART;
+  active = this;
+  if(sigaction(SIGPROF, &azione, &previous_action) != 0) {
+    active = 0;
+    throw string("impossibile impostare il gestore di SIGPROF: ") +
+      strerror(errno);
+  }
+  struct itimerval timer;
+  timer.it_interval.tv_sec = interval / 1000000;
+  timer.it_interval.tv_usec = interval % 1000000;
+  timer.it_value = timer.it_interval;
+  if(setitimer(ITIMER_PROF, &timer, 0) != 0) {
+    const int errore = errno;
+    sigaction(SIGPROF, &previous_action, 0);
+    active = 0;
+    throw string("impossibile impostare il timer del campionamento: ") +
+      strerror(errore);
+  }
+  return;
+} // end of method start(...)
+
+
+/* void stop() ****************************************************************/
+void
+Sampler::stop() {
+  if(active != this)
+    return;
+  struct itimerval timer;
+  memset(&timer, 0, sizeof(timer));
+  setitimer(ITIMER_PROF, &timer, 0);
+  sigaction(SIGPROF, &previous_action, 0);
+  active = 0;
+  return;
+}
+
+
+/* string get_folded() const **************************************************/
+string
+Sampler::get_folded() const {
+  vector<string> righe;
+  char numero[32];
+  for(uint32_t k = 0; k < table.size(); ++k) {
+    const Stack& elemento = table[k];
+    if(elemento.depth == 0)
+      continue;
+    // le funzioni sono memorizzate dalla cima dello stack
+    string riga;
+    for(uint32_t d = elemento.depth; d > 0; --d) {
+      riga += frame_name(frames[elemento.offset + d - 1]);
+      riga += d > 1 ? ";" : "";
+    }
+    sprintf(numero, " %llu\n", static_cast<unsigned long long>(elemento.count));
+    righe.push_back(riga + numero);
+  }
+  std::sort(righe.begin(), righe.end());
+  string folded;
+  for(unsigned int r = 0; r < righe.size(); ++r)
+    folded += righe[r];
+  return folded;
+}
+
+
+/* void handler(int signal) ***************************************************/
+void
+Sampler::handler(int) {
+  Sampler* campionatore = active;
+  if(campionatore != 0)
+    campionatore->sample();
+  return;
+}
+
+
+/* void sample() **************************************************************/
+void
+Sampler::sample() {
+  unsigned int n = stack->backtrace(&pcs[0], MAX_DEPTH);
+  // un RdA appena creato, senza PC, appartiene ancora alla chiamata
+  unsigned int primo = 0;
+  if(n > 0 && pcs[0] == ActivationRecord::NO_PC)
+    primo = 1;
+  if(n == primo) {
+    ++lost;
+    return;
+  }
+  // traduce i PC nelle funzioni, sul posto; uno stack troncato finisce con
+  // TRUNCATED al posto della funzione piu` in basso
+  const bool troncato = n == MAX_DEPTH;
+  n -= primo;
+  for(unsigned int d = 0; d < n; ++d) {
+    const unsigned int pc = pcs[primo + d];
+    pcs[d] = pc < functions.size() ? functions[pc] : UNKNOWN;
+  }
+  if(troncato)
+    pcs[n-1] = TRUNCATED;
+  // hash FNV-1a delle funzioni
+  uint64_t hash = 14695981039346656037ull;
+  for(unsigned int d = 0; d < n; ++d)
+    hash = (hash ^ pcs[d]) * 1099511628211ull;
+
+  // cerca lo stack nella tabella, o il primo elemento libero
+  const uint32_t maschera = static_cast<uint32_t>(table.size()) - 1;
+  for(uint32_t k = static_cast<uint32_t>(hash) & maschera, passi = 0;
+      passi <= maschera; k = (k + 1) & maschera, ++passi) {
+    Stack& elemento = table[k];
+    if(elemento.depth == 0) {
+      if(frames.size() - frames_used < n)
+        break;
+      for(unsigned int d = 0; d < n; ++d)
+        frames[frames_used + d] = pcs[d];
+      elemento.hash = hash;
+      elemento.offset = frames_used;
+      elemento.count = 1;
+      elemento.depth = n;
+      frames_used += n;
+      ++samples;
+      return;
+    }
+    if(elemento.hash == hash && elemento.depth == n &&
+        std::equal(&pcs[0], &pcs[0] + n, &frames[elemento.offset])) {
+      ++elemento.count;
+      ++samples;
+      return;
+    }
+  }
+  // tabella o area delle funzioni piena
+  ++lost;
+  return;
+} // end of method sample()
+
+
+/* string frame_name(const uint32_t& function) const **************************/
+string
+Sampler::frame_name(const uint32_t& function) const {
+  if(function == TRUNCATED)
+    return "[...]";
+  if(function == UNKNOWN)
+    return "[?]";
+  string nome(program->get_function(function).name);
+  std::replace(nome.begin(), nome.end(), ';', ',');
+  return nome;
+}
+
+
+#endif // SAMPLER_CC_INCLUSION_GUARD
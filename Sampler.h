@@ -0,0 +1,191 @@
+/*!
+  \file Sampler.h
+  \brief Interfaccia di Sampler
+  \author Andrea Zanelli
+  \date 17-10-2026
+*/
+
+#ifndef SAMPLER_H_INCLUSION_GUARD
+#define SAMPLER_H_INCLUSION_GUARD
+
+#include <signal.h>
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+#include "ProgramArea.h"
+#include "RegisterCode.h"
+#include "SystemStack.h"
+
+using std::string;
+using std::vector;
+
+
+/*!
+  \class Sampler
+  \brief Profilo dell'esecuzione per campionamento
+
+  A intervalli regolari di tempo del processore (timer <tt>ITIMER_PROF</tt>)
+  il segnale <tt>SIGPROF</tt> interrompe l'esecuzione, e il gestore del
+  segnale legge lo stack delle chiamate del programma: i PC dei RdA dello
+  stack di sistema (vedi SystemStack::backtrace()), tradotti nelle funzioni
+  della tabella delle funzioni di ProgramArea. A differenza di Profiler
+  l'esecutore non conta niente, percio` il costo non dipende dal numero di
+  istruzioni eseguite ma solo dalla frequenza dei campioni, e il
+  campionamento funziona con tutti i modi di esecuzione (anche con il codice
+  a registri e il codice nativo, in cui il PC di ogni RdA resta nel codice
+  della sua funzione).\\
+  Il gestore del segnale non alloca memoria: gli stack campionati vengono
+  contati in una tabella hash con un numero massimo di elementi, e le
+  funzioni che li compongono in un'area allocata da start(); i campioni che
+  non ci stanno, o presi mentre lo stack di sistema e` vuoto o viene
+  ingrandito, vengono solo contati come persi. Gli stack piu` profondi di
+  MAX_DEPTH vengono troncati, tenendo le funzioni in cima.\\
+  Alla fine get_folded() restituisce gli stack nel formato "folded" di
+  Brendan Gregg, una riga per stack con le funzioni separate da ';' (dalla
+  prima chiamata all'ultima) e il numero di campioni, che e` l'ingresso di
+  flamegraph.pl e degli altri strumenti per i flame graph.
+*/
+class Sampler {
+
+  public:
+    /* METODI PUBBLICI */
+
+    //! numero massimo di RdA letti da ogni campione
+    static const unsigned int MAX_DEPTH = 16384;
+
+    /**
+     * Costruttore di default: campionamento non attivo.
+     */
+    Sampler();
+
+    /**
+     * Distruttore: ferma il campionamento, se attivo.
+     */
+    ~Sampler();
+
+    /**
+     * Inizia a campionare ogni <tt>interval</tt> microsecondi di tempo del
+     * processore lo stack <tt>stack</tt> del programma <tt>program</tt>,
+     * gia` caricato, con il codice a registri <tt>registers</tt> (vuoto se
+     * le funzioni non sono state tradotte). Se il timer o il gestore del
+     * segnale non possono essere impostati lancia un'eccezione di tipo
+     * std::string con la descrizione dell'errore.
+     */
+    void start(const ProgramArea& program, const RegisterCode& registers,
+        const SystemStack& stack, const unsigned int& interval);
+
+    /**
+     * Ferma il campionamento (i campioni presi restano).
+     */
+    void stop();
+
+    /**
+     * Restituisce true se il campionamento e` attivo.
+     */
+    inline
+    bool is_enabled() const {
+      return active == this;
+    }
+
+    /**
+     * Restituisce il numero di campioni registrati.
+     */
+    inline
+    uint64_t get_samples() const {
+      return samples;
+    }
+
+    /**
+     * Restituisce il numero di campioni persi.
+     */
+    inline
+    uint64_t get_lost() const {
+      return lost;
+    }
+
+    /**
+     * Restituisce gli stack campionati nel formato "folded", in ordine
+     * alfabetico. Nei nomi delle funzioni i ';' dei descrittori (che
+     * separano le funzioni) diventano ','.
+     */
+    string get_folded() const;
+
+  private:
+    /* VARIABILI PRIVATE */
+
+    /*!
+      \struct Stack
+      \brief Elemento della tabella degli stack campionati
+    */
+    struct Stack {
+      uint64_t hash;        //!< hash delle funzioni dello stack
+      uint32_t offset;      //!< posizione della prima funzione in frames
+      uint32_t depth;       //!< numero di funzioni (0: elemento libero)
+      uint64_t count;       //!< numero di campioni
+    };
+
+    //! funzione di un PC fuori dal programma
+    static const uint32_t UNKNOWN = 0xFFFFFFFFu;
+
+    //! funzione aggiunta sotto uno stack troncato
+    static const uint32_t TRUNCATED = 0xFFFFFFFEu;
+
+    //! campionamento attivo (0 se nessuno), usato dal gestore del segnale
+    static Sampler* volatile active;
+
+    //! programma campionato
+    const ProgramArea* program;
+
+    //! stack di sistema campionato
+    const SystemStack* stack;
+
+    //! funzione di ogni PC: le istruzioni del programma seguite da quelle
+    //! del codice a registri
+    vector<uint32_t> functions;
+
+    //! PC letti dall'ultimo campione
+    vector<unsigned int> pcs;
+
+    //! funzioni degli stack della tabella, dalla cima di ogni stack
+    vector<uint32_t> frames;
+
+    //! posizioni usate in frames
+    uint32_t frames_used;
+
+    //! tabella hash degli stack campionati (indirizzamento aperto)
+    vector<Stack> table;
+
+    //! numero di campioni registrati e persi
+    uint64_t samples;
+    uint64_t lost;
+
+    //! gestore di SIGPROF precedente a start()
+    struct sigaction previous_action;
+
+    /* METODI PRIVATI */
+
+    // il campionamento non puo` essere copiato
+    Sampler(const Sampler&);
+    Sampler& operator=(const Sampler&);
+
+    /**
+     * Gestore del segnale SIGPROF: campiona lo stack con sample().
+     */
+    static void handler(int signal);
+
+    /**
+     * Legge lo stack di sistema e conta il campione nella tabella.
+     */
+    void sample();
+
+    /**
+     * Restituisce il nome della funzione <tt>function</tt> per il formato
+     * "folded".
+     */
+    string frame_name(const uint32_t& function) const;
+
+};
+
+
+#endif // SAMPLER_H_INCLUSION_GUARD
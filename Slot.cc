@@ -0,0 +1,67 @@
+/*!
+  \file Slot.cc
+  \brief Tabella dei tipi di riferimento
+  \author Andrea Zanelli
+  \date 17-10-2026
+*/
+
+#ifndef SLOT_CC_INCLUSION_GUARD
+#define SLOT_CC_INCLUSION_GUARD
+
+#include <deque>
+#include <mutex>
+
+#include "Slot.h"
+
+using std::deque;
+
+
+// la tabella e` condivisa da tutte le macchine astratte del processo, che
+// possono caricare programmi contemporaneamente in thread diversi
+static std::mutex mutex_tipi;
+
+// tabella dei tipi di riferimento: i primi sono quelli di RefType, nello
+// stesso ordine (una deque, cosi` che i nomi restituiti da ref_type_name()
+// restino validi quando vengono aggiunti altri tipi)
+static deque<string>& tipi_riferimento() {
+  static deque<string> tipi;
+  if(tipi.empty()) {
+    tipi.push_back("");
+    tipi.push_back("Ljava/lang/String;");
+    tipi.push_back("Ljava/io/PrintStream;");
+    tipi.push_back("Ljava/io/InputStream;");
+    tipi.push_back("Ljava/io/InputStreamReader;");
+    tipi.push_back("Ljava/io/BufferedReader;");
+  }
+  return tipi;
+}
+
+
+/* uint16_t ref_type_id(const string& name) ***********************************/
+uint16_t
+ref_type_id(const string& name) {
+  std::lock_guard<std::mutex> blocco(mutex_tipi);
+  deque<string>& tipi = tipi_riferimento();
+  for(deque<string>::size_type i = 1; i < tipi.size(); ++i) {
+    if(tipi[i] == name)
+      return static_cast<uint16_t>(i);
+  }
+  if(tipi.size() > 0xFFFF)
+    throw string("troppi tipi di riferimento nel programma");
+  tipi.push_back(name);
+  return static_cast<uint16_t>(tipi.size()-1);
+}
+
+
+/* const string& ref_type_name(const uint16_t& id) ****************************/
+const string&
+ref_type_name(const uint16_t& id) {
+  std::lock_guard<std::mutex> blocco(mutex_tipi);
+  deque<string>& tipi = tipi_riferimento();
+  if(id >= tipi.size())
+    throw string("tipo di riferimento inesistente");
+  return tipi[id];
+}
+
+
+#endif // SLOT_CC_INCLUSION_GUARD
@@ -0,0 +1,76 @@
+/*!
+  \file Slot.h
+  \brief Valore con tipo (slot) dello stack degli operandi e delle variabili
+  locali
+  \author Andrea Zanelli
+  \date 17-10-2026
+*/
+
+#ifndef SLOT_H_INCLUSION_GUARD
+#define SLOT_H_INCLUSION_GUARD
+
+#include <stdint.h>
+#include <string>
+
+using std::string;
+
+
+/*!
+  \struct Slot
+  \brief Elemento di dimensione fissa dello stack degli operandi e delle
+  variabili locali
+
+  Contiene direttamente il valore (non un puntatore ad un oggetto allocato)
+  e un carattere che ne indica il tipo:
+    - 'I': int (valore in <tt>value.i</tt>);
+    - 'J': long (valore in <tt>value.l</tt>), occupa due slot consecutivi;
+    - '$': seconda posizione occupata da un long, senza valore;
+    - 'L': riferimento (puntatore in <tt>value.a</tt>) ad un oggetto del tipo
+      indicato da <tt>ref_type</tt> (vedi ref_type_id());
+    - 0: slot vuoto (ad esempio una variabile locale non inizializzata).
+  Un long occupa due slot sia sullo stack degli operandi che tra le variabili
+  locali: il primo, con il valore, ha tipo 'J' e il secondo ha tipo '$'.
+*/
+struct Slot {
+  union {
+    int32_t i;
+    int64_t l;
+    void*   a;
+  } value;           //!< valore dello slot
+  uint16_t ref_type; //!< tipo del riferimento (solo se tag vale 'L')
+  char tag;          //!< tipo dello slot
+};
+
+
+/*!
+  \enum RefType
+  \brief Tipi di riferimento predefiniti
+
+  Indici dei tipi di riferimento usati dalle istruzioni di stampa e lettura,
+  gia` presenti nella tabella dei tipi prima del caricamento del programma.
+*/
+enum RefType {
+  REF_NESSUNO = 0,       //!< tipo sconosciuto
+  REF_STRING,            //!< Ljava/lang/String;
+  REF_PRINTSTREAM,       //!< Ljava/io/PrintStream;
+  REF_INPUTSTREAM,       //!< Ljava/io/InputStream;
+  REF_INPUTSTREAMREADER, //!< Ljava/io/InputStreamReader;
+  REF_BUFFEREDREADER     //!< Ljava/io/BufferedReader;
+};
+
+
+/**
+ * Restituisce l'indice del tipo di riferimento <tt>name</tt> (nella forma
+ * "Lnome;"), aggiungendolo alla tabella dei tipi se non e` ancora presente.
+ */
+uint16_t ref_type_id(const string& name);
+
+/**
+ * Restituisce il nome del tipo di riferimento con indice <tt>id</tt>. Se
+ * l'indice non esiste lancia un'eccezione di tipo std::string con la
+ * descrizione dell'errore.
+ */
+const string& ref_type_name(const uint16_t& id);
+
+
+#endif // SLOT_H_INCLUSION_GUARD
@@ -0,0 +1,208 @@
+/*!
+  \file SystemStack.cc
+  \brief Implementazione di SystemStack
+  \author Andrea Zanelli
+  \date 17-10-2026
+*/
+
+#ifndef SYSTEMSTACK_CC_INCLUSION_GUARD
+#define SYSTEMSTACK_CC_INCLUSION_GUARD
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <new>
+
+#include "SystemStack.h"
+
+
+// numero di Slot allocati alla prima chiamata
+static const unsigned int DIMENSIONE_INIZIALE = 4096;
+
+
+/* SystemStack() **************************************************************/
+SystemStack::SystemStack()
+  : region(0), limit(0), frame(0), locals(0), op_base(0), sp(0),
+    resizing(0) {
+}
+
+
+/* ~SystemStack() *************************************************************/
+SystemStack::~SystemStack() {
+  free(region);
+}
+
+
+/* void push_ar(const unsigned int& n_locals, const unsigned int& n_stack) ****/
+void
+SystemStack::push_ar(const unsigned int& n_locals,
+    const unsigned int& n_stack) {
+  push_frame(n_locals, 0, n_stack);
+  return;
+}
+
+
+/* void push_ar(const unsigned int& n_locals, const string& arguments, ...) ***/
+void
+SystemStack::push_ar(const unsigned int& n_locals, const string& arguments,
+    const unsigned int& n_stack) {
+  const unsigned int n_args = arguments.size();
+  if(frame == 0)
+    throw string("chiamata a funzione senza un record di attivazione");
+  // controlla il tipo dei parametri, che restano al loro posto, partendo
+  // dall'ultimo (in cima allo stack)
+  const Slot* arg = sp;
+  for(unsigned int i = n_args; i > 0; --i) {
+    --arg;
+    if(arg < op_base || arg->tag != arguments[i-1])
+      argument_error(arguments[i-1]);
+  }
+  push_frame(n_locals, n_args, n_stack);
+  return;
+}
+
+
+/* void push_frame(const unsigned int& n_locals, ...) *************************/
+void
+SystemStack::push_frame(const unsigned int& n_locals,
+    const unsigned int& n_args, const unsigned int& n_stack) {
+  // variabili locali, intestazione e stack degli operandi del nuovo AR
+  const unsigned int n_slots = n_locals + HEADER_SLOTS + n_stack;
+  if(static_cast<unsigned int>(limit - sp) + n_args < n_slots)
+    grow(n_slots - n_args);
+  uint32_t previous = NO_FRAME;
+  if(frame != 0) {
+    // i parametri passano al nuovo AR: la cima dello stack degli operandi
+    // del chiamante, al ritorno, sara` sotto i parametri
+    previous = static_cast<uint32_t>(reinterpret_cast<Slot*>(frame) - region);
+    frame->top = static_cast<uint32_t>(sp - n_args - region);
+  }
+  // le variabili locali iniziano dai parametri (o dalla cima dello stack)
+  locals = sp - n_args;
+  for(unsigned int i = n_args; i < n_locals; ++i)
+    locals[i].tag = char();
+  frame = new (locals + n_locals) ActivationRecord(previous, n_locals);
+  op_base = operand_base(frame);
+  sp = op_base;
+  return;
+}
+
+
+/* void pop_ar() **************************************************************/
+void
+SystemStack::pop_ar() {
+  if(frame == 0)
+    throw string("pop sullo stack di sistema vuoto");
+  if(frame->previous_frame == NO_FRAME) {
+    frame = 0;
+    locals = op_base = sp = region;
+    return;
+  }
+  frame = reinterpret_cast<ActivationRecord*>(region + frame->previous_frame);
+  locals = reinterpret_cast<Slot*>(frame) - frame->locals_size;
+  op_base = operand_base(frame);
+  sp = region + frame->top;
+  return;
+}
+
+
+/* unsigned int backtrace(unsigned int* pcs, ...) const ***********************/
+unsigned int
+SystemStack::backtrace(unsigned int* pcs, const unsigned int& max) const {
+  if(resizing || frame == 0)
+    return 0;
+  const uint32_t capacity = static_cast<uint32_t>(limit - region);
+  const ActivationRecord* ar = frame;
+  unsigned int n = 0;
+  while(n < max) {
+    pcs[n++] = ar->program_counter;
+    // l'indice del RdA precedente viene controllato, perche` l'AR in cima
+    // potrebbe essere stato interrotto mentre veniva creato
+    const uint32_t previous = ar->previous_frame;
+    if(previous == NO_FRAME || previous >= capacity)
+      break;
+    ar = reinterpret_cast<const ActivationRecord*>(region + previous);
+  }
+  return n;
+}
+
+
+/* void grow(const unsigned int& n) *******************************************/
+void
+SystemStack::grow(const unsigned int& n) {
+  size_t used = sp - region;
+  size_t capacity = limit - region;
+  if(capacity == 0)
+    capacity = DIMENSIONE_INIZIALE;
+  while(capacity - used < n)
+    capacity = capacity * 2;
+  if(capacity > NO_FRAME)
+    throw string("stack di sistema esaurito");
+
+  // le posizioni salvate negli AR sono indici, percio` restano valide;
+  // vanno aggiornati solo i puntatori all'AR in cima
+  size_t frame_pos = frame ? reinterpret_cast<Slot*>(frame) - region : 0;
+  size_t locals_pos = locals - region;
+  size_t op_base_pos = op_base - region;
+  // backtrace() non deve leggere l'area vecchia, gia` liberata
+  resizing = 1;
+  Slot* new_region = static_cast<Slot*>(realloc(region,
+        capacity * sizeof(Slot)));
+  if(new_region == 0) {
+    resizing = 0;
+    throw string("memoria insufficiente per lo stack di sistema");
+  }
+  region = new_region;
+  limit = region + capacity;
+  if(frame)
+    frame = reinterpret_cast<ActivationRecord*>(region + frame_pos);
+  locals = region + locals_pos;
+  op_base = region + op_base_pos;
+  sp = region + used;
+  resizing = 0;
+  return;
+}
+
+
+/* void op_stack_error(const char* message) const *****************************/
+void
+SystemStack::op_stack_error(const char* message) const {
+  throw string(message);
+}
+
+
+/* void variable_error(const uint16_t& index, const char* message) const ******/
+void
+SystemStack::variable_error(const uint16_t& index,
+    const char* message) const {
+  char numero[8];
+  sprintf(numero, "%u", (unsigned int)index);
+  throw string("la variabile locale ") + numero + " " + message;
+}
+
+
+/* void argument_error(const char& type) const ********************************/
+void
+SystemStack::argument_error(const char& type) const {
+  if(type == 'I')
+    throw string("non vi e` un elemento di tipo int sullo stack degli "
+        "operandi");
+  else if(type == 'L')
+    throw string("non vi e` un riferimento sullo stack degli operandi");
+  throw string("non vi e` un elemento di tipo long sullo stack degli "
+      "operandi");
+}
+
+
+/* void variable_type_error(const uint16_t& index, const char* type) const ****/
+void
+SystemStack::variable_type_error(const uint16_t& index,
+    const char* type) const {
+  if(index >= frame->locals_size)
+    variable_error(index, "non esiste");
+  else if(locals[index].tag == char())
+    variable_error(index, "non e` stata inizializzata");
+  variable_error(index, (string("non e` di tipo ") + type).c_str());
+}
+
+
+#endif // SYSTEMSTACK_CC_INCLUSION_GUARD
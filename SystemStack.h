@@ -8,13 +8,13 @@
 #ifndef SYSTEMSTACK_H_INCLUSION_GUARD
 #define SYSTEMSTACK_H_INCLUSION_GUARD
 
+#include <signal.h>
 #include <stdint.h>
-#include <list>
 #include <string>
 
 #include "ActivationRecord.h"
+#include "Slot.h"
 
-using std::list;
 using std::string;
 
 
@@ -24,27 +24,85 @@ using std::string;
 
   Stack di AR (Activation Record, record di attivazione) che permette di
   eseguire operazioni sul PC (program counter), sulle variabili locali e sullo
-  stack degli operandi dell'AR in cima allo stack.
+  stack degli operandi dell'AR in cima allo stack.\\
+  Tutti gli AR sono memorizzati, uno dopo l'altro, in un'unica area contigua
+  di Slot: ogni AR occupa le posizioni delle sue variabili locali, seguite
+  dall'intestazione (ActivationRecord) e dallo stack degli operandi, che
+  arriva fino alla cima dell'area usata. Un nuovo AR viene creato sulla cima
+  dello stack degli operandi dell'AR chiamante, percio` creare o togliere un
+  AR non richiede nessuna allocazione (a meno che l'area non debba essere
+  ingrandita). Nelle chiamate a funzione le prime variabili locali dell'AR
+  chiamato si sovrappongono ai parametri in cima allo stack degli operandi
+  del chiamante, cosi` che il passaggio dei parametri non richieda copie.\\
+  I metodi che controllano i tipi degli elementi hanno il parametro
+  <tt>CHECK</tt> (true se non indicato): con <tt>CHECK</tt> false non
+  eseguono nessun controllo, le scritture nelle variabili locali non
+  cancellano le variabili sovrascritte e gli inserimenti sullo stack degli
+  operandi non ingrandiscono l'area, percio` vanno usati solo nelle
+  funzioni verificate al caricamento (vedi Verifier), in cui nessuna
+  istruzione puo` trovare un elemento o una variabile del tipo sbagliato e
+  il cui RdA ha gia` lo spazio per lo stack degli operandi piu` alto.
 */
 class SystemStack {
 
   public:
     /* METODI PUBBLICI */
 
+    /**
+     * Costruttore di default: crea lo Stack vuoto.
+     */
+    SystemStack();
+
+    /**
+     * Distruttore
+     */
+    ~SystemStack();
+
     /**
      * Restituisce true se lo Stack e` vuoto, false altrimenti.
      */
     inline
-    bool empty() {
-      return system_stack.empty();
+    bool empty() const {
+      return frame == 0;
     }
 
     /**
-     * Aggiunge un record di attivazione vuoto in cima allo Stack.
+     * Aggiunge un record di attivazione vuoto in cima allo Stack, con
+     * <tt>n_locals</tt> posizioni per le variabili locali (non inizializzate)
+     * e spazio per <tt>n_stack</tt> posizioni dello stack degli operandi.
+     */
+    void push_ar(const unsigned int& n_locals, const unsigned int& n_stack);
+
+    /**
+     * Aggiunge in cima allo Stack il record di attivazione di una funzione
+     * chiamata, con <tt>n_locals</tt> posizioni per le variabili locali.
+     * Le prime variabili locali del nuovo RdA coincidono con gli elementi in
+     * cima allo stack degli operandi del RdA chiamante (i parametri), che
+     * vengono cosi` passati senza essere copiati e tolti dallo stack del
+     * chiamante. <tt>arguments</tt> contiene il tipo di ogni posizione
+     * occupata dai parametri (vedi Slot), a partire dalla variabile locale 0:
+     * se gli elementi sullo stack degli operandi non hanno i tipi indicati
+     * viene lanciata un'eccezione di tipo std::string con la descrizione
+     * dell'errore.\\
+     * L'area viene ingrandita, se necessario, in modo che dopo il RdA ci
+     * siano <tt>n_stack</tt> posizioni libere per lo stack degli operandi
+     * (vedi Function::max_stack): nelle funzioni verificate lo stack degli
+     * operandi non supera questa dimensione, e le istruzioni vi mettono gli
+     * elementi senza controllare lo spazio.
+     */
+    void push_ar(const unsigned int& n_locals, const string& arguments,
+        const unsigned int& n_stack);
+
+    /**
+     * Come push_ar(n_locals, arguments, n_stack), con <tt>n_args</tt>
+     * posizioni occupate dai parametri, ma senza controllarne il tipo: da
+     * usare solo nelle funzioni verificate (vedi Verifier), che chiamano una
+     * funzione solo con i parametri del tipo giusto.
      */
     inline
-    void push_ar() {
-      system_stack.push_back(ActivationRecord());
+    void push_verified_ar(const unsigned int& n_locals,
+        const unsigned int& n_args, const unsigned int& n_stack) {
+      push_frame(n_locals, n_args, n_stack);
       return;
     }
 
@@ -53,11 +111,7 @@ class SystemStack {
      * viene lanciata un'eccezione di tipo std::string con la descrizione
      * dell'errore.
      */
-    inline
-    void pop_ar(){
-      system_stack.pop_back();
-      return;
-    }
+    void pop_ar();
 
     /**
      * Setta il valore del PC del RdA in cima allo Stack con il valore passato
@@ -65,7 +119,7 @@ class SystemStack {
      */
     inline
     void pc_set(const unsigned int& value) {
-      system_stack.back().pc_set_value(value);
+      frame->pc_set_value(value);
       return;
     }
 
@@ -74,7 +128,7 @@ class SystemStack {
      */
     inline
     unsigned int pc_get() const {
-      return system_stack.back().pc_get_value();
+      return frame->pc_get_value();
     }
 
     /**
@@ -83,28 +137,58 @@ class SystemStack {
      */
     inline
     unsigned int pc_inc() {
-      return system_stack.back().pc_inc();
+      return frame->pc_inc();
     }
 
+    /**
+     * Scrive in <tt>pcs</tt> i PC dei RdA dello Stack, partendo da quello in
+     * cima, fino a un massimo di <tt>max</tt>, e restituisce il numero di PC
+     * scritti. Legge soltanto l'area dello Stack, senza allocazioni ne`
+     * eccezioni, percio` puo` essere chiamato da un gestore di segnale che
+     * interrompe l'esecuzione (vedi Sampler): se in quel momento l'area sta
+     * venendo ingrandita restituisce 0.
+     */
+    unsigned int backtrace(unsigned int* pcs, const unsigned int& max) const;
+
     /**
      * Setta la variabile locale di indice <tt>index</tt> del RdA in cima allo
      * Stack, con il valore <tt>value</tt> di tipo int (occupa quindi un posto
-     * tra le variabili locali).
+     * tra le variabili locali). Se in quell'indice c'era un'altra variabile
+     * viene sovrascritta (se era un long viene eliminato anche l'altro posto
+     * occupato).
      */
+    template<bool CHECK = true>
     inline
     void local_variable_set_int(const uint16_t& index, const int32_t& value){
-      system_stack.back().variable_set_int(index,value);
+      if(CHECK) {
+        if(index >= frame->locals_size)
+          variable_error(index, "non esiste");
+        clear_variable(index);
+      }
+      locals[index].value.i = value;
+      locals[index].tag = 'I';
       return;
     }
 
     /**
      * Setta la variabile locale di indice <tt>index</tt> del RdA in cima allo
-     * Stack, con il valore <tt>value</tt> di tipo long (occupa quindi due posti 
-     * tra le variabili locali).
+     * Stack, con il valore <tt>value</tt> di tipo long (occupa quindi due posti
+     * tra le variabili locali). Le variabili sovrascritte vengono eliminate
+     * come in local_variable_set_int().
      */
+    template<bool CHECK = true>
     inline
     void local_variable_set_long(const uint16_t& index, const int64_t& value){
-      system_stack.back().variable_set_long(index,value);
+      if(CHECK) {
+        if((unsigned int)index+1 >= frame->locals_size)
+          variable_error(index, "non esiste");
+        clear_variable(index);
+        clear_variable(index+1);
+      }
+      locals[index].value.l = value;
+      locals[index].tag = 'J';
+      // "riempe" lo spazio successivo alla variabile di tipo long con un '$'
+      locals[index+1].tag = '$';
       return;
     }
 
@@ -113,9 +197,12 @@ class SystemStack {
      * tipo int del RdA in cima allo Stack. In caso di errore lancia una
      * eccezione di tipo std::string con la descrizione dell'errore.
      */
+    template<bool CHECK = true>
     inline
     int32_t local_variable_get_int(const uint16_t& index) const {
-      return system_stack.back().variable_get_int(index);
+      if(CHECK && (index >= frame->locals_size || locals[index].tag != 'I'))
+        variable_type_error(index, "int");
+      return locals[index].value.i;
     }
 
     /**
@@ -123,18 +210,27 @@ class SystemStack {
      * tipo long del RdA in cima allo Stack. In caso di errore lancia
      * un'eccezione di tipo std::string con la descrizione dell'errore.
      */
+    template<bool CHECK = true>
     inline
     int64_t local_variable_get_long(const uint16_t& index) const {
-      return system_stack.back().variable_get_long(index);
+      if(CHECK && ((unsigned int)index+1 >= frame->locals_size ||
+          locals[index].tag != 'J'))
+        variable_type_error(index, "long");
+      return locals[index].value.l;
     }
 
     /**
      * Mette sullo stack degli operandi del RdA in cima allo Stack il valore
      * <tt>value</tt> di tipo int.
      */
+    template<bool CHECK = true>
     inline
     void op_stack_push_int(const int32_t& value) {
-      system_stack.back().op_stack_push_int(value);
+      if(CHECK && sp == limit)
+        grow(1);
+      sp->value.i = value;
+      sp->tag = 'I';
+      ++sp;
       return;
     }
 
@@ -143,69 +239,138 @@ class SystemStack {
      * <tt>value</tt> di tipo long; da notare che il tipo long occupa due slot
      * sullo stack degli operandi.
      */
+    template<bool CHECK = true>
     inline
     void op_stack_push_long(const int64_t& value) {
-      system_stack.back().op_stack_push_long(value);
+      if(CHECK && limit - sp < 2)
+        grow(2);
+      sp[0].value.l = value;
+      sp[0].tag = 'J';
+      sp[1].tag = '$';
+      sp += 2;
       return;
     }
 
     /**
-     * Mette sullo stack degli operandi del RdA in cima allo Stack il 
-     * riferimento <tt>value</tt> di tipo void*, che punta ad una valore di 
+     * Mette sullo stack degli operandi del RdA in cima allo Stack il
+     * riferimento <tt>value</tt> di tipo void*, che punta ad una valore di
      * tipo <tt>type</tt>.
      */
     inline
     void op_stack_push_ref(const string& type, void* value) {
-      system_stack.back().op_stack_push_ref(type,value);
+      op_stack_push_ref(ref_type_id(type), value);
+      return;
+    }
+
+    /**
+     * Mette sullo stack degli operandi del RdA in cima allo Stack il
+     * riferimento <tt>value</tt> di tipo void*, che punta ad una valore del
+     * tipo con indice <tt>type</tt> nella tabella dei tipi (vedi
+     * ref_type_id()).
+     */
+    template<bool CHECK = true>
+    inline
+    void op_stack_push_ref(const uint16_t& type, void* value) {
+      if(CHECK && sp == limit)
+        grow(1);
+      sp->value.a = value;
+      sp->ref_type = type;
+      sp->tag = 'L';
+      ++sp;
       return;
     }
 
     /**
      * Restituisce il valore dell'elemento di tipo int in cima allo stack degli
      * operandi del RdA in cima allo Stack.
-     * Se in cima allo stack degli operandi non c'e` un elemento di tipo int 
+     * Se in cima allo stack degli operandi non c'e` un elemento di tipo int
      * viene lanciata un'eccezione di tipo std::string con la descrizione
      * dell'errore.
      */
+    template<bool CHECK = true>
     inline
     int32_t op_stack_top_int() const {
-      return system_stack.back().op_stack_top_int();
+      if(CHECK && (sp == op_base || sp[-1].tag != 'I'))
+        op_stack_error("non vi e` un elemento di tipo int sullo stack "
+            "degli operandi");
+      return sp[-1].value.i;
     }
 
     /**
      * Restituisce il valore dell'elemento di tipo long in cima allo stack degli
      * operandi del RdA in cima allo Stack.
-     * Se in cima allo stack degli operandi non c'e` un elemento di tipo long 
+     * Se in cima allo stack degli operandi non c'e` un elemento di tipo long
      * viene lanciata un'eccezione di tipo std::string con la descrizione
      * dell'errore.
      */
+    template<bool CHECK = true>
     inline
     int64_t op_stack_top_long() const {
-      return system_stack.back().op_stack_top_long();
+      if(CHECK && (sp - op_base < 2 || sp[-1].tag != '$' || sp[-2].tag != 'J'))
+        op_stack_error("non vi e` un elemento di tipo long sullo stack "
+            "degli operandi");
+      return sp[-2].value.l;
     }
 
     /**
      * Restituisce il valore dell'elemento di tipo ref in cima allo stack degli
      * operandi del RdA in cima allo Stack.
-     * Se in cima allo stack degli operandi non c'e` un elemento di tipo ref 
+     * Se in cima allo stack degli operandi non c'e` un elemento di tipo ref
      * viene lanciata un'eccezione di tipo std::string con la descrizione
      * dell'errore.
      */
+    template<bool CHECK = true>
     inline
     void* op_stack_top_ref() const {
-      return system_stack.back().op_stack_top_ref();
+      if(CHECK && (sp == op_base || sp[-1].tag != 'L'))
+        op_stack_error("non vi e` un riferimento sullo stack degli operandi");
+      return sp[-1].value.a;
     }
 
     /**
-     * Restituisce il tipo dell'oggetto puntato dall'elemento di tipo ref in 
-     * cima allo stack degli operandi del RdA in cima allo Stack. Se in cima 
-     * allo stack degli operandi non c'e` un elemento di tipo ref 
+     * Restituisce il tipo dell'oggetto puntato dall'elemento di tipo ref in
+     * cima allo stack degli operandi del RdA in cima allo Stack. Se in cima
+     * allo stack degli operandi non c'e` un elemento di tipo ref
      * viene lanciata un'eccezione di tipo std::string con la descrizione
      * dell'errore.
      */
     inline
     string op_stack_top_ref_type() const {
-      return system_stack.back().op_stack_top_ref_type();
+      return ref_type_name(op_stack_top_ref_type_id());
+    }
+
+    /**
+     * Restituisce l'indice, nella tabella dei tipi, del tipo dell'oggetto
+     * puntato dall'elemento di tipo ref in cima allo stack degli operandi del
+     * RdA in cima allo Stack. Se in cima allo stack degli operandi non c'e` un
+     * elemento di tipo ref viene lanciata un'eccezione di tipo std::string con
+     * la descrizione dell'errore.
+     */
+    template<bool CHECK = true>
+    inline
+    uint16_t op_stack_top_ref_type_id() const {
+      if(CHECK && (sp == op_base || sp[-1].tag != 'L'))
+        op_stack_error("non vi e` un riferimento sullo stack degli operandi");
+      return sp[-1].ref_type;
+    }
+
+    /**
+     * Restituisce il carattere che rappresenta il tipo di elemento in cima
+     * allo stack degli operandi del RdA in cima allo Stack con questa
+     * convenzione:
+     *   - 'I': tipo int
+     *   - 'J': tipo long
+     *   - 'L': tipo ref (riferimento)
+     * Se lo stack e` vuoto viene lanciata un'eccezione di tipo std::string con
+     * la descrizione dell'errore.
+     */
+    inline
+    char op_stack_top_type() const {
+      if(sp == op_base)
+        op_stack_error("si e` cercato di accedere allo stack degli operandi "
+            "che e` vuoto");
+      // la cima di un long e` la sua seconda posizione
+      return sp[-1].tag == '$' ? 'J' : sp[-1].tag;
     }
 
     /**
@@ -214,31 +379,69 @@ class SystemStack {
      */
     inline
     bool op_stack_empty() const {
-      return system_stack.back().op_stack_empty();
+      return sp == op_base;
+    }
+
+    /**
+     * Restituisce il numero di Slot dello stack degli operandi del RdA in
+     * cima allo Stack.
+     */
+    inline
+    unsigned int op_stack_size() const {
+      return static_cast<unsigned int>(sp - op_base);
+    }
+
+    /**
+     * Restituisce lo Slot dello stack degli operandi del RdA in cima allo
+     * Stack a distanza <tt>depth</tt> dalla cima (0 e` la cima), che deve
+     * essere minore di op_stack_size().
+     */
+    inline
+    const Slot& op_stack_peek(const unsigned int& depth) const {
+      return sp[-1 - static_cast<long>(depth)];
     }
 
     /**
-     * Toglie il primo elemento sullo stack degli operandi che occupa uno slot 
-     * (int o ref). Se in cima e` presente un elemento che occupa due posizioni 
+     * Toglie il primo elemento sullo stack degli operandi che occupa uno slot
+     * (int o ref). Se in cima e` presente un elemento che occupa due posizioni
      * viene lanciata un'eccezione di tipo std::string con la descrizione
      * dell'errore.
      * NOTA: se viene tolto un elemento di tipo "ref" (un riferimento) NON viene
      * distrutto l'oggetto puntato dal riferimento.
      */
+    template<bool CHECK = true>
     inline
     void op_stack_pop() {
-      system_stack.back().op_stack_pop();
+      if(CHECK) {
+        if(sp == op_base)
+          op_stack_error("pop sullo stack degli operandi vuoto");
+        // gli unici tipi che occupano un posto sono int ('I') e ref ('L')
+        if(sp[-1].tag != 'I' && sp[-1].tag != 'L')
+          op_stack_error("si ci aspettava un int o un riferimento sullo "
+              "stack degli operandi durante l'operazione pop");
+      }
+      --sp;
       return;
     }
 
     /**
-     * Toglie il primo elemento sullo stack degli operandi che occupa due slot 
-     * (long). Se in cima e` presente un elemento che occupa un posto viene 
+     * Toglie il primo elemento sullo stack degli operandi che occupa due slot
+     * (long). Se in cima e` presente un elemento che occupa un posto viene
      * lanciata un'eccezione di tipo std::string con la descrizione dell'errore.
      */
+    template<bool CHECK = true>
     inline
     void op_stack_pop2() {
-      system_stack.back().op_stack_pop2();
+      if(CHECK) {
+        if(sp == op_base)
+          op_stack_error("pop sullo stack degli operandi vuoto");
+        // l'unico tipo che occupa due posizioni e` il long ('J' seguito da
+        // '$')
+        if(sp[-1].tag != '$')
+          op_stack_error("si ci aspettava un long sullo stack degli operandi "
+              "durante l'operazione pop");
+      }
+      sp -= 2;
       return;
     }
 
@@ -248,9 +451,20 @@ class SystemStack {
      * un elemento che occupa due posizioni, o se lo stack e` vuoto viene
      * lanciata un'eccezione di tipo std::string con la descrizione dell'errore.
      */
+    template<bool CHECK = true>
     inline
     void op_stack_dup() {
-      system_stack.back().op_stack_dup();
+      if(CHECK) {
+        if(sp == op_base)
+          op_stack_error("accesso allo stack degli operandi vuoto");
+        if(sp[-1].tag != 'I' && sp[-1].tag != 'L')
+          op_stack_error("si ci aspettava un int o un riferimento sullo "
+              "stack degli operandi");
+      }
+      if(CHECK && sp == limit)
+        grow(1);
+      sp[0] = sp[-1];
+      ++sp;
       return;
     }
 
@@ -260,9 +474,17 @@ class SystemStack {
      * elemento che occupa una posizione, o se lo stack e` vuoto viene lanciata
      * un'eccezione di tipo std::string con la descrizione dell'errore.
      */
+    template<bool CHECK = true>
     inline
     void op_stack_dup2() {
-      system_stack.back().op_stack_dup2();
+      if(CHECK) {
+        if(sp == op_base)
+          op_stack_error("accesso allo stack degli operandi vuoto");
+        if(sp[-1].tag != '$')
+          op_stack_error("si ci aspettava un long sullo stack degli "
+              "operandi");
+      }
+      op_stack_push_long<CHECK>(op_stack_top_long<CHECK>());
       return;
     }
 
@@ -273,51 +495,131 @@ class SystemStack {
      * una posizione, o se lo stack contiene meno di due elementi, viene
      * lanciata un'eccezione di tipo std::string con la descrizione dell'errore.
      */
+    template<bool CHECK = true>
     inline
     void op_stack_swap() {
-      system_stack.back().op_stack_swap();
+      if(CHECK) {
+        if(sp - op_base < 2)
+          op_stack_error("swap sullo stack degli operandi con meno di due "
+              "elementi");
+        if((sp[-1].tag != 'I' && sp[-1].tag != 'L') ||
+            (sp[-2].tag != 'I' && sp[-2].tag != 'L'))
+          op_stack_error("si ci aspettava un int o un riferimento sullo "
+              "stack degli operandi");
+      }
+      Slot slot = sp[-1];
+      sp[-1] = sp[-2];
+      sp[-2] = slot;
       return;
     }
 
     /**
-     * Utilizzato per il passaggio di parametri nelle chiamate a funzione.\\
-     * Prende l'elemento di tipo int sullo stack degli operandi del RdA
-     * "vecchio" (cioe` NON il RdA in cima allo stack di sistema, ma il
-     * precedente), e lo mette nella variabile locale <tt>index</tt> del RdA
-     * in cima allo stack. In caso di errori (il tipo non e` esatto) viene
-     * lanciata un'eccezione di tipo std::string con la descrizione dell'errore.
+     * Restituisce il puntatore alla prima variabile locale del RdA in cima
+     * allo Stack. Le variabili locali, l'intestazione e lo stack degli
+     * operandi del RdA sono Slot consecutivi, percio` da questo puntatore si
+     * raggiunge anche la posizione <em>d</em> dello stack degli operandi, con
+     * l'indice <em>n_locals</em> + HEADER_SLOTS + <em>d</em> (vedi
+     * RegisterCode). Il puntatore non e` piu` valido dopo un'operazione che
+     * crea un RdA o ingrandisce lo Stack.
      */
     inline
-    void parameter_pass_int(const uint16_t& index) {
-      list<ActivationRecord>::reverse_iterator r_iter = system_stack.rbegin();
-      ++r_iter;
-      this->local_variable_set_int(index, r_iter->op_stack_top_int());
-      r_iter->op_stack_pop();
+    Slot* frame_slots() const {
+      return locals;
+    }
+
+    /**
+     * Imposta a <tt>n</tt> il numero di Slot dello stack degli operandi del
+     * RdA in cima allo Stack, i cui valori sono gia` stati scritti attraverso
+     * frame_slots() (nello spazio riservato con op_stack_reserve()).
+     */
+    inline
+    void op_stack_set_size(const unsigned int& n) {
+      sp = op_base + n;
       return;
     }
 
     /**
-     * Utilizzato per il passaggio di parametri nelle chiamate a funzione.\\
-     * Prende l'elemento di tipo long sullo stack degli operandi del RdA
-     * "vecchio" (cioe` NON il RdA in cima allo stack di sistema, ma il
-     * precedente), e lo mette nella variabile locale <tt>index</tt> del RdA
-     * in cima allo stack. In caso di errori (il tipo non e` esatto) viene
-     * lanciata un'eccezione di tipo std::string con la descrizione dell'errore.
+     * Si assicura che sopra la cima dello stack degli operandi del RdA in
+     * cima allo Stack ci siano almeno <tt>n</tt> Slot liberi, ingrandendo
+     * l'area se necessario.
      */
     inline
-    void parameter_pass_long(const uint16_t& index) {
-      list<ActivationRecord>::reverse_iterator r_iter = system_stack.rbegin();
-      ++r_iter;
-      this->local_variable_set_long(index, r_iter->op_stack_top_long());
-      r_iter->op_stack_pop2();
+    void op_stack_reserve(const unsigned int& n) {
+      if(static_cast<unsigned int>(limit - sp) < n)
+        grow(n);
       return;
     }
 
+    //! posizioni dell'area occupate da un'intestazione
+    static const unsigned int HEADER_SLOTS =
+      (sizeof(ActivationRecord) + sizeof(Slot) - 1) / sizeof(Slot);
+
   private:
     /* VARIABILI PRIVATE */
 
-    //! Stack di record di attivazione (ActivationRecord)
-    list<ActivationRecord> system_stack;
+    //! Area contigua con tutti gli AR
+    Slot* region;
+
+    //! Fine dell'area allocata
+    Slot* limit;
+
+    //! Intestazione dell'AR in cima allo Stack (0 se lo Stack e` vuoto)
+    ActivationRecord* frame;
+
+    //! Variabili locali dell'AR in cima allo Stack
+    Slot* locals;
+
+    //! Base dello stack degli operandi dell'AR in cima allo Stack
+    Slot* op_base;
+
+    //! Cima dello stack degli operandi dell'AR in cima allo Stack (primo Slot
+    //! libero)
+    Slot* sp;
+
+    //! Diverso da 0 mentre l'area viene ingrandita (vedi backtrace())
+    volatile sig_atomic_t resizing;
+
+    /* METODI PRIVATI */
+
+    // lo Stack non puo` essere copiato
+    SystemStack(const SystemStack&);
+    SystemStack& operator=(const SystemStack&);
+
+    // base dello stack degli operandi dell'AR con intestazione ar
+    inline
+    Slot* operand_base(ActivationRecord* ar) const {
+      return reinterpret_cast<Slot*>(ar) + HEADER_SLOTS;
+    }
+
+    // svuota la variabile locale index (e l'altra meta` se e` un long)
+    inline
+    void clear_variable(const uint16_t& index) {
+      if(locals[index].tag == 'J')
+        locals[index+1].tag = char();
+      else if(locals[index].tag == '$')
+        locals[index-1].tag = char();
+      locals[index].tag = char();
+      return;
+    }
+
+    // crea un AR con n_locals variabili locali, di cui le prime n_args sono
+    // gli ultimi n_args Slot dello stack degli operandi, e n_stack posizioni
+    // libere per il suo stack degli operandi
+    void push_frame(const unsigned int& n_locals, const unsigned int& n_args,
+        const unsigned int& n_stack);
+
+    // ingrandisce l'area in modo che ci siano almeno n posizioni libere
+    // sopra la cima dello stack degli operandi
+    void grow(const unsigned int& n);
+
+    // lanciano l'eccezione con la descrizione dell'errore
+    void op_stack_error(const char* message) const;
+    void variable_error(const uint16_t& index, const char* message) const;
+    void variable_type_error(const uint16_t& index, const char* type) const;
+    void argument_error(const char& type) const;
+
+    // valore di previous_frame per il primo AR dello Stack
+    static const uint32_t NO_FRAME = 0xFFFFFFFFu;
 
 };
 
@@ -0,0 +1,388 @@
+/*!
+  \file Verifier.cc
+  \brief Implementazione di Verifier
+  \author Andrea Zanelli
+  \date 17-10-2026
+*/
+
+#ifndef VERIFIER_CC_INCLUSION_GUARD
+#define VERIFIER_CC_INCLUSION_GUARD
+
+#include <stdio.h>
+
+#include <algorithm>
+
+#include "NativeMethod.h"
+#include "Slot.h"
+#include "Verifier.h"
+
+
+/* Verifier(const ProgramArea& program, const Function& function) *************/
+Verifier::Verifier(const ProgramArea& program, const Function& function)
+  : program(program), function(function), code(program.get_code()),
+    max_stack(0) {
+}
+
+
+/* bool verify(string& reason) ************************************************/
+bool
+Verifier::verify(string& reason) {
+  const unsigned int n = function.end - function.start + 1;
+  states.assign(n, State());
+  targets.assign(n, false);
+  max_stack = 0;
+
+  // stato iniziale: stack vuoto, parametri nelle prime variabili locali
+  State iniziale;
+  iniziale.reached = true;
+  iniziale.locals.assign(function.locals, Type());
+  for(string::size_type i = 0; i < function.arguments.size(); ++i)
+    iniziale.locals[i] = function.arguments[i];
+  states[0] = iniziale;
+
+  vector<unsigned int> da_simulare(1, 0);
+  while(!da_simulare.empty()) {
+    unsigned int i = da_simulare.back();
+    da_simulare.pop_back();
+    State stato = states[i];
+    if(!simulate(i, stato, reason))
+      return false;
+    if(stato.stack.size() > max_stack)
+      max_stack = stato.stack.size();
+    if(max_stack > function.stack_limit) {
+      reason = "lo stack degli operandi supera il limite di .limit stack";
+      return false;
+    }
+
+    // successori: l'istruzione seguente e la destinazione del salto
+    const Instruction& istr = code[function.start + i];
+    bool prosegue = istr.opcode != OP_GOTO && istr.opcode != OP_RETURN &&
+      istr.opcode != OP_IRETURN && istr.opcode != OP_LRETURN;
+    if(istr.opcode >= OP_GOTO && istr.opcode <= OP_IFNE) {
+      if(istr.index < function.start || istr.index > function.end) {
+        reason = "salto fuori dalla funzione";
+        return false;
+      }
+      unsigned int j = istr.index - function.start;
+      targets[j] = true;
+      State precedente = states[j];
+      if(!merge(j, stato, reason))
+        return false;
+      if(!precedente.reached || precedente.locals != states[j].locals)
+        da_simulare.push_back(j);
+    }
+    if(prosegue) {
+      if(i + 1 >= n) {
+        reason = "la funzione non termina con un'istruzione di ritorno";
+        return false;
+      }
+      State precedente = states[i + 1];
+      if(!merge(i + 1, stato, reason))
+        return false;
+      if(!precedente.reached || precedente.locals != states[i + 1].locals)
+        da_simulare.push_back(i + 1);
+    }
+  }
+  return true;
+} // end of method verify(string& reason)
+
+
+/* bool merge(const unsigned int& i, const State& state, string& reason) ******/
+bool
+Verifier::merge(const unsigned int& i, const State& state, string& reason) {
+  State& destinazione = states[i];
+  if(!destinazione.reached) {
+    destinazione = state;
+    return true;
+  }
+  if(destinazione.stack != state.stack) {
+    reason = "stack degli operandi diverso nei percorsi che si uniscono";
+    return false;
+  }
+  // una variabile con tipi diversi non puo` essere letta; se nessuno dei due
+  // tipi e` (forse) parte di un long viene considerata vuota, cosi` le
+  // istruzioni istore e lstore sulle variabili vicine restano tipizzate
+  for(vector<Type>::size_type k = 0; k < state.locals.size(); ++k) {
+    Type& t = destinazione.locals[k];
+    if(t == state.locals[k])
+      continue;
+    if(is_long_part(t) || is_long_part(state.locals[k]))
+      t = UNKNOWN;
+    else
+      t = Type();
+  }
+  return true;
+}
+
+
+/* void clear(vector<Type>& locals, const unsigned int& n) ********************/
+void
+Verifier::clear(vector<Type>& locals, const unsigned int& n) {
+  if(locals[n] == 'J' || locals[n] == UNKNOWN) {
+    if(n + 1 < locals.size())
+      locals[n + 1] = (locals[n] == 'J') ? Type() : UNKNOWN;
+  }
+  if(locals[n] == '$' || locals[n] == UNKNOWN) {
+    if(n > 0)
+      locals[n - 1] = (locals[n] == '$') ? Type() : UNKNOWN;
+  }
+  locals[n] = Type();
+  return;
+}
+
+
+/* bool simulate_native(const Instruction& istr, vector<Type>& s) const *******/
+bool
+Verifier::simulate_native(const Instruction& istr, vector<Type>& s) const {
+  // i tipi dichiarati dal metodo (nessuno per un metodo sconosciuto)
+  const NativeMethod& metodo = native_method(istr.index);
+  const vector<Type>& argomenti = metodo.arguments;
+  if(s.size() < argomenti.size() ||
+      !std::equal(argomenti.begin(), argomenti.end(),
+        s.end() - argomenti.size()))
+    return false;
+  s.resize(s.size() - argomenti.size());
+  s.insert(s.end(), metodo.result.begin(), metodo.result.end());
+  return true;
+}
+
+
+/* bool simulate(const unsigned int& i, State& state, string& reason) const ***/
+bool
+Verifier::simulate(const unsigned int& i, State& state, string& reason) const {
+  const Instruction& istr = code[function.start + i];
+  vector<Type>& s = state.stack;
+  vector<Type>& l = state.locals;
+  const vector<Type>::size_type n = s.size();
+  // controlli sulla cima dello stack degli operandi
+  #define CIMA_INT(k) (n >= (k) + 1 && s[n - (k) - 1] == 'I')
+  #define CIMA_LONG(k) (n >= (k) + 2 && s[n - (k) - 1] == '$' && \
+                        s[n - (k) - 2] == 'J')
+  #define CIMA_UNO(k) (n >= (k) + 1 && (s[n - (k) - 1] == 'I' || \
+                       (s[n - (k) - 1] >= REF && s[n - (k) - 1] != UNKNOWN)))
+  bool valida = true;
+  switch(istr.opcode) {
+    case OP_NOP:
+    case OP_GOTO:
+      break;
+    case OP_LDC_W:
+      s.push_back(istr.type == 'L' ? REF + REF_STRING : 'I');
+      break;
+    case OP_LDC2_W:
+      s.push_back('J');
+      s.push_back('$');
+      break;
+    case OP_SIPUSH:
+      s.push_back('I');
+      break;
+    case OP_IF_ICMPEQ: case OP_IF_ICMPGE: case OP_IF_ICMPGT:
+    case OP_IF_ICMPLE: case OP_IF_ICMPLT: case OP_IF_ICMPNE:
+    case OP_IADD: case OP_IDIV: case OP_IMUL: case OP_IREM:
+    case OP_ISHL: case OP_ISHR: case OP_ISUB:
+      valida = CIMA_INT(0) && CIMA_INT(1);
+      if(valida) {
+        s.resize(n - 2);
+        if(istr.opcode >= OP_IADD)
+          s.push_back('I');
+      }
+      break;
+    case OP_IFEQ: case OP_IFGE: case OP_IFGT:
+    case OP_IFLE: case OP_IFLT: case OP_IFNE:
+      valida = CIMA_INT(0);
+      if(valida)
+        s.pop_back();
+      break;
+    case OP_GETSTATIC:
+      if(istr.type == 'J') {
+        s.push_back('J');
+        s.push_back('$');
+      }
+      else if(istr.type == 'L')
+        s.push_back(REF + istr.index);
+      else
+        s.push_back('I');
+      break;
+    case OP_PUTSTATIC:
+      if(istr.type == 'J') {
+        valida = CIMA_LONG(0);
+        if(valida)
+          s.resize(n - 2);
+      }
+      else {
+        valida = istr.type != 'L' && CIMA_INT(0);
+        if(valida)
+          s.pop_back();
+      }
+      break;
+    case OP_INVOKESTATIC: {
+      if(istr.type != 'M') {
+        valida = simulate_native(istr, s);
+        break;
+      }
+      const Function& chiamata = program.get_function(istr.index);
+      const string& argomenti = chiamata.arguments;
+      valida = n >= argomenti.size();
+      for(string::size_type k = 0; valida && k < argomenti.size(); ++k) {
+        Type t = s[n - argomenti.size() + k];
+        valida = (argomenti[k] == 'L') ? (t >= REF && t != UNKNOWN)
+                                       : (t == Type(argomenti[k]));
+      }
+      if(!valida)
+        break;
+      s.resize(n - argomenti.size());
+      if(chiamata.return_type == 'I')
+        s.push_back('I');
+      else if(chiamata.return_type == 'J') {
+        s.push_back('J');
+        s.push_back('$');
+      }
+      else if(chiamata.return_type != 'V') {
+        reason = "chiamata a una funzione che restituisce un riferimento";
+        return false;
+      }
+      break;
+    }
+    case OP_RETURN:
+    case OP_IRETURN:
+    case OP_LRETURN: {
+      // il valore restituito dev'essere quello dichiarato, che il chiamante
+      // si aspetta sul suo stack degli operandi
+      const char ritorno = (istr.opcode == OP_IRETURN) ? 'I' :
+        (istr.opcode == OP_LRETURN) ? 'J' : 'V';
+      if(ritorno != function.return_type) {
+        reason = string(opcode_name(istr.opcode)) +
+          " diverso dal tipo di ritorno";
+        return false;
+      }
+      valida = (ritorno == 'I') ? CIMA_INT(0) :
+        (ritorno == 'J') ? CIMA_LONG(0) : true;
+      break;
+    }
+    case OP_LCMP:
+      valida = CIMA_LONG(0) && CIMA_LONG(2);
+      if(valida) {
+        s.resize(n - 4);
+        s.push_back('I');
+      }
+      break;
+    case OP_INEG: case OP_I2C: case OP_I2S:
+      valida = CIMA_INT(0);
+      break;
+    case OP_LADD: case OP_LDIV: case OP_LMUL: case OP_LREM: case OP_LSUB:
+      valida = CIMA_LONG(0) && CIMA_LONG(2);
+      if(valida)
+        s.resize(n - 2);
+      break;
+    case OP_LSHL: case OP_LSHR:
+      valida = CIMA_INT(0) && CIMA_LONG(1);
+      if(valida)
+        s.pop_back();
+      break;
+    case OP_LNEG:
+      valida = CIMA_LONG(0);
+      break;
+    case OP_ILOAD:
+      if(istr.index >= l.size() || l[istr.index] != 'I') {
+        reason = "variabile locale di tipo non noto";
+        return false;
+      }
+      s.push_back('I');
+      break;
+    case OP_LLOAD:
+      if(istr.index + 1 >= l.size() || l[istr.index] != 'J' ||
+          l[istr.index + 1] != '$') {
+        reason = "variabile locale di tipo non noto";
+        return false;
+      }
+      s.push_back('J');
+      s.push_back('$');
+      break;
+    case OP_ISTORE:
+      valida = CIMA_INT(0) && istr.index < l.size();
+      if(valida) {
+        s.pop_back();
+        clear(l, istr.index);
+        l[istr.index] = 'I';
+      }
+      break;
+    case OP_LSTORE:
+      valida = CIMA_LONG(0) && istr.index + 1 < l.size();
+      if(valida) {
+        s.resize(n - 2);
+        clear(l, istr.index);
+        clear(l, istr.index + 1);
+        l[istr.index] = 'J';
+        l[istr.index + 1] = '$';
+      }
+      break;
+    case OP_I2L:
+      valida = CIMA_INT(0);
+      if(valida) {
+        s.back() = 'J';
+        s.push_back('$');
+      }
+      break;
+    case OP_L2I:
+      valida = CIMA_LONG(0);
+      if(valida) {
+        s.resize(n - 2);
+        s.push_back('I');
+      }
+      break;
+    case OP_DUP:
+      valida = CIMA_UNO(0);
+      if(valida)
+        s.push_back(s[n - 1]);
+      break;
+    case OP_DUP2:
+      valida = CIMA_LONG(0);
+      if(valida) {
+        s.push_back('J');
+        s.push_back('$');
+      }
+      break;
+    case OP_POP:
+      valida = CIMA_UNO(0);
+      if(valida)
+        s.pop_back();
+      break;
+    case OP_POP2:
+      valida = CIMA_LONG(0);
+      if(valida)
+        s.resize(n - 2);
+      break;
+    case OP_SWAP:
+      valida = CIMA_UNO(0) && CIMA_UNO(1);
+      if(valida) {
+        Type t = s[n - 1];
+        s[n - 1] = s[n - 2];
+        s[n - 2] = t;
+      }
+      break;
+    case OP_NEW:
+      s.push_back(REF + istr.index);
+      break;
+    case OP_INVOKEVIRTUAL:
+    case OP_INVOKESPECIAL:
+      valida = simulate_native(istr, s);
+      break;
+    default:
+      // superistruzioni: la verifica precede fuse()
+      reason = string("istruzione ") + opcode_name(istr.opcode);
+      return false;
+  }
+  #undef CIMA_INT
+  #undef CIMA_LONG
+  #undef CIMA_UNO
+  if(!valida) {
+    char numero[16];
+    sprintf(numero, "%u", function.start + i);
+    reason = string("tipi non validi per ") + opcode_name(istr.opcode) +
+      " all'indice " + numero;
+    return false;
+  }
+  return true;
+} // end of method simulate(...)
+
+
+#endif // VERIFIER_CC_INCLUSION_GUARD
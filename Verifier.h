@@ -0,0 +1,167 @@
+/*!
+  \file Verifier.h
+  \brief Interfaccia di Verifier
+  \author Andrea Zanelli
+  \date 17-10-2026
+*/
+
+#ifndef VERIFIER_H_INCLUSION_GUARD
+#define VERIFIER_H_INCLUSION_GUARD
+
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+#include "Function.h"
+#include "Instruction.h"
+#include "ProgramArea.h"
+
+using std::string;
+using std::vector;
+
+
+/*!
+  \class Verifier
+  \brief Verifica statica dei tipi di una funzione
+
+  Simula l'esecuzione di una funzione sui tipi invece che sui valori, con
+  un'analisi del flusso dei dati: per ogni istruzione raggiungibile calcola
+  il tipo di ogni posizione dello stack degli operandi e di ogni variabile
+  locale (con la stessa convenzione dei tag degli Slot, 'I', 'J' seguito da
+  '$', e il tipo dei riferimenti), e controlla che ogni istruzione trovi gli
+  operandi del tipo richiesto. Nei punti in cui si uniscono piu` percorsi lo
+  stack degli operandi deve avere la stessa forma, mentre le variabili locali
+  con tipi diversi non possono piu` essere lette.\\
+  Una funzione verificata non puo` incontrare durante l'esecuzione nessuno
+  degli errori sui tipi controllati da SystemStack: l'esecutore la esegue
+  senza controlli (vedi ProgramArea::verify()), e la traduzione nel codice a
+  registri (RegisterCode) e in C++ (CppCode) usa i tipi calcolati. Restano
+  possibili solo gli errori che dipendono dai valori (divisione per 0).
+*/
+class Verifier {
+
+  public:
+    /* METODI PUBBLICI */
+
+    //! tipo di uno Slot: 0 (vuoto), 'I', 'J', '$', 'L' (variabile locale con
+    //! un riferimento), REF piu` l'indice del tipo nella tabella dei tipi
+    //! (riferimento sullo stack degli operandi) oppure UNKNOWN (tipi diversi
+    //! a seconda del percorso seguito, forse parte di un long)
+    typedef uint16_t Type;
+    static const Type REF = 0x100;
+    static const Type UNKNOWN = 0xFFFF;
+
+    /*!
+      \struct State
+      \brief Tipi all'inizio di un'istruzione
+    */
+    struct State {
+      bool reached;         //!< true se l'istruzione e` raggiungibile
+      vector<Type> stack;   //!< tipo delle posizioni dello stack degli operandi
+      vector<Type> locals;  //!< tipo delle variabili locali
+      State() : reached(false) {}
+    };
+
+    /**
+     * Costruttore: verifichera` la funzione <tt>function</tt> di
+     * <tt>program</tt>, gia` collegato e senza superistruzioni (vedi
+     * ProgramArea::fuse()).
+     */
+    Verifier(const ProgramArea& program, const Function& function);
+
+    /**
+     * Verifica la funzione: restituisce true se i tipi sono corretti in ogni
+     * istruzione raggiungibile, altrimenti false e la spiegazione in
+     * <tt>reason</tt>.
+     */
+    bool verify(string& reason);
+
+    /**
+     * Restituisce i tipi all'inizio dell'istruzione <tt>i</tt> della
+     * funzione (0 e` la prima), dopo verify().
+     */
+    inline
+    const State& get_state(const unsigned int& i) const {
+      return states[i];
+    }
+
+    /**
+     * Restituisce true se l'istruzione <tt>i</tt> della funzione e` la
+     * destinazione di un salto, dopo verify().
+     */
+    inline
+    bool is_target(const unsigned int& i) const {
+      return targets[i];
+    }
+
+    /**
+     * Restituisce il numero massimo di posizioni occupate sullo stack degli
+     * operandi, dopo verify().
+     */
+    inline
+    unsigned int get_max_stack() const {
+      return max_stack;
+    }
+
+    /**
+     * Applica a <tt>state</tt> l'istruzione <tt>i</tt> della funzione: se gli
+     * operandi non hanno i tipi richiesti restituisce false e la spiegazione
+     * in <tt>reason</tt>.
+     */
+    bool simulate(const unsigned int& i, State& state, string& reason) const;
+
+    /**
+     * Applica ai tipi <tt>s</tt> dello stack degli operandi la chiamata del
+     * metodo nativo dell'istruzione <tt>istr</tt>: se in cima non ci sono i
+     * tipi dichiarati dal metodo (vedi NativeMethod) restituisce false.
+     */
+    bool simulate_native(const Instruction& istr, vector<Type>& s) const;
+
+    /**
+     * Restituisce true se lo Slot con tipo <tt>type</tt> puo` essere una
+     * delle due posizioni di un long.
+     */
+    static inline
+    bool is_long_part(const Type& type) {
+      return type == 'J' || type == '$' || type == UNKNOWN;
+    }
+
+  private:
+    /* VARIABILI PRIVATE */
+
+    const ProgramArea& program;
+    const Function& function;
+    const Instruction* code;
+
+    //! tipi all'inizio di ogni istruzione della funzione
+    vector<State> states;
+
+    //! true per le istruzioni destinazione di un salto
+    vector<bool> targets;
+
+    //! numero massimo di posizioni dello stack degli operandi
+    unsigned int max_stack;
+
+    /* METODI PRIVATI */
+
+    // la verifica non puo` essere copiata
+    Verifier(const Verifier&);
+    Verifier& operator=(const Verifier&);
+
+    /**
+     * Unisce <tt>state</tt> ai tipi all'inizio dell'istruzione <tt>i</tt>;
+     * se lo stack degli operandi ha una forma diversa restituisce false e la
+     * spiegazione in <tt>reason</tt>.
+     */
+    bool merge(const unsigned int& i, const State& state, string& reason);
+
+    /**
+     * Svuota la variabile locale <tt>n</tt> come
+     * SystemStack::clear_variable(), con i tipi non noti.
+     */
+    static void clear(vector<Type>& locals, const unsigned int& n);
+
+};
+
+
+#endif // VERIFIER_H_INCLUSION_GUARD
@@ -0,0 +1,615 @@
+/*!
+  \file esecutore-registri.cc
+  \brief Implementazione della funzione esecutore_a_registri()
+  \author Andrea Zanelli
+  \date 17-10-2026
+*/
+
+#include <string>
+#include <stdint.h>
+
+#include "Machine.h"
+#include "NativeMethod.h"
+#include "Slot.h"
+
+using std::string;
+
+// Dichiarazione funzioni
+
+extern void esecutore(Machine& m);
+extern void libera_stringa(Machine& m, string* str);
+void esegui_registri(Machine& m);
+bool esegui_nativo(Machine& m, unsigned int& indice);
+
+
+// Stessa tecnica di dispatch di esecutore() (vedi esecutore.cc)
+#if defined(__GNUC__) && !defined(ESECUTORE_DISPATCH_SWITCH)
+#define ESECUTORE_DISPATCH_THREADED
+#endif
+
+#ifdef ESECUTORE_DISPATCH_THREADED
+#define ISTRUZIONE(op) L_##op:
+#define VAI() goto *tabella[ip->opcode]
+#else
+#define ISTRUZIONE(op) case op:
+#define VAI() continue
+#endif
+// (senza do-while: con lo switch VAI() e` un continue del ciclo esterno)
+#define PROSSIMA() \
+  { \
+    ++ip; \
+    VAI(); \
+  }
+
+// registri dell'istruzione corrente
+#define RI(x) r[ip->x].value.i
+#define RJ(x) r[ip->x].value.l
+
+// scrive il risultato (int o long) nel registro dst, con il tipo
+#define SCRIVI_I(v) \
+  do { \
+    int32_t risultato = (v); \
+    r[ip->dst].value.i = risultato; \
+    r[ip->dst].tag = 'I'; \
+  } while(0)
+#define SCRIVI_J(v) \
+  do { \
+    int64_t risultato = (v); \
+    r[ip->dst].value.l = risultato; \
+    r[ip->dst].tag = 'J'; \
+    r[ip->dst + 1].tag = '$'; \
+  } while(0)
+
+// operazioni aritmetiche senza segno: stesso risultato delle istruzioni a
+// stack, senza overflow con segno
+#define SOMMA_I(x, y) \
+  static_cast<int32_t>(static_cast<uint32_t>(x) + static_cast<uint32_t>(y))
+#define DIFFERENZA_I(x, y) \
+  static_cast<int32_t>(static_cast<uint32_t>(x) - static_cast<uint32_t>(y))
+#define PRODOTTO_I(x, y) \
+  static_cast<int32_t>(static_cast<uint32_t>(x) * static_cast<uint32_t>(y))
+
+// salto condizionato all'istruzione index
+#define SALTO(condizione) \
+  { \
+    if(condizione) { \
+      if(jit && ip->index <= static_cast<uint32_t>(ip - codice)) { \
+        const unsigned int destinazione = ip->index; \
+        CONTA(destinazione, destinazione); \
+      } \
+      ip = codice + ip->index; \
+      VAI(); \
+    } \
+    PROSSIMA(); \
+  }
+
+// con il compilatore JIT attivo: se l'istruzione indice ha codice nativo lo
+// esegue (vedi esegui_nativo()), altrimenti prosegue nell'interprete
+#define NATIVO(indice) \
+  { \
+    unsigned int indice_nativo = (indice); \
+    if(m.native.get_entry(indice_nativo) != 0) { \
+      if(!esegui_nativo(m, indice_nativo)) \
+        return; \
+      ip = codice + indice_nativo; \
+      r = m.stack.frame_slots(); \
+      VAI(); \
+    } \
+  }
+
+// conta una chiamata o un salto all'indietro sull'istruzione contatore: alla
+// soglia compila la funzione, poi prosegue dall'istruzione indice nel codice
+// nativo, se c'e`
+#define CONTA(contatore, indice) \
+  { \
+    if(m.native.get_entry(indice) == 0 && \
+        m.native.count(contatore)) \
+      m.native.compile(contatore); \
+    NATIVO(indice); \
+  }
+
+// riprende l'esecuzione del RdA in cima allo stack dopo una chiamata o un
+// ritorno: prosegue qui se esegue codice a registri, altrimenti torna a
+// esecutore_a_registri()
+#define RIPRENDI() \
+  { \
+    const unsigned int pc_ripresa = m.stack.pc_get(); \
+    if(pc_ripresa < base) \
+      return; \
+    if(jit) \
+      NATIVO(pc_ripresa - base); \
+    ip = codice + (pc_ripresa - base); \
+    r = m.stack.frame_slots(); \
+    VAI(); \
+  }
+
+
+/*!
+  \fn void esecutore_a_registri(Machine& m)
+  \brief Esegue il programma con il codice a registri delle funzioni tradotte
+
+  Come esecutore(), esegue le istruzioni puntate dal PC dell'AR in cima a
+  <tt>m.stack</tt> finche` e` presente un AR: se il PC e` nel
+  codice a registri (cioe` non e` minore del numero di istruzioni del
+  programma, vedi RegisterCode) esegue il codice a registri con
+  esegui_registri(), altrimenti le istruzioni a stack con esecutore(). Le due
+  funzioni si restituiscono il controllo quando una chiamata o un ritorno
+  passano da una funzione tradotta a una non tradotta, o viceversa.
+
+  In caso di errori viene lanciata un'eccezione di tipo std::string con la
+  descrizione dell'errore.
+*/
+void esecutore_a_registri(Machine& m) {
+  const unsigned int base = m.program.get_instructions_size();
+  while(!m.stack.empty()) {
+    if(m.stack.pc_get() >= base)
+      esegui_registri(m);
+    else
+      esecutore(m);
+  }
+  return;
+}
+
+
+/*!
+  \fn void esegui_registri(Machine& m)
+  \brief Esegue il codice a registri dal PC dell'AR in cima allo stack
+
+  Legge il PC una sola volta e lo salva nell'AR solo per le chiamate: le
+  istruzioni operano direttamente sugli Slot del RdA (vedi
+  SystemStack::frame_slots()), senza passare dallo stack degli operandi e
+  senza controlli sui tipi, gia` verificati dalla traduzione. Ritorna quando
+  lo stack di sistema e` vuoto o il RdA in cima esegue codice a stack.
+*/
+void esegui_registri(Machine& m) {
+  const RegisterInstruction* const codice = m.registers.get_code();
+  const unsigned int base = m.program.get_instructions_size();
+  const unsigned int pc = m.stack.pc_get();
+  if(pc - base >= m.registers.get_size())
+    throw string("l'istruzione richiesta e` fuori dall'area del programma");
+  const RegisterInstruction* ip = codice + (pc - base);
+  Slot* r = m.stack.frame_slots();
+  const bool jit = m.native.enabled();
+
+#ifdef ESECUTORE_DISPATCH_THREADED
+  // tabella degli indirizzi dei gestori, nello stesso ordine di RegisterOpcode
+  static const void* const tabella[R_NUMERO_OPCODE] = {
+    &&L_R_ENTER,
+    &&L_R_MOV,
+    &&L_R_MOV_J,
+    &&L_R_SWAP,
+    &&L_R_CONST_I,
+    &&L_R_CONST_J,
+    &&L_R_CONST_STR,
+    &&L_R_CONST_REF,
+    &&L_R_IADD,
+    &&L_R_ISUB,
+    &&L_R_IMUL,
+    &&L_R_IDIV,
+    &&L_R_IREM,
+    &&L_R_ISHL,
+    &&L_R_ISHR,
+    &&L_R_IADD_K,
+    &&L_R_ISUB_K,
+    &&L_R_IMUL_K,
+    &&L_R_IDIV_K,
+    &&L_R_IREM_K,
+    &&L_R_ISHL_K,
+    &&L_R_ISHR_K,
+    &&L_R_INEG,
+    &&L_R_I2C,
+    &&L_R_I2S,
+    &&L_R_I2L,
+    &&L_R_L2I,
+    &&L_R_LADD,
+    &&L_R_LSUB,
+    &&L_R_LMUL,
+    &&L_R_LDIV,
+    &&L_R_LREM,
+    &&L_R_LSHL,
+    &&L_R_LSHR,
+    &&L_R_LNEG,
+    &&L_R_LCMP,
+    &&L_R_ISTORE,
+    &&L_R_LSTORE,
+    &&L_R_GETSTATIC_I,
+    &&L_R_GETSTATIC_J,
+    &&L_R_PUTSTATIC_I,
+    &&L_R_PUTSTATIC_J,
+    &&L_R_PUTSTATIC_S,
+    &&L_R_PUTSTATIC_C,
+    &&L_R_GOTO,
+    &&L_R_IF_ICMPEQ,
+    &&L_R_IF_ICMPGE,
+    &&L_R_IF_ICMPGT,
+    &&L_R_IF_ICMPLE,
+    &&L_R_IF_ICMPLT,
+    &&L_R_IF_ICMPNE,
+    &&L_R_IF_ICMPEQ_K,
+    &&L_R_IF_ICMPGE_K,
+    &&L_R_IF_ICMPGT_K,
+    &&L_R_IF_ICMPLE_K,
+    &&L_R_IF_ICMPLT_K,
+    &&L_R_IF_ICMPNE_K,
+    &&L_R_CALL,
+    &&L_R_RETURN,
+    &&L_R_IRETURN,
+    &&L_R_LRETURN,
+    &&L_R_PRINT_I,
+    &&L_R_PRINT_C,
+    &&L_R_PRINT_J,
+    &&L_R_PRINT_STR,
+    &&L_R_PRINT_CONST,
+    &&L_R_NATIVE
+  };
+
+  VAI();
+#else
+  for(;;) {
+    switch(ip->opcode) {
+#endif
+
+    ISTRUZIONE(R_ENTER)
+      // inizio di una funzione: spazio per lo stack degli operandi
+      m.stack.op_stack_reserve(static_cast<unsigned int>(ip->value));
+      r = m.stack.frame_slots();
+      if(jit) {
+        const unsigned int indice = ip - codice;
+        CONTA(indice, indice + 1);
+      }
+      PROSSIMA();
+
+    ISTRUZIONE(R_MOV)
+      r[ip->dst] = r[ip->a];
+      PROSSIMA();
+
+    ISTRUZIONE(R_MOV_J)
+      r[ip->dst] = r[ip->a];
+      r[ip->dst + 1].tag = '$';
+      PROSSIMA();
+
+    ISTRUZIONE(R_SWAP) {
+      Slot slot = r[ip->dst];
+      r[ip->dst] = r[ip->a];
+      r[ip->a] = slot;
+      PROSSIMA();
+    }
+
+    ISTRUZIONE(R_CONST_I)
+      SCRIVI_I(static_cast<int32_t>(ip->value));
+      PROSSIMA();
+
+    ISTRUZIONE(R_CONST_J)
+      SCRIVI_J(ip->value);
+      PROSSIMA();
+
+    ISTRUZIONE(R_CONST_STR)
+      r[ip->dst].value.a = const_cast<string*>(
+          &m.program.get_constant(ip->index) );
+      r[ip->dst].ref_type = REF_STRING;
+      r[ip->dst].tag = 'L';
+      PROSSIMA();
+
+    ISTRUZIONE(R_CONST_REF)
+      r[ip->dst].value.a = 0;
+      r[ip->dst].ref_type = static_cast<uint16_t>(ip->index);
+      r[ip->dst].tag = 'L';
+      PROSSIMA();
+
+    ISTRUZIONE(R_IADD)
+      SCRIVI_I(SOMMA_I(RI(a), RI(b)));
+      PROSSIMA();
+
+    ISTRUZIONE(R_ISUB)
+      SCRIVI_I(DIFFERENZA_I(RI(a), RI(b)));
+      PROSSIMA();
+
+    ISTRUZIONE(R_IMUL)
+      SCRIVI_I(PRODOTTO_I(RI(a), RI(b)));
+      PROSSIMA();
+
+    ISTRUZIONE(R_IDIV)
+      if(RI(b) == 0)
+        throw string("divisione per 0");
+      SCRIVI_I(RI(a) / RI(b));
+      PROSSIMA();
+
+    ISTRUZIONE(R_IREM)
+      if(RI(b) == 0)
+        throw string("divisione per 0");
+      SCRIVI_I(RI(a) % RI(b));
+      PROSSIMA();
+
+    ISTRUZIONE(R_ISHL)
+      SCRIVI_I(RI(a) << RI(b));
+      PROSSIMA();
+
+    ISTRUZIONE(R_ISHR)
+      SCRIVI_I(RI(a) >> RI(b));
+      PROSSIMA();
+
+    ISTRUZIONE(R_IADD_K)
+      SCRIVI_I(SOMMA_I(RI(a), ip->value));
+      PROSSIMA();
+
+    ISTRUZIONE(R_ISUB_K)
+      SCRIVI_I(DIFFERENZA_I(RI(a), ip->value));
+      PROSSIMA();
+
+    ISTRUZIONE(R_IMUL_K)
+      SCRIVI_I(PRODOTTO_I(RI(a), ip->value));
+      PROSSIMA();
+
+    ISTRUZIONE(R_IDIV_K)
+      // la traduzione non usa costanti nulle come divisore
+      SCRIVI_I(RI(a) / static_cast<int32_t>(ip->value));
+      PROSSIMA();
+
+    ISTRUZIONE(R_IREM_K)
+      SCRIVI_I(RI(a) % static_cast<int32_t>(ip->value));
+      PROSSIMA();
+
+    ISTRUZIONE(R_ISHL_K)
+      SCRIVI_I(RI(a) << static_cast<int32_t>(ip->value));
+      PROSSIMA();
+
+    ISTRUZIONE(R_ISHR_K)
+      SCRIVI_I(RI(a) >> static_cast<int32_t>(ip->value));
+      PROSSIMA();
+
+    ISTRUZIONE(R_INEG)
+      SCRIVI_I(-RI(a));
+      PROSSIMA();
+
+    ISTRUZIONE(R_I2C)
+      SCRIVI_I(static_cast<uint16_t>(RI(a)));
+      PROSSIMA();
+
+    ISTRUZIONE(R_I2S)
+      SCRIVI_I(static_cast<int16_t>(RI(a)));
+      PROSSIMA();
+
+    ISTRUZIONE(R_I2L)
+      SCRIVI_J(static_cast<int64_t>(RI(a)));
+      PROSSIMA();
+
+    ISTRUZIONE(R_L2I)
+      SCRIVI_I(static_cast<int32_t>(RJ(a)));
+      PROSSIMA();
+
+    ISTRUZIONE(R_LADD)
+      SCRIVI_J(RJ(a) + RJ(b));
+      PROSSIMA();
+
+    ISTRUZIONE(R_LSUB)
+      SCRIVI_J(RJ(a) - RJ(b));
+      PROSSIMA();
+
+    ISTRUZIONE(R_LMUL)
+      SCRIVI_J(RJ(a) * RJ(b));
+      PROSSIMA();
+
+    ISTRUZIONE(R_LDIV)
+      if(RJ(b) == 0)
+        throw string("divisione per 0");
+      SCRIVI_J(RJ(a) / RJ(b));
+      PROSSIMA();
+
+    ISTRUZIONE(R_LREM)
+      if(RJ(b) == 0)
+        throw string("divisione per 0");
+      SCRIVI_J(RJ(a) % RJ(b));
+      PROSSIMA();
+
+    ISTRUZIONE(R_LSHL)
+      SCRIVI_J(RJ(a) << RI(b));
+      PROSSIMA();
+
+    ISTRUZIONE(R_LSHR)
+      SCRIVI_J(RJ(a) >> RI(b));
+      PROSSIMA();
+
+    ISTRUZIONE(R_LNEG)
+      SCRIVI_J(-RJ(a));
+      PROSSIMA();
+
+    ISTRUZIONE(R_LCMP)
+      SCRIVI_I(RJ(a) == RJ(b) ? 0 : (RJ(a) > RJ(b) ? 1 : -1));
+      PROSSIMA();
+
+    ISTRUZIONE(R_ISTORE)
+      m.stack.local_variable_set_int(ip->dst, RI(a));
+      if(jit)
+        NATIVO(ip - codice + 1);
+      PROSSIMA();
+
+    ISTRUZIONE(R_LSTORE)
+      m.stack.local_variable_set_long(ip->dst, RJ(a));
+      if(jit)
+        NATIVO(ip - codice + 1);
+      PROSSIMA();
+
+    ISTRUZIONE(R_GETSTATIC_I)
+      SCRIVI_I(static_cast<int32_t>(m.globals.get_value(ip->index)));
+      PROSSIMA();
+
+    ISTRUZIONE(R_GETSTATIC_J)
+      SCRIVI_J(m.globals.get_value(ip->index));
+      PROSSIMA();
+
+    ISTRUZIONE(R_PUTSTATIC_I)
+      m.globals.set_value(ip->index, RI(a));
+      PROSSIMA();
+
+    ISTRUZIONE(R_PUTSTATIC_J)
+      m.globals.set_value(ip->index, RJ(a));
+      PROSSIMA();
+
+    ISTRUZIONE(R_PUTSTATIC_S)
+      m.globals.set_value(ip->index, static_cast<int16_t>(RI(a)));
+      PROSSIMA();
+
+    ISTRUZIONE(R_PUTSTATIC_C)
+      m.globals.set_value(ip->index, static_cast<uint16_t>(RI(a)));
+      PROSSIMA();
+
+    ISTRUZIONE(R_GOTO)
+      if(jit && ip->index <= static_cast<uint32_t>(ip - codice)) {
+        const unsigned int destinazione = ip->index;
+        CONTA(destinazione, destinazione);
+      }
+      ip = codice + ip->index;
+      VAI();
+
+    ISTRUZIONE(R_IF_ICMPEQ)
+      SALTO(RI(a) == RI(b));
+
+    ISTRUZIONE(R_IF_ICMPGE)
+      SALTO(RI(a) >= RI(b));
+
+    ISTRUZIONE(R_IF_ICMPGT)
+      SALTO(RI(a) > RI(b));
+
+    ISTRUZIONE(R_IF_ICMPLE)
+      SALTO(RI(a) <= RI(b));
+
+    ISTRUZIONE(R_IF_ICMPLT)
+      SALTO(RI(a) < RI(b));
+
+    ISTRUZIONE(R_IF_ICMPNE)
+      SALTO(RI(a) != RI(b));
+
+    ISTRUZIONE(R_IF_ICMPEQ_K)
+      SALTO(RI(a) == ip->value);
+
+    ISTRUZIONE(R_IF_ICMPGE_K)
+      SALTO(RI(a) >= ip->value);
+
+    ISTRUZIONE(R_IF_ICMPGT_K)
+      SALTO(RI(a) > ip->value);
+
+    ISTRUZIONE(R_IF_ICMPLE_K)
+      SALTO(RI(a) <= ip->value);
+
+    ISTRUZIONE(R_IF_ICMPLT_K)
+      SALTO(RI(a) < ip->value);
+
+    ISTRUZIONE(R_IF_ICMPNE_K)
+      SALTO(RI(a) != ip->value);
+
+    ISTRUZIONE(R_CALL) {
+      // i parametri sono gia` nelle posizioni dello stack degli operandi: il
+      // nuovo RdA inizia da li`, come in invokestatic
+      const Function& funzione = m.program.get_function(ip->index);
+      m.stack.op_stack_set_size(ip->dst);
+      m.stack.pc_set(base + static_cast<unsigned int>(ip + 1 -
+            codice));
+      m.stack.push_ar(funzione.locals, funzione.arguments,
+          funzione.max_stack);
+      m.stack.pc_set(funzione.entry);
+      RIPRENDI();
+    }
+
+    // ritorni: il tipo restituito e` quello dichiarato dalla funzione (vedi
+    // RegisterCode::compile()), come si aspetta il chiamante
+    ISTRUZIONE(R_RETURN)
+      m.stack.pop_ar();
+      if(m.stack.empty())
+        return;
+      RIPRENDI();
+
+    ISTRUZIONE(R_IRETURN) {
+      int32_t valore = RI(a);
+      m.stack.pop_ar();
+      if(m.stack.empty()) {
+        m.result = valore;
+        return;
+      }
+      m.stack.op_stack_push_int(valore);
+      RIPRENDI();
+    }
+
+    ISTRUZIONE(R_LRETURN) {
+      int64_t valore = RJ(a);
+      m.stack.pop_ar();
+      if(m.stack.empty()) {
+        m.result = valore;
+        return;
+      }
+      m.stack.op_stack_push_long(valore);
+      RIPRENDI();
+    }
+
+    ISTRUZIONE(R_PRINT_I)
+      m.output.put_int(RI(a));
+      PROSSIMA();
+
+    ISTRUZIONE(R_PRINT_C)
+      m.output.put_char(static_cast<char>(RI(a)));
+      PROSSIMA();
+
+    ISTRUZIONE(R_PRINT_J)
+      m.output.put_long(RJ(a));
+      PROSSIMA();
+
+    ISTRUZIONE(R_PRINT_STR) {
+      string* stringa = static_cast<string*>(r[ip->a].value.a);
+      m.output.put_string(*stringa);
+      libera_stringa(m, stringa);
+      if(jit)
+        NATIVO(ip - codice + 1);
+      PROSSIMA();
+    }
+
+    ISTRUZIONE(R_PRINT_CONST)
+      m.output.put_string(m.program.get_constant(ip->index));
+      PROSSIMA();
+
+    ISTRUZIONE(R_NATIVE)
+      // i parametri sono gia` nelle posizioni dello stack degli operandi,
+      // come in R_CALL; il metodo mette il risultato nella posizione dst
+      m.stack.op_stack_set_size(ip->dst);
+      native_method(ip->index).function(m);
+      PROSSIMA();
+
+#ifndef ESECUTORE_DISPATCH_THREADED
+      default:
+        throw string("codice operativo del codice a registri non valido");
+    } // end switch
+  } // end for
+#endif
+
+} // end of function void esegui_registri()
+
+
+/*!
+  \fn bool esegui_nativo(Machine& m, unsigned int& indice)
+  \brief Esegue il codice nativo dall'istruzione <tt>indice</tt>
+  \param indice istruzione del codice a registri del RdA in cima allo stack
+
+  Esegue il codice nativo (vedi NativeCode) dell'istruzione <tt>indice</tt>
+  e, dopo le chiamate e i ritorni, quello del RdA in cima allo stack finche`
+  ne ha. Restituisce true con in <tt>indice</tt> l'istruzione da cui
+  l'interprete deve proseguire nel RdA in cima allo stack, oppure false se lo
+  stack di sistema e` vuoto o il RdA in cima esegue codice a stack.
+*/
+bool esegui_nativo(Machine& m, unsigned int& indice) {
+  const unsigned int base = m.program.get_instructions_size();
+  const void* ingresso;
+  while((ingresso = m.native.get_entry(indice)) != 0) {
+    const uint32_t esito = m.native.run(m.stack.frame_slots(),
+        ingresso);
+    if(esito == NativeCode::END)
+      return false;
+    if(esito != NativeCode::RESUME) {
+      // istruzione senza codice nativo
+      indice = esito;
+      return true;
+    }
+    const unsigned int pc = m.stack.pc_get();
+    if(pc < base)
+      return false;
+    indice = pc - base;
+  }
+  return true;
+}
@@ -10,927 +10,1262 @@
 #include <stdint.h>
 #include <cstdlib>
 
-#include "ProgramArea.h"
-#include "GlobalVariablesArea.h"
-#include "SystemStack.h"
+#include "Machine.h"
+#include "NativeMethod.h"
+#include "Slot.h"
 
 using std::string;
 
 
-// Variabili globali
-
-extern ProgramArea programma;
-extern GlobalVariablesArea variabili_globali; 
-extern SystemStack stack_di_sistema;
+// Ogni funzione riceve la macchina astratta m (vedi Machine) che esegue il
+// programma: area del programma, variabili globali, stack di sistema e
+// uscita sono quelli di m, percio` piu` macchine possono eseguire
+// contemporaneamente, in thread diversi.
 
 // Dichiarazione funzioni
 
-void f_ldc_w(string& arg);
-void f_ldc2_w(string& arg);
-void f_sipush(string& arg);
-void f_goto(string& arg);
-void f_if_icmpeq(string& arg);
-void f_if_icmpge(string& arg);
-void f_if_icmpgt(string& arg);
-void f_if_icmple(string& arg);
-void f_if_icmplt(string& arg);
-void f_if_icmpne(string& arg);
-void f_ifeq(string& arg);
-void f_ifge(string& arg);
-void f_ifgt(string& arg);
-void f_ifle(string& arg);
-void f_iflt(string& arg);
-void f_ifne(string& arg);
-void f_getstatic(string& arg);
-void f_putstatic(string& arg);
-void f_invokestatic(string& arg);
-void f_lcmp();
-void f_ireturn();
-void f_lreturn();
-void f_return();
-void f_iadd();
-void f_idiv();
-void f_imul();
-void f_ineg();
-void f_irem();
-void f_ishl();
-void f_ishr();
-void f_isub();
-void f_ladd();
-void f_ldiv();
-void f_lmul();
-void f_lneg();
-void f_lrem();
-void f_lshl();
-void f_lshr();
-void f_lsub();
-void f_iload(string& arg);
-void f_istore(string& arg);
-void f_lload(string& arg);
-void f_lstore(string& arg);
-void f_i2c();
-void f_i2s();
-void f_i2l();
-void f_l2i();
-void f_dup();
-void f_dup2();
-void f_pop();
-void f_pop2();
-void f_swap();
-void f_new(string& arg);
-void f_invokevirtual(string& arg);
-void stampa_int();
-void stampa_char();
-void stampa_long();
-void stampa_stringa();
-void f_invokespecial(string& arg);
+template<bool CONTROLLI, bool PROFILO, bool LIMITE> void esegui(Machine& m);
+template<bool PROFILO, bool LIMITE> void esegui_modo(Machine& m);
+template<bool CONTROLLI> void f_ldc_w(Machine& m, const Instruction& istr);
+template<bool CONTROLLI> void f_ldc2_w(Machine& m, const Instruction& istr);
+template<bool CONTROLLI> void f_sipush(Machine& m, const Instruction& istr);
+void f_goto(Machine& m, const Instruction& istr);
+template<bool CONTROLLI> void f_if_icmpeq(Machine& m, const Instruction& istr);
+template<bool CONTROLLI> void f_if_icmpge(Machine& m, const Instruction& istr);
+template<bool CONTROLLI> void f_if_icmpgt(Machine& m, const Instruction& istr);
+template<bool CONTROLLI> void f_if_icmple(Machine& m, const Instruction& istr);
+template<bool CONTROLLI> void f_if_icmplt(Machine& m, const Instruction& istr);
+template<bool CONTROLLI> void f_if_icmpne(Machine& m, const Instruction& istr);
+template<bool CONTROLLI> void f_ifeq(Machine& m, const Instruction& istr);
+template<bool CONTROLLI> void f_ifge(Machine& m, const Instruction& istr);
+template<bool CONTROLLI> void f_ifgt(Machine& m, const Instruction& istr);
+template<bool CONTROLLI> void f_ifle(Machine& m, const Instruction& istr);
+template<bool CONTROLLI> void f_iflt(Machine& m, const Instruction& istr);
+template<bool CONTROLLI> void f_ifne(Machine& m, const Instruction& istr);
+template<bool CONTROLLI> void f_getstatic(Machine& m, const Instruction& istr);
+template<bool CONTROLLI> void f_putstatic(Machine& m, const Instruction& istr);
+template<bool CONTROLLI>
+void f_invokestatic(Machine& m, const Instruction& istr);
+template<bool CONTROLLI> void f_lcmp(Machine& m);
+template<bool CONTROLLI>
+void f_ireturn(Machine& m, const unsigned int& pc);
+template<bool CONTROLLI>
+void f_lreturn(Machine& m, const unsigned int& pc);
+template<bool CONTROLLI> void f_return(Machine& m, const unsigned int& pc);
+void controlla_ritorno(Machine& m, const unsigned int& pc, const char& tipo);
+template<bool CONTROLLI> void f_iadd(Machine& m);
+template<bool CONTROLLI> void f_idiv(Machine& m);
+template<bool CONTROLLI> void f_imul(Machine& m);
+template<bool CONTROLLI> void f_ineg(Machine& m);
+template<bool CONTROLLI> void f_irem(Machine& m);
+template<bool CONTROLLI> void f_ishl(Machine& m);
+template<bool CONTROLLI> void f_ishr(Machine& m);
+template<bool CONTROLLI> void f_isub(Machine& m);
+template<bool CONTROLLI> void f_ladd(Machine& m);
+template<bool CONTROLLI> void f_ldiv(Machine& m);
+template<bool CONTROLLI> void f_lmul(Machine& m);
+template<bool CONTROLLI> void f_lneg(Machine& m);
+template<bool CONTROLLI> void f_lrem(Machine& m);
+template<bool CONTROLLI> void f_lshl(Machine& m);
+template<bool CONTROLLI> void f_lshr(Machine& m);
+template<bool CONTROLLI> void f_lsub(Machine& m);
+template<bool CONTROLLI> void f_iload(Machine& m, const Instruction& istr);
+template<bool CONTROLLI> void f_istore(Machine& m, const Instruction& istr);
+template<bool CONTROLLI> void f_lload(Machine& m, const Instruction& istr);
+template<bool CONTROLLI> void f_lstore(Machine& m, const Instruction& istr);
+template<bool CONTROLLI> void f_i2c(Machine& m);
+template<bool CONTROLLI> void f_i2s(Machine& m);
+template<bool CONTROLLI> void f_i2l(Machine& m);
+template<bool CONTROLLI> void f_l2i(Machine& m);
+template<bool CONTROLLI> void f_dup(Machine& m);
+template<bool CONTROLLI> void f_dup2(Machine& m);
+template<bool CONTROLLI> void f_pop(Machine& m);
+template<bool CONTROLLI> void f_pop2(Machine& m);
+template<bool CONTROLLI> void f_swap(Machine& m);
+template<bool CONTROLLI> void f_new(Machine& m, const Instruction& istr);
+template<bool CONTROLLI>
+void f_invokevirtual(Machine& m, const Instruction& istr);
+template<bool CONTROLLI>
+void chiama_nativo(Machine& m, const Instruction& istr);
+void libera_stringa(Machine& m, string* str);
+template<bool CONTROLLI>
+void f_invokespecial(Machine& m, const Instruction& istr);
+template<bool CONTROLLI>
+void f_incremento_locale(Machine& m, const Instruction* istr,
+    const int32_t& k);
+template<bool CONTROLLI>
+void f_stampa_locale_int(Machine& m, const Instruction* istr);
+template<bool CONTROLLI>
+void f_stampa_locale_long(Machine& m, const Instruction* istr);
+void f_stampa_costante_stringa(Machine& m, const Instruction* istr);
+
+
+// Tecnica di dispatch: con GCC (e i compilatori compatibili) viene usato il
+// "threaded code", saltando direttamente al gestore dell'istruzione successiva
+// attraverso una tabella di indirizzi (computed goto); definendo
+// ESECUTORE_DISPATCH_SWITCH, o con altri compilatori, viene usato uno switch.
+#if defined(__GNUC__) && !defined(ESECUTORE_DISPATCH_SWITCH)
+#define ESECUTORE_DISPATCH_THREADED
+#endif
+
+// (1), (2) e (3): legge l'istruzione puntata dal PC dell'AR in cima allo stack
+// e incrementa il PC; se il PC e` nel codice a registri (vedi RegisterCode)
+// restituisce il controllo a esecutore_a_registri()
+#define PRELEVA() \
+  do { \
+    pc = m.stack.pc_get(); \
+    if(pc >= n_istruzioni) { \
+      if(pc - n_istruzioni < n_registri) \
+        return; \
+      throw string("l'istruzione richiesta e` fuori dall'area del programma"); \
+    } \
+    istruzione = &codice[pc]; \
+    if(PROFILO) \
+      m.profiler.count(pc); \
+    if(LIMITE) \
+      m.limit.count(is_superinstruction(istruzione->opcode) ? \
+          superinstruction_length(istruzione->opcode) : 1); \
+    m.stack.pc_inc(); \
+  } while(0)
+
+// superistruzione "iload n; ldc_w k; if_icmp<cmp> label": confronta la
+// variabile locale n con la costante k e salta a label, oppure all'istruzione
+// successiva alla sequenza
+#define CONFRONTO_LOCALE(cmp) \
+  do { \
+    if(m.stack.local_variable_get_int<CONTROLLI>( \
+          static_cast<uint16_t>(istruzione[0].index)) cmp \
+        static_cast<int32_t>(istruzione[1].value)) \
+      m.stack.pc_set(istruzione[2].index); \
+    else \
+      m.stack.pc_set(pc + 3); \
+  } while(0)
+
+// dopo una chiamata o un ritorno: se la funzione in cima allo stack va
+// eseguita nell'altro modo (verificata o no, vedi ProgramArea::verify())
+// restituisce il controllo a esecutore()
+#define CAMBIO_FUNZIONE() \
+  do { \
+    if(m.program.is_verified(m.stack.pc_get()) == CONTROLLI) \
+      return; \
+  } while(0)
+
+#ifdef ESECUTORE_DISPATCH_THREADED
+#define ISTRUZIONE(op) L_##op:
+#define PROSSIMA() \
+  do { \
+    PRELEVA(); \
+    goto *tabella[istruzione->opcode]; \
+  } while(0)
+#else
+#define ISTRUZIONE(op) case op:
+#define PROSSIMA() continue
+#endif
 
 
 /*!
-  \fn void esecutore()
-  \brief Esegue le istruzioni puntate dal PC nello <tt>stack_di_sitema</tt>
+  \fn void esecutore(Machine& m)
+  \brief Esegue le istruzioni puntate dal PC nello <tt>m.stack</tt>
 
-  Finche` in <tt>stack_di_sistema</tt> e` presente un activation record (AR)
+  Finche` in <tt>m.stack</tt> e` presente un activation record (AR)
   esegue i seguenti passi:
-    - (1) Prende il valore del PC dell'AR in cima a <tt>stack_di_sitema</tt>.
-    - (2) Legge l'istruzione in <tt>programma</tt> "puntata" dal PC.
+    - (1) Prende il valore del PC dell'AR in cima a <tt>m.stack</tt>.
+    - (2) Legge l'istruzione decodificata in <tt>m.program</tt> "puntata" dal
+      PC.
     - (3) Incrementa il PC.
-    - (4) Esegue l'istruzione chiamando la funzione appropriata (da notare che
-      l'istruzione <tt>return</tt> toglie un AR da <tt>stack_di_sistema</tt>
-  Si assume che le istruzioni siano valide (sintatticamente corrette) oppure
-  vuote, senza spazi all'inizio e alla fine, con un solo spazio tra l'istruzione
-  e gli argomenti ed un solo spazio per separare piu` argomenti, senza
-  etichette.
+    - (4) Esegue l'istruzione chiamando la funzione appropriata in base al
+      codice operativo (da notare che l'istruzione <tt>return</tt> toglie un AR
+      da <tt>m.stack</tt>).
+  Le istruzioni vengono decodificate da <tt>m.program</tt> al caricamento,
+  percio` durante l'esecuzione non viene analizzata nessuna stringa: gli
+  argomenti sono gia` estratti nella struttura Instruction.\\
+  Il passo (4) usa il codice operativo come indice in una tabella con gli
+  indirizzi dei gestori (computed goto di GCC), e ogni gestore, terminata
+  l'istruzione, salta direttamente al gestore della successiva. Se il
+  compilatore non supporta i computed goto, oppure se e` definita la macro
+  ESECUTORE_DISPATCH_SWITCH, viene usato uno switch sul codice operativo.\\
+  Se il PC dell'AR in cima punta al codice a registri di una funzione
+  tradotta (vedi RegisterCode), esecutore() ritorna lasciando l'esecuzione a
+  esecutore_a_registri().\\
+  Le funzioni verificate al caricamento (vedi ProgramArea::verify() e
+  Verifier) vengono eseguite senza nessun controllo sui tipi degli elementi
+  dello stack degli operandi e delle variabili locali, le altre con tutti i
+  controlli: il ciclo dei passi (1)-(4) e` la funzione esegui(), istanziata
+  nelle due versioni, e esecutore() passa dall'una all'altra quando una
+  chiamata o un ritorno cambia il modo della funzione in cima allo stack.\\
+  Con il profilo attivo (opzione <tt>--profile</tt>, vedi Profiler) viene
+  usata un'altra coppia di versioni di esegui(), che conta ogni istruzione
+  eseguita e registra le chiamate e i ritorni in <tt>m.profiler</tt>; allo
+  stesso modo, con i limiti di istruzioni o di tempo (vedi ExecutionLimit)
+  viene usata una coppia di versioni che conta ogni istruzione in
+  <tt>m.limit</tt>. Le versioni senza profilo e senza limiti restano senza
+  nessun costo aggiuntivo.
 
   In caso di errori viene lanciata un'eccezione di tipo std::string con la
   descrizione dell'errore.
 */
-void esecutore() {
-  string istruzione = "";
-  string argomenti = "";
-  string::size_type pos_istruzione;
-
-  while(!stack_di_sistema.empty()) {
-    // (1), (2): legge l'istruzione puntata dal PC dell'AR in cima allo stack
-    istruzione = programma.get_instruction(stack_di_sistema.pc_get());
-    pos_istruzione = istruzione.find_first_of(' ');
-    if(pos_istruzione != string::npos) {
-      // siccome non ci sono spazi iniziali e finali dopo lo spazio c'e`
-      // sicuramente almeno un argomento
-      argomenti = istruzione.substr(pos_istruzione+1);
-      istruzione = istruzione.substr(0,pos_istruzione);
-    }
-    else {
-      // se non ci sono spazi significa che e` un'istruzione senza argomenti
-      argomenti = "";
+void esecutore(Machine& m) {
+  const unsigned int n_istruzioni = m.program.get_instructions_size();
+  const unsigned int n_registri = m.registers.get_size();
+  while(!m.stack.empty()) {
+    unsigned int pc = m.stack.pc_get();
+    if(pc >= n_istruzioni && pc - n_istruzioni < n_registri)
+      return;
+    // il profilo e i limiti usano versioni dell'esecutore separate, cosi`
+    // che senza --profile e senza limiti le istruzioni non vengano contate
+    if(m.profiler.is_enabled()) {
+      if(m.limit.is_enabled())
+        esegui_modo<true, true>(m);
+      else
+        esegui_modo<true, false>(m);
     }
+    else if(m.limit.is_enabled())
+      esegui_modo<false, true>(m);
+    else
+      esegui_modo<false, false>(m);
+  }
+  return;
+}
 
-    // (3): incrementa il PC
-    stack_di_sistema.pc_inc();
 
-    // (4): esegue l'istruzione
-    if(istruzione.empty()) {
-      //istruzione vuota
-    }
-    else if(istruzione == "ldc_w")
-      f_ldc_w(argomenti);
-    else if(istruzione == "ldc2_w")
-      f_ldc2_w(argomenti);
-    else if(istruzione == "sipush")
-      f_sipush(argomenti);
-    else if(istruzione == "goto")
-      f_goto(argomenti);
-    else if(istruzione == "if_icmpeq")
-      f_if_icmpeq(argomenti);
-    else if(istruzione == "if_icmpge")
-      f_if_icmpge(argomenti);
-    else if(istruzione == "if_icmpgt")
-      f_if_icmpgt(argomenti);
-    else if(istruzione == "if_icmple")
-      f_if_icmple(argomenti);
-    else if(istruzione == "if_icmplt")
-      f_if_icmplt(argomenti);
-    else if(istruzione == "if_icmpne")
-      f_if_icmpne(argomenti);
-    else if(istruzione == "ifeq")
-      f_ifeq(argomenti);
-    else if(istruzione == "ifge")
-      f_ifge(argomenti);
-    else if(istruzione == "ifgt")
-      f_ifgt(argomenti);
-    else if(istruzione == "ifle")
-      f_ifle(argomenti);
-    else if(istruzione == "iflt")
-      f_iflt(argomenti);
-    else if(istruzione == "ifne")
-      f_ifne(argomenti);
-    else if(istruzione == "getstatic")
-      f_getstatic(argomenti);
-    else if(istruzione == "invokestatic")
-      f_invokestatic(argomenti);
-    else if(istruzione == "putstatic")
-      f_putstatic(argomenti);
-    else if(istruzione == "return")
-      f_return();
-    else if(istruzione == "ireturn")
-      f_ireturn();
-    else if(istruzione == "lreturn")
-      f_lreturn();
-    else if(istruzione == "lcmp")
-      f_lcmp();
-    else if(istruzione == "nop") {
-      // nessuna operazione
-    }
-    else if(istruzione == "iadd")
-      f_iadd();
-    else if(istruzione == "idiv")
-      f_idiv();
-    else if(istruzione == "imul")
-      f_imul();
-    else if(istruzione == "ineg")
-      f_ineg();
-    else if(istruzione == "irem")
-      f_irem();
-    else if(istruzione == "ishl")
-      f_ishl();
-    else if(istruzione == "ishr")
-      f_ishr();
-    else if(istruzione == "isub")
-      f_isub();
-    else if(istruzione == "ladd")
-      f_ladd();
-    else if(istruzione == "ldiv")
-      f_ldiv();
-    else if(istruzione == "lmul")
-      f_lmul();
-    else if(istruzione == "lneg")
-      f_lneg();
-    else if(istruzione == "lrem")
-      f_lrem();
-    else if(istruzione == "lshl")
-      f_lshl();
-    else if(istruzione == "lshr")
-      f_lshr();
-    else if(istruzione == "lsub")
-      f_lsub();
-    else if(istruzione == "iload")
-      f_iload(argomenti);
-    else if(istruzione == "istore")
-      f_istore(argomenti);
-    else if(istruzione == "lload")
-      f_lload(argomenti);
-    else if(istruzione == "lstore")
-      f_lstore(argomenti);
-    else if(istruzione == "i2c")
-      f_i2c();
-    else if(istruzione == "i2s")
-      f_i2s();
-    else if(istruzione == "i2l")
-      f_i2l();
-    else if(istruzione == "l2i")
-      f_l2i();
-    else if(istruzione == "dup")
-      f_dup();
-    else if(istruzione == "dup2")
-      f_dup2();
-    else if(istruzione == "pop")
-      f_pop();
-    else if(istruzione == "pop2")
-      f_pop2();
-    else if(istruzione == "swap")
-      f_swap();
-    else if(istruzione == "new")
-      f_new(argomenti);
-    else if(istruzione == "invokevirtual")
-      f_invokevirtual(argomenti);
-    else if(istruzione == "invokespecial")
-      f_invokespecial(argomenti);
-    else {
-      throw string("istruzione sconosciuta: " + istruzione);
-    }
-
-  } // end while(!stack_di_sitema.empty())
+/*!
+  \fn void esegui_modo(Machine& m)
+  \brief Chiama la versione di esegui() con o senza controlli sui tipi
 
+  Chiama esegui() senza controlli sui tipi se la funzione in cima allo stack
+  e` verificata, con i controlli altrimenti.
+*/
+template<bool PROFILO, bool LIMITE>
+void esegui_modo(Machine& m) {
+  if(m.program.is_verified(m.stack.pc_get()))
+    esegui<false, PROFILO, LIMITE>(m);
+  else
+    esegui<true, PROFILO, LIMITE>(m);
   return;
-} // end of function void esecutore()
+}
+
+
+/*!
+  \fn void esegui(Machine& m)
+  \brief Esegue le istruzioni della funzione in cima allo stack finche` il
+  modo di esecuzione non cambia
+
+  Esegue i passi (1)-(4) di esecutore(); con <tt>CONTROLLI</tt> false la
+  funzione in cima allo stack dev'essere verificata, e le istruzioni
+  vengono eseguite senza controlli sui tipi; con <tt>PROFILO</tt> true le
+  istruzioni, le chiamate e i ritorni vengono registrati in
+  <tt>m.profiler</tt>; con <tt>LIMITE</tt> true le istruzioni vengono
+  contate in <tt>m.limit</tt>, che interrompe l'esecuzione superato un
+  limite. Ritorna quando lo stack e`
+  vuoto, quando il PC punta al codice a registri o quando, dopo una chiamata
+  o un ritorno, la funzione in cima allo stack va eseguita nell'altro modo.
+*/
+template<bool CONTROLLI, bool PROFILO, bool LIMITE>
+void esegui(Machine& m) {
+  const Instruction* codice = m.program.get_code();
+  const unsigned int n_istruzioni = m.program.get_instructions_size();
+  const unsigned int n_registri = m.registers.get_size();
+  const Instruction* istruzione;
+  unsigned int pc;
+
+#ifdef ESECUTORE_DISPATCH_THREADED
+  // tabella degli indirizzi dei gestori, nello stesso ordine di Opcode
+  static const void* const tabella[OP_NUMERO_OPCODE] = {
+    &&L_OP_NOP,
+    &&L_OP_LDC_W,
+    &&L_OP_LDC2_W,
+    &&L_OP_SIPUSH,
+    &&L_OP_GOTO,
+    &&L_OP_IF_ICMPEQ,
+    &&L_OP_IF_ICMPGE,
+    &&L_OP_IF_ICMPGT,
+    &&L_OP_IF_ICMPLE,
+    &&L_OP_IF_ICMPLT,
+    &&L_OP_IF_ICMPNE,
+    &&L_OP_IFEQ,
+    &&L_OP_IFGE,
+    &&L_OP_IFGT,
+    &&L_OP_IFLE,
+    &&L_OP_IFLT,
+    &&L_OP_IFNE,
+    &&L_OP_GETSTATIC,
+    &&L_OP_PUTSTATIC,
+    &&L_OP_INVOKESTATIC,
+    &&L_OP_RETURN,
+    &&L_OP_IRETURN,
+    &&L_OP_LRETURN,
+    &&L_OP_LCMP,
+    &&L_OP_IADD,
+    &&L_OP_IDIV,
+    &&L_OP_IMUL,
+    &&L_OP_INEG,
+    &&L_OP_IREM,
+    &&L_OP_ISHL,
+    &&L_OP_ISHR,
+    &&L_OP_ISUB,
+    &&L_OP_LADD,
+    &&L_OP_LDIV,
+    &&L_OP_LMUL,
+    &&L_OP_LNEG,
+    &&L_OP_LREM,
+    &&L_OP_LSHL,
+    &&L_OP_LSHR,
+    &&L_OP_LSUB,
+    &&L_OP_ILOAD,
+    &&L_OP_ISTORE,
+    &&L_OP_LLOAD,
+    &&L_OP_LSTORE,
+    &&L_OP_I2C,
+    &&L_OP_I2S,
+    &&L_OP_I2L,
+    &&L_OP_L2I,
+    &&L_OP_DUP,
+    &&L_OP_DUP2,
+    &&L_OP_POP,
+    &&L_OP_POP2,
+    &&L_OP_SWAP,
+    &&L_OP_NEW,
+    &&L_OP_INVOKEVIRTUAL,
+    &&L_OP_INVOKESPECIAL,
+    &&L_OP_LDC_W_ILOAD_IADD_ISTORE,
+    &&L_OP_ILOAD_LDC_W_IADD_ISTORE,
+    &&L_OP_ILOAD_LDC_W_ISUB_ISTORE,
+    &&L_OP_ILOAD_LDC_W_IF_ICMPEQ,
+    &&L_OP_ILOAD_LDC_W_IF_ICMPGE,
+    &&L_OP_ILOAD_LDC_W_IF_ICMPGT,
+    &&L_OP_ILOAD_LDC_W_IF_ICMPLE,
+    &&L_OP_ILOAD_LDC_W_IF_ICMPLT,
+    &&L_OP_ILOAD_LDC_W_IF_ICMPNE,
+    &&L_OP_GETSTATIC_ILOAD_PRINT_INT,
+    &&L_OP_GETSTATIC_LLOAD_PRINT_LONG,
+    &&L_OP_GETSTATIC_LDC_W_PRINT_STRING
+  };
+#endif
+
+  if(m.stack.empty())
+    return;
+
+#ifdef ESECUTORE_DISPATCH_THREADED
+  PROSSIMA();
+#else
+  for(;;) {
+    PRELEVA();
+    switch(istruzione->opcode) {
+#endif
+
+    ISTRUZIONE(OP_NOP)
+      // nessuna operazione (o istruzione vuota)
+      PROSSIMA();
+
+    ISTRUZIONE(OP_LDC_W)
+      f_ldc_w<CONTROLLI>(m, *istruzione);
+      PROSSIMA();
+
+    ISTRUZIONE(OP_LDC2_W)
+      f_ldc2_w<CONTROLLI>(m, *istruzione);
+      PROSSIMA();
+
+    ISTRUZIONE(OP_SIPUSH)
+      f_sipush<CONTROLLI>(m, *istruzione);
+      PROSSIMA();
+
+    ISTRUZIONE(OP_GOTO)
+      f_goto(m, *istruzione);
+      PROSSIMA();
+
+    ISTRUZIONE(OP_IF_ICMPEQ)
+      f_if_icmpeq<CONTROLLI>(m, *istruzione);
+      PROSSIMA();
+
+    ISTRUZIONE(OP_IF_ICMPGE)
+      f_if_icmpge<CONTROLLI>(m, *istruzione);
+      PROSSIMA();
+
+    ISTRUZIONE(OP_IF_ICMPGT)
+      f_if_icmpgt<CONTROLLI>(m, *istruzione);
+      PROSSIMA();
+
+    ISTRUZIONE(OP_IF_ICMPLE)
+      f_if_icmple<CONTROLLI>(m, *istruzione);
+      PROSSIMA();
+
+    ISTRUZIONE(OP_IF_ICMPLT)
+      f_if_icmplt<CONTROLLI>(m, *istruzione);
+      PROSSIMA();
+
+    ISTRUZIONE(OP_IF_ICMPNE)
+      f_if_icmpne<CONTROLLI>(m, *istruzione);
+      PROSSIMA();
+
+    ISTRUZIONE(OP_IFEQ)
+      f_ifeq<CONTROLLI>(m, *istruzione);
+      PROSSIMA();
+
+    ISTRUZIONE(OP_IFGE)
+      f_ifge<CONTROLLI>(m, *istruzione);
+      PROSSIMA();
+
+    ISTRUZIONE(OP_IFGT)
+      f_ifgt<CONTROLLI>(m, *istruzione);
+      PROSSIMA();
+
+    ISTRUZIONE(OP_IFLE)
+      f_ifle<CONTROLLI>(m, *istruzione);
+      PROSSIMA();
+
+    ISTRUZIONE(OP_IFLT)
+      f_iflt<CONTROLLI>(m, *istruzione);
+      PROSSIMA();
+
+    ISTRUZIONE(OP_IFNE)
+      f_ifne<CONTROLLI>(m, *istruzione);
+      PROSSIMA();
+
+    ISTRUZIONE(OP_GETSTATIC)
+      f_getstatic<CONTROLLI>(m, *istruzione);
+      PROSSIMA();
+
+    ISTRUZIONE(OP_PUTSTATIC)
+      f_putstatic<CONTROLLI>(m, *istruzione);
+      PROSSIMA();
+
+    ISTRUZIONE(OP_INVOKESTATIC)
+      f_invokestatic<CONTROLLI>(m, *istruzione);
+      if(PROFILO && istruzione->type == 'M')
+        m.profiler.call(istruzione->index);
+      CAMBIO_FUNZIONE();
+      PROSSIMA();
+
+    ISTRUZIONE(OP_RETURN)
+      f_return<CONTROLLI>(m, pc);
+      if(PROFILO)
+        m.profiler.ret();
+      if(m.stack.empty())
+        return;
+      CAMBIO_FUNZIONE();
+      PROSSIMA();
+
+    ISTRUZIONE(OP_IRETURN)
+      f_ireturn<CONTROLLI>(m, pc);
+      if(PROFILO)
+        m.profiler.ret();
+      if(m.stack.empty())
+        return;
+      CAMBIO_FUNZIONE();
+      PROSSIMA();
+
+    ISTRUZIONE(OP_LRETURN)
+      f_lreturn<CONTROLLI>(m, pc);
+      if(PROFILO)
+        m.profiler.ret();
+      if(m.stack.empty())
+        return;
+      CAMBIO_FUNZIONE();
+      PROSSIMA();
+
+    ISTRUZIONE(OP_LCMP)
+      f_lcmp<CONTROLLI>(m);
+      PROSSIMA();
+
+    ISTRUZIONE(OP_IADD)
+      f_iadd<CONTROLLI>(m);
+      PROSSIMA();
+
+    ISTRUZIONE(OP_IDIV)
+      f_idiv<CONTROLLI>(m);
+      PROSSIMA();
+
+    ISTRUZIONE(OP_IMUL)
+      f_imul<CONTROLLI>(m);
+      PROSSIMA();
+
+    ISTRUZIONE(OP_INEG)
+      f_ineg<CONTROLLI>(m);
+      PROSSIMA();
+
+    ISTRUZIONE(OP_IREM)
+      f_irem<CONTROLLI>(m);
+      PROSSIMA();
+
+    ISTRUZIONE(OP_ISHL)
+      f_ishl<CONTROLLI>(m);
+      PROSSIMA();
+
+    ISTRUZIONE(OP_ISHR)
+      f_ishr<CONTROLLI>(m);
+      PROSSIMA();
+
+    ISTRUZIONE(OP_ISUB)
+      f_isub<CONTROLLI>(m);
+      PROSSIMA();
+
+    ISTRUZIONE(OP_LADD)
+      f_ladd<CONTROLLI>(m);
+      PROSSIMA();
+
+    ISTRUZIONE(OP_LDIV)
+      f_ldiv<CONTROLLI>(m);
+      PROSSIMA();
+
+    ISTRUZIONE(OP_LMUL)
+      f_lmul<CONTROLLI>(m);
+      PROSSIMA();
+
+    ISTRUZIONE(OP_LNEG)
+      f_lneg<CONTROLLI>(m);
+      PROSSIMA();
+
+    ISTRUZIONE(OP_LREM)
+      f_lrem<CONTROLLI>(m);
+      PROSSIMA();
+
+    ISTRUZIONE(OP_LSHL)
+      f_lshl<CONTROLLI>(m);
+      PROSSIMA();
+
+    ISTRUZIONE(OP_LSHR)
+      f_lshr<CONTROLLI>(m);
+      PROSSIMA();
+
+    ISTRUZIONE(OP_LSUB)
+      f_lsub<CONTROLLI>(m);
+      PROSSIMA();
+
+    ISTRUZIONE(OP_ILOAD)
+      f_iload<CONTROLLI>(m, *istruzione);
+      PROSSIMA();
+
+    ISTRUZIONE(OP_ISTORE)
+      f_istore<CONTROLLI>(m, *istruzione);
+      PROSSIMA();
+
+    ISTRUZIONE(OP_LLOAD)
+      f_lload<CONTROLLI>(m, *istruzione);
+      PROSSIMA();
+
+    ISTRUZIONE(OP_LSTORE)
+      f_lstore<CONTROLLI>(m, *istruzione);
+      PROSSIMA();
+
+    ISTRUZIONE(OP_I2C)
+      f_i2c<CONTROLLI>(m);
+      PROSSIMA();
+
+    ISTRUZIONE(OP_I2S)
+      f_i2s<CONTROLLI>(m);
+      PROSSIMA();
+
+    ISTRUZIONE(OP_I2L)
+      f_i2l<CONTROLLI>(m);
+      PROSSIMA();
+
+    ISTRUZIONE(OP_L2I)
+      f_l2i<CONTROLLI>(m);
+      PROSSIMA();
+
+    ISTRUZIONE(OP_DUP)
+      f_dup<CONTROLLI>(m);
+      PROSSIMA();
+
+    ISTRUZIONE(OP_DUP2)
+      f_dup2<CONTROLLI>(m);
+      PROSSIMA();
+
+    ISTRUZIONE(OP_POP)
+      f_pop<CONTROLLI>(m);
+      PROSSIMA();
+
+    ISTRUZIONE(OP_POP2)
+      f_pop2<CONTROLLI>(m);
+      PROSSIMA();
+
+    ISTRUZIONE(OP_SWAP)
+      f_swap<CONTROLLI>(m);
+      PROSSIMA();
+
+    ISTRUZIONE(OP_NEW)
+      f_new<CONTROLLI>(m, *istruzione);
+      PROSSIMA();
+
+    ISTRUZIONE(OP_INVOKEVIRTUAL)
+      f_invokevirtual<CONTROLLI>(m, *istruzione);
+      PROSSIMA();
+
+    ISTRUZIONE(OP_INVOKESPECIAL)
+      f_invokespecial<CONTROLLI>(m, *istruzione);
+      PROSSIMA();
+
+    // Superistruzioni (vedi ProgramArea::fuse()): gli argomenti sono nelle
+    // istruzioni della sequenza, e il PC viene portato dopo l'ultima
+
+    ISTRUZIONE(OP_LDC_W_ILOAD_IADD_ISTORE)
+      f_incremento_locale<CONTROLLI>(m, istruzione + 1,
+          static_cast<int32_t>(istruzione[0].value));
+      m.stack.pc_set(pc + 4);
+      PROSSIMA();
+
+    ISTRUZIONE(OP_ILOAD_LDC_W_IADD_ISTORE)
+      f_incremento_locale<CONTROLLI>(m, istruzione,
+          static_cast<int32_t>(istruzione[1].value));
+      m.stack.pc_set(pc + 4);
+      PROSSIMA();
+
+    ISTRUZIONE(OP_ILOAD_LDC_W_ISUB_ISTORE)
+      // x - k calcolato come in isub, con gli interi senza segno
+      f_incremento_locale<CONTROLLI>(m, istruzione, static_cast<int32_t>(
+          0u - static_cast<uint32_t>(istruzione[1].value)));
+      m.stack.pc_set(pc + 4);
+      PROSSIMA();
+
+    ISTRUZIONE(OP_ILOAD_LDC_W_IF_ICMPEQ)
+      CONFRONTO_LOCALE(==);
+      PROSSIMA();
+
+    ISTRUZIONE(OP_ILOAD_LDC_W_IF_ICMPGE)
+      CONFRONTO_LOCALE(>=);
+      PROSSIMA();
+
+    ISTRUZIONE(OP_ILOAD_LDC_W_IF_ICMPGT)
+      CONFRONTO_LOCALE(>);
+      PROSSIMA();
+
+    ISTRUZIONE(OP_ILOAD_LDC_W_IF_ICMPLE)
+      CONFRONTO_LOCALE(<=);
+      PROSSIMA();
+
+    ISTRUZIONE(OP_ILOAD_LDC_W_IF_ICMPLT)
+      CONFRONTO_LOCALE(<);
+      PROSSIMA();
+
+    ISTRUZIONE(OP_ILOAD_LDC_W_IF_ICMPNE)
+      CONFRONTO_LOCALE(!=);
+      PROSSIMA();
+
+    ISTRUZIONE(OP_GETSTATIC_ILOAD_PRINT_INT)
+      f_stampa_locale_int<CONTROLLI>(m, istruzione);
+      m.stack.pc_set(pc + 3);
+      PROSSIMA();
+
+    ISTRUZIONE(OP_GETSTATIC_LLOAD_PRINT_LONG)
+      f_stampa_locale_long<CONTROLLI>(m, istruzione);
+      m.stack.pc_set(pc + 3);
+      PROSSIMA();
+
+    ISTRUZIONE(OP_GETSTATIC_LDC_W_PRINT_STRING)
+      f_stampa_costante_stringa(m, istruzione);
+      m.stack.pc_set(pc + 3);
+      PROSSIMA();
+
+#ifndef ESECUTORE_DISPATCH_THREADED
+    default:
+      throw string("istruzione sconosciuta: ") +
+        opcode_name(istruzione->opcode);
+    } // end switch(istruzione->opcode)
+  } // end for(;;)
+#endif
+
+} // end of function void esegui()
 
 
 /**
- * \fn void f_ldc_w(string& arg)
- * \param arg x
+ * \fn void f_ldc_w(Machine& m, const Instruction& istr)
+ * \param istr x
  * \brief Esegue <tt>ldc_w x</tt>
  *
- * Estrapola <em>x</em> da <tt>arg</tt>, che puo` rappresentare una costante di 
- * tipo int o String (stringa tra virgolette), e la mette in cima allo stack 
- * degli operandi in <tt>stack_di_sistema</tt>.\\
- * Si assume che in <tt>arg</tt> ci sia sempre un valore corretto, ovvero un
- * numero intero a 32 bit con segno, oppure una stringa valida racchiusa tra
- * virgolette. Senza spazi all'inizio e alla fine di <tt>arg</tt>.
+ * Mette in cima allo stack degli operandi in <tt>m.stack</tt> la
+ * costante <em>x</em>, che puo` essere di tipo int (<tt>istr.type</tt> 'I',
+ * valore in <tt>istr.value</tt>) o String (<tt>istr.type</tt> 'L', stringa
+ * gia` senza virgolette e caratteri di escape nel pool delle costanti stringa
+ * all'indice <tt>istr.index</tt>). Per una String viene messo un riferimento
+ * alla stringa del pool, senza copiarla.
  */
-void f_ldc_w(string& arg) {
-  if(arg[0]=='"') {
-    // costante di tipo String
-    arg.erase(arg.size()-1);
-    arg.erase(0,1);
-    // sostituisce i "caratteri particolari" (es: \" diventa ") prendendo come
-    // ipotesi che la stringa sia corretta, quindi non possa finire con il
-    // carattere \ non preceduto da un altro \.
-    // Se si vogliono trasformare sequenze di caratteri in carateri speciali
-    // basta cambiare solo il codice qui sotto (es: sostituire \t con una tab.)
-    for(string::size_type i = 0; i < arg.size(); ++i) {
-      if(arg[i] == '\\') {
-        arg.erase(i,1);
-      }
-    }
-    stack_di_sistema.op_stack_push_ref("Ljava/lang/String;", new string(arg));
+template<bool CONTROLLI>
+void f_ldc_w(Machine& m, const Instruction& istr) {
+  if(istr.type == 'L') {
+    // costante di tipo String: il riferimento non viene mai modificato ne`
+    // deallocato (vedi libera_stringa())
+    m.stack.op_stack_push_ref<CONTROLLI>(REF_STRING,
+        const_cast<string*>(&m.program.get_constant(istr.index)) );
   }
   else {
     // costante di tipo int
-    stack_di_sistema.op_stack_push_int(
-        static_cast<int32_t>(atol(arg.c_str())) );
+    m.stack.op_stack_push_int<CONTROLLI>(
+        static_cast<int32_t>(istr.value));
   }
   return;
 }
 
 
 /**
- * \fn void f_ldc2_w(string& arg)
- * \param arg x
+ * \fn void f_ldc2_w(Machine& m, const Instruction& istr)
+ * \param istr x
  * \brief Esegue <tt>ldc2_w x</tt>
  *
- * Estrapola <em>x</em> da <tt>arg</tt>, che deve rappresentare una costante di 
- * tipo long, e la mette in cima allo stack degli operandi in
- * <tt>stack_di_sistema</tt>.\\
- * Si assume che in <tt>arg</tt> ci sia sempre un valore corretto, ovvero un
- * numero intero a 64 bit con segno (tipo long) senza spazi all'inizio e
- * alla fine.
+ * Mette in cima allo stack degli operandi in <tt>m.stack</tt> la
+ * costante <em>x</em> di tipo long, memorizzata in <tt>istr.value</tt>.
  */
-void f_ldc2_w(string& arg) {
-  stack_di_sistema.op_stack_push_long(
-      static_cast<int64_t>( atoll(arg.c_str())) );
+template<bool CONTROLLI>
+void f_ldc2_w(Machine& m, const Instruction& istr) {
+  m.stack.op_stack_push_long<CONTROLLI>(istr.value);
   return;
 }
 
 
 /**
- * \fn void f_sipush(string& arg)
- * \param arg x
+ * \fn void f_sipush(Machine& m, const Instruction& istr)
+ * \param istr x
  * \brief Esegue <tt>sipush x</tt>
  *
- * Estrapola <em>x</em> da <tt>arg</tt>, che deve rappresentare una costante di 
- * tipo int, la converte in short (intero con segno a 16 bit) e la mette in
- * cima allo stack degli operandi in <tt>stack_di_sistema</tt>.\\
- * Si assume che in <tt>arg</tt> ci sia sempre un valore corretto, ovvero un
- * numero intero a 32 bit con segno, senza spazi all'inizio e alla fine.
+ * Mette in cima allo stack degli operandi in <tt>m.stack</tt> la
+ * costante <em>x</em>, gia` convertita in short (intero con segno a 16 bit) al
+ * caricamento e memorizzata in <tt>istr.value</tt>.
  */
-void f_sipush(string& arg) {
-  stack_di_sistema.op_stack_push_int(
-      static_cast<int16_t>(atol(arg.c_str())) );
+template<bool CONTROLLI>
+void f_sipush(Machine& m, const Instruction& istr) {
+  m.stack.op_stack_push_int<CONTROLLI>(
+      static_cast<int32_t>(istr.value));
   return;
 }
 
 
 /**
- * \fn
+ * \fn void f_goto(Machine& m, const Instruction& istr)
  * \brief Esegue <tt>goto label</tt>
- * \param arg label
+ * \param istr label
  *
- * Ricava da <tt>programma</tt> l'indice dell'istruzione "puntata" dall'
- * ettichetta <em>label</em>, quindi imposta il PC a quell'istruzione.\\
- * Si assume che <em>label</em> esista in <tt>programma</tt> e che <tt>arg</tt>
- * sia senza spazi iniziali e finali.
+ * Imposta il PC all'istruzione "puntata" dall'ettichetta <em>label</em>.\\
+ * L'indice dell'istruzione "puntata" da <em>label</em>, risolto al
+ * caricamento, e` in <tt>istr.index</tt>.
  */
-void f_goto(string& arg) {
-  stack_di_sistema.pc_set(programma.get_label_index(arg));
+void f_goto(Machine& m, const Instruction& istr) {
+  m.stack.pc_set(istr.index);
   return;
 }
 
 
 /**
- * \fn void f_if_icmpeq(string& arg)
+ * \fn void f_if_icmpeq(Machine& m, const Instruction& istr)
  * \brief Esegue <tt>if_icmpeq label</tt>
- * \param arg label 
+ * \param istr label 
  *
  * Preleva i primi due int in cima allo stack degli operandi (a e b): se il
  * secondo e` uguale al primo (b == a) imposta il PC dell'AR in cima allo stack
- * con l'indice dell'istruzione "puntata" da <em>label<em> (indice ricavato da
- * <tt>programma</tt>), altrimenti non esegue nessuna modifica. Se in cima allo
+ * con l'indice dell'istruzione "puntata" da <em>label<em> (indice risolto al
+ * caricamento), altrimenti non esegue nessuna modifica. Se in cima allo
  * stack NON ci sono due int viene lanciata un'eccezione di tipo std::string
  * con la descrizione dell'errore.\\
- * Si assume che <em>label</em> esista in <tt>programma</tt> e che <tt>arg</tt>
- * sia senza spazi iniziali e finali.
+ * L'indice dell'istruzione "puntata" da <em>label</em>, risolto al
+ * caricamento, e` in <tt>istr.index</tt>.
  */
-void f_if_icmpeq(string& arg) {
+template<bool CONTROLLI>
+void f_if_icmpeq(Machine& m, const Instruction& istr) {
   // Se in cima allo stack degli operandi non ci sono due interi,
-  // "stack_di_sistema" lancia un'eccezione
-  int32_t value_a = stack_di_sistema.op_stack_top_int();
-  stack_di_sistema.op_stack_pop();
-  if(stack_di_sistema.op_stack_top_int() == value_a) {
+  // "m.stack" lancia un'eccezione
+  int32_t value_a = m.stack.op_stack_top_int<CONTROLLI>();
+  m.stack.op_stack_pop<CONTROLLI>();
+  if(m.stack.op_stack_top_int<CONTROLLI>() == value_a) {
     // modifica il valore del PC
-    stack_di_sistema.op_stack_pop();
-    stack_di_sistema.pc_set(programma.get_label_index(arg));
+    m.stack.op_stack_pop<CONTROLLI>();
+    m.stack.pc_set(istr.index);
   }
   else {
-    stack_di_sistema.op_stack_pop();
+    m.stack.op_stack_pop<CONTROLLI>();
   }
   return;
 }
 
 
 /**
- * \fn void f_if_icmpge(string& arg)
+ * \fn void f_if_icmpge(Machine& m, const Instruction& istr)
  * \brief Esegue <tt>if_icmpge label</tt>
- * \param arg label 
+ * \param istr label 
  *
  * Preleva i primi due int in cima allo stack degli operandi (a e b): se il
  * secondo e` maggiore-uguale al primo (b >= a) imposta il PC dell'AR in cima
  * allo stack con l'indice dell'istruzione "puntata" da <em>label<em> (indice
- * ricavato da <tt>programma</tt>), altrimenti non esegue nessuna modifica.
+ * risolto al caricamento), altrimenti non esegue nessuna modifica.
  * Se in cima allo stack NON ci sono due int viene lanciata un'eccezione di
  * tipo std::string con la descrizione dell'errore.\\
- * Si assume che <em>label</em> esista in <tt>programma</tt> e che <tt>arg</tt>
- * sia senza spazi iniziali e finali.
+ * L'indice dell'istruzione "puntata" da <em>label</em>, risolto al
+ * caricamento, e` in <tt>istr.index</tt>.
  */
-void f_if_icmpge(string& arg) {
+template<bool CONTROLLI>
+void f_if_icmpge(Machine& m, const Instruction& istr) {
   // Se in cima allo stack degli operandi non ci sono due interi,
-  // "stack_di_sistema" lancia un'eccezione
-  int32_t value_a = stack_di_sistema.op_stack_top_int();
-  stack_di_sistema.op_stack_pop();
-  if(stack_di_sistema.op_stack_top_int() >= value_a) {
+  // "m.stack" lancia un'eccezione
+  int32_t value_a = m.stack.op_stack_top_int<CONTROLLI>();
+  m.stack.op_stack_pop<CONTROLLI>();
+  if(m.stack.op_stack_top_int<CONTROLLI>() >= value_a) {
     // modifica il valore del PC
-    stack_di_sistema.op_stack_pop();
-    stack_di_sistema.pc_set(programma.get_label_index(arg));
+    m.stack.op_stack_pop<CONTROLLI>();
+    m.stack.pc_set(istr.index);
   }
   else {
-    stack_di_sistema.op_stack_pop();
+    m.stack.op_stack_pop<CONTROLLI>();
   }
   return;
 }
 
 
 /**
- * \fn void f_if_icmpgt(string& arg)
+ * \fn void f_if_icmpgt(Machine& m, const Instruction& istr)
  * \brief Esegue <tt>if_icmpgt label</tt>
- * \param arg label 
+ * \param istr label 
  *
  * Preleva i primi due int in cima allo stack degli operandi (a e b): se il
  * secondo e` maggiore del primo (b \> a) imposta il PC dell'AR in cima
  * allo stack con l'indice dell'istruzione "puntata" da <em>label<em> (indice
- * ricavato da <tt>programma</tt>), altrimenti non esegue nessuna modifica.
+ * risolto al caricamento), altrimenti non esegue nessuna modifica.
  * Se in cima allo stack NON ci sono due int viene lanciata un'eccezione di
  * tipo std::string con la descrizione dell'errore.\\
- * Si assume che <em>label</em> esista in <tt>programma</tt> e che <tt>arg</tt>
- * sia senza spazi iniziali e finali.
+ * L'indice dell'istruzione "puntata" da <em>label</em>, risolto al
+ * caricamento, e` in <tt>istr.index</tt>.
  */
-void f_if_icmpgt(string& arg) {
+template<bool CONTROLLI>
+void f_if_icmpgt(Machine& m, const Instruction& istr) {
   // Se in cima allo stack degli operandi non ci sono due interi,
-  // "stack_di_sistema" lancia un'eccezione
-  int32_t value_a = stack_di_sistema.op_stack_top_int();
-  stack_di_sistema.op_stack_pop();
-  if(stack_di_sistema.op_stack_top_int() > value_a) {
+  // "m.stack" lancia un'eccezione
+  int32_t value_a = m.stack.op_stack_top_int<CONTROLLI>();
+  m.stack.op_stack_pop<CONTROLLI>();
+  if(m.stack.op_stack_top_int<CONTROLLI>() > value_a) {
     // modifica il valore del PC
-    stack_di_sistema.op_stack_pop();
-    stack_di_sistema.pc_set(programma.get_label_index(arg));
+    m.stack.op_stack_pop<CONTROLLI>();
+    m.stack.pc_set(istr.index);
   }
   else {
-    stack_di_sistema.op_stack_pop();
+    m.stack.op_stack_pop<CONTROLLI>();
   }
   return;
 }
 
 
 /**
- * \fn void f_if_icmple(string& arg)
+ * \fn void f_if_icmple(Machine& m, const Instruction& istr)
  * \brief Esegue <tt>if_icmple label</tt>
- * \param arg label 
+ * \param istr label 
  *
  * Preleva i primi due int in cima allo stack degli operandi (a e b): se il
  * secondo e` minore-uguale al primo (b <= a) imposta il PC dell'AR in cima
  * allo stack con l'indice dell'istruzione "puntata" da <em>label<em> (indice
- * ricavato da <tt>programma</tt>), altrimenti non esegue nessuna modifica.
+ * risolto al caricamento), altrimenti non esegue nessuna modifica.
  * Se in cima allo stack NON ci sono due int viene lanciata un'eccezione di
  * tipo std::string con la descrizione dell'errore.\\
- * Si assume che <em>label</em> esista in <tt>programma</tt> e che <tt>arg</tt>
- * sia senza spazi iniziali e finali.
+ * L'indice dell'istruzione "puntata" da <em>label</em>, risolto al
+ * caricamento, e` in <tt>istr.index</tt>.
  */
-void f_if_icmple(string& arg) {
+template<bool CONTROLLI>
+void f_if_icmple(Machine& m, const Instruction& istr) {
   // Se in cima allo stack degli operandi non ci sono due interi,
-  // "stack_di_sistema" lancia un'eccezione
-  int32_t value_a = stack_di_sistema.op_stack_top_int();
-  stack_di_sistema.op_stack_pop();
-  if(stack_di_sistema.op_stack_top_int() <= value_a) {
+  // "m.stack" lancia un'eccezione
+  int32_t value_a = m.stack.op_stack_top_int<CONTROLLI>();
+  m.stack.op_stack_pop<CONTROLLI>();
+  if(m.stack.op_stack_top_int<CONTROLLI>() <= value_a) {
     // modifica il valore del PC
-    stack_di_sistema.op_stack_pop();
-    stack_di_sistema.pc_set(programma.get_label_index(arg));
+    m.stack.op_stack_pop<CONTROLLI>();
+    m.stack.pc_set(istr.index);
   }
   else {
-    stack_di_sistema.op_stack_pop();
+    m.stack.op_stack_pop<CONTROLLI>();
   }
   return;
 }
 
 
 /**
- * \fn void f_if_icmplt(string& arg)
+ * \fn void f_if_icmplt(Machine& m, const Instruction& istr)
  * \brief Esegue <tt>if_icmplt label</tt>
- * \param arg label 
+ * \param istr label 
  *
  * Preleva i primi due int in cima allo stack degli operandi (a e b): se il
  * secondo e` minore del primo (b \< a) imposta il PC dell'AR in cima
  * allo stack con l'indice dell'istruzione "puntata" da <em>label<em> (indice
- * ricavato da <tt>programma</tt>), altrimenti non esegue nessuna modifica.
+ * risolto al caricamento), altrimenti non esegue nessuna modifica.
  * Se in cima allo stack NON ci sono due int viene lanciata un'eccezione di
  * tipo std::string con la descrizione dell'errore.\\
- * Si assume che <em>label</em> esista in <tt>programma</tt> e che <tt>arg</tt>
- * sia senza spazi iniziali e finali.
+ * L'indice dell'istruzione "puntata" da <em>label</em>, risolto al
+ * caricamento, e` in <tt>istr.index</tt>.
  */
-void f_if_icmplt(string& arg) {
+template<bool CONTROLLI>
+void f_if_icmplt(Machine& m, const Instruction& istr) {
   // Se in cima allo stack degli operandi non ci sono due interi,
-  // "stack_di_sistema" lancia un'eccezione
-  int32_t value_a = stack_di_sistema.op_stack_top_int();
-  stack_di_sistema.op_stack_pop();
-  if(stack_di_sistema.op_stack_top_int() < value_a) {
+  // "m.stack" lancia un'eccezione
+  int32_t value_a = m.stack.op_stack_top_int<CONTROLLI>();
+  m.stack.op_stack_pop<CONTROLLI>();
+  if(m.stack.op_stack_top_int<CONTROLLI>() < value_a) {
     // modifica il valore del PC
-    stack_di_sistema.op_stack_pop();
-    stack_di_sistema.pc_set(programma.get_label_index(arg));
+    m.stack.op_stack_pop<CONTROLLI>();
+    m.stack.pc_set(istr.index);
   }
   else {
-    stack_di_sistema.op_stack_pop();
+    m.stack.op_stack_pop<CONTROLLI>();
   }
   return;
 }
 
 
 /**
- * \fn void f_if_icmpne(string& arg)
+ * \fn void f_if_icmpne(Machine& m, const Instruction& istr)
  * \brief Esegue <tt>if_icmpne label</tt>
- * \param arg label 
+ * \param istr label 
  *
  * Preleva i primi due int in cima allo stack degli operandi (a e b): se il
  * secondo e` diverso dal primo (b != a) imposta il PC dell'AR in cima
  * allo stack con l'indice dell'istruzione "puntata" da <em>label<em> (indice
- * ricavato da <tt>programma</tt>), altrimenti non esegue nessuna modifica.
+ * risolto al caricamento), altrimenti non esegue nessuna modifica.
  * Se in cima allo stack NON ci sono due int viene lanciata un'eccezione di
  * tipo std::string con la descrizione dell'errore.\\
- * Si assume che <em>label</em> esista in <tt>programma</tt> e che <tt>arg</tt>
- * sia senza spazi iniziali e finali.
+ * L'indice dell'istruzione "puntata" da <em>label</em>, risolto al
+ * caricamento, e` in <tt>istr.index</tt>.
  */
-void f_if_icmpne(string& arg) {
+template<bool CONTROLLI>
+void f_if_icmpne(Machine& m, const Instruction& istr) {
   // Se in cima allo stack degli operandi non ci sono due interi,
-  // "stack_di_sistema" lancia un'eccezione
-  int32_t value_a = stack_di_sistema.op_stack_top_int();
-  stack_di_sistema.op_stack_pop();
-  if(stack_di_sistema.op_stack_top_int() != value_a) {
+  // "m.stack" lancia un'eccezione
+  int32_t value_a = m.stack.op_stack_top_int<CONTROLLI>();
+  m.stack.op_stack_pop<CONTROLLI>();
+  if(m.stack.op_stack_top_int<CONTROLLI>() != value_a) {
     // modifica il valore del PC
-    stack_di_sistema.op_stack_pop();
-    stack_di_sistema.pc_set(programma.get_label_index(arg));
+    m.stack.op_stack_pop<CONTROLLI>();
+    m.stack.pc_set(istr.index);
   }
   else {
-    stack_di_sistema.op_stack_pop();
+    m.stack.op_stack_pop<CONTROLLI>();
   }
   return;
 }
 
 
 /**
- * \fn void f_ifeq(string& arg)
+ * \fn void f_ifeq(Machine& m, const Instruction& istr)
  * \brief Esegue <tt>ifeq label</tt>
- * \param arg label 
+ * \param istr label 
  *
  * Preleva il primo elemento int in cima allo stack degli operandi (a): se e`
  * uguale a zero (a == 0) imposta il PC dell'AR in cima allo stack con l'indice
- * dell'istruzione "puntata" da <em>label<em> (indice ricavato da
- * <tt>programma</tt>), altrimenti non esegue nessuna modifica.
+ * dell'istruzione "puntata" da <em>label<em> (indice risolto al
+ * caricamento), altrimenti non esegue nessuna modifica.
  * Se in cima allo stack NON c'e` un int viene lanciata un'eccezione di tipo
  * std::string con la descrizione dell'errore.\\
- * Si assume che <em>label</em> esista in <tt>programma</tt> e che <tt>arg</tt>
- * sia senza spazi iniziali e finali.
+ * L'indice dell'istruzione "puntata" da <em>label</em>, risolto al
+ * caricamento, e` in <tt>istr.index</tt>.
  */
-void f_ifeq(string& arg) {
+template<bool CONTROLLI>
+void f_ifeq(Machine& m, const Instruction& istr) {
   // Se in cima allo stack degli operandi non ci sono due interi,
-  // "stack_di_sistema" lancia un'eccezione
-  if(stack_di_sistema.op_stack_top_int() == 0) {
+  // "m.stack" lancia un'eccezione
+  if(m.stack.op_stack_top_int<CONTROLLI>() == 0) {
     // modifica il valore del PC
-    stack_di_sistema.op_stack_pop();
-    stack_di_sistema.pc_set(programma.get_label_index(arg));
+    m.stack.op_stack_pop<CONTROLLI>();
+    m.stack.pc_set(istr.index);
   }
   else {
-    stack_di_sistema.op_stack_pop();
+    m.stack.op_stack_pop<CONTROLLI>();
   }
   return;
 }
 
 
 /**
- * \fn void f_ifge(string& arg)
+ * \fn void f_ifge(Machine& m, const Instruction& istr)
  * \brief Esegue <tt>ifge label</tt>
- * \param arg label 
+ * \param istr label 
  *
  * Preleva il primo elemento int in cima allo stack degli operandi (a): se e`
  * maggiore-uguale a zero (a >= 0) imposta il PC dell'AR in cima allo stack con
- * l'indice dell'istruzione "puntata" da <em>label<em> (indice ricavato da
- * <tt>programma</tt>), altrimenti non esegue nessuna modifica.
+ * l'indice dell'istruzione "puntata" da <em>label<em> (indice risolto al
+ * caricamento), altrimenti non esegue nessuna modifica.
  * Se in cima allo stack NON c'e` un int viene lanciata un'eccezione di tipo
  * std::string con la descrizione dell'errore.\\
- * Si assume che <em>label</em> esista in <tt>programma</tt> e che <tt>arg</tt>
- * sia senza spazi iniziali e finali.
+ * L'indice dell'istruzione "puntata" da <em>label</em>, risolto al
+ * caricamento, e` in <tt>istr.index</tt>.
  */
-void f_ifge(string& arg) {
+template<bool CONTROLLI>
+void f_ifge(Machine& m, const Instruction& istr) {
   // Se in cima allo stack degli operandi non ci sono due interi,
-  // "stack_di_sistema" lancia un'eccezione
-  if(stack_di_sistema.op_stack_top_int() >= 0) {
+  // "m.stack" lancia un'eccezione
+  if(m.stack.op_stack_top_int<CONTROLLI>() >= 0) {
     // modifica il valore del PC
-    stack_di_sistema.op_stack_pop();
-    stack_di_sistema.pc_set(programma.get_label_index(arg));
+    m.stack.op_stack_pop<CONTROLLI>();
+    m.stack.pc_set(istr.index);
   }
   else {
-    stack_di_sistema.op_stack_pop();
+    m.stack.op_stack_pop<CONTROLLI>();
   }
   return;
 }
 
 
 /**
- * \fn void f_ifgt(string& arg)
+ * \fn void f_ifgt(Machine& m, const Instruction& istr)
  * \brief Esegue <tt>ifgt label</tt>
- * \param arg label 
+ * \param istr label 
  *
  * Preleva il primo elemento int in cima allo stack degli operandi (a): se e`
  * maggiore di zero (a > 0) imposta il PC dell'AR in cima allo stack con
- * l'indice dell'istruzione "puntata" da <em>label<em> (indice ricavato da
- * <tt>programma</tt>), altrimenti non esegue nessuna modifica.
+ * l'indice dell'istruzione "puntata" da <em>label<em> (indice risolto al
+ * caricamento), altrimenti non esegue nessuna modifica.
  * Se in cima allo stack NON c'e` un int viene lanciata un'eccezione di tipo
  * std::string con la descrizione dell'errore.\\
- * Si assume che <em>label</em> esista in <tt>programma</tt> e che <tt>arg</tt>
- * sia senza spazi iniziali e finali.
+ * L'indice dell'istruzione "puntata" da <em>label</em>, risolto al
+ * caricamento, e` in <tt>istr.index</tt>.
  */
-void f_ifgt(string& arg) {
+template<bool CONTROLLI>
+void f_ifgt(Machine& m, const Instruction& istr) {
   // Se in cima allo stack degli operandi non ci sono due interi,
-  // "stack_di_sistema" lancia un'eccezione
-  if(stack_di_sistema.op_stack_top_int() > 0) {
+  // "m.stack" lancia un'eccezione
+  if(m.stack.op_stack_top_int<CONTROLLI>() > 0) {
     // modifica il valore del PC
-    stack_di_sistema.op_stack_pop();
-    stack_di_sistema.pc_set(programma.get_label_index(arg));
+    m.stack.op_stack_pop<CONTROLLI>();
+    m.stack.pc_set(istr.index);
   }
   else {
-    stack_di_sistema.op_stack_pop();
+    m.stack.op_stack_pop<CONTROLLI>();
   }
   return;
 }
 
 
 /**
- * \fn void f_ifle(string& arg)
+ * \fn void f_ifle(Machine& m, const Instruction& istr)
  * \brief Esegue <tt>ifle label</tt>
- * \param arg label 
+ * \param istr label 
  *
  * Preleva il primo elemento int in cima allo stack degli operandi (a): se e`
  * minore-uguale a zero (a <= 0) imposta il PC dell'AR in cima allo stack con
- * l'indice dell'istruzione "puntata" da <em>label<em> (indice ricavato da
- * <tt>programma</tt>), altrimenti non esegue nessuna modifica.
+ * l'indice dell'istruzione "puntata" da <em>label<em> (indice risolto al
+ * caricamento), altrimenti non esegue nessuna modifica.
  * Se in cima allo stack NON c'e` un int viene lanciata un'eccezione di tipo
  * std::string con la descrizione dell'errore.\\
- * Si assume che <em>label</em> esista in <tt>programma</tt> e che <tt>arg</tt>
- * sia senza spazi iniziali e finali.
+ * L'indice dell'istruzione "puntata" da <em>label</em>, risolto al
+ * caricamento, e` in <tt>istr.index</tt>.
  */
-void f_ifle(string& arg) {
+template<bool CONTROLLI>
+void f_ifle(Machine& m, const Instruction& istr) {
   // Se in cima allo stack degli operandi non ci sono due interi,
-  // "stack_di_sistema" lancia un'eccezione
-  if(stack_di_sistema.op_stack_top_int() <= 0) {
+  // "m.stack" lancia un'eccezione
+  if(m.stack.op_stack_top_int<CONTROLLI>() <= 0) {
     // modifica il valore del PC
-    stack_di_sistema.op_stack_pop();
-    stack_di_sistema.pc_set(programma.get_label_index(arg));
+    m.stack.op_stack_pop<CONTROLLI>();
+    m.stack.pc_set(istr.index);
   }
   else {
-    stack_di_sistema.op_stack_pop();
+    m.stack.op_stack_pop<CONTROLLI>();
   }
   return;
 }
 
 
 /**
- * \fn void f_iflt(string& arg)
+ * \fn void f_iflt(Machine& m, const Instruction& istr)
  * \brief Esegue <tt>iflt label</tt>
- * \param arg label 
+ * \param istr label 
  *
  * Preleva il primo elemento int in cima allo stack degli operandi (a): se e`
  * minore di zero (a < 0) imposta il PC dell'AR in cima allo stack con
- * l'indice dell'istruzione "puntata" da <em>label<em> (indice ricavato da
- * <tt>programma</tt>), altrimenti non esegue nessuna modifica.
+ * l'indice dell'istruzione "puntata" da <em>label<em> (indice risolto al
+ * caricamento), altrimenti non esegue nessuna modifica.
  * Se in cima allo stack NON c'e` un int viene lanciata un'eccezione di tipo
  * std::string con la descrizione dell'errore.\\
- * Si assume che <em>label</em> esista in <tt>programma</tt> e che <tt>arg</tt>
- * sia senza spazi iniziali e finali.
+ * L'indice dell'istruzione "puntata" da <em>label</em>, risolto al
+ * caricamento, e` in <tt>istr.index</tt>.
  */
-void f_iflt(string& arg) {
+template<bool CONTROLLI>
+void f_iflt(Machine& m, const Instruction& istr) {
   // Se in cima allo stack degli operandi non ci sono due interi,
-  // "stack_di_sistema" lancia un'eccezione
-  if(stack_di_sistema.op_stack_top_int() < 0) {
+  // "m.stack" lancia un'eccezione
+  if(m.stack.op_stack_top_int<CONTROLLI>() < 0) {
     // modifica il valore del PC
-    stack_di_sistema.op_stack_pop();
-    stack_di_sistema.pc_set(programma.get_label_index(arg));
+    m.stack.op_stack_pop<CONTROLLI>();
+    m.stack.pc_set(istr.index);
   }
   else {
-    stack_di_sistema.op_stack_pop();
+    m.stack.op_stack_pop<CONTROLLI>();
   }
   return;
 }
 
 
 /**
- * \fn void f_ifne(string& arg)
+ * \fn void f_ifne(Machine& m, const Instruction& istr)
  * \brief Esegue <tt>ifne label</tt>
- * \param arg label 
+ * \param istr label 
  *
  * Preleva il primo elemento int in cima allo stack degli operandi (a): se e`
  * diverso da zero (a != 0) imposta il PC dell'AR in cima allo stack con
- * l'indice dell'istruzione "puntata" da <em>label<em> (indice ricavato da
- * <tt>programma</tt>), altrimenti non esegue nessuna modifica.
+ * l'indice dell'istruzione "puntata" da <em>label<em> (indice risolto al
+ * caricamento), altrimenti non esegue nessuna modifica.
  * Se in cima allo stack NON c'e` un int viene lanciata un'eccezione di tipo
  * std::string con la descrizione dell'errore.\\
- * Si assume che <em>label</em> esista in <tt>programma</tt> e che <tt>arg</tt>
- * sia senza spazi iniziali e finali.
+ * L'indice dell'istruzione "puntata" da <em>label</em>, risolto al
+ * caricamento, e` in <tt>istr.index</tt>.
  */
-void f_ifne(string& arg) {
+template<bool CONTROLLI>
+void f_ifne(Machine& m, const Instruction& istr) {
   // Se in cima allo stack degli operandi non ci sono due interi,
-  // "stack_di_sistema" lancia un'eccezione
-  if(stack_di_sistema.op_stack_top_int() != 0) {
+  // "m.stack" lancia un'eccezione
+  if(m.stack.op_stack_top_int<CONTROLLI>() != 0) {
     // modifica il valore del PC
-    stack_di_sistema.op_stack_pop();
-    stack_di_sistema.pc_set(programma.get_label_index(arg));
+    m.stack.op_stack_pop<CONTROLLI>();
+    m.stack.pc_set(istr.index);
   }
   else {
-    stack_di_sistema.op_stack_pop();
+    m.stack.op_stack_pop<CONTROLLI>();
   }
   return;
 }
 
 
 /**
- * \fn void f_getstatic(string& arg)
- * \param arg Main/f d
+ * \fn void f_getstatic(Machine& m, const Instruction& istr)
+ * \param istr Main/f d
  * \brief Esegue <tt>getstatic Main/<em>f</em> <em>d</em> </tt>
  *
  * Prende il valore della variabile globale di nome <em>f</em> e tipo <em>d</em>
- * (che puo` essere J, I, S oppure C) da <tt>variabili_globali</tt> e lo mette
+ * (che puo` essere J, I, S oppure C) da <tt>m.globals</tt> e lo mette
  * sullo stack. Si assume che la variabile globale <em>f d</em> esista, e che
  * il tipo <em>d</em> sia J, I, S oppure C.\\
- * Se <tt>getstatic</tt> e` utilizzato nella stampa, allora <tt>arg</tt>
+ * La posizione della variabile in <tt>m.globals</tt>, risolta al
+ * caricamento, e` in <tt>istr.index</tt> e il tipo <em>d</em> in
+ * <tt>istr.type</tt>.\\
+ * Se <tt>getstatic</tt> e` utilizzato nella stampa, allora l'argomento
  * dev'essere "java/lang/System/out Ljava/io/PrintStream;", in questo caso
  * viene messo sullo stack degli operandi un riferimento "finto" all'oggetto
  * <em>out</em>, che dovra` essere presente al momento della stampa.\\
- * Se <tt>getstatic</tt> e` utilizzato nella lettura, allora <tt>arg</tt>
+ * Se <tt>getstatic</tt> e` utilizzato nella lettura, allora l'argomento
  * dev'essere "java/lang/System/in Ljava/io/InputStream;", in questo caso viene
  * messo sullo stack degli operandi un "finto" riferimento all'oggetto
  * <em>in</em> che dovra` essere presente sullo stack al momento della 
- * lettura.\\
- * In ogni caso si assume che in <tt>arg</tt> ci sia un solo spazio per separare
- * gli argomenti, e non ci siano spazi iniziali e finali.
+ * lettura. In entrambi i casi <tt>istr.type</tt> vale 'L' e
+ * <tt>istr.index</tt> e` l'indice del tipo del riferimento nella tabella dei
+ * tipi.
  */
-void f_getstatic(string& arg) {
-  // Variabile globale
-  if(arg.substr(0,5) == "Main/") {
-    string::size_type pos = arg.find_first_of(' ');
-    string nome = arg.substr(5,pos-5);
-    char tipo = arg[arg.size()-1];
-    if(tipo == 'I')
-      stack_di_sistema.op_stack_push_int(
-          variabili_globali.get_variable_I(nome) );
-    else if(tipo == 'J')
-      stack_di_sistema.op_stack_push_long(
-          variabili_globali.get_variable_J(nome) );
-    else if(tipo == 'S')
-      stack_di_sistema.op_stack_push_int(
-          static_cast<int32_t>(variabili_globali.get_variable_S(nome)) );
-    else if(tipo == 'C')
-      stack_di_sistema.op_stack_push_int(
-          static_cast<int32_t>(variabili_globali.get_variable_C(nome)) );
-  }
-
-  // Stampa
-  else if(arg == "java/lang/System/out Ljava/io/PrintStream;") {
-    stack_di_sistema.op_stack_push_ref("Ljava/io/PrintStream;",0);
+template<bool CONTROLLI>
+void f_getstatic(Machine& m, const Instruction& istr) {
+  switch(istr.type) {
+    // Variabili globali
+    case 'I':
+    case 'S':
+    case 'C':
+      m.stack.op_stack_push_int<CONTROLLI>( static_cast<int32_t>(
+          m.globals.get_value(istr.index)) );
+      break;
+    case 'J':
+      m.stack.op_stack_push_long<CONTROLLI>(
+          m.globals.get_value(istr.index) );
+      break;
+
+    // Stampa e lettura
+    case 'L':
+      m.stack.op_stack_push_ref<CONTROLLI>(
+          static_cast<uint16_t>(istr.index), 0);
+      break;
   }
-
-  // Lettura
-  else if(arg == "java/lang/System/in Ljava/io/InputStream;") {
-    stack_di_sistema.op_stack_push_ref("Ljava/io/InputStream;",0);
-  }
-
   return;
-} // end of void f_getstatic(string& arg)
+} // end of void f_getstatic(const Instruction& istr)
 
 
 /**
- * \fn void f_putstatic(string& arg)
+ * \fn void f_putstatic(Machine& m, const Instruction& istr)
  * \brief Esegue <tt>putstatic Main/<em>f</em> <em>d</em></tt>
- * \param arg Main/f d
+ * \param istr Main/f d
  *
- * Estrapola da <tt>arg</tt> il nome della variabile globale <em>f</em> e il
- * tipo <em>d</em>, e memorizza in tale variabile, dentro
- * <tt>variabili_globali</tt>, il valore sullo stack degli operandi. Si assume
- * che la variabile globale <em>f d</em> esista, e che il tipo <em>d</em> sia J,
- * I, S oppure C.\\
+ * Memorizza nella variabile globale <em>f d</em>, dentro
+ * <tt>m.globals</tt>, il valore sullo stack degli operandi. La
+ * posizione della variabile, risolta al caricamento, e` in
+ * <tt>istr.index</tt> e il tipo <em>d</em> (J, I, S oppure C) in
+ * <tt>istr.type</tt>.\\
  * Se la variabile e` di tipo J, sullo stack dovra` esserci un elemento di tipo
  * long, se la variabile e` di tipo S, C o I sullo stack dovra` esserci un int.
  * se l'elemento sullo stack non e` compatibile con il tipo della variabile
  * viene lanciata un'eccezione di tipo std::string con la descrizione
- * dell'errore.\\
- * Si assume inoltre che in <tt>arg</tt> ci sia un solo spazio per separare
- * gli argomenti, e non ci siano spazi iniziali e finali.
+ * dell'errore.
  */
-void f_putstatic(string& arg) {
-  // esempio arg = "Main/field I"
-  string::size_type pos = arg.find_first_of(' ');
-  string nome = arg.substr(5,pos-5);
-  char tipo = arg[arg.size()-1];
-  // se l'elemento sullo stack non e` di tipo giusto, "stack_di_sistema" lancia
+template<bool CONTROLLI>
+void f_putstatic(Machine& m, const Instruction& istr) {
+  char tipo = istr.type;
+  // se l'elemento sullo stack non e` di tipo giusto, "m.stack" lancia
   // un'eccezione
   if(tipo == 'I') {
-    variabili_globali.set_variable_I(
-        nome,
-        stack_di_sistema.op_stack_top_int() );
-    stack_di_sistema.op_stack_pop();
+    m.globals.set_value(istr.index,
+        m.stack.op_stack_top_int<CONTROLLI>() );
+    m.stack.op_stack_pop<CONTROLLI>();
   }
   else if(tipo == 'J') {
-    variabili_globali.set_variable_J(
-        nome,
-        stack_di_sistema.op_stack_top_long() );
-    stack_di_sistema.op_stack_pop2();
+    m.globals.set_value(istr.index,
+        m.stack.op_stack_top_long<CONTROLLI>() );
+    m.stack.op_stack_pop2<CONTROLLI>();
   }
   else if(tipo == 'S') {
-    variabili_globali.set_variable_S(
-        nome,
-        static_cast<int16_t>(stack_di_sistema.op_stack_top_int()) );
-    stack_di_sistema.op_stack_pop();
+    m.globals.set_value(istr.index,
+        static_cast<int16_t>(m.stack.op_stack_top_int<CONTROLLI>()) );
+    m.stack.op_stack_pop<CONTROLLI>();
   }
   else if(tipo == 'C') {
-    variabili_globali.set_variable_C(
-        nome,
-        static_cast<uint16_t>(stack_di_sistema.op_stack_top_int()) );
-    stack_di_sistema.op_stack_pop();
+    m.globals.set_value(istr.index,
+        static_cast<uint16_t>(m.stack.op_stack_top_int<CONTROLLI>()) );
+    m.stack.op_stack_pop<CONTROLLI>();
   }
   return;
 }
 
 
 /**
- * \fn void f_invokestatic(string& arg)
- * \param arg Main/m d
+ * \fn void f_invokestatic(Machine& m, const Instruction& istr)
+ * \param istr Main/m d
  * \brief Esegue <tt>invokestatic Main/<em>m</em> <em>d</em> </tt>
  *
- * Estrapola da <tt>arg</tt> il nome e il descrittore della funzione,
- * rispettivamente <em>m</em> e <em>d</em>, quindi crea un nuovo AR in
- * <tt>stack_di_sistema</tt>, imposta il PC dell'AR alla prima istruzione della
+ * Prende dalla tabella delle funzioni di <tt>m.program</tt> l'elemento con
+ * indice <tt>istr.index</tt>, della funzione <em>m d</em> risolta al
+ * caricamento (vedi Function), quindi crea un nuovo AR in
+ * <tt>m.stack</tt>, imposta il PC dell'AR alla prima istruzione della
  * funzione <em>m d</em> ed, eventualmente, esegue il passaggio parametri alla
- * funzione chiamata, prendendo i valori sullo stack degli operandi dell'AR
- * corrente e mettendoli nelle variabili locali del nuovo AR. Nel passaggio
- * parametri viene preso come ultimo argomento il valore in cima allo stack
- * degli operandi, come penultimo il secondo in cima allo stack, e cosi` via,
- * e vengono messi nelle variabili locali, in ordine, a partire dalla variabile
- * locale 0.\\
- * Si assume che <tt>arg</tt> sia sintatticamente corretto, percio` inizi con
- * "Main/", seguito immediatamente (senza spazi) dal nome della funzione, e da
- * una coppia di parentesi contenenti i tipi degli argomenti della funzione
- * (senza spazi tra un tipo e l'altro), infine il tipo di ritorno della
- * funzione. Sono ammessi spazi tra il nome e la prima parentesi, tra le
- * parentesi e gli argomenti, tra l'ultima parentesi e il tipo di ritorno,
- * senza spazi iniziali e finali.\\
- * Se utilizzata nella lettura di int o long (per convertire la stringa letta
- * da input in un numero) <tt>arg</tt> deve rispettivamente contenere:
- *   - java/lang/Integer/parseInt (Ljava/lang/String;)I
- *   - java/lang/Long/parseLong (Ljava/lang/String;)J
- * in entrambi i casi sullo stack ci deve essere un riferimento ad un oggetto
- * di tipo Ljava/lang/String; (argomento della funzione). La prima funzione
- * converte una stringa in un int e lo mette sullo stack degli operandi, la
- * seconda la converte in un long e lo mette sullo stack degli operandi, in
- * caso di errori di conversioni (la stringa non contiene un numero) viene
- * messo il valore 0 sullo stack.\\
+ * funzione chiamata. I parametri non vengono copiati: le prime variabili
+ * locali del nuovo AR sono le posizioni in cima allo stack degli operandi
+ * dell'AR corrente occupate dai parametri (l'ultimo argomento e` quello in
+ * cima allo stack, il primo diventa la variabile locale 0), che vengono cosi`
+ * tolte dallo stack del chiamante.\\
+ * L'elemento contiene l'indice della prima istruzione, il numero di variabili
+ * locali e la disposizione dei parametri nelle variabili locali; in questo
+ * caso <tt>istr.type</tt> vale 'M'.\\
+ * Se <em>m d</em> non e` una funzione del programma ma un metodo di libreria
+ * (ad esempio <tt>java/lang/Integer/parseInt (Ljava/lang/String;)I</tt>,
+ * usato nella lettura di int) <tt>istr.type</tt> vale 'N' e il metodo viene
+ * eseguito da chiama_nativo().\\
  * Se nello stack degli operandi non ci sono i tipi corrispondenti ai tipi
  * dei parametri della funzione viene lanciata un'eccezione di tipo std::string
  * con la descrizione dell'errore.
  */
-void f_invokestatic(string& arg) {
-  // elimina tutti gli spazi dall'argomento della funzione
-  string::size_type pos = arg.find(' ');
-  while(pos != string::npos) {
-    arg.erase(pos, 1);
-    pos = arg.find(' ', pos);
-  }
-
+template<bool CONTROLLI>
+void f_invokestatic(Machine& m, const Instruction& istr) {
   // Chiamata a funzione locale
-  if(arg.substr(0,5) == "Main/") {
-    uint16_t index = 0;
-    string::size_type pos = arg.rfind('(');
-    while(arg[pos] != ')') {
-      // calcola lo spazio per mettere i parametri nelle variabili locali
-      if(arg[pos] == 'I' || arg[pos] == 'C' || arg[pos] == 'S') {
-        ++index; // le variabili int occupano un solo spazio
-      }
-      else if(arg[pos] == 'J') {
-        index = index + 2; // le variabili long occupano due spazi
-      }
-      ++pos;
-    } // end while( arg[pos] != ')' )
-
-    stack_di_sistema.push_ar();
-    --pos;
-    while(index != 0 && arg[pos] != '(') {
-      // trasferisce i parametri nelle variabili locali
-      if(arg[pos] == 'I' || arg[pos] == 'C' || arg[pos] == 'S') {
-        --index;
-        // Se sullo stack degli operandi non c'e` il tipo giusto
-        // "stack_di_sistema" lancia un'eccezione
-        stack_di_sistema.parameter_pass_int(index);
-      }
-      else if(arg[pos] == 'J') {
-        index = index - 2;
-        // Se sullo stack degli operandi non c'e` il tipo giusto
-        // "stack_di_sistema" lancia un'eccezione
-        stack_di_sistema.parameter_pass_long(index);
-      }
-      --pos;
-    } // end while( arg[pos] != '(' )
-
-    // imposta il pc: per l'ipotesi che arg inizia esattamente con "Main/",
-    // il nome della funzione e` dalla posizione 5 fino alla fine della stringa
-    stack_di_sistema.pc_set(programma.get_function_index(arg.substr(5)));
-  } // end if(arg.substr(0,4) == "Main")
-
-  // Conversione di una stringa in int (utilizzato nella lettura)
-  else if(arg == "java/lang/Integer/parseInt(Ljava/lang/String;)I") {
-    // nota: se non c'e` un riferimento in cima allo stack degli operandi,
-    // "stack_di_sistema" lancia un'eccezione
-    if(stack_di_sistema.op_stack_top_ref_type() != "Ljava/lang/String;") {
-      throw string("si ci aspettava un oggetto di tipo java/lang/String " +
-          string("sullo stack degli operandi") );
-    }
-    string* str = static_cast<string*>(stack_di_sistema.op_stack_top_ref());
-    stack_di_sistema.op_stack_pop();
-    stack_di_sistema.op_stack_push_int( atol(str->c_str()) );
-    delete str;
-  }
-
-  // Conversione di una stringa in long (utilizzato nella lettura)
-  else if(arg == "java/lang/Long/parseLong(Ljava/lang/String;)J") {
-    // nota: se non c'e` un riferimento in cima allo stack degli operandi,
-    // "stack_di_sistema" lancia un'eccezione
-    if(stack_di_sistema.op_stack_top_ref_type() != "Ljava/lang/String;") {
-      throw string("si ci aspettava un oggetto di tipo java/lang/String " +
-          string("sullo stack degli operandi") );
-    }
-    string* str = static_cast<string*>(stack_di_sistema.op_stack_top_ref());
-    stack_di_sistema.op_stack_pop();
-    stack_di_sistema.op_stack_push_long( atoll(str->c_str()) );
-    delete str;
-  }
+  if(istr.type == 'M') {
+    const Function& funzione = m.program.get_function(istr.index);
+    // i parametri in cima allo stack degli operandi diventano le prime
+    // variabili locali del nuovo AR; se non sono del tipo giusto
+    // "m.stack" lancia un'eccezione (nelle funzioni verificate il
+    // tipo e` gia` stato controllato al caricamento); il nuovo AR ha lo
+    // spazio per tutto lo stack degli operandi della funzione
+    if(CONTROLLI)
+      m.stack.push_ar(funzione.locals, funzione.arguments,
+          funzione.max_stack);
+    else
+      m.stack.push_verified_ar(funzione.locals,
+          funzione.arguments.size(), funzione.max_stack);
+    // imposta il pc alla prima istruzione della funzione (o al suo codice a
+    // registri, vedi esecutore_a_registri())
+    m.stack.pc_set(funzione.entry);
+  } // end if(istr.type == 'M')
+
+  // Metodo di libreria (vedi NativeMethod)
+  else
+    chiama_nativo<CONTROLLI>(m, istr);
 
   return;
-} // end of void f_invokestatic(string& arg)
+} // end of void f_invokestatic(const Instruction& istr)
 
 
 /**
- * \fn void f_lcmp()
+ * \fn void f_lcmp(Machine& m)
  * \brief Esegue <tt>lcmp</tt>
  *
  * Preleva i primi due long in cima allo stack (ab e cd), li confronta, e
@@ -941,90 +1276,129 @@ void f_invokestatic(string& arg) {
  * Se sullo stack non sono presenti due long viene lanciata un'eccezione di
  * tipo std::string con la descrizione dell'errore.
  */
-void f_lcmp() {
-  // Se sullo stack non ci sono due elementi di tipo long, "stack_di_sistema"
+template<bool CONTROLLI>
+void f_lcmp(Machine& m) {
+  // Se sullo stack non ci sono due elementi di tipo long, "m.stack"
   // lancia un'eccezione
-  int64_t value_ab = stack_di_sistema.op_stack_top_long();
-  stack_di_sistema.op_stack_pop2();
-  if(stack_di_sistema.op_stack_top_long() == value_ab) {
-    stack_di_sistema.op_stack_pop2();
-    stack_di_sistema.op_stack_push_int(0);
+  int64_t value_ab = m.stack.op_stack_top_long<CONTROLLI>();
+  m.stack.op_stack_pop2<CONTROLLI>();
+  if(m.stack.op_stack_top_long<CONTROLLI>() == value_ab) {
+    m.stack.op_stack_pop2<CONTROLLI>();
+    m.stack.op_stack_push_int<CONTROLLI>(0);
   }
-  else if(stack_di_sistema.op_stack_top_long() > value_ab) {
-    stack_di_sistema.op_stack_pop2();
-    stack_di_sistema.op_stack_push_int(1);
+  else if(m.stack.op_stack_top_long<CONTROLLI>() > value_ab) {
+    m.stack.op_stack_pop2<CONTROLLI>();
+    m.stack.op_stack_push_int<CONTROLLI>(1);
   }
   else {
-    // if(stack_di_sistema.op_stack_top_long() < value_ab)
-    stack_di_sistema.op_stack_pop2();
-    stack_di_sistema.op_stack_push_int(-1);
+    // if(m.stack.op_stack_top_long<CONTROLLI>() < value_ab)
+    m.stack.op_stack_pop2<CONTROLLI>();
+    m.stack.op_stack_push_int<CONTROLLI>(-1);
   }
   return;
 }
 
 
 /**
- * \fn void f_ireturn()
+ * \fn void controlla_ritorno(Machine& m, const unsigned int& pc, const char& tipo)
+ * \brief Controlla il tipo di ritorno di una funzione non verificata
+ *
+ * Se la funzione che contiene l'istruzione di ritorno con indice
+ * <tt>pc</tt> non ha tipo di ritorno <tt>tipo</tt> ('I', 'J' o 'V') lancia
+ * un'eccezione di tipo std::string con la descrizione dell'errore. Il
+ * chiamante puo` essere una funzione verificata, che esegue senza controlli
+ * e si fida del tipo di ritorno dichiarato (vedi Verifier).
+ */
+void controlla_ritorno(Machine& m, const unsigned int& pc, const char& tipo) {
+  const Function& funzione = m.program.get_function_at(pc);
+  if(funzione.return_type != tipo)
+    throw string(opcode_name(m.program.get_code()[pc].opcode)) +
+      " diverso dal tipo di ritorno della funzione " + funzione.name;
+  return;
+}
+
+
+/**
+ * \fn void f_ireturn(Machine& m, const unsigned int& pc)
  * \brief Esegue <tt>ireturn</tt>
+ * \param pc indice dell'istruzione
  *
  * Prende dallo stack degli operandi il valore di ritorno di tipo int (se il
  * tipo non e` esatto viene lanciata un'eccezione di tipo std::string con la
  * descrizione dell'errore.), dopodiche` toglie un AR da
- * <tt>stack_di_sitema</tt>, e mette il valore di ritorno sullo stack degli 
- * operandi del vecchio AR.\\
- * Si assume che il tipo di ritorno della funzione sia compatibile con il tipo
- * di ritorno (I, S, o C), e che in <tt>stack_di_sistema</tt> siano presenti
- * almeno due AR.
+ * <tt>m.stack</tt>, e mette il valore di ritorno sullo stack degli 
+ * operandi del vecchio AR; se non ci sono altri AR (la funzione e` stata
+ * chiamata da Machine::call()) lo mette in <tt>m.result</tt>.\\
+ * Con i controlli anche il tipo di ritorno della funzione dev'essere int
+ * (vedi controlla_ritorno()).
  */
-void f_ireturn() {
-  // Se non c'e` un int in cima allo stack degli operandi, "stack_di_sistema"
+template<bool CONTROLLI>
+void f_ireturn(Machine& m, const unsigned int& pc) {
+  if(CONTROLLI)
+    controlla_ritorno(m, pc, 'I');
+  // Se non c'e` un int in cima allo stack degli operandi, "m.stack"
   // lancia un'eccezione
-  int32_t return_value = stack_di_sistema.op_stack_top_int();
-  stack_di_sistema.pop_ar();
-  stack_di_sistema.op_stack_push_int(return_value);
+  int32_t return_value = m.stack.op_stack_top_int<CONTROLLI>();
+  m.stack.pop_ar();
+  if(!m.stack.empty())
+    // il chiamante puo` non essere verificato: l'inserimento controlla lo
+    // spazio sul suo stack degli operandi
+    m.stack.op_stack_push_int(return_value);
+  else
+    m.result = return_value;
   return;
 }
 
 
 /**
- * \fn void f_lreturn()
+ * \fn void f_lreturn(Machine& m, const unsigned int& pc)
  * \brief Esegue <tt>lreturn</tt>
+ * \param pc indice dell'istruzione
  *
  * Prende dallo stack degli operandi il valore di ritorno di tipo long (se il
  * tipo non e` esatto viene lanciata un'eccezione di tipo std::string con la
  * descrizione dell'errore.), dopodiche` toglie un AR da
- * <tt>stack_di_sitema</tt>, e mette il valore di ritorno sullo stack degli
- * operandi del vecchio AR.\\
- * Si assume che il tipo di ritorno della funzione sia compatibile con il tipo
- * di ritorno (J), e che in <tt>stack_di_sistema</tt> siano presenti almeno
- * due AR.
+ * <tt>m.stack</tt>, e mette il valore di ritorno sullo stack degli
+ * operandi del vecchio AR (o, come in f_ireturn(), in <tt>m.result</tt>).\\
+ * Con i controlli anche il tipo di ritorno della funzione dev'essere long.
  */
-void f_lreturn() {
-  // Se non c'e` un long in cima allo stack degli operandi, "stack_di_sistema"
+template<bool CONTROLLI>
+void f_lreturn(Machine& m, const unsigned int& pc) {
+  if(CONTROLLI)
+    controlla_ritorno(m, pc, 'J');
+  // Se non c'e` un long in cima allo stack degli operandi, "m.stack"
   // lancia un'eccezione
-  int64_t return_value = stack_di_sistema.op_stack_top_long();
-  stack_di_sistema.pop_ar();
-  stack_di_sistema.op_stack_push_long(return_value);
+  int64_t return_value = m.stack.op_stack_top_long<CONTROLLI>();
+  m.stack.pop_ar();
+  if(!m.stack.empty())
+    // come in f_ireturn(), il chiamante puo` non essere verificato
+    m.stack.op_stack_push_long(return_value);
+  else
+    m.result = return_value;
   return;
 }
 
 
 /**
- * \fn void f_return()
+ * \fn void f_return(Machine& m, const unsigned int& pc)
  * \brief Esegue <tt>return</tt>
+ * \param pc indice dell'istruzione
  *
- * Toglie un AR da <tt>stack_di_sistema</tt>.\\
- * Si assume che il tipo di ritorno della funzione sia compatibile con il tipo
- * di ritorno (V), e che in <tt>stack_di_sistema</tt> sia presente almeno un AR.
+ * Toglie un AR da <tt>m.stack</tt>.\\
+ * Si assume che in <tt>m.stack</tt> sia presente almeno un AR; con i
+ * controlli la funzione non deve restituire un valore.
  */
-void f_return() {
-  stack_di_sistema.pop_ar();
+template<bool CONTROLLI>
+void f_return(Machine& m, const unsigned int& pc) {
+  if(CONTROLLI)
+    controlla_ritorno(m, pc, 'V');
+  m.stack.pop_ar();
   return;
 }
 
 
 /**
- * \fn void f_iadd()
+ * \fn void f_iadd(Machine& m)
  * \brief Esegue <tt>iadd</tt>
  *
  * Preleva i primi due int in cima allo stack degli operandi (a e b), esegue la
@@ -1032,20 +1406,21 @@ void f_return() {
  * Se i primi due elementi sullo stack non sono int, viene lanciata un'eccezione
  * di tipo std::string con la descrizione dell'errore.
  */
-void f_iadd() {
+template<bool CONTROLLI>
+void f_iadd(Machine& m) {
   // Se in cima allo stack degli operandi non ci sono due interi,
-  // "stack_di_sistema" lancia un'eccezione
-  int32_t value_a = stack_di_sistema.op_stack_top_int();
-  stack_di_sistema.op_stack_pop();
-  int32_t value_b = stack_di_sistema.op_stack_top_int();
-  stack_di_sistema.op_stack_pop();
-  stack_di_sistema.op_stack_push_int(value_b + value_a);
+  // "m.stack" lancia un'eccezione
+  int32_t value_a = m.stack.op_stack_top_int<CONTROLLI>();
+  m.stack.op_stack_pop<CONTROLLI>();
+  int32_t value_b = m.stack.op_stack_top_int<CONTROLLI>();
+  m.stack.op_stack_pop<CONTROLLI>();
+  m.stack.op_stack_push_int<CONTROLLI>(value_b + value_a);
   return;
 }
 
 
 /**
- * \fn void f_idiv()
+ * \fn void f_idiv(Machine& m)
  * \brief Esegue <tt>idiv</tt>
  *
  * Preleva il primo int in cima allo stack degli operandi (a), preleva il
@@ -1055,22 +1430,23 @@ void f_iadd() {
  * di tipo std::string con la descrizione dell'errore. Se avviene una divisione
  * per 0 viene lanciata un'eccezione.
  */
-void f_idiv() {
+template<bool CONTROLLI>
+void f_idiv(Machine& m) {
   // Se in cima allo stack degli operandi non ci sono due interi,
-  // "stack_di_sistema" lancia un'eccezione
-  int32_t value_a = stack_di_sistema.op_stack_top_int();
+  // "m.stack" lancia un'eccezione
+  int32_t value_a = m.stack.op_stack_top_int<CONTROLLI>();
   if(value_a == 0)
     throw string("divisione per 0");
-  stack_di_sistema.op_stack_pop();
-  int32_t value_b = stack_di_sistema.op_stack_top_int();
-  stack_di_sistema.op_stack_pop();
-  stack_di_sistema.op_stack_push_int(value_b / value_a);
+  m.stack.op_stack_pop<CONTROLLI>();
+  int32_t value_b = m.stack.op_stack_top_int<CONTROLLI>();
+  m.stack.op_stack_pop<CONTROLLI>();
+  m.stack.op_stack_push_int<CONTROLLI>(value_b / value_a);
   return;
 }
 
 
 /**
- * \fn void f_imul()
+ * \fn void f_imul(Machine& m)
  * \brief Esegue <tt>imul</tt>
  *
  * Preleva i primi due int in cima allo stack degli operandi (a e b), esegue il
@@ -1079,20 +1455,21 @@ void f_idiv() {
  * Se i primi due elementi sullo stack non sono int, viene lanciata un'eccezione
  * di tipo std::string con la descrizione dell'errore.
  */
-void f_imul() {
+template<bool CONTROLLI>
+void f_imul(Machine& m) {
   // Se in cima allo stack degli operandi non ci sono due interi,
-  // "stack_di_sistema" lancia un'eccezione
-  int32_t value_a = stack_di_sistema.op_stack_top_int();
-  stack_di_sistema.op_stack_pop();
-  int32_t value_b = stack_di_sistema.op_stack_top_int();
-  stack_di_sistema.op_stack_pop();
-  stack_di_sistema.op_stack_push_int(value_b * value_a );
+  // "m.stack" lancia un'eccezione
+  int32_t value_a = m.stack.op_stack_top_int<CONTROLLI>();
+  m.stack.op_stack_pop<CONTROLLI>();
+  int32_t value_b = m.stack.op_stack_top_int<CONTROLLI>();
+  m.stack.op_stack_pop<CONTROLLI>();
+  m.stack.op_stack_push_int<CONTROLLI>(value_b * value_a );
   return;
 }
 
 
 /**
- * \fn void f_ineg() 
+ * \fn void f_ineg(Machine& m)
  * \brief Esegue <tt>ineg</tt>
  *
  * Preleva il primo int in cima allo stack degli operandi (a), lo nega (-a), e
@@ -1100,18 +1477,19 @@ void f_imul() {
  * Se sullo stack degli operandi non e` presente un int viene lanciata
  * un'eccezione di tipo std::string con la descrizione dell'errore.
  */
-void f_ineg() {
-  // Se in cima allo stack degli operandi non c'e` un intero, "stack_di_sistema"
+template<bool CONTROLLI>
+void f_ineg(Machine& m) {
+  // Se in cima allo stack degli operandi non c'e` un intero, "m.stack"
   // lancia un'eccezione
-  int32_t value_a = stack_di_sistema.op_stack_top_int();
-  stack_di_sistema.op_stack_pop();
-  stack_di_sistema.op_stack_push_int(-value_a);
+  int32_t value_a = m.stack.op_stack_top_int<CONTROLLI>();
+  m.stack.op_stack_pop<CONTROLLI>();
+  m.stack.op_stack_push_int<CONTROLLI>(-value_a);
   return;
 }
 
 
 /**
- * \fn void f_irem()
+ * \fn void f_irem(Machine& m)
  * \brief Esegue <tt>irem</tt>
  *
  * Preleva il primo int in cima allo stack degli operandi (a), preleva il
@@ -1121,22 +1499,23 @@ void f_ineg() {
  * di tipo std::string con la descrizione dell'errore. Se avviene una divisione
  * per 0 viene lanciata un'eccezione.
  */
-void f_irem() {
+template<bool CONTROLLI>
+void f_irem(Machine& m) {
   // Se in cima allo stack degli operandi non ci sono due interi,
-  // "stack_di_sistema" lancia un'eccezione
-  int32_t value_a = stack_di_sistema.op_stack_top_int();
+  // "m.stack" lancia un'eccezione
+  int32_t value_a = m.stack.op_stack_top_int<CONTROLLI>();
   if(value_a == 0)
     throw string("divisione per 0");
-  stack_di_sistema.op_stack_pop();
-  int32_t value_b = stack_di_sistema.op_stack_top_int();
-  stack_di_sistema.op_stack_pop();
-  stack_di_sistema.op_stack_push_int(value_b % value_a);
+  m.stack.op_stack_pop<CONTROLLI>();
+  int32_t value_b = m.stack.op_stack_top_int<CONTROLLI>();
+  m.stack.op_stack_pop<CONTROLLI>();
+  m.stack.op_stack_push_int<CONTROLLI>(value_b % value_a);
   return;
 }
 
 
 /**
- * \fn void f_ishl()
+ * \fn void f_ishl(Machine& m)
  * \brief Esegue <tt>ishl</tt>
  *
  * Preleva i primi due int in cima allo stack (a e b), calcola lo shift a
@@ -1144,20 +1523,21 @@ void f_irem() {
  * stack degli operandi non ci sono due interi lancia un'eccezione di tipo
  * std::string con la descrizione dell'errore.
  */
-void f_ishl() {
+template<bool CONTROLLI>
+void f_ishl(Machine& m) {
   // Se in cima allo stack degli operandi non ci sono due interi,
-  // "stack_di_sistema" lancia un'eccezione
-  int32_t value_a = stack_di_sistema.op_stack_top_int();
-  stack_di_sistema.op_stack_pop();
-  int32_t value_b = stack_di_sistema.op_stack_top_int();
-  stack_di_sistema.op_stack_pop();
-  stack_di_sistema.op_stack_push_int(value_b << value_a);
+  // "m.stack" lancia un'eccezione
+  int32_t value_a = m.stack.op_stack_top_int<CONTROLLI>();
+  m.stack.op_stack_pop<CONTROLLI>();
+  int32_t value_b = m.stack.op_stack_top_int<CONTROLLI>();
+  m.stack.op_stack_pop<CONTROLLI>();
+  m.stack.op_stack_push_int<CONTROLLI>(value_b << value_a);
   return;
 }
 
 
 /**
- * \fn void f_ishr()
+ * \fn void f_ishr(Machine& m)
  * \brief Esegue <tt>ishr</tt>
  *
  * Preleva i primi due int in cima allo stack (a e b), calcola lo shift a
@@ -1165,20 +1545,21 @@ void f_ishl() {
  * stack degli operandi non ci sono due interi lancia un'eccezione di tipo
  * std::string con la descrizione dell'errore.
  */
-void f_ishr() {
+template<bool CONTROLLI>
+void f_ishr(Machine& m) {
   // Se in cima allo stack degli operandi non ci sono due interi,
-  // "stack_di_sistema" lancia un'eccezione
-  int32_t value_a = stack_di_sistema.op_stack_top_int();
-  stack_di_sistema.op_stack_pop();
-  int32_t value_b = stack_di_sistema.op_stack_top_int();
-  stack_di_sistema.op_stack_pop();
-  stack_di_sistema.op_stack_push_int(value_b >> value_a);
+  // "m.stack" lancia un'eccezione
+  int32_t value_a = m.stack.op_stack_top_int<CONTROLLI>();
+  m.stack.op_stack_pop<CONTROLLI>();
+  int32_t value_b = m.stack.op_stack_top_int<CONTROLLI>();
+  m.stack.op_stack_pop<CONTROLLI>();
+  m.stack.op_stack_push_int<CONTROLLI>(value_b >> value_a);
   return;
 }
 
 
 /**
- * \fn void f_isub()
+ * \fn void f_isub(Machine& m)
  * \brief Esegue <tt>isub</tt>
  *
  * Preleva il primo int in cima allo stack degli operandi (a), preleva il
@@ -1187,20 +1568,21 @@ void f_ishr() {
  * Se i primi due elementi sullo stack non sono int, viene lanciata un'eccezione
  * di tipo std::string con la descrizione dell'errore.
  */
-void f_isub() {
+template<bool CONTROLLI>
+void f_isub(Machine& m) {
   // Se in cima allo stack degli operandi non ci sono due interi,
-  // "stack_di_sistema" lancia un'eccezione
-  int32_t value_a = stack_di_sistema.op_stack_top_int();
-  stack_di_sistema.op_stack_pop();
-  int32_t value_b = stack_di_sistema.op_stack_top_int();
-  stack_di_sistema.op_stack_pop();
-  stack_di_sistema.op_stack_push_int(value_b - value_a);
+  // "m.stack" lancia un'eccezione
+  int32_t value_a = m.stack.op_stack_top_int<CONTROLLI>();
+  m.stack.op_stack_pop<CONTROLLI>();
+  int32_t value_b = m.stack.op_stack_top_int<CONTROLLI>();
+  m.stack.op_stack_pop<CONTROLLI>();
+  m.stack.op_stack_push_int<CONTROLLI>(value_b - value_a);
   return;
 }
 
 
 /**
- * \fn void f_ladd()
+ * \fn void f_ladd(Machine& m)
  * \brief Esegue <tt>ladd</tt>
  *
  * Preleva i primi due long in cima allo stack degli operandi (ab e cd),
@@ -1209,20 +1591,21 @@ void f_isub() {
  * Se i primi due elementi sullo stack non sono long, viene lanciata
  * un'eccezione di tipo std::string con la descrizione dell'errore.
  */
-void f_ladd() {
+template<bool CONTROLLI>
+void f_ladd(Machine& m) {
   // Se in cima allo stack degli operandi non ci sono due long,
-  // "stack_di_sistema" lancia un'eccezione
-  int64_t value_ab = stack_di_sistema.op_stack_top_long();
-  stack_di_sistema.op_stack_pop2();
-  int64_t value_cd = stack_di_sistema.op_stack_top_long();
-  stack_di_sistema.op_stack_pop2();
-  stack_di_sistema.op_stack_push_long(value_cd + value_ab);
+  // "m.stack" lancia un'eccezione
+  int64_t value_ab = m.stack.op_stack_top_long<CONTROLLI>();
+  m.stack.op_stack_pop2<CONTROLLI>();
+  int64_t value_cd = m.stack.op_stack_top_long<CONTROLLI>();
+  m.stack.op_stack_pop2<CONTROLLI>();
+  m.stack.op_stack_push_long<CONTROLLI>(value_cd + value_ab);
   return;
 }
 
 
 /**
- * \fn void f_ldiv()
+ * \fn void f_ldiv(Machine& m)
  * \brief Esegue <tt>ldiv</tt>
  *
  * Preleva il primo long in cima allo stack degli operandi (ab), preleva il
@@ -1232,22 +1615,23 @@ void f_ladd() {
  * un'eccezione di tipo std::string con la descrizione dell'errore. Se avviene
  * una divisione per 0 viene lanciata un'eccezione.
  */
-void f_ldiv() {
+template<bool CONTROLLI>
+void f_ldiv(Machine& m) {
   // Se in cima allo stack degli operandi non ci sono due long,
-  // "stack_di_sistema" lancia un'eccezione
-  int64_t value_ab = stack_di_sistema.op_stack_top_long();
+  // "m.stack" lancia un'eccezione
+  int64_t value_ab = m.stack.op_stack_top_long<CONTROLLI>();
   if(value_ab == 0)
     throw string("divisione per 0");
-  stack_di_sistema.op_stack_pop2();
-  int64_t value_cd = stack_di_sistema.op_stack_top_long();
-  stack_di_sistema.op_stack_pop2();
-  stack_di_sistema.op_stack_push_long(value_cd / value_ab);
+  m.stack.op_stack_pop2<CONTROLLI>();
+  int64_t value_cd = m.stack.op_stack_top_long<CONTROLLI>();
+  m.stack.op_stack_pop2<CONTROLLI>();
+  m.stack.op_stack_push_long<CONTROLLI>(value_cd / value_ab);
   return;
 }
 
 
 /**
- * \fn void f_lmul()
+ * \fn void f_lmul(Machine& m)
  * \brief Esegue <tt>lmul</tt>
  *
  * Preleva i primi due long in cima allo stack degli operandi (ab e cd), esegue
@@ -1256,20 +1640,21 @@ void f_ldiv() {
  * Se i primi due elementi sullo stack non sono long, viene lanciata
  * un'eccezione di tipo std::string con la descrizione dell'errore.
  */
-void f_lmul() {
+template<bool CONTROLLI>
+void f_lmul(Machine& m) {
   // Se in cima allo stack degli operandi non ci sono due long,
-  // "stack_di_sistema" lancia un'eccezione
-  int64_t value_ab = stack_di_sistema.op_stack_top_long();
-  stack_di_sistema.op_stack_pop2();
-  int64_t value_cd = stack_di_sistema.op_stack_top_long();
-  stack_di_sistema.op_stack_pop2();
-  stack_di_sistema.op_stack_push_long(value_cd * value_ab);
+  // "m.stack" lancia un'eccezione
+  int64_t value_ab = m.stack.op_stack_top_long<CONTROLLI>();
+  m.stack.op_stack_pop2<CONTROLLI>();
+  int64_t value_cd = m.stack.op_stack_top_long<CONTROLLI>();
+  m.stack.op_stack_pop2<CONTROLLI>();
+  m.stack.op_stack_push_long<CONTROLLI>(value_cd * value_ab);
   return;
 }
 
 
 /**
- * \fn void f_lneg()
+ * \fn void f_lneg(Machine& m)
  * \brief Esegue <tt>lneg</tt>
  *
  * Preleva il primo long in cima allo stack degli operandi (ab), lo nega (-ab),
@@ -1277,18 +1662,19 @@ void f_lmul() {
  * Se sullo stack degli operandi non e` presente un long viene lanciata
  * un'eccezione di tipo std::string con la descrizione dell'errore.
  */
-void f_lneg() {
-  // Se in cima allo stack degli operandi non c'e` un long, "stack_di_sistema"
+template<bool CONTROLLI>
+void f_lneg(Machine& m) {
+  // Se in cima allo stack degli operandi non c'e` un long, "m.stack"
   // lancia un'eccezione
-  int64_t value_ab = stack_di_sistema.op_stack_top_long();
-  stack_di_sistema.op_stack_pop2();
-  stack_di_sistema.op_stack_push_long(-value_ab);
+  int64_t value_ab = m.stack.op_stack_top_long<CONTROLLI>();
+  m.stack.op_stack_pop2<CONTROLLI>();
+  m.stack.op_stack_push_long<CONTROLLI>(-value_ab);
   return;
 }
 
 
 /**
- * \fn void f_lrem()
+ * \fn void f_lrem(Machine& m)
  * \brief Esegue <tt>lrem</tt>
  *
  * Preleva il primo long in cima allo stack degli operandi (ab), preleva il
@@ -1298,22 +1684,23 @@ void f_lneg() {
  * di tipo std::string con la descrizione dell'errore. Se avviene una divisione
  * per 0 viene lanciata un'eccezione.
  */
-void f_lrem() {
+template<bool CONTROLLI>
+void f_lrem(Machine& m) {
   // Se in cima allo stack degli operandi non ci sono due long,
-  // "stack_di_sistema" lancia un'eccezione
-  int64_t value_ab = stack_di_sistema.op_stack_top_long();
+  // "m.stack" lancia un'eccezione
+  int64_t value_ab = m.stack.op_stack_top_long<CONTROLLI>();
   if(value_ab == 0)
     throw string("divisione per 0");
-  stack_di_sistema.op_stack_pop2();
-  int64_t value_cd = stack_di_sistema.op_stack_top_long();
-  stack_di_sistema.op_stack_pop2();
-  stack_di_sistema.op_stack_push_long(value_cd % value_ab);
+  m.stack.op_stack_pop2<CONTROLLI>();
+  int64_t value_cd = m.stack.op_stack_top_long<CONTROLLI>();
+  m.stack.op_stack_pop2<CONTROLLI>();
+  m.stack.op_stack_push_long<CONTROLLI>(value_cd % value_ab);
   return;
 }
 
 
 /**
- * \fn void f_lshl()
+ * \fn void f_lshl(Machine& m)
  * \brief Esegue <tt>lshl</tt>
  *
  * Preleva un elemento di tipo int in cima allo stack (a), quindi preleva un
@@ -1322,20 +1709,21 @@ void f_lrem() {
  * poi un long, lancia un'eccezione di tipo std::string con la descrizione
  * dell'errore.
  */
-void f_lshl() {
+template<bool CONTROLLI>
+void f_lshl(Machine& m) {
   // Se in cima allo stack degli operandi non ci sono un int e un long,
-  // "stack_di_sistema" lancia un'eccezione
-  int32_t value_a = stack_di_sistema.op_stack_top_int();
-  stack_di_sistema.op_stack_pop();
-  int64_t value_bc = stack_di_sistema.op_stack_top_long();
-  stack_di_sistema.op_stack_pop2();
-  stack_di_sistema.op_stack_push_long(value_bc << value_a);
+  // "m.stack" lancia un'eccezione
+  int32_t value_a = m.stack.op_stack_top_int<CONTROLLI>();
+  m.stack.op_stack_pop<CONTROLLI>();
+  int64_t value_bc = m.stack.op_stack_top_long<CONTROLLI>();
+  m.stack.op_stack_pop2<CONTROLLI>();
+  m.stack.op_stack_push_long<CONTROLLI>(value_bc << value_a);
   return;
 }
 
 
 /**
- * \fn void f_lshr()
+ * \fn void f_lshr(Machine& m)
  * \brief Esegue <tt>lshr</tt>
  *
  * Preleva un elemento di tipo int in cima allo stack (a), quindi preleva un
@@ -1344,20 +1732,21 @@ void f_lshl() {
  * poi un long, lancia un'eccezione di tipo std::string con la descrizione
  * dell'errore.
  */
-void f_lshr() {
+template<bool CONTROLLI>
+void f_lshr(Machine& m) {
   // Se in cima allo stack degli operandi non ci sono un int e un long,
-  // "stack_di_sistema" lancia un'eccezione
-  int32_t value_a = stack_di_sistema.op_stack_top_int();
-  stack_di_sistema.op_stack_pop();
-  int64_t value_bc = stack_di_sistema.op_stack_top_long();
-  stack_di_sistema.op_stack_pop2();
-  stack_di_sistema.op_stack_push_long(value_bc >> value_a);
+  // "m.stack" lancia un'eccezione
+  int32_t value_a = m.stack.op_stack_top_int<CONTROLLI>();
+  m.stack.op_stack_pop<CONTROLLI>();
+  int64_t value_bc = m.stack.op_stack_top_long<CONTROLLI>();
+  m.stack.op_stack_pop2<CONTROLLI>();
+  m.stack.op_stack_push_long<CONTROLLI>(value_bc >> value_a);
   return;
 }
 
 
 /**
- * \fn void f_lsub()
+ * \fn void f_lsub(Machine& m)
  * \brief Esegue <tt>lsub</tt>
  *
  * Preleva il primo long in cima allo stack degli operandi (ab), preleva il
@@ -1366,104 +1755,103 @@ void f_lshr() {
  * Se i primi due elementi sullo stack non sono long, viene lanciata
  * un'eccezione di tipo std::string con la descrizione dell'errore.
  */
-void f_lsub() {
+template<bool CONTROLLI>
+void f_lsub(Machine& m) {
   // Se in cima allo stack degli operandi non ci sono due interi,
-  // "stack_di_sistema" lancia un'eccezione
-  int64_t value_ab = stack_di_sistema.op_stack_top_long();
-  stack_di_sistema.op_stack_pop2();
-  int64_t value_cd = stack_di_sistema.op_stack_top_long();
-  stack_di_sistema.op_stack_pop2();
-  stack_di_sistema.op_stack_push_long(value_cd - value_ab);
+  // "m.stack" lancia un'eccezione
+  int64_t value_ab = m.stack.op_stack_top_long<CONTROLLI>();
+  m.stack.op_stack_pop2<CONTROLLI>();
+  int64_t value_cd = m.stack.op_stack_top_long<CONTROLLI>();
+  m.stack.op_stack_pop2<CONTROLLI>();
+  m.stack.op_stack_push_long<CONTROLLI>(value_cd - value_ab);
   return;
 }
 
 
 /**
- * \fn void f_iload(string& arg)
+ * \fn void f_iload(Machine& m, const Instruction& istr)
  * \brief Esegue <tt>iload n</tt>
- * \param arg n
+ * \param istr n
  *
  * Mette sullo stack degli operandi il valore memorizzato nella variabile
  * locale di tipo int con indice <em>n</em>.\\
- * Si assume che in <tt>arg</tt> sia presente la rappresentazione di un numero
- * intero, senza spazi all'inizio e alla fine, e che la variabile con indice
- * <em>n</em> sia stata precedentemente inizializzata con il tipo esatto (int).
+ * L'indice <em>n</em> e` in <tt>istr.index</tt>. Si assume che la variabile con
+ * indice <em>n</em> sia stata precedentemente inizializzata con il tipo esatto (int).
  */
-void f_iload(string& arg) {
-  stack_di_sistema.op_stack_push_int(
-      stack_di_sistema.local_variable_get_int(
-          static_cast<uint16_t>(atol(arg.c_str())) ) );
+template<bool CONTROLLI>
+void f_iload(Machine& m, const Instruction& istr) {
+  m.stack.op_stack_push_int<CONTROLLI>(
+      m.stack.local_variable_get_int<CONTROLLI>(
+          static_cast<uint16_t>(istr.index) ) );
   return;
 }
 
 
 /**
- * \fn void f_istore(string& arg)
+ * \fn void f_istore(Machine& m, const Instruction& istr)
  * \brief Esegue <tt>istore n</tt>
- * \param arg n
+ * \param istr n
  *
  * Preleva l'elemento di tipo int in cima allo stack degli operandi (se non e`
  * presente un elemento di tipo int lancia un'eccezione di tipo std::string con
  * la descrizione dell'errore.) e lo memorizza nella variabile locale di indice
- * <em>n</em>.\\
- * Si assume che in <tt>arg</tt> sia presente la rappresentazione di un numero
- * intero, senza spazi all'inizio e alla fine.
+ * <em>n</em>, che e` in <tt>istr.index</tt>.
  */
-void f_istore(string& arg) {
+template<bool CONTROLLI>
+void f_istore(Machine& m, const Instruction& istr) {
   // Se non c'e` un elemento di tipo int in cima allo stack degli operandi,
-  // "stack_di_sistema" lancia un'eccezione
-  stack_di_sistema.local_variable_set_int(
-      static_cast<uint16_t>(atol(arg.c_str())),
-      stack_di_sistema.op_stack_top_int() );
-  stack_di_sistema.op_stack_pop();
+  // "m.stack" lancia un'eccezione
+  m.stack.local_variable_set_int<CONTROLLI>(
+      static_cast<uint16_t>(istr.index),
+      m.stack.op_stack_top_int<CONTROLLI>() );
+  m.stack.op_stack_pop<CONTROLLI>();
   return;
 }
 
 
 /**
- * \fn void f_lload(string& arg)
+ * \fn void f_lload(Machine& m, const Instruction& istr)
  * \brief Esegue <tt>lload n</tt>
- * \param arg n
+ * \param istr n
  *
  * Mette sullo stack degli operandi il valore memorizzato nella variabile
  * locale di tipo long con indice <em>n</em>.\\
- * Si assume che in <tt>arg</tt> sia presente la rappresentazione di un numero
- * intero, senza spazi all'inizio e alla fine, e che la variabile con indice
- * <em>n</em> sia stata precedentemente inizializzata con il tipo esatto (long).
+ * L'indice <em>n</em> e` in <tt>istr.index</tt>. Si assume che la variabile con
+ * indice <em>n</em> sia stata precedentemente inizializzata con il tipo esatto (long).
  */
-void f_lload(string& arg) {
- stack_di_sistema.op_stack_push_long(
-      stack_di_sistema.local_variable_get_long(
-          static_cast<uint16_t>(atol(arg.c_str())) ) );
+template<bool CONTROLLI>
+void f_lload(Machine& m, const Instruction& istr) {
+ m.stack.op_stack_push_long<CONTROLLI>(
+      m.stack.local_variable_get_long<CONTROLLI>(
+          static_cast<uint16_t>(istr.index) ) );
   return;
 }
 
 
 /**
- * \fn void f_lstore(string& arg)
+ * \fn void f_lstore(Machine& m, const Instruction& istr)
  * \brief Esegue <tt>lstore n</tt>
- * \param arg n
+ * \param istr n
  *
  * Preleva l'elemento di tipo long in cima allo stack degli operandi (se non e`
  * presente un elemento di tipo long lancia un'eccezione di tipo std::string con
  * la descrizione dell'errore.) e lo memorizza nella variabile locale di indice
- * <em>n</em>.\\
- * Si assume che in <tt>arg</tt> sia presente la rappresentazione di un numero
- * intero, senza spazi all'inizio e alla fine.
+ * <em>n</em>, che e` in <tt>istr.index</tt>.
  */
-void f_lstore(string& arg) {
+template<bool CONTROLLI>
+void f_lstore(Machine& m, const Instruction& istr) {
   // Se non c'e` un elemento di tipo long in cima allo stack degli operandi,
-  // "stack_di_sistema" lancia un'eccezione
-  stack_di_sistema.local_variable_set_long(
-      static_cast<uint16_t>(atol(arg.c_str())),
-      stack_di_sistema.op_stack_top_long() );
-  stack_di_sistema.op_stack_pop2();
+  // "m.stack" lancia un'eccezione
+  m.stack.local_variable_set_long<CONTROLLI>(
+      static_cast<uint16_t>(istr.index),
+      m.stack.op_stack_top_long<CONTROLLI>() );
+  m.stack.op_stack_pop2<CONTROLLI>();
   return;
 }
 
 
 /**
- * \fn void f_i2c()
+ * \fn void f_i2c(Machine& m)
  * \brief Esegue <tt>i2c</tt>
  *
  * Preleva l'elemento di tipo int in cima allo stack degli operandi, lo converte
@@ -1471,18 +1859,19 @@ void f_lstore(string& arg) {
  * stack degli operandi. Se non e` presente un int sullo stack viene lanciata
  * un'eccezione di tipo std::string con la descrizione dell'errore.
  */
-void f_i2c() {
-  // Se in cima allo stack non c'e` un int, "stack_di_sistema" lancia
+template<bool CONTROLLI>
+void f_i2c(Machine& m) {
+  // Se in cima allo stack non c'e` un int, "m.stack" lancia
   // un'eccezione
-  int32_t value = stack_di_sistema.op_stack_top_int();
-  stack_di_sistema.op_stack_pop();
-  stack_di_sistema.op_stack_push_int( static_cast<uint16_t>(value) );
+  int32_t value = m.stack.op_stack_top_int<CONTROLLI>();
+  m.stack.op_stack_pop<CONTROLLI>();
+  m.stack.op_stack_push_int<CONTROLLI>( static_cast<uint16_t>(value) );
   return;
 }
 
 
 /**
- * \fn void f_i2s()
+ * \fn void f_i2s(Machine& m)
  * \brief Esegue <tt>i2s</tt>
  *
  * Preleva l'elemento di tipo int in cima allo stack degli operandi, lo converte
@@ -1490,18 +1879,19 @@ void f_i2c() {
  * stack degli operandi. Se non e` presente un int sullo stack viene lanciata
  * un'eccezione di tipo std::string con la descrizione dell'errore.
  */
-void f_i2s() {
-  // Se in cima allo stack non c'e` un int, "stack_di_sistema" lancia
+template<bool CONTROLLI>
+void f_i2s(Machine& m) {
+  // Se in cima allo stack non c'e` un int, "m.stack" lancia
   // un'eccezione
-  int32_t value = stack_di_sistema.op_stack_top_int();
-  stack_di_sistema.op_stack_pop();
-  stack_di_sistema.op_stack_push_int( static_cast<int16_t>(value) );
+  int32_t value = m.stack.op_stack_top_int<CONTROLLI>();
+  m.stack.op_stack_pop<CONTROLLI>();
+  m.stack.op_stack_push_int<CONTROLLI>( static_cast<int16_t>(value) );
   return;
 }
 
 
 /**
- * \fn void f_i2l()
+ * \fn void f_i2l(Machine& m)
  * \brief Esegue <tt>i2l</tt>
  *
  * Preleva l'elemento di tipo int in cima allo stack degli operandi, lo converte
@@ -1510,18 +1900,19 @@ void f_i2s() {
  * presente un int sullo stack viene lanciata un'eccezione di tipo std::string
  * con la descrizione dell'errore.
  */
-void f_i2l() {
-  // Se in cima allo stack non c'e` un int, "stack_di_sistema" lancia
+template<bool CONTROLLI>
+void f_i2l(Machine& m) {
+  // Se in cima allo stack non c'e` un int, "m.stack" lancia
   // un'eccezione
-  int32_t value = stack_di_sistema.op_stack_top_int();
-  stack_di_sistema.op_stack_pop();
-  stack_di_sistema.op_stack_push_long(value);
+  int32_t value = m.stack.op_stack_top_int<CONTROLLI>();
+  m.stack.op_stack_pop<CONTROLLI>();
+  m.stack.op_stack_push_long<CONTROLLI>(value);
   return;
 }
 
 
 /**
- * \fn void f_l2i()
+ * \fn void f_l2i(Machine& m)
  * \brief Esegue <tt>l2i</tt>
  *
  * Preleva l'elemento di tipo long in cima allo stack degli operandi, lo
@@ -1530,18 +1921,19 @@ void f_i2l() {
  * e` presente un int sullo stack viene lanciata un'eccezione di tipo
  * std::string con la descrizione dell'errore.
  */
-void f_l2i() {
-  // Se in cima allo stack non c'e` un long, "stack_di_sistema" lancia
+template<bool CONTROLLI>
+void f_l2i(Machine& m) {
+  // Se in cima allo stack non c'e` un long, "m.stack" lancia
   // un'eccezione
-  int64_t value = stack_di_sistema.op_stack_top_long();
-  stack_di_sistema.op_stack_pop2();
-  stack_di_sistema.op_stack_push_int( static_cast<int32_t>(value) );
+  int64_t value = m.stack.op_stack_top_long<CONTROLLI>();
+  m.stack.op_stack_pop2<CONTROLLI>();
+  m.stack.op_stack_push_int<CONTROLLI>( static_cast<int32_t>(value) );
   return;
 }
 
 
 /**
- * \fn void f_dup()
+ * \fn void f_dup(Machine& m)
  * \brief Esegue <tt>dup</tt>
  *
  * Duplica e mette sullo stack degli operandi l'elemento in cima allo stack che
@@ -1549,14 +1941,15 @@ void f_l2i() {
  * un elemento che occupa due posizioni, oppure se lo stack e` vuoto, viene
  * lanciata un'eccezione di tipo std::string con la descrizione dell'errore.
  */
-void f_dup() {
-  stack_di_sistema.op_stack_dup();
+template<bool CONTROLLI>
+void f_dup(Machine& m) {
+  m.stack.op_stack_dup<CONTROLLI>();
   return;
 }
 
 
 /**
- * \fn void f_dup2()
+ * \fn void f_dup2(Machine& m)
  * \brief Esegue <tt>dup2</tt>
  *
  * Duplica e mette sullo stack degli operandi l'elemento in cima allo stack che
@@ -1564,14 +1957,15 @@ void f_dup() {
  * che occupa uan posizione, oppure se lo stack e` vuoto, viene lanciata
  * un'eccezione di tipo std::string con la descrizione dell'errore.
  */
-void f_dup2() {
-  stack_di_sistema.op_stack_dup2();
+template<bool CONTROLLI>
+void f_dup2(Machine& m) {
+  m.stack.op_stack_dup2<CONTROLLI>();
   return;
 }
 
 
 /**
- * \fn void f_pop()
+ * \fn void f_pop(Machine& m)
  * \brief Esegue <tt>pop</tt>
  *
  * Toglie il primo elemento sullo stack degli operandi che occupa una posizione
@@ -1581,14 +1975,15 @@ void f_dup2() {
  * NOTA: se viene tolto un elemento di tipo "ref" (un riferimento) NON viene
  * distrutto l'oggetto puntato dal riferimento.
  */
-void f_pop() {
-  stack_di_sistema.op_stack_pop();
+template<bool CONTROLLI>
+void f_pop(Machine& m) {
+  m.stack.op_stack_pop<CONTROLLI>();
   return;
 }
 
 
 /**
- * \fn void f_pop2()
+ * \fn void f_pop2(Machine& m)
  * \brief Esegue <tt>pop2</tt>
  *
  * Toglie il primo elemento sullo stack degli operandi che occupa due posizioni
@@ -1596,14 +1991,15 @@ void f_pop() {
  * viene lanciata un'eccezione di tipo std::string con la descrizione
  * dell'errore.
  */
-void f_pop2() {
-  stack_di_sistema.op_stack_pop2();
+template<bool CONTROLLI>
+void f_pop2(Machine& m) {
+  m.stack.op_stack_pop2<CONTROLLI>();
   return;
 }
 
 
 /**
- * \fn void f_swap()
+ * \fn void f_swap(Machine& m)
  * \brief Esegue <tt>swap</tt>
  *
  * Scambia il primo elemento sullo stack degli operandi con il secondo,
@@ -1612,226 +2008,108 @@ void f_pop2() {
  * una posizione, o se lo stack contiene meno di due elementi, viene
  * lanciata un'eccezione di tipo std::string con la descrizione dell'errore.
  */
-void f_swap() {
-  stack_di_sistema.op_stack_swap();
+template<bool CONTROLLI>
+void f_swap(Machine& m) {
+  m.stack.op_stack_swap<CONTROLLI>();
   return;
 }
 
 
 /**
- * \fn void f_invokevirtual(string& arg)
- * \param arg
+ * \fn void f_invokevirtual(Machine& m, const Instruction& istr)
+ * \param istr
  * \brief Istruzione fittizia utilizzata solo per stampa e lettura
  *
- * Per la stampa <tt>arg</tt> dev'essere:
+ * Chiama un metodo di libreria, riconosciuto al caricamento, con l'oggetto
+ * sotto i parametri sullo stack degli operandi (vedi chiama_nativo()). Per
+ * la stampa l'argomento dev'essere:
  * "java/io/PrintStream/print (<em>T</em>)V", dove <em>T</em> puo` essere C, I,
  * J oppure Ljava/lang/String;, se si stampa rispettivamente un carattere, un
- * intero, un long, oppure una stringa. Se nello stack degli operandi non c'e`
- * il tipo corrispondente a quello che si vuol cambiare viene lanciata
- * un'eccezione di tipo std::string con la descrizione dell'errore. Allo stesso
- * modo, per effettuare la stampa, dev'essere presente sullo stack un oggetto
- * di tipo Ljava/io/PrintStream;, se non c'e` viene lanciata un'eccezione di
- * tipo std::string con la descrizione dell'errore.\\
- * Nella lettura di un carattere <tt>arg</tt> dev'essere:
+ * intero, un long, oppure una stringa, con sotto un oggetto di tipo
+ * Ljava/io/PrintStream;.\\
+ * Nella lettura di un carattere l'argomento dev'essere:
  * "java/io/BufferedReader/read ()I".\\
- * Nella lettura di una stringa (utilizzata anche per int e long) <tt>arg</tt>
+ * Nella lettura di una stringa (utilizzata anche per int e long) l'argomento
  * dev'essere: "java/io/BufferedReader/readLine ()Ljava/lang/String;".\\
  * Nella lettura (sia di char, int o long) ci dev'essere un "finto" riferimento
- * ad un oggetto di tipo LBufferedReader; sullo stack degli operandi, altrimenti
- * viene lanciata un'eccezione di tipo std::string con la descrizione
- * dell'errore.\\
- * In ogni caso sono ammessi spazi tra il nome della funzione e le parentesi,
- * tra le parentesi e gli argomenti della funzione e del tipo di ritorno. Si
- * assume che non ci siano spazi iniziale e finali.
+ * ad un oggetto di tipo LBufferedReader; sullo stack degli operandi.\\
+ * Se nello stack degli operandi non ci sono i tipi richiesti viene lanciata
+ * un'eccezione di tipo std::string con la descrizione dell'errore; i metodi
+ * sconosciuti vengono ignorati.
  */
-void f_invokevirtual(string& arg) {
-  // elimina tutti gli spazi dall'argomento della funzione
-  string::size_type pos = arg.find(' ');
-  while(pos != string::npos) {
-    arg.erase(pos, 1);
-    pos = arg.find(' ', pos);
-  }
-
-  // Stampa
-  if(arg.substr(0,25) == "java/io/PrintStream/print") {
-    if(arg[26] == 'I')
-      stampa_int();
-    else if(arg[26] == 'L')
-      stampa_stringa();
-    else if(arg[26] == 'C')
-      stampa_char();
-    else if(arg[26] == 'J')
-      stampa_long();
-  }
-
-  // Lettura char
-  else if(arg == "java/io/BufferedReader/read()I") {
-    // nota: se non c'e` un riferimento in cima allo stack degli operandi,
-    // "stack_di_sistema" lancia un'eccezione
-    if(stack_di_sistema.op_stack_top_ref_type() != "Ljava/io/BufferedReader;") {
-      throw string("si ci aspettava un oggetto di tipo java/io/BufferedReader "
-          + string("sullo stack degli operandi") );
-    }
-    stack_di_sistema.op_stack_pop();
-    // legge un carattere e lo mette sullo stack
-    char c;
-    c = getchar();
-    if(c != '\n') {
-      char t = getchar();
-      while(t != '\n')
-        t = getchar();
-    }
-    stack_di_sistema.op_stack_push_int(static_cast<int32_t>(c));
-  }
-
-  // Lettura di una stringa (utilizzata anche per int e long)
-  else if(arg == "java/io/BufferedReader/readLine()Ljava/lang/String;") {
-    // nota: se non c'e` un riferimento in cima allo stack degli operandi,
-    // "stack_di_sistema" lancia un'eccezione
-    if(stack_di_sistema.op_stack_top_ref_type() != "Ljava/io/BufferedReader;") {
-      throw string("si ci aspettava un oggetto di tipo java/io/BufferedReader "
-          + string("sullo stack degli operandi") );
-    }
-    stack_di_sistema.op_stack_pop();
-    // legge una stringa e la mette sullo stack
-    string* str = new string("");
-    std::getline(std::cin, *str);
-    stack_di_sistema.op_stack_push_ref("Ljava/lang/String;",str);
-  }
-
+template<bool CONTROLLI>
+void f_invokevirtual(Machine& m, const Instruction& istr) {
+  chiama_nativo<CONTROLLI>(m, istr);
   return;
 }
 
 
 /**
- * Stampa l'elemento di tipo int sullo stack degli operandi (utilizzato
- * dalla funzione f_invokevirtual)
- */
-void stampa_int() {
-  // Se sullo stack degli operandi non c'e` un int, "stack_di_sistema" 
-  // lancia un'eccezione
-  int32_t print_value = stack_di_sistema.op_stack_top_int();
-  stack_di_sistema.op_stack_pop();
-
-  // Se non c'e` un riferimento in cima allo stack degli operandi,
-  // "stack_di_sistema" lancia un'eccezione
-  if(stack_di_sistema.op_stack_top_ref_type() != "Ljava/io/PrintStream;") {
-    throw string("si ci aspettava un oggetto di tipo java/io/PrintStream "
-          + string("sullo stack degli operandi") );
-  }
-  stack_di_sistema.op_stack_pop();
-
-  // stampa il valore
-  std::cout <<print_value;
-  return;
-}
-
-
-/**
- * Stampa l'elemento di tipo int sullo stack degli operandi convertendolo
- * in un carattere (utilizzato dalla funzione f_invokevirtual)
- */
-void stampa_char() {
-  // Se sullo stack degli operandi non c'e` un int, "stack_di_sistema" 
-  // lancia un'eccezione
-  int32_t print_value = stack_di_sistema.op_stack_top_int();
-  stack_di_sistema.op_stack_pop();
-
-  // Se non c'e` un riferimento in cima allo stack degli operandi,
-  // "stack_di_sistema" lancia un'eccezione
-  if(stack_di_sistema.op_stack_top_ref_type() != "Ljava/io/PrintStream;") {
-    throw string("si ci aspettava un oggetto di tipo java/io/PrintStream "
-          + string("sullo stack degli operandi") );
-  }
-  stack_di_sistema.op_stack_pop();
-
-  // stampa il valore
-  std::cout <<static_cast<char>(print_value);
-  return;
-}
-
-
-/**
- * Stampa l'elemento di tipo long sullo stack degli operandi (utilizzato
- * dalla funzione f_invokevirtual)
+ * \fn void chiama_nativo(Machine& m, const Instruction& istr)
+ * \brief Esegue il metodo di libreria chiamato da <tt>istr</tt>
+ *
+ * Esegue il metodo con indice <tt>istr.index</tt> nella tabella dei metodi
+ * nativi (vedi NativeMethod), risolto al caricamento: nelle funzioni
+ * verificate i tipi sullo stack degli operandi sono gia` stati controllati,
+ * percio` la chiamata e` una sola chiamata indiretta; altrimenti il metodo
+ * controlla i tipi, oppure li controlla check_native_stack() con i tipi
+ * dichiarati dal metodo.
  */
-void stampa_long() {
-  // Se sullo stack degli operandi non c'e` un long, "stack_di_sistema" 
-  // lancia un'eccezione
-  int64_t print_value = stack_di_sistema.op_stack_top_long();
-  stack_di_sistema.op_stack_pop2();
-
-  // Se non c'e` un riferimento in cima allo stack degli operandi,
-  // "stack_di_sistema" lancia un'eccezione
-  if(stack_di_sistema.op_stack_top_ref_type() != "Ljava/io/PrintStream;") {
-    throw string("si ci aspettava un oggetto di tipo java/io/PrintStream "
-          + string("sullo stack degli operandi") );
+template<bool CONTROLLI>
+void chiama_nativo(Machine& m, const Instruction& istr) {
+  const NativeMethod& metodo = native_method(istr.index);
+  if(!CONTROLLI)
+    metodo.function(m);
+  else if(metodo.checked != 0)
+    metodo.checked(m);
+  else {
+    check_native_stack(m.stack, metodo);
+    metodo.function(m);
   }
-  stack_di_sistema.op_stack_pop();
-
-  // stampa il valore
-  std::cout <<print_value;
   return;
 }
 
 
 /**
- * Stampa l'elemento di tipo string sullo stack degli operandi (utilizzato
- * dalla funzione f_invokevirtual)
+ * Dealloca la stringa <tt>str</tt> dopo il suo utilizzo, se e` stata letta
+ * dallo standard input; le stringhe del pool delle costanti (messe sullo
+ * stack da ldc_w) appartengono al programma e non vengono deallocate.
  */
-void stampa_stringa() {
-  // Se non c'e` un riferimento in cima allo stack degli operandi,
-  // "stack_di_sistema" lancia un'eccezione
-  if(stack_di_sistema.op_stack_top_ref_type() != "Ljava/lang/String;") {
-    throw string("si ci aspettava un oggetto di tipo java/lang/String "
-          + string("sullo stack degli operandi") );
-  }
-  string* print_str;
-  print_str = static_cast<string*>( stack_di_sistema.op_stack_top_ref() );
-  stack_di_sistema.op_stack_pop();
-
-  // Se non c'e` un riferimento in cima allo stack degli operandi,
-  // "stack_di_sistema" lancia un'eccezione
-  if(stack_di_sistema.op_stack_top_ref_type() != "Ljava/io/PrintStream;") {
-    // errore sullo stack degli operandi
-    throw string("si ci aspettava un oggetto di tipo java/io/PrintStream "
-          + string("sullo stack degli operandi") );
-  }
-  stack_di_sistema.op_stack_pop();
-
-  // stampa la stringa
-  std::cout <<*print_str;
-  delete print_str;
+void libera_stringa(Machine& m, string* str) {
+  if(!m.program.is_constant(str))
+    delete str;
   return;
 }
 
 
 /**
- * \fn void f_new(string& arg)
+ * \fn void f_new(Machine& m, const Instruction& istr)
  * \brief Istruzione fittizia utilizzata solo per la lettura
- * \param arg
+ * \param istr
  *
  * Crea e mette sullo stack degli operandi un "finto" riferimento ad un'oggetto
- * di tipo passato come parametro in <tt>arg</tt>.\\
+ * di tipo passato come parametro, con indice <tt>istr.index</tt> nella tabella
+ * dei tipi.\\
  * Per l'operazione di lettura servono:
  *   - java/io/BufferedReader
  *   - java/io/InputStreamReader
  */
-void f_new(string& arg) {
-  arg.insert(arg.begin(), 'L');
-  arg.push_back(';');
-  stack_di_sistema.op_stack_push_ref(arg, 0);
+template<bool CONTROLLI>
+void f_new(Machine& m, const Instruction& istr) {
+  m.stack.op_stack_push_ref<CONTROLLI>(
+      static_cast<uint16_t>(istr.index), 0);
   return;
 }
 
 
 /**
- * \fn void f_invokespecial(string& arg)
+ * \fn void f_invokespecial(Machine& m, const Instruction& istr)
  * \brief Istruzione fittizia utilizzata solo per la lettura
- * \param arg
+ * \param istr
  *
- * Chiama un metodo di una classe con riferimento sullo stack degli operandi.
- * Possibili valori di <tt>arg</tt> (utilizzati nella lettura):
+ * Chiama un metodo di una classe con riferimento sullo stack degli operandi
+ * (vedi chiama_nativo()). Possibili valori dell'argomento (utilizzati nella
+ * lettura):
  *   - java/io/InputStreamReader/\<init\> (Ljava/io/InputStream;)V
  *   - java/io/BufferedReader/\<init\> (Ljava/io/Reader;)V
  * Nel primo caso finge di chiamare il costruttore di un oggetto di tipo
@@ -1847,51 +2125,91 @@ void f_new(string& arg) {
  * appena "costruito" (sempre "virtualmente"), ed un riferimento (finto) ad un
  * BufferedReader. Di quest'ultimo oggetto verranno poi chiamati i metodi
  * per eseguire la lettura.\\
- * Si assume che questa funzione venga utilizzata solamente per i due casi
- * descritti, e che <tt>arg</tt> non contenga spazi iniziali e finali ed un solo
- * spazio per separare gli argomenti.\\
  * Se nello stack degli operandi non ci sono gli elementi sopracitati viene
  * lanciata un'eccezione di tipo std::string con la descrizione dell'errore.\\
  */
-void f_invokespecial(string& arg) {
-  // elimina tutti gli spazi dall'argomento della funzione
-  string::size_type pos = arg.find(' ');
-  while(pos != string::npos) {
-    arg.erase(pos, 1);
-    pos = arg.find(' ', pos);
-  }
+template<bool CONTROLLI>
+void f_invokespecial(Machine& m, const Instruction& istr) {
+  chiama_nativo<CONTROLLI>(m, istr);
+  return;
+}
 
-  if(arg == "java/io/InputStreamReader/<init>(Ljava/io/InputStream;)V") {
-    // nota: se non c'e` un riferimento in cima allo stack degli operandi,
-    // "stack_di_sistema" lancia un'eccezione
-    if(stack_di_sistema.op_stack_top_ref_type() != "Ljava/io/InputStream;") {
-      throw string("si ci aspettava un oggetto di tipo java/io/InputStream "
-          + string("sullo stack degli operandi") );
-    }
-    stack_di_sistema.op_stack_pop();
-    if(stack_di_sistema.op_stack_top_ref_type() != 
-        "Ljava/io/InputStreamReader;") {
-      throw string("si ci aspettava un oggetto di tipo " +
-          string("java/io/InputStreamReader sullo stack degli operandi") );
-    }
-    stack_di_sistema.op_stack_pop();
-    // oggetto InputStreamReader costruito
-  }
-  else if(arg == "java/io/BufferedReader/<init>(Ljava/io/Reader;)V") {
-    // nota: se non c'e` un riferimento in cima allo stack degli operandi,
-    // "stack_di_sistema" lancia un'eccezione
-    if(stack_di_sistema.op_stack_top_ref_type() !=
-        "Ljava/io/InputStreamReader;") {
-      throw string("si ci aspettava un oggetto di tipo " +
-          string("java/io/InputStreamReader sullo stack degli operandi") );
-    }
-    stack_di_sistema.op_stack_pop();
-    if(stack_di_sistema.op_stack_top_ref_type() != "Ljava/io/BufferedReader;") {
-      throw string("si ci aspettava un oggetto di tipo java/io/BufferedReader "
-          + string("sullo stack degli operandi") );
-    }
-    stack_di_sistema.op_stack_pop();
-    // oggetto BufferedReader costruito
-  }
+
+/**
+ * \fn void f_incremento_locale(Machine& m, const Instruction* istr, const int32_t& k)
+ * \brief Esegue le superistruzioni di incremento di una variabile locale
+ * \param istr iload n (seguita da istore n nella sequenza)
+ * \param k incremento
+ *
+ * Esegue <tt>ldc_w k; iload n; iadd; istore n</tt> e <tt>iload n; ldc_w k;
+ * iadd; istore n</tt> (per <tt>isub</tt> <tt>k</tt> e` gia` negato): somma
+ * <tt>k</tt> alla variabile locale di tipo int con indice <em>n</em>, che e`
+ * in <tt>istr->index</tt>, senza passare dallo stack degli operandi. La
+ * somma e` calcolata senza segno, con lo stesso risultato di iadd in caso di
+ * overflow. Se la variabile non e` di tipo int viene lanciata la stessa
+ * eccezione di iload.
+ */
+template<bool CONTROLLI>
+void f_incremento_locale(Machine& m, const Instruction* istr,
+    const int32_t& k) {
+  uint16_t n = static_cast<uint16_t>(istr->index);
+  uint32_t x = static_cast<uint32_t>(
+      m.stack.local_variable_get_int<CONTROLLI>(n) );
+  m.stack.local_variable_set_int<CONTROLLI>(n,
+      static_cast<int32_t>(x + static_cast<uint32_t>(k)) );
+  return;
+}
+
+
+/**
+ * \fn void f_stampa_locale_int(Machine& m, const Instruction* istr)
+ * \brief Esegue la superistruzione di stampa di una variabile locale int
+ * \param istr getstatic java/lang/System/out Ljava/io/PrintStream;
+ *
+ * Esegue <tt>getstatic java/lang/System/out Ljava/io/PrintStream; iload n;
+ * invokevirtual java/io/PrintStream/print(I)V</tt>: stampa la variabile
+ * locale di tipo int con indice <em>n</em>, che e` in
+ * <tt>istr[1].index</tt>, senza passare dallo stack degli operandi. Se la
+ * variabile non e` di tipo int viene lanciata la stessa eccezione di iload.
+ */
+template<bool CONTROLLI>
+void f_stampa_locale_int(Machine& m, const Instruction* istr) {
+  m.output.put_int(m.stack.local_variable_get_int<CONTROLLI>(
+      static_cast<uint16_t>(istr[1].index) ));
+  return;
+}
+
+
+/**
+ * \fn void f_stampa_locale_long(Machine& m, const Instruction* istr)
+ * \brief Esegue la superistruzione di stampa di una variabile locale long
+ * \param istr getstatic java/lang/System/out Ljava/io/PrintStream;
+ *
+ * Esegue <tt>getstatic java/lang/System/out Ljava/io/PrintStream; lload n;
+ * invokevirtual java/io/PrintStream/print(J)V</tt>: stampa la variabile
+ * locale di tipo long con indice <em>n</em>, che e` in
+ * <tt>istr[1].index</tt>, senza passare dallo stack degli operandi. Se la
+ * variabile non e` di tipo long viene lanciata la stessa eccezione di lload.
+ */
+template<bool CONTROLLI>
+void f_stampa_locale_long(Machine& m, const Instruction* istr) {
+  m.output.put_long(m.stack.local_variable_get_long<CONTROLLI>(
+      static_cast<uint16_t>(istr[1].index) ));
+  return;
+}
+
+
+/**
+ * \fn void f_stampa_costante_stringa(Machine& m, const Instruction* istr)
+ * \brief Esegue la superistruzione di stampa di una stringa costante
+ * \param istr getstatic java/lang/System/out Ljava/io/PrintStream;
+ *
+ * Esegue <tt>getstatic java/lang/System/out Ljava/io/PrintStream; ldc_w
+ * "str"; invokevirtual java/io/PrintStream/print(Ljava/lang/String;)V</tt>:
+ * stampa la stringa del pool delle costanti stringa con indice
+ * <tt>istr[1].index</tt>, senza passare dallo stack degli operandi.
+ */
+void f_stampa_costante_stringa(Machine& m, const Instruction* istr) {
+  m.output.put_string(m.program.get_constant(istr[1].index));
   return;
-} // end of void f_invokespecial(string& arg)
+}
@@ -0,0 +1,343 @@
+/*!
+  \file libmacchina.cc
+  \brief Implementazione dell'interfaccia C della libreria
+  \author Andrea Zanelli
+  \date 17-10-2026
+*/
+
+#ifndef LIBMACCHINA_CC_INCLUSION_GUARD
+#define LIBMACCHINA_CC_INCLUSION_GUARD
+
+#include <stdio.h>
+#include <iostream>
+#include <istream>
+#include <memory>
+#include <streambuf>
+#include <string>
+#include <vector>
+
+#include "Machine.h"
+#include "ProgramImage.h"
+#include "libmacchina.h"
+
+using std::shared_ptr;
+using std::string;
+using std::unique_ptr;
+using std::vector;
+
+
+//! Soglia del compilatore JIT (come in macchina-astratta)
+static const unsigned int SOGLIA_JIT = 1000;
+
+//! Dimensione in byte dell'area del codice nativo di ogni macchina
+static const size_t DIMENSIONE_CODICE_NATIVO = 4 * 1024 * 1024;
+
+
+/*!
+  \class ReadBuffer
+  \brief Buffer dell'ingresso del programma letto con una ma_read_function
+*/
+class ReadBuffer : public std::streambuf {
+
+  public:
+    /* METODI PUBBLICI */
+
+    /**
+     * Costruttore: l'ingresso viene letto chiamando <tt>read</tt> con
+     * <tt>data</tt> come primo argomento.
+     */
+    ReadBuffer(ma_read_function read, void* data)
+      : read(read), data(data) {
+    }
+
+  protected:
+    /**
+     * Legge altri caratteri con <tt>read</tt> quando il buffer e` vuoto.
+     */
+    int_type underflow() {
+      if(gptr() < egptr())
+        return traits_type::to_int_type(*gptr());
+      size_t n = read(data, buffer, sizeof(buffer));
+      if(n == 0)
+        return traits_type::eof();
+      if(n > sizeof(buffer))
+        n = sizeof(buffer);
+      setg(buffer, buffer, buffer + n);
+      return traits_type::to_int_type(*gptr());
+    }
+
+  private:
+    /* VARIABILI PRIVATE */
+
+    //! funzione che legge l'ingresso, e suo primo argomento
+    ma_read_function read;
+    void* data;
+
+    //! caratteri letti e non ancora usati dal programma
+    char buffer[4096];
+
+};
+
+
+//! Programma caricato e preparato
+struct ma_program {
+  shared_ptr<const ProgramImage> image;  //!< immagine del programma
+  bool jit;                              //!< true con l'opzione MA_JIT
+};
+
+
+//! Macchina che esegue un programma
+struct ma_machine {
+  Machine machine;                       //!< macchina astratta
+  unique_ptr<ReadBuffer> buffer;         //!< buffer di ma_set_input()
+  unique_ptr<std::istream> input;        //!< ingresso di ma_set_input()
+  string error;                          //!< descrizione dell'ultimo errore
+
+  explicit ma_machine(const shared_ptr<const ProgramImage>& image)
+    : machine(image) {
+  }
+};
+
+
+/*!
+  \fn void copia_errore(const string& errore, char* error, size_t error_size)
+  \brief Copia la descrizione di un errore nel buffer del chiamante
+*/
+static void copia_errore(const string& errore, char* error,
+    size_t error_size) {
+  if(error != 0 && error_size > 0)
+    snprintf(error, error_size, "%s", errore.c_str());
+  return;
+}
+
+
+/*!
+  \fn void svuota(ma_machine* machine)
+  \brief Passa le stampe rimaste nel buffer dopo un errore
+
+  Come svuota_uscita() di macchina-astratta: un eventuale errore di
+  scrittura viene ignorato, perche` l'errore da segnalare e` quello gia`
+  avvenuto.
+*/
+static void svuota(ma_machine* machine) {
+  try {
+    machine->machine.output.flush();
+  }
+  catch(...) {
+    // l'errore da segnalare e` quello gia` avvenuto
+  }
+  return;
+}
+
+
+/* ma_program* ma_program_load(...) *******************************************/
+ma_program*
+ma_program_load(const char* text, size_t size, int options, char* error,
+    size_t error_size) {
+  try {
+    if((options & MA_JIT) && !NativeCode::available())
+      throw string("il compilatore JIT richiede un processore x86-64");
+    shared_ptr<ProgramImage> immagine(new ProgramImage());
+    immagine->load_data(text, size);
+    // come in macchina-astratta: la traduzione legge le istruzioni prima
+    // della fusione, e la verifica precede la fusione
+    if(options & (MA_REGISTER_IR | MA_JIT))
+      immagine->registers.compile(immagine->program);
+    if(!(options & MA_NO_VERIFY))
+      immagine->program.verify();
+    if(!(options & MA_NO_FUSION))
+      immagine->program.fuse();
+    ma_program* programma = new ma_program;
+    programma->image = immagine;
+    programma->jit = (options & MA_JIT) != 0;
+    copia_errore("", error, error_size);
+    return programma;
+  }
+  catch(string e) {
+    copia_errore(e, error, error_size);
+  }
+  catch(...) {
+    copia_errore("errore sconosciuto nel caricamento", error, error_size);
+  }
+  return 0;
+}
+
+
+/* void ma_program_free(ma_program* program) **********************************/
+void
+ma_program_free(ma_program* program) {
+  delete program;
+  return;
+}
+
+
+/* ma_machine* ma_machine_new(const ma_program* program) **********************/
+ma_machine*
+ma_machine_new(const ma_program* program) {
+  ma_machine* macchina = 0;
+  try {
+    macchina = new ma_machine(program->image);
+    if(program->jit)
+      macchina->machine.native.enable(macchina->machine, SOGLIA_JIT,
+          DIMENSIONE_CODICE_NATIVO);
+    return macchina;
+  }
+  catch(...) {
+    delete macchina;
+  }
+  return 0;
+}
+
+
+/* void ma_machine_free(ma_machine* machine) **********************************/
+void
+ma_machine_free(ma_machine* machine) {
+  delete machine;
+  return;
+}
+
+
+/*!
+  \fn bool limiti_ammessi(ma_machine* machine, const uint64_t& limite)
+  \brief Controlla che la macchina possa usare il limite <tt>limite</tt>
+
+  Come Machine::call(), che rifiuta i limiti con il codice a registri: se il
+  limite non e` 0 e il programma e` stato caricato con MA_REGISTER_IR o
+  MA_JIT mette la descrizione dell'errore in <tt>machine->error</tt> e
+  restituisce false.
+*/
+static bool limiti_ammessi(ma_machine* machine, const uint64_t& limite) {
+  if(limite != 0 && machine->machine.registers.get_size() > 0) {
+    machine->error = "i limiti di istruzioni e di tempo non si usano con il "
+      "codice a registri (MA_REGISTER_IR e MA_JIT)";
+    return false;
+  }
+  return true;
+}
+
+
+/* int ma_set_output(ma_machine* machine, ...) ********************************/
+int
+ma_set_output(ma_machine* machine, ma_write_function write, void* data) {
+  try {
+    if(write != 0)
+      machine->machine.output.redirect(
+          [write, data](const char* str, size_t n) { write(data, str, n); });
+    else
+      machine->machine.output.redirect(
+          std::function<void (const char*, size_t)>());
+    machine->error.clear();
+    return 1;
+  }
+  catch(string e) {
+    // le stampe precedenti non sono state scritte
+    machine->error = e;
+  }
+  return 0;
+}
+
+
+/* int ma_set_input(ma_machine* machine, ...) *********************************/
+int
+ma_set_input(ma_machine* machine, ma_read_function read, void* data) {
+  try {
+    if(read == 0) {
+      machine->machine.input = &std::cin;
+      machine->input.reset();
+      machine->buffer.reset();
+    }
+    else {
+      unique_ptr<ReadBuffer> buffer(new ReadBuffer(read, data));
+      unique_ptr<std::istream> input(new std::istream(buffer.get()));
+      machine->machine.input = input.get();
+      machine->input.swap(input);
+      machine->buffer.swap(buffer);
+    }
+    machine->error.clear();
+    return 1;
+  }
+  catch(...) {
+    machine->error = "memoria insufficiente per l'ingresso del programma";
+  }
+  return 0;
+}
+
+
+/* int ma_set_instruction_limit(ma_machine* machine, ...) *********************/
+int
+ma_set_instruction_limit(ma_machine* machine, uint64_t instructions) {
+  if(!limiti_ammessi(machine, instructions))
+    return 0;
+  machine->machine.limit.set_instructions(instructions);
+  machine->error.clear();
+  return 1;
+}
+
+
+/* int ma_set_time_limit(ma_machine* machine, uint64_t milliseconds) **********/
+int
+ma_set_time_limit(ma_machine* machine, uint64_t milliseconds) {
+  if(!limiti_ammessi(machine, milliseconds))
+    return 0;
+  machine->machine.limit.set_time(milliseconds);
+  machine->error.clear();
+  return 1;
+}
+
+
+/* int ma_call(ma_machine* machine, const char* name, ...) ********************/
+int
+ma_call(ma_machine* machine, const char* name, const int64_t* arguments,
+    size_t n_arguments, int64_t* result) {
+  try {
+    vector<int64_t> parametri;
+    if(n_arguments > 0)
+      parametri.assign(arguments, arguments + n_arguments);
+    machine->machine.call(name, parametri);
+    machine->machine.output.flush();
+    if(result != 0)
+      *result = machine->machine.result;
+    machine->error.clear();
+    return 1;
+  }
+  catch(string e) {
+    machine->error = e;
+  }
+  catch(...) {
+    machine->error = "l'esecuzione e` stata interrotta da un errore "
+      "sconosciuto";
+  }
+  svuota(machine);
+  return 0;
+}
+
+
+/* int ma_run(ma_machine* machine) ********************************************/
+int
+ma_run(ma_machine* machine) {
+  try {
+    machine->machine.run();
+    machine->machine.output.flush();
+    machine->error.clear();
+    return 1;
+  }
+  catch(string e) {
+    machine->error = e;
+  }
+  catch(...) {
+    machine->error = "l'esecuzione e` stata interrotta da un errore "
+      "sconosciuto";
+  }
+  svuota(machine);
+  return 0;
+}
+
+
+/* const char* ma_error(const ma_machine* machine) ****************************/
+const char*
+ma_error(const ma_machine* machine) {
+  return machine->error.c_str();
+}
+
+
+#endif // LIBMACCHINA_CC_INCLUSION_GUARD
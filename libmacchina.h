@@ -0,0 +1,151 @@
+/*!
+  \file libmacchina.h
+  \brief Interfaccia C della libreria della macchina astratta
+  \author Andrea Zanelli
+  \date 17-10-2026
+
+  La libreria <tt>libmacchina</tt> (<tt>lib/libmacchina.a</tt> e
+  <tt>lib/libmacchina.so</tt>, vedi il makefile) contiene tutta la macchina
+  astratta, cosi` che possa essere usata da un altro programma senza
+  eseguire <tt>macchina-astratta</tt> in un altro processo. Dal C++ si
+  possono usare direttamente le classi ProgramImage (caricamento del
+  programma) e Machine (esecuzione); questa interfaccia, usabile anche dal
+  C, offre le operazioni principali:
+    - ma_program_load() carica e prepara un programma dalla memoria
+      (sorgente o file bytecode), una volta sola: il programma puo` essere
+      eseguito da piu` macchine, anche contemporaneamente in thread diversi;
+    - ma_machine_new() crea una macchina che esegue il programma;
+    - ma_call() esegue una funzione del programma con parametri int o
+      long e ne restituisce il valore, ma_run() esegue il programma come
+      <tt>macchina-astratta</tt>;
+    - ma_set_output() e ma_set_input() passano le stampe e le letture del
+      programma a funzioni del chiamante invece che allo standard output e
+      allo standard input;
+    - ma_set_instruction_limit() e ma_set_time_limit() limitano il numero
+      di istruzioni e il tempo di ogni chiamata (vedi ExecutionLimit).
+  Le funzioni che possono fallire restituiscono 0 (o NULL) in caso di
+  errore, con la descrizione dell'errore in ma_error(), che resta fino
+  alla successiva funzione che termina con successo.
+*/
+
+#ifndef LIBMACCHINA_H_INCLUSION_GUARD
+#define LIBMACCHINA_H_INCLUSION_GUARD
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+//! Opzione di ma_program_load(): traduce le funzioni nel codice a registri
+#define MA_REGISTER_IR 1
+//! Opzione di ma_program_load(): codice a registri e compilatore JIT
+#define MA_JIT 2
+//! Opzione di ma_program_load(): senza verifica dei tipi
+#define MA_NO_VERIFY 4
+//! Opzione di ma_program_load(): senza superistruzioni
+#define MA_NO_FUSION 8
+
+//! Programma caricato e preparato (vedi ProgramImage)
+typedef struct ma_program ma_program;
+
+//! Macchina che esegue un programma (vedi Machine)
+typedef struct ma_machine ma_machine;
+
+//! Funzione che riceve <tt>n</tt> caratteri stampati dal programma
+typedef void (*ma_write_function)(void* data, const char* str, size_t n);
+
+//! Funzione che mette in <tt>buffer</tt> al piu` <tt>size</tt> caratteri
+//! da leggere e ne restituisce il numero (0: fine dell'ingresso)
+typedef size_t (*ma_read_function)(void* data, char* buffer, size_t size);
+
+/**
+ * Carica il programma dai <tt>size</tt> byte in <tt>text</tt> (sorgente o
+ * file bytecode, che vengono copiati) e lo prepara secondo
+ * <tt>options</tt> (MA_REGISTER_IR, MA_JIT, MA_NO_VERIFY e MA_NO_FUSION,
+ * combinate con '|'). In caso di errore restituisce NULL e, se
+ * <tt>error</tt> non e` NULL, ne scrive la descrizione in <tt>error</tt>
+ * (al piu` <tt>error_size</tt> caratteri, compreso lo 0 finale).
+ */
+ma_program* ma_program_load(const char* text, size_t size, int options,
+    char* error, size_t error_size);
+
+/**
+ * Libera il programma; le macchine create con il programma restano valide.
+ */
+void ma_program_free(ma_program* program);
+
+/**
+ * Crea una macchina che esegue <tt>program</tt>, con le variabili globali
+ * al loro valore iniziale, che stampa sullo standard output e legge dallo
+ * standard input; restituisce NULL se non puo` essere creata.
+ */
+ma_machine* ma_machine_new(const ma_program* program);
+
+/**
+ * Libera la macchina, dopo aver passato le stampe rimaste.
+ */
+void ma_machine_free(ma_machine* machine);
+
+/**
+ * Passa le stampe del programma a <tt>write</tt>, con <tt>data</tt> come
+ * primo argomento (con <tt>write</tt> NULL di nuovo sullo standard output).
+ * Le stampe vengono accumulate nel buffer della macchina e passate quando
+ * il buffer e` pieno, prima di ogni lettura e alla fine di ogni chiamata.
+ * Prima del cambio passa le stampe rimaste alla destinazione precedente;
+ * restituisce 0 se non e` stato possibile (vedi ma_error()), altrimenti 1.
+ */
+int ma_set_output(ma_machine* machine, ma_write_function write, void* data);
+
+/**
+ * Legge l'ingresso del programma con <tt>read</tt>, con <tt>data</tt> come
+ * primo argomento (con <tt>read</tt> NULL di nuovo dallo standard input).
+ * Restituisce 1, oppure 0 in caso di errore (vedi ma_error()).
+ */
+int ma_set_input(ma_machine* machine, ma_read_function read, void* data);
+
+/**
+ * Imposta il numero massimo di istruzioni di ogni chiamata (0: nessun
+ * limite); le istruzioni fuse in una superistruzione vengono contate tutte,
+ * percio` il limite non dipende da MA_NO_FUSION. I limiti si usano solo con i programmi caricati senza
+ * MA_REGISTER_IR e MA_JIT: per gli altri un limite diverso da 0 non viene
+ * impostato e la funzione restituisce 0 (vedi ma_error()), altrimenti 1.
+ */
+int ma_set_instruction_limit(ma_machine* machine, uint64_t instructions);
+
+/**
+ * Imposta il tempo massimo in millisecondi di ogni chiamata (0: nessun
+ * limite), con le stesse restrizioni di ma_set_instruction_limit().
+ */
+int ma_set_time_limit(ma_machine* machine, uint64_t milliseconds);
+
+/**
+ * Esegue la funzione con descrittore <tt>name</tt> (ad esempio "fact(I)I")
+ * con gli <tt>n_arguments</tt> parametri int o long in <tt>arguments</tt>
+ * e, se <tt>result</tt> non e` NULL, vi mette il valore restituito (vedi
+ * Machine::call()). Restituisce 1 se la funzione e` terminata, 0 in caso di
+ * errore (vedi ma_error()).
+ */
+int ma_call(ma_machine* machine, const char* name, const int64_t* arguments,
+    size_t n_arguments, int64_t* result);
+
+/**
+ * Esegue il programma: la funzione "<clinit>()V", se esiste, e poi la
+ * funzione main. Restituisce 1 se il programma e` terminato, 0 in caso di
+ * errore (vedi ma_error()).
+ */
+int ma_run(ma_machine* machine);
+
+/**
+ * Restituisce la descrizione dell'ultimo errore della macchina (la stringa
+ * vuota se non c'e` stato nessun errore).
+ */
+const char* ma_error(const ma_machine* machine);
+
+#ifdef __cplusplus
+}
+#endif
+
+
+#endif // LIBMACCHINA_H_INCLUSION_GUARD
@@ -27,6 +27,140 @@
       pdf dentro la directory "doc".
   L'eseguibile <tt>macchina-astratta</tt> si aspetta come argomento un file,
   all'interno del quale ci dovra` essere il codice del programma da eseguire.
+
+  \section options_sec Opzioni
+
+  Prima del nome del file possono essere date le seguenti opzioni:
+    - <tt>--output-buffer <em>n</em></tt> (o <tt>--output-buffer=<em>n</em></tt>):
+      la stampa del programma viene accumulata in un buffer di <em>n</em> byte
+      (65536 se l'opzione non e` data) e scritta sullo standard output quando
+      il buffer e` pieno, prima di ogni lettura dallo standard input e alla
+      fine del programma. Con <em>n</em> uguale a 0 la stampa non usa il buffer.
+    - <tt>--unbuffered</tt>: equivale a <tt>--output-buffer 0</tt>, ogni stampa
+      viene scritta subito (utile se l'uscita e` letta da un altro programma
+      mentre la macchina astratta e` in esecuzione).
+    - <tt>--timing</tt>: alla fine stampa sullo standard error il tempo di
+      caricamento del programma (lettura, decodifica e collegamento) e,
+      separatamente, quello di esecuzione.
+    - <tt>--no-verify</tt>: non verifica i tipi delle funzioni dopo il
+      caricamento (vedi ProgramArea::verify()): tutte le funzioni vengono
+      eseguite con i controlli sui tipi dello stack degli operandi e delle
+      variabili locali, che altrimenti sono omessi nelle funzioni verificate.
+    - <tt>--verify-report</tt>: dopo il caricamento stampa sullo standard
+      error, per ogni funzione, l'esito della verifica dei tipi.
+    - <tt>--no-fusion</tt>: non fonde le sequenze di istruzioni piu`
+      frequenti in superistruzioni (vedi ProgramArea::fuse()), che altrimenti
+      vengono create dopo il caricamento.
+    - <tt>--fusion-report</tt>: dopo il caricamento stampa sullo standard
+      error, per ogni funzione, le superistruzioni create.
+    - <tt>--register-ir</tt>: dopo il caricamento traduce le funzioni in
+      codice a registri (vedi RegisterCode), eseguito da
+      esecutore_a_registri(); le funzioni che non possono essere tradotte
+      restano eseguite sullo stack.
+    - <tt>--register-report</tt>: con <tt>--register-ir</tt> stampa sullo
+      standard error, per ogni funzione, l'esito della traduzione.
+    - <tt>--jit</tt>: come <tt>--register-ir</tt>, e in piu` compila in
+      codice macchina x86-64 (vedi NativeCode) le funzioni tradotte quando
+      il numero di chiamate o di salti all'indietro verso la stessa
+      istruzione raggiunge la soglia.
+    - <tt>--jit-threshold <em>n</em></tt> (o
+      <tt>--jit-threshold=<em>n</em></tt>): soglia del compilatore JIT (1000
+      se l'opzione non e` data; con 0 le funzioni vengono compilate alla
+      prima chiamata).
+    - <tt>--jit-report</tt>: con <tt>--jit</tt>, alla fine stampa sullo
+      standard error le funzioni compilate.
+    - <tt>--profile</tt>: conta le istruzioni eseguite e le chiamate e
+      misura il tempo trascorso in ogni funzione (vedi Profiler); alla fine
+      stampa sullo standard error le funzioni ordinate per tempo esclusivo,
+      le istruzioni eseguite per codice operativo e le istruzioni piu`
+      eseguite, e scrive gli stessi dati in formato JSON nel file con lo
+      stesso nome del programma ed estensione ".profile.json". Non puo`
+      essere usata con <tt>--register-ir</tt> e <tt>--jit</tt>.
+    - <tt>--profile-json <em>file</em></tt> (o
+      <tt>--profile-json=<em>file</em></tt>): come <tt>--profile</tt>, con
+      il profilo in formato JSON scritto in <em>file</em>.
+    - <tt>--sample</tt>: campiona lo stack delle chiamate del programma a
+      intervalli regolari di tempo del processore (vedi Sampler), senza
+      rallentare l'esecuzione delle istruzioni, e alla fine scrive gli
+      stack campionati nel formato "folded" (l'ingresso di flamegraph.pl)
+      nel file con lo stesso nome del programma ed estensione ".folded".
+      Puo` essere usata con tutti i modi di esecuzione.
+    - <tt>--sample-output <em>file</em></tt> (o
+      <tt>--sample-output=<em>file</em></tt>): come <tt>--sample</tt>, con
+      gli stack scritti in <em>file</em>.
+    - <tt>--sample-interval <em>n</em></tt> (o
+      <tt>--sample-interval=<em>n</em></tt>): con <tt>--sample</tt>, prende
+      un campione ogni <em>n</em> microsecondi (1000 se l'opzione non e`
+      data), nei limiti della risoluzione del timer del sistema.
+    - <tt>--batch</tt>: al posto di un solo file ne prende una lista, e
+      esegue ogni programma con una sua macchina, con al piu`
+      <tt>--jobs</tt> programmi contemporaneamente in thread diversi (vedi
+      \ref batch_sec).
+    - <tt>--jobs <em>n</em></tt> (o <tt>--jobs=<em>n</em></tt>): con
+      <tt>--batch</tt>, numero massimo di programmi eseguiti
+      contemporaneamente (se l'opzione non e` data, il numero di processori).
+    - <tt>--compile</tt>: invece di eseguire il programma lo compila nel
+      file bytecode indicato con <tt>-o <em>file</em></tt> (dopo il nome del
+      sorgente, ad esempio <tt>--compile prog.j -o prog.jbc</tt>) o, senza
+      <tt>-o</tt>, nel file con lo stesso nome del sorgente ed estensione
+      ".jbc".
+    - <tt>--emit-cpp</tt>: invece di eseguire il programma lo traduce in un
+      sorgente C++ indipendente dalla macchina astratta (vedi CppCode),
+      scritto nel file indicato con <tt>-o <em>file</em></tt> o, senza
+      <tt>-o</tt>, sullo standard output. Compilato con lo stesso
+      compilatore del makefile, il sorgente da` un eseguibile con le stesse
+      stampe del programma (vedi \ref aot_sec).
+
+  \section bytecode_sec File bytecode
+
+  Il file bytecode contiene il programma gia` decodificato e collegato: il
+  pool delle costanti stringa, la tabella delle funzioni, le variabili
+  globali (con la loro posizione) e l'array delle istruzioni decodificate.
+  La macchina astratta esegue direttamente un file bytecode passato al posto
+  del sorgente, riconoscendolo dall'identificativo iniziale; inoltre, se
+  accanto al sorgente <tt>prog.j</tt> c'e` un file <tt>prog.jbc</tt> piu`
+  recente, usa quest'ultimo senza rileggere il sorgente. Il file bytecode
+  non viene mai creato durante l'esecuzione, solo con <tt>--compile</tt>, e
+  puo` essere letto solo da una macchina astratta della stessa versione e
+  architettura che l'ha scritto.
+
+  \section batch_sec Esecuzione di piu` programmi
+
+  Con l'opzione <tt>--batch</tt> la macchina astratta esegue tutti i file
+  dati dopo le opzioni, con le stesse opzioni, in un gruppo di thread grande
+  quanto il numero dato con <tt>--jobs</tt>: ogni thread prende dalla coda il
+  primo programma non ancora eseguito e lo esegue con una sua macchina (vedi
+  Machine), poi passa al successivo. Ogni file diverso viene caricato e
+  preparato una volta sola: i programmi dello stesso file usano la stessa
+  immagine (vedi ProgramImage). Con <tt>--sample</tt> i programmi
+  vengono eseguiti uno alla volta, perche' il campionamento usa un timer
+  unico per il processo. Lo standard output e lo standard error di ogni
+  programma vengono raccolti in memoria e scritti, nell'ordine dei file,
+  quando il programma e` terminato e lo sono tutti i precedenti, percio` lo
+  standard output complessivo e` lo stesso dell'esecuzione dei programmi uno
+  dopo l'altro; ogni riga dello standard error e` preceduta dal nome del
+  file. Lo standard input dei programmi e` vuoto. Con <tt>--profile</tt> e
+  <tt>--sample</tt> i file dei profili hanno il nome del programma, percio`
+  non si possono dare due volte lo stesso programma (o il sorgente e il file
+  bytecode dello stesso programma). La macchina astratta termina con 1 se
+  almeno un programma e` terminato con un errore. Con <tt>--compile</tt> e
+  <tt>--emit-cpp</tt> ogni file viene compilato o tradotto allo stesso modo
+  (senza <tt>-o</tt>).
+
+  \section aot_sec Traduzione in C++
+
+  Con l'opzione <tt>--emit-cpp</tt> il programma caricato viene tradotto in
+  un'unica unita` di traduzione C++: ogni funzione diventa una funzione C++,
+  le variabili locali e le posizioni dello stack degli operandi variabili
+  C++ del loro tipo e le etichette destinazioni di <tt>goto</tt>. Possono
+  essere tradotti i programmi in cui il tipo di ogni posizione dello stack
+  degli operandi e di ogni variabile locale letta e` noto in ogni
+  istruzione (come per <tt>--register-ir</tt>, vedi CppCode). Il makefile
+  crea l'eseguibile tradotto di un programma con
+  <tt>make aot/<em>percorso</em>/<em>nome</em></tt> (dal file
+  <tt><em>percorso</em>/<em>nome</em>.j</tt>) e con <tt>make aot-test</tt>
+  confronta la stampa e il codice di uscita degli eseguibili tradotti dei
+  programmi in "test" con quelli della macchina astratta.
 */
 
 /*!
@@ -36,45 +170,106 @@
   \date 18-12-2008
 */
 
+#include <condition_variable>
 #include <fstream>
+#include <future>
 #include <iostream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <sstream>
 #include <string>
 #include <stdio.h>
+#include <stdlib.h>
+#include <system_error>
+#include <thread>
+#include <time.h>
+#include <utility>
+#include <vector>
 
-#include "ProgramArea.h"
-#include "GlobalVariablesArea.h"
-#include "SystemStack.h"
+#include "CppCode.h"
+#include "Machine.h"
+#include "Sampler.h"
 
+using std::map;
+using std::shared_ptr;
 using std::string;
+using std::unique_ptr;
+using std::vector;
 
 // Variabili globali
 
-//! Contiene l'insieme delle istruzioni da eseguire suddivise per funzione
-ProgramArea programma;
-
-//! Contiene le variabili globali del programma
-GlobalVariablesArea variabili_globali; 
+//! Dimensione in byte dell'area del codice nativo
+static const size_t DIMENSIONE_CODICE_NATIVO = 4 * 1024 * 1024;
 
-//! Stack di sistema del programma da eseguire, contiene i record di attivazione
-SystemStack stack_di_sistema;
-
-//! Se "true" e` stata trovata la funzione "clinit"
-bool funzione_clinit = false;
+/*!
+  \struct Opzioni
+  \brief Opzioni della riga di comando (vedi \ref options_sec), le stesse per
+  tutti i programmi eseguiti
+*/
+struct Opzioni {
+  const char* nome_uscita;          //!< file di -o (0 se non e` dato)
+  bool compila;                     //!< --compile
+  bool traduci_cpp;                 //!< --emit-cpp
+  bool tempi;                       //!< --timing
+  bool verifica;                    //!< false con --no-verify
+  bool rapporto_verifica;           //!< --verify-report
+  bool fusione;                     //!< false con --no-fusion
+  bool rapporto_fusione;            //!< --fusion-report
+  bool registri;                    //!< --register-ir (o --jit)
+  bool rapporto_registri;           //!< --register-report
+  bool jit;                         //!< --jit
+  bool rapporto_jit;                //!< --jit-report
+  bool profilo_attivo;              //!< --profile (o --profile-json)
+  string nome_profilo;              //!< file di --profile-json
+  bool campionamento;               //!< --sample (o --sample-output)
+  string nome_campioni;             //!< file di --sample-output
+  unsigned int intervallo_campioni; //!< --sample-interval
+  unsigned int soglia_jit;          //!< --jit-threshold
+  unsigned int dimensione_buffer;   //!< --output-buffer
+  Opzioni()
+    : nome_uscita(0), compila(false), traduci_cpp(false), tempi(false),
+      verifica(true), rapporto_verifica(false), fusione(true),
+      rapporto_fusione(false), registri(false), rapporto_registri(false),
+      jit(false), rapporto_jit(false), profilo_attivo(false),
+      campionamento(false), intervallo_campioni(1000), soglia_jit(1000),
+      dimensione_buffer(OutputBuffer::DEFAULT_SIZE) {}
+};
 
-//! Numero di funzioni trovate all'interno del programma
-unsigned int n_funzioni = 0;
+/*!
+  \struct Immagini
+  \brief Immagini dei programmi di esegui_batch(), una per ogni file diverso,
+  condivise dai thread
+*/
+struct Immagini {
+  //! immagine (o errore del caricamento) di ogni file, gia` pronta o in
+  //! caricamento da parte di un altro thread
+  map<string, std::shared_future<shared_ptr<const ProgramImage> > > immagine;
+  std::mutex mutex;  //!< protegge immagine
+};
 
 // Dichiarazione di funzioni
 
-void leggi_file(std::ifstream& in_file);
-bool leggi_istruzione(std::ifstream& file, string& str);
-void cotrolla_etichetta(string& str);
-void gestisci_direttiva(const string& direttiva);
-void inserisci_variabile_globale(const string& direttiva);
-void pulisci_stringa(string& str);
-void elimina_spazi_iniziali_e_finali(string& str);
-void cancella_carattere(string& str, char c = ' ');
-extern void esecutore();
+int esegui_programma(const char* nome_file, const Opzioni& opzioni,
+    std::ostream& errori, string* uscita, std::istream* ingresso,
+    Immagini* immagini);
+shared_ptr<const ProgramImage> prepara_immagine(const char* nome_file,
+    const Opzioni& opzioni);
+shared_ptr<const ProgramImage> immagine_condivisa(Immagini& immagini,
+    const char* nome_file, const Opzioni& opzioni);
+void scrivi_cpp(const string& sorgente, const char* nome_file);
+string nome_file_profilo(const string& programma, const char* estensione);
+void scrivi_profilo(Machine& macchina, const string& nome_file,
+    std::ostream& errori);
+void scrivi_campioni(Sampler& campionatore, const string& nome_file,
+    std::ostream& errori);
+bool leggi_dimensione(const char* str, unsigned int& dimensione);
+void svuota_uscita(Machine* macchina);
+double millisecondi();
+void stampa_tempi(const double& caricamento, const double& esecuzione,
+    std::ostream& errori);
+int esegui_batch(const vector<const char*>& file, const Opzioni& opzioni,
+    const unsigned int& lavori);
 
 
 /*!
@@ -85,387 +280,800 @@ extern void esecutore();
   \return 0: Ok
   \return 1: Errore
 
-  Prende come argomento il nome del file da eseguire (contenente il programma).
-  Dopodiche` esegue i seguenti passi:
-    - (1) Inizializza l'oggetto globale <tt>programma</tt> e carica le
-      istruzioni del programma al suo interno.
-    - (2) Inizializza l'oggetto globale <tt>variabili_globali</tt> e ci
-      mette dentro le variabili globali del programma.
-    - (3) Se esiste la funzione "\<clinit\> ()V" (per l'inizializzazione 
-      delle variabili globali) crea un record di attivazione vuoto in
-      <tt>stack_di_sistema</tt> impostando il PC alla prima istruzione di
-      "&lt;clinit&gt; ()V" e chiama la funzione <tt>esecutore()</tt>.
-    - (4) Crea un record di attivazione nell'oggetto globale
-      <tt>stack_di_sistema</tt> e imposta il PC alla prima istruzione della
-      funzione main.
-    - (5) Passa il controllo alla funzione <tt>esecutore()</tt> che si occupa
-      di eseguire le istruzioni contenute in <tt>programma</tt>.
+  Prende come argomento il nome del file da eseguire (contenente il programma),
+  preceduto eventualmente dalle opzioni descritte in \ref options_sec, e lo
+  esegue con esegui_programma(). Con l'opzione <tt>--batch</tt> esegue allo
+  stesso modo tutti i file dati, in piu` thread (vedi esegui_batch()).
 */
 int main(int argc, char **argv) {
-  /* Gestisce gli argomenti e apre il file */
-  std::ifstream in_file;
-  if(argc < 2) {
+  /* Gestisce gli argomenti */
+  const char* nome_file = 0;
+  Opzioni opzioni;
+  bool batch = false;
+  unsigned int lavori = 0;
+  int i = 1;
+  for(; i<argc && nome_file == 0; ++i) {
+    string opzione(argv[i]);
+    if(opzione == "--unbuffered") {
+      opzioni.dimensione_buffer = 0;
+    }
+    else if(opzione == "--output-buffer" ||
+        opzione.substr(0,16) == "--output-buffer=") {
+      const char* valore = 0;
+      if(opzione.size() > 15)
+        valore = argv[i] + 16;
+      else if(i+1 < argc)
+        valore = argv[++i];
+      if(valore == 0 || !leggi_dimensione(valore, opzioni.dimensione_buffer)) {
+        std::cerr <<"Errore: dimensione del buffer non valida in "
+                  <<opzione <<std::endl;
+        return 1;
+      }
+    }
+    else if(opzione == "--batch") {
+      batch = true;
+    }
+    else if(opzione == "--jobs" || opzione.substr(0,7) == "--jobs=") {
+      const char* valore = 0;
+      if(opzione.size() > 6)
+        valore = argv[i] + 7;
+      else if(i+1 < argc)
+        valore = argv[++i];
+      if(valore == 0 || !leggi_dimensione(valore, lavori) || lavori == 0) {
+        std::cerr <<"Errore: numero di programmi non valido in " <<opzione
+                  <<std::endl;
+        return 1;
+      }
+    }
+    else if(opzione == "--compile") {
+      opzioni.compila = true;
+    }
+    else if(opzione == "--emit-cpp") {
+      opzioni.traduci_cpp = true;
+    }
+    else if(opzione == "--timing") {
+      opzioni.tempi = true;
+    }
+    else if(opzione == "--no-verify") {
+      opzioni.verifica = false;
+    }
+    else if(opzione == "--verify-report") {
+      opzioni.rapporto_verifica = true;
+    }
+    else if(opzione == "--no-fusion") {
+      opzioni.fusione = false;
+    }
+    else if(opzione == "--fusion-report") {
+      opzioni.rapporto_fusione = true;
+    }
+    else if(opzione == "--register-ir") {
+      opzioni.registri = true;
+    }
+    else if(opzione == "--register-report") {
+      opzioni.rapporto_registri = true;
+    }
+    else if(opzione == "--jit") {
+      opzioni.jit = opzioni.registri = true;
+    }
+    else if(opzione == "--jit-threshold" ||
+        opzione.substr(0,16) == "--jit-threshold=") {
+      const char* valore = 0;
+      if(opzione.size() > 15)
+        valore = argv[i] + 16;
+      else if(i+1 < argc)
+        valore = argv[++i];
+      if(valore == 0 || !leggi_dimensione(valore, opzioni.soglia_jit)) {
+        std::cerr <<"Errore: soglia non valida in " <<opzione <<std::endl;
+        return 1;
+      }
+    }
+    else if(opzione == "--jit-report") {
+      opzioni.rapporto_jit = true;
+    }
+    else if(opzione == "--profile") {
+      opzioni.profilo_attivo = true;
+    }
+    else if(opzione == "--profile-json" ||
+        opzione.substr(0,15) == "--profile-json=") {
+      const char* valore = 0;
+      if(opzione.size() > 14)
+        valore = argv[i] + 15;
+      else if(i+1 < argc)
+        valore = argv[++i];
+      if(valore == 0 || *valore == '\0') {
+        std::cerr <<"Errore: nome del file mancante in " <<opzione
+                  <<std::endl;
+        return 1;
+      }
+      opzioni.profilo_attivo = true;
+      opzioni.nome_profilo = valore;
+    }
+    else if(opzione == "--sample") {
+      opzioni.campionamento = true;
+    }
+    else if(opzione == "--sample-output" ||
+        opzione.substr(0,16) == "--sample-output=") {
+      const char* valore = 0;
+      if(opzione.size() > 15)
+        valore = argv[i] + 16;
+      else if(i+1 < argc)
+        valore = argv[++i];
+      if(valore == 0 || *valore == '\0') {
+        std::cerr <<"Errore: nome del file mancante in " <<opzione
+                  <<std::endl;
+        return 1;
+      }
+      opzioni.campionamento = true;
+      opzioni.nome_campioni = valore;
+    }
+    else if(opzione == "--sample-interval" ||
+        opzione.substr(0,18) == "--sample-interval=") {
+      const char* valore = 0;
+      if(opzione.size() > 17)
+        valore = argv[i] + 18;
+      else if(i+1 < argc)
+        valore = argv[++i];
+      if(valore == 0 ||
+          !leggi_dimensione(valore, opzioni.intervallo_campioni) ||
+          opzioni.intervallo_campioni == 0) {
+        std::cerr <<"Errore: intervallo non valido in " <<opzione
+                  <<std::endl;
+        return 1;
+      }
+    }
+    else if(opzione == "-o" && i+1 < argc) {
+      opzioni.nome_uscita = argv[++i];
+    }
+    else if(opzione.substr(0,2) == "--" || opzione == "-o") {
+      std::cerr <<"Errore: opzione sconosciuta " <<opzione <<std::endl;
+      return 1;
+    }
+    else {
+      nome_file = argv[i];
+    }
+  } // end for(; i<argc && nome_file == 0; ++i)
+  if(nome_file == 0) {
     std::cerr <<"Errore: specificare il nome del file" <<std::endl;
     return 1;
   }
-  if(argc > 2) {
+  // "--compile sorgente -o destinazione": l'opzione -o puo` seguire il file
+  if((opzioni.compila || opzioni.traduci_cpp) && i+1 < argc &&
+      string(argv[i]) == "-o") {
+    opzioni.nome_uscita = argv[i+1];
+    i += 2;
+  }
+  // con --batch gli argomenti successivi sono gli altri file
+  vector<const char*> file_batch(1, nome_file);
+  for(; batch && i < argc; ++i)
+    file_batch.push_back(argv[i]);
+  if(i < argc) {
     std::cerr <<"Attenzione: i seguenti argomenti sono stati ignorati:";
-    for(int i=2; i<argc; ++i)
+    for(; i<argc; ++i)
       std::cerr  <<" " <<argv[i];
     std::cerr <<std::endl;
-  } // end if(argc > 2)
-
-  in_file.open(argv[1]);
-  if(!in_file) {
-    std::cerr <<"Errore: impossibile aprire il file " <<argv[1] <<std::endl;
+  } // end if(i < argc)
+  if(opzioni.nome_uscita != 0 && !opzioni.compila && !opzioni.traduci_cpp) {
+    std::cerr <<"Errore: l'opzione -o si usa solo con --compile o --emit-cpp"
+              <<std::endl;
     return 1;
   }
+  if(opzioni.compila && opzioni.traduci_cpp) {
+    std::cerr <<"Errore: le opzioni --compile e --emit-cpp sono alternative"
+              <<std::endl;
+    return 1;
+  }
+  if(opzioni.profilo_attivo && opzioni.registri) {
+    std::cerr <<"Errore: l'opzione --profile non si usa con --register-ir "
+              <<"o --jit" <<std::endl;
+    return 1;
+  }
+  if(batch && (opzioni.nome_uscita != 0 || !opzioni.nome_profilo.empty() ||
+        !opzioni.nome_campioni.empty())) {
+    std::cerr <<"Errore: con --batch i file scritti hanno il nome del "
+              <<"programma (non si usano -o, --profile-json e "
+              <<"--sample-output)" <<std::endl;
+    return 1;
+  }
+  if(batch && (opzioni.profilo_attivo || opzioni.campionamento)) {
+    // due programmi non possono scrivere lo stesso file del profilo
+    map<string, const char*> profili;
+    for(unsigned int k = 0; k < file_batch.size(); ++k) {
+      const string profilo = nome_file_profilo(file_batch[k], "");
+      if(profili.count(profilo) != 0) {
+        std::cerr <<"Errore: con --profile e --sample i programmi "
+                  <<profili[profilo] <<" e " <<file_batch[k]
+                  <<" scriverebbero lo stesso file" <<std::endl;
+        return 1;
+      }
+      profili[profilo] = file_batch[k];
+    }
+  }
+  if(batch)
+    return esegui_batch(file_batch, opzioni, lavori);
+  return esegui_programma(nome_file, opzioni, std::cerr, 0, 0, 0);
+} // end main(int argc, char **argv)
+
 
+/*!
+  \fn int esegui_programma(const char* nome_file, const Opzioni& opzioni, std::ostream& errori, string* uscita, std::istream* ingresso, Immagini* immagini)
+  \brief Esegue un programma
+  \param nome_file nome del file del programma (sorgente o bytecode)
+  \param opzioni opzioni della riga di comando
+  \param errori dove scrivere i messaggi di errore, i rapporti e i tempi
+  (lo standard error del programma)
+  \param uscita stringa a cui aggiungere la stampa del programma (o il
+  sorgente C++ di <tt>--emit-cpp</tt>), oppure 0 per lo standard output
+  \param ingresso ingresso del programma, oppure 0 per lo standard input
+  \param immagini immagini gia` caricate dagli altri programmi, oppure 0
+  per caricare sempre il file
+  \return 0: Ok
+  \return 1: Errore
+
+  Con l'opzione <tt>--compile</tt> carica il sorgente, scrive il file bytecode
+  (vedi \ref bytecode_sec) e termina senza eseguire il programma; allo
+  stesso modo, con l'opzione <tt>--emit-cpp</tt> carica il programma e ne
+  scrive la traduzione in C++ (vedi \ref aot_sec). Altrimenti esegue i
+  seguenti passi:
+    - (1) Carica in un'immagine del programma (vedi ProgramImage) le
+      istruzioni del programma e le variabili globali e le collega,
+      risolvendo le etichette dei salti, le funzioni chiamate e le
+      variabili globali (se non esistono il caricamento fallisce). Se il
+      file e` un file bytecode, o se il sorgente ha un file bytecode piu`
+      recente, il programma viene letto gia` decodificato e collegato (vedi
+      ProgramImage::load()). Poi, se non e` data l'opzione
+      <tt>--no-verify</tt>, vengono verificati i tipi di ogni funzione, e se
+      non e` data l'opzione <tt>--no-fusion</tt> le sequenze di istruzioni
+      piu` frequenti vengono fuse in superistruzioni (e, prima, con
+      l'opzione <tt>--register-ir</tt> le funzioni vengono tradotte in
+      codice a registri). Se <tt>immagini</tt> non e` 0, il programma viene
+      caricato e preparato una volta sola per ogni file (vedi
+      immagine_condivisa()).
+    - (2) Crea la macchina (vedi Machine), che esegue l'immagine, con le
+      variabili globali al loro valore iniziale.
+    - (3) Se esiste la funzione "\<clinit\> ()V" (per l'inizializzazione 
+      delle variabili globali) crea un record di attivazione vuoto nello
+      stack di sistema della macchina impostando il PC alla prima
+      istruzione di "&lt;clinit&gt; ()V" e chiama la funzione
+      <tt>esecutore()</tt> (o <tt>esecutore_a_registri()</tt>, con
+      <tt>--register-ir</tt>).
+    - (4) Crea un record di attivazione nello stack di sistema e imposta il
+      PC alla prima istruzione della funzione main.
+    - (5) Passa il controllo alla funzione <tt>esecutore()</tt> che si occupa
+      di eseguire le istruzioni del programma (vedi Machine::run()).
+
+  Non usa variabili globali, percio` puo` essere chiamata da piu` thread
+  contemporaneamente, tranne che con <tt>--sample</tt> (vedi Sampler).
+*/
+int esegui_programma(const char* nome_file, const Opzioni& opzioni,
+    std::ostream& errori, string* uscita, std::istream* ingresso,
+    Immagini* immagini) {
+  string nome_profilo(opzioni.nome_profilo);
+  if(opzioni.profilo_attivo && nome_profilo.empty())
+    nome_profilo = nome_file_profilo(nome_file, ".profile.json");
+  string nome_campioni(opzioni.nome_campioni);
+  if(opzioni.campionamento && nome_campioni.empty())
+    nome_campioni = nome_file_profilo(nome_file, ".folded");
+
+  // macchina che esegue il programma, creata dopo il caricamento
+  unique_ptr<Machine> macchina;
+  // campionamento dello stack delle chiamate (opzione --sample)
+  Sampler campionatore;
+  // istanti di inizio e fine del caricamento e fine dell'esecuzione
+  double inizio = millisecondi();
+  double caricato = inizio;
   try{
-    /* (1) e (2): legge e gestisce le istruzioni nel file */
-    leggi_file(in_file);
-
-    /* (3) e (4): mette un RDA vuoto sullo stack di sistema e chiama la funzione
-       esecutore() */
-    if(funzione_clinit) {
-      // esegue la funzione <clinit>()V
-      stack_di_sistema.push_ar();
-      stack_di_sistema.pc_set(programma.get_function_index("<clinit>()V"));
-      esecutore();
-    }
-    stack_di_sistema.push_ar();
-    stack_di_sistema.pc_set(
-        programma.get_function_index("main([Ljava/lang/String;)V") );
-
-    /* (5): passa il controllo alla funzione esecutore() */
-    esecutore();
+    /* (1): carica il programma e le variabili globali */
+    if(opzioni.compila) {
+      shared_ptr<ProgramImage> immagine(new ProgramImage());
+      // compila il sorgente nel file bytecode, senza eseguirlo
+      immagine->load_source(nome_file);
+      caricato = millisecondi();
+      immagine->write_bytecode(opzioni.nome_uscita != 0 ?
+          string(opzioni.nome_uscita) : ProgramImage::bytecode_name(nome_file));
+      if(opzioni.tempi)
+        stampa_tempi(caricato - inizio, millisecondi() - caricato, errori);
+      return 0;
+    }
+    if(opzioni.traduci_cpp) {
+      // traduce il programma in C++, senza eseguirlo
+      shared_ptr<ProgramImage> immagine(new ProgramImage());
+      immagine->load(nome_file);
+      caricato = millisecondi();
+      CppCode codice_cpp;
+      codice_cpp.translate(immagine->program, immagine->globals, nome_file);
+      if(uscita != 0 && opzioni.nome_uscita == 0)
+        *uscita += codice_cpp.get_source();
+      else
+        scrivi_cpp(codice_cpp.get_source(), opzioni.nome_uscita);
+      if(opzioni.tempi)
+        stampa_tempi(caricato - inizio, millisecondi() - caricato, errori);
+      return 0;
+    }
+    shared_ptr<const ProgramImage> immagine = immagini != 0 ?
+      immagine_condivisa(*immagini, nome_file, opzioni) :
+      prepara_immagine(nome_file, opzioni);
+
+    /* (2): crea la macchina, con le variabili globali dell'immagine */
+    macchina.reset(new Machine(immagine));
+    macchina->output.set_size(opzioni.dimensione_buffer);
+    if(uscita != 0)
+      macchina->output.capture(uscita);
+    if(ingresso != 0)
+      macchina->input = ingresso;
+    if(opzioni.jit)
+      macchina->native.enable(*macchina, opzioni.soglia_jit,
+          DIMENSIONE_CODICE_NATIVO);
+    caricato = millisecondi();
+    if(opzioni.verifica && opzioni.rapporto_verifica)
+      errori <<"Verifica dei tipi:\n"
+             <<immagine->program.get_verification_report();
+    if(opzioni.profilo_attivo)
+      macchina->profiler.enable(macchina->program);
+    if(opzioni.rapporto_fusione)
+      errori <<"Superistruzioni:\n" <<immagine->program.get_fusion_report();
+    if(opzioni.registri && opzioni.rapporto_registri)
+      errori <<"Codice a registri:\n" <<immagine->registers.get_report();
+    if(opzioni.campionamento)
+      campionatore.start(immagine->program, immagine->registers,
+          macchina->stack, opzioni.intervallo_campioni);
+
+    /* (3), (4) e (5): esegue <clinit>()V, se c'e`, e la funzione main */
+    macchina->run();
+    macchina->output.flush();
+    if(opzioni.campionamento)
+      scrivi_campioni(campionatore, nome_campioni, errori);
+    if(opzioni.jit && opzioni.rapporto_jit)
+      errori <<"Codice nativo:\n" <<macchina->native.get_report();
+    if(opzioni.profilo_attivo)
+      scrivi_profilo(*macchina, nome_profilo, errori);
   } // end try
 
   /* Gestione eccezioni */
   catch(string e) {
-    std::cerr <<"Errore: " <<e <<std::endl;
-    in_file.close();
+    svuota_uscita(macchina.get());
+    errori <<"Errore: " <<e <<std::endl;
+    if(macchina && macchina->profiler.is_enabled()) {
+      // il profilo fino all'errore
+      try {
+        scrivi_profilo(*macchina, nome_profilo, errori);
+      }
+      catch(string e2) {
+        errori <<"Errore: " <<e2 <<std::endl;
+      }
+    }
+    if(campionatore.is_enabled()) {
+      // i campioni fino all'errore
+      try {
+        scrivi_campioni(campionatore, nome_campioni, errori);
+      }
+      catch(string e2) {
+        errori <<"Errore: " <<e2 <<std::endl;
+      }
+    }
+    if(opzioni.tempi)
+      stampa_tempi(caricato - inizio, millisecondi() - caricato, errori);
     return 1;
   }
   catch(...) {
-    std::cerr <<"Errore: l'esecuzione e` stata interrotta da "
-              <<"un errore sconosciuto" <<std::endl;
-    in_file.close();
+    svuota_uscita(macchina.get());
+    errori <<"Errore: l'esecuzione e` stata interrotta da "
+           <<"un errore sconosciuto" <<std::endl;
+    if(opzioni.tempi)
+      stampa_tempi(caricato - inizio, millisecondi() - caricato, errori);
     return 1;
   }
 
-  in_file.close();
+  if(opzioni.tempi)
+    stampa_tempi(caricato - inizio, millisecondi() - caricato, errori);
   return 0;
-} // end main(int argc, char **argv)
+} // end esegui_programma(...)
 
 
 /*!
-  \fn void leggi_file(const std::ifstream& in_file)
-  \brief Legge il file passato e gestisce le istruzioni lette
-  \param in_file file-stream di input, aperto sul file da leggere
-
-  Legge il file passato come file-stream e mette le istruzioni in 
-  <tt>programma</tt> e le variabili globali in <tt>variabili_globali</tt>.
-  Ogni istruzione inserita in <tt>programma</tt> e` senza spazi all'inizio o 
-  alla fine ed ha un solo spazio tra istruzione e argomenti. Allo stesso modo il
-  nome delle variabili globali dentro alla struttura <tt>variabili_globali</tt>
-  e` senza spazi.
+  \fn shared_ptr<const ProgramImage> prepara_immagine(const char* nome_file, const Opzioni& opzioni)
+  \brief Carica un programma e lo prepara per l'esecuzione
+  \param nome_file nome del file del programma (sorgente o bytecode)
+  \param opzioni opzioni della riga di comando
+  \return immagine del programma, con il codice a registri, verificata e con
+  le superistruzioni secondo le opzioni
+
+  In caso di errore lancia un'eccezione di tipo std::string con la
+  descrizione dell'errore.
 */
-void leggi_file(std::ifstream& in_file) {
-  string riga;
-  while(leggi_istruzione(in_file,riga)) {
-    cotrolla_etichetta(riga);
-    if(riga == "") {
-      // Riga vuota
-    }
-    else if(riga[0] == '.') {
-      // Direttiva
-      gestisci_direttiva(riga);
-    }
-    else{
-      // Istruzione
-      programma.add_instruction(riga);
-    }
-  } // end while(std::getline(infile,riga))
-  return;
-} // end leggi_file(std::ifstream& in_file)
+shared_ptr<const ProgramImage> prepara_immagine(const char* nome_file,
+    const Opzioni& opzioni) {
+  shared_ptr<ProgramImage> immagine(new ProgramImage());
+  immagine->load(nome_file);
+  // la traduzione legge le istruzioni prima della fusione
+  if(opzioni.registri)
+    immagine->registers.compile(immagine->program);
+  // la verifica precede la fusione, che ne mantiene l'esito
+  if(opzioni.verifica)
+    immagine->program.verify();
+  if(opzioni.fusione)
+    immagine->program.fuse();
+  return immagine;
+}
 
 
 /*!
-  \fn bool leggi_istruzione(std::ifstream& file, string& str)
-  \brief Legge le istruzioni da file e le mette in str
-  \param file file-stream di input, aperto sul file da leggere
-  \param str stringa in cui mettere le istruzioni lette
-  \return <tt>false</tt>: errore di lettura o fine del file
-  \return <tt>true</tt>: letta e inserita una istruzione in <tt>str</tt> 
-
-  Legge le istruzioni dal file-stream <tt>file</tt> e le inserisce nella stringa
-  <tt>str</tt>.\\
-  Ogni istruzione dev'essere separata da un "a-capo". Da ogni istruzione vengono
-  eliminati gli "spazi inutili", ovvero gli spazi iniziali e finali e gli spazi
-  doppi (lasciando ovviamente inalterate le stringhe all'interno delle 
-  istruzioni).\\ 
-  Se si vuole cambiare il metodo di lettura delle istruzioni (ad esempio si 
-  vuole permettere che stiano tutte su una riga, separate da spazi) e` 
-  sufficente modificare solo questa funzione.
+  \fn shared_ptr<const ProgramImage> immagine_condivisa(Immagini& immagini, const char* nome_file, const Opzioni& opzioni)
+  \brief Restituisce l'immagine di un programma, preparandola solo la prima
+  volta
+  \param immagini immagini gia` preparate
+  \param nome_file nome del file del programma
+  \param opzioni opzioni della riga di comando
+  \return immagine del programma (vedi prepara_immagine())
+
+  Il primo thread che chiede il file <tt>nome_file</tt> prepara l'immagine
+  con prepara_immagine(), fuori dal mutex di <tt>immagini</tt>, cosi` che
+  file diversi vengano caricati contemporaneamente; gli altri thread che
+  chiedono lo stesso file aspettano la fine della preparazione e ricevono
+  la stessa immagine, o la stessa eccezione se il caricamento e` fallito.
 */
-bool leggi_istruzione(std::ifstream& file, string& str) {
-  // azzera str
-  str.clear();
-
-  char ch; // carattere letto da file
-  bool istr_stringa = false; // dentro o fuori a una stringa nell'istruzione
-
-  // legge l'istruzione da file
-  while(file.get(ch)) {
-    if(!istr_stringa && ch == '\t') {
-      // sostituisce le tabulazioni con spazi
-      ch = ' ';
-    }
-    if(ch == ' ') {
-      // spazio: elimina gli spazi inutili
-      if(!str.empty() && !istr_stringa && str[str.size()-1]==' ')
-        str.erase(str.size()-1);
-    }
-    else if(ch == '"') {
-      // virgolette: valuta se nell'istruzione vi e` una stringa
-      if(istr_stringa && str[str.size()-1]=='\\') {
-        // dentro una stringa c'e` la sequenza \"
-        // allora si rimane all'interno della stringa (istr_stringa=true)
-      }
-      else {
-        // dentro o fuori una stringa dell'istruzione
-        istr_stringa?istr_stringa=false:istr_stringa=true;
-      }
+shared_ptr<const ProgramImage> immagine_condivisa(Immagini& immagini,
+    const char* nome_file, const Opzioni& opzioni) {
+  std::promise<shared_ptr<const ProgramImage> > promessa;
+  std::shared_future<shared_ptr<const ProgramImage> > futuro;
+  bool prepara = false;
+  {
+    std::lock_guard<std::mutex> blocco(immagini.mutex);
+    if(immagini.immagine.count(nome_file) == 0) {
+      futuro = promessa.get_future().share();
+      immagini.immagine[nome_file] = futuro;
+      prepara = true;
     }
-    else if(ch == '\n') {
-      // a-capo: se e` fuori da una stringa e` la fine dell'istruzione
-      if(!istr_stringa) {
-        // fine istruzione
-        elimina_spazi_iniziali_e_finali(str);
-        return true;
-      }
-    } // end else if(ch=='\n')
-    // inserisce il carattere letto nella stringa
-    str.push_back(ch);
-  } // end while(file.get(ch))
+    else
+      futuro = immagini.immagine[nome_file];
+  }
+  if(prepara) {
+    try {
+      promessa.set_value(prepara_immagine(nome_file, opzioni));
+    }
+    catch(...) {
+      promessa.set_exception(std::current_exception());
+    }
+  }
+  return futuro.get();
+}
 
-  // fine del file
-  return false;
-} // end leggi_istruzione(std::ifstream&, string&)
+
+/*!
+  \fn void scrivi_cpp(const string& sorgente, const char* nome_file)
+  \brief Scrive la traduzione in C++ del programma
+  \param sorgente sorgente C++ (vedi CppCode)
+  \param nome_file nome del file da scrivere, oppure 0 per lo standard output
+
+  In caso di errore lancia un'eccezione di tipo std::string con la
+  descrizione dell'errore.
+*/
+void scrivi_cpp(const string& sorgente, const char* nome_file) {
+  if(nome_file == 0) {
+    std::cout <<sorgente <<std::flush;
+    if(!std::cout)
+      throw string("errore nella scrittura sullo standard output");
+    return;
+  }
+  std::ofstream out_file(nome_file, std::ios::out | std::ios::trunc);
+  if(!out_file)
+    throw string("impossibile scrivere il file " + string(nome_file));
+  out_file <<sorgente;
+  out_file.close();
+  if(!out_file)
+    throw string("errore nella scrittura del file " + string(nome_file));
+  return;
+}
 
 
 /*!
-  \fn void cotrolla_etichetta(string& str)
-  \brief Controlla se nell'istruzione c'e` un'ettichetta e la rende unica
-  \param str istruzione da controllare
-
-  Controlla se nell'istruzione e` presente un'ettichetta, in tal caso la rende
-  unica all'interno del programma aggiungendoci un numero relativo alla funzione
-  nella quale e` contenuta.\\
-  L'istruzione passata dev'essere senza spazi iniziali e finali e con un solo
-  spazio per separare gli argomenti.
+  \fn string nome_file_profilo(const string& programma, const char* estensione)
+  \brief Restituisce il nome di un file del profilo del programma
+  \param programma nome del file del programma (sorgente o bytecode)
+  \param estensione estensione del file del profilo (ad esempio
+  ".profile.json")
+  \return nome del file con l'estensione ".j" o ".jbc" sostituita da
+  <tt>estensione</tt> (o con <tt>estensione</tt> aggiunta, se l'estensione e`
+  diversa)
 */
-void cotrolla_etichetta(string& str) {
-  if(!str.empty()) {
-    // L'etichetta dev'essere sempre all'inizio dell'istruzione, siccome non ci
-    // sono spazi iniziali e finali, se c'e` uno spazio prima dei due-punti
-    // significa che non c'e` un'etichetta.
-    string::size_type pos_label = str.find(':');
-    string::size_type pos_space = str.find(' ');
-    bool etichetta = false;
-    char nf[3];
-    if(pos_label != string::npos &&
-        (pos_space == string::npos || pos_label < pos_space)) {
-      // c'e` un'etichetta
-      etichetta = true;
-      sprintf(nf, "_%d", n_funzioni);
-      str.insert(pos_label, nf);
-    }
-    string::size_type pos_istr = 0;
-    if(etichetta) {
-      pos_label = str.find(':');
-      ++pos_label;
-      while(str[pos_label] == ' ')
-        ++pos_label;
-      pos_istr = pos_label;
-    }
-    string::size_type pos_arg = str.find(' ',pos_istr);
-    if(pos_arg != string::npos) {
-      string istruzione;
-      istruzione = str.substr(pos_istr,pos_arg-pos_istr);
-      // istruzioni che hanno come argomento una etichetta
-      if( istruzione == "goto" ||
-          istruzione == "if_icmpeq" ||
-          istruzione == "if_icmpge" ||
-          istruzione == "if_icmpgt" ||
-          istruzione == "if_icmple" ||
-          istruzione == "if_icmplt" ||
-          istruzione == "if_icmpne" ||
-          istruzione == "ifeq" ||
-          istruzione == "ifge" ||
-          istruzione == "ifgt" ||
-          istruzione == "ifle" ||
-          istruzione == "iflt" ||
-          istruzione == "ifne"
-        ) {
-        // sostituisce l'etichetta: siccome queste istruzioni hanno come
-        // argomento solo l'etichetta, e non ci sono spazi finali, allora si
-        // aggiunge il numero alla ifne dell'istruzione
-        sprintf(nf, "_%d", n_funzioni);
-        str.insert(str.size(), nf);
-      }
-    }
-  } // end if(!str.empty())
+string nome_file_profilo(const string& programma, const char* estensione) {
+  string nome(programma);
+  if(nome.size() > 4 && nome.substr(nome.size()-4) == ".jbc")
+    nome.erase(nome.size()-4);
+  else if(nome.size() > 2 && nome.substr(nome.size()-2) == ".j")
+    nome.erase(nome.size()-2);
+  return nome + estensione;
+}
+
+
+/*!
+  \fn void scrivi_profilo(Machine& macchina, const string& nome_file, std::ostream& errori)
+  \brief Stampa il profilo dell'esecuzione e lo scrive in formato JSON
+  \param macchina macchina che ha eseguito il programma
+  \param nome_file nome del file del profilo in formato JSON
+  \param errori dove stampare il profilo (lo standard error del programma)
+
+  Chiude le chiamate ancora in corso nel profilo di <tt>macchina</tt>, ne
+  stampa il testo su <tt>errori</tt> e scrive il formato JSON nel file
+  <tt>nome_file</tt>. In caso di errore lancia un'eccezione di tipo
+  std::string con la descrizione dell'errore.
+*/
+void scrivi_profilo(Machine& macchina, const string& nome_file,
+    std::ostream& errori) {
+  macchina.profiler.finish();
+  errori <<"Profilo:\n" <<macchina.profiler.get_report();
+  std::ofstream out_file(nome_file.c_str(), std::ios::out | std::ios::trunc);
+  if(!out_file)
+    throw string("impossibile scrivere il file " + nome_file);
+  out_file <<macchina.profiler.get_json();
+  out_file.close();
+  if(!out_file)
+    throw string("errore nella scrittura del file " + nome_file);
   return;
 }
 
+
 /*!
-  \fn void gestisci_direttiva(const string& direttiva)
-  \brief In base alla direttiva passata esegue l'operazione appropriata
-  \param direttiva direttiva da gestire
-
-  Le direttive possono essere:
-    - <tt>.method public static <em>methodname</em> <em>descriptor</em></tt>
-    - <tt>.end method</tt>
-    - <tt>.field public static <em>fieldname</em> <em>descriptor</em></tt>
-    - <tt>.class public Main</tt>
-    - <tt>.super java/lang/Object</tt>
-    - <tt>.end class</tt>
-  devono essere senza spazi iniziali e finali e con un solo sapzio tra le 
-  parole, in caso di errore viene lanciata un'eccezione di tipo std::string
-  con la descrizione dell'errore.
+  \fn void scrivi_campioni(Sampler& campionatore, const string& nome_file, std::ostream& errori)
+  \brief Ferma il campionamento e scrive gli stack campionati
+  \param campionatore campionamento del programma
+  \param nome_file nome del file degli stack nel formato "folded"
+  \param errori dove stampare il numero di campioni (lo standard error del
+  programma)
+
+  Ferma <tt>campionatore</tt>, scrive gli stack campionati nel file
+  <tt>nome_file</tt> (vedi Sampler::get_folded()) e stampa su
+  <tt>errori</tt> il numero di campioni. In caso di errore lancia
+  un'eccezione di tipo std::string con la descrizione dell'errore.
 */
-void gestisci_direttiva(const string& direttiva) {
-  if(direttiva.substr(0,22) == ".method public static ") {
-    // Dichiarazione funzione
-    string nome_funzione = direttiva.substr(22);
-    cancella_carattere(nome_funzione,' ');
-    if(nome_funzione == "<clinit>()V")
-      funzione_clinit = true;
-    programma.add_instruction(direttiva);
-    ++n_funzioni;
-  }
-  else if(direttiva == ".end method") {
-    // Fine funzione
-    programma.add_instruction(direttiva);
-  }
-  else if(direttiva.substr(0,21) == ".field public static ") {
-    // Variabile globale
-    inserisci_variabile_globale(direttiva);
-  }
-  else if(direttiva == ".class public Main") {
-    // Prima direttiva d'inizio del programma
-  }
-  else if(direttiva == ".super java/lang/Object") {
-    // Seconda direttiva d'inizio del programma
-  }
-  else if(direttiva == ".end class") {
-    // Fine del programma
-  }
-  else{
-    throw string("direttiva sconosciuta: " + direttiva);
-  }
+void scrivi_campioni(Sampler& campionatore, const string& nome_file,
+    std::ostream& errori) {
+  campionatore.stop();
+  std::ofstream out_file(nome_file.c_str(), std::ios::out | std::ios::trunc);
+  if(!out_file)
+    throw string("impossibile scrivere il file " + nome_file);
+  out_file <<campionatore.get_folded();
+  out_file.close();
+  if(!out_file)
+    throw string("errore nella scrittura del file " + nome_file);
+  errori <<"Campioni: " <<campionatore.get_samples() <<" (persi "
+         <<campionatore.get_lost() <<"), scritti in " <<nome_file
+         <<std::endl;
   return;
-} // end gestisci_direttiva(const string& direttiva)
+}
 
 
 /*!
-  \fn void inserisci_variabile_globale(const string& direttiva)
-  \brief Inserisce la variabile globale in <tt>variabili_globali</tt>
-  \param direttiva direttiva contenente la variabile globale
-
-  Estrapola la variabile globale dalla direttiva passata e la inserisce in 
-  <tt>variabili_globali</tt>. La direttiva dev'essere nella forma
-  <tt>.field public static <em>fieldname</em> <em>descriptor</em></tt>, con un
-  solo spazio tra gli argomenti e senza spazi iniziali o finali. In caso di
-  errore lancia un'eccezione di tipo std::string con la descrizione dell'errore.
+  \fn bool leggi_dimensione(const char* str, unsigned int& dimensione)
+  \brief Legge una dimensione (numero di byte) dalla stringa passata
+  \param str stringa contenente la dimensione, in base 10
+  \param dimensione variabile in cui mettere la dimensione letta
+  \return <tt>false</tt>: la stringa non contiene un numero valido
+  \return <tt>true</tt>: la dimensione e` stata letta
+
+  Legge dalla stringa <tt>str</tt>, che deve contenere solo cifre, la
+  dimensione di un buffer (o un altro valore, come la soglia del
+  compilatore JIT) e la mette in <tt>dimensione</tt>.
 */
-void inserisci_variabile_globale(const string& direttiva) {
-  string fieldname, descriptor;
-  // ricava il nome della variabile
-  string::size_type pos_name = direttiva.find(' ', 21);
-  if(pos_name != string::npos) {
-    fieldname = direttiva.substr(21,pos_name-21);
-    // ricava il nome del descrittore
-    descriptor = direttiva.substr(pos_name+1);
-    if(descriptor == "S")
-      variabili_globali.add_variable_S(fieldname);
-    else if(descriptor == "C")
-      variabili_globali.add_variable_C(fieldname);
-    else if(descriptor == "I")
-      variabili_globali.add_variable_I(fieldname);
-    else if(descriptor == "J")
-      variabili_globali.add_variable_J(fieldname);
-    else {
-      throw string("tipo sconosciuto nella variabile globale: " + direttiva);
-    }
-  } // end if(pos_name != string::npos)
-  else {
-    throw string("manca il tipo nella variabile globale: " + direttiva);
+bool leggi_dimensione(const char* str, unsigned int& dimensione) {
+  if(*str < '0' || *str > '9')
+    return false;
+  char* fine;
+  unsigned long valore = strtoul(str, &fine, 10);
+  if(*fine != '\0' || valore > 0x7FFFFFFFUL)
+    return false;
+  dimensione = static_cast<unsigned int>(valore);
+  return true;
+}
+
+
+/*!
+  \fn void svuota_uscita(Machine* macchina)
+  \brief Scrive le stampe rimaste nel buffer di uscita prima di un errore
+  \param macchina macchina del programma (0 se non e` ancora stata creata)
+
+  Svuota il buffer dell'uscita di <tt>macchina</tt>, cosi` che quanto
+  stampato dal programma prima di un errore compaia prima del messaggio di
+  errore; un eventuale errore di scrittura viene ignorato.
+*/
+void svuota_uscita(Machine* macchina) {
+  try {
+    if(macchina != 0)
+      macchina->output.flush();
+  }
+  catch(...) {
+    // l'errore da segnalare e` quello gia` avvenuto
   }
   return;
-} // end inserisci_variabile_globale(const string& direttiva)
+}
 
 
 /*!
-  \fn void pulisci_stringa(string& str)
-  \brief Elimina gli spazi inutili alla stringa passata
-  \param str stringa da "ripulire"
+  \fn double millisecondi()
+  \brief Restituisce l'istante attuale in millisecondi
+  \return millisecondi trascorsi da un istante fisso (non l'ora del giorno),
+  per misurare la durata del caricamento e dell'esecuzione
+*/
+double millisecondi() {
+  struct timespec istante;
+  clock_gettime(CLOCK_MONOTONIC, &istante);
+  return istante.tv_sec * 1000.0 + istante.tv_nsec / 1000000.0;
+}
 
-  Elimina gli spazi iniziali e finali (trim) dalla stringa <tt>str</tt> e
-  rimuove tutti gli spazi consecutivi all'interno della stringa lasciando solo
-  spazi singoli.
+
+/*!
+  \fn void stampa_tempi(const double& caricamento, const double& esecuzione, std::ostream& errori)
+  \brief Stampa la durata del caricamento e dell'esecuzione
+  \param caricamento durata del caricamento in millisecondi
+  \param esecuzione durata dell'esecuzione in millisecondi (o della scrittura
+  del file bytecode con <tt>--compile</tt>)
+  \param errori dove stampare (lo standard error del programma)
 */
-void pulisci_stringa(string& str) {
-  // eliminazione spazi iniziali e finali (trim)
-  elimina_spazi_iniziali_e_finali(str);
-  // eliminazione spazi doppi
-  string::size_type pos = str.find("  ");
-  while(pos != string::npos) {
-    str.erase(pos, 1);
-    pos = str.find("  ", pos);
-  }
+void stampa_tempi(const double& caricamento, const double& esecuzione,
+    std::ostream& errori) {
+  char riga[128];
+  sprintf(riga, "Tempo di caricamento: %.3f ms\nTempo di esecuzione: %.3f ms",
+      caricamento, esecuzione);
+  errori <<riga <<std::endl;
   return;
-} // end pulisci_stringa(string& str)
+}
+
+
 
 
 /*!
-  \fn void elimina_spazi_iniziali_e_finali(string& str)
-  \brief Elimina gli spazi iniziali e finali nella stringa (trim)
-  \param str stringa da "ripulire"
+  \struct Risultato
+  \brief Programma eseguito da esegui_batch()
+*/
+struct Risultato {
+  string uscita;    //!< stampa del programma
+  string errori;    //!< standard error del programma
+  int stato;        //!< valore restituito da esegui_programma()
+  bool finito;      //!< true quando il programma e` terminato
+  Risultato() : stato(0), finito(false) {}
+};
 
-  Elimina gli spazi iniziali e finali dalla stringa <tt>str</tt> (funzione 
-  trim).
+
+/*!
+  \struct Batch
+  \brief Programmi di esegui_batch(), condivisi dai suoi thread
 */
-void elimina_spazi_iniziali_e_finali(string& str) {
-  string::size_type pos = str.find_last_not_of(' ');
-  if(pos != string::npos) {
-    str.erase(pos + 1);
-    pos = str.find_first_not_of(' ');
-    if(pos != string::npos) str.erase(0, pos);
-  }
-  else {
-    str.erase(str.begin(), str.end());
+struct Batch {
+  const vector<const char*>& file;    //!< nomi dei file dei programmi
+  const Opzioni& opzioni;             //!< opzioni della riga di comando
+  vector<Risultato> risultati;        //!< risultato di ogni programma
+  unsigned int prossimo;              //!< primo programma non ancora preso
+  Immagini immagini;                  //!< immagine di ogni file diverso
+  std::mutex mutex;                   //!< protegge prossimo e risultati
+  std::condition_variable terminato;  //!< segnala i programmi terminati
+  Batch(const vector<const char*>& f, const Opzioni& o)
+    : file(f), opzioni(o), risultati(f.size()), prossimo(0) {}
+};
+
+
+/*!
+  \fn void esegui_lavoro(Batch& batch, const unsigned int& k)
+  \brief Esegue il programma <tt>k</tt> di <tt>batch</tt>, con la stampa e
+  lo standard error raccolti in memoria e l'ingresso vuoto, e ne segnala la
+  fine
+*/
+void esegui_lavoro(Batch& batch, const unsigned int& k) {
+  Risultato risultato;
+  std::ostringstream errori;
+  std::istringstream ingresso;
+  risultato.stato = esegui_programma(batch.file[k], batch.opzioni, errori,
+      &risultato.uscita, &ingresso, &batch.immagini);
+  risultato.errori = errori.str();
+  risultato.finito = true;
+  {
+    std::lock_guard<std::mutex> blocco(batch.mutex);
+    batch.risultati[k] = std::move(risultato);
   }
+  batch.terminato.notify_one();
   return;
 }
 
 
 /*!
-  \fn void cancella_carattere(string& str, char c)
-  \brief Elimina tutte le occorrenze del carattere passato dalla stringa
-  \param str stringa da "ripulire"
-  \param c carattere da eliminare dalla stringa
+  \fn void lavoratore(Batch* batch)
+  \brief Funzione dei thread di esegui_batch(): prende dalla coda ed esegue
+  i programmi di <tt>batch</tt> finche` ce ne sono
+*/
+void lavoratore(Batch* batch) {
+  for(;;) {
+    unsigned int k;
+    {
+      std::lock_guard<std::mutex> blocco(batch->mutex);
+      if(batch->prossimo >= batch->file.size())
+        return;
+      k = batch->prossimo++;
+    }
+    esegui_lavoro(*batch, k);
+  }
+}
+
 
-  Elimina dalla stringa <tt>str</tt> tutte le occorrenze del carattere passato
-  <tt>c</tt>, di default ' ' (spazio bianco).
+/*!
+  \fn void stampa_risultato(const string& nome, const Risultato& risultato)
+  \brief Scrive sullo standard output la stampa del programma <tt>nome</tt>
+  e sullo standard error i suoi errori, con ogni riga preceduta dal nome del
+  file
 */
-void cancella_carattere(string& str, char c) {
-  string::size_type pos = str.find(c);
-  while(pos != string::npos) {
-    str.erase(pos, 1);
-    pos = str.find(c, pos);
+void stampa_risultato(const string& nome, const Risultato& risultato) {
+  std::cout <<risultato.uscita <<std::flush;
+  const string& testo = risultato.errori;
+  string errori;
+  for(string::size_type inizio = 0; inizio < testo.size(); ) {
+    string::size_type fine = testo.find('\n', inizio);
+    if(fine == string::npos)
+      fine = testo.size() - 1;
+    errori += nome + ": " + testo.substr(inizio, fine - inizio + 1);
+    if(testo[fine] != '\n')
+      errori += '\n';
+    inizio = fine + 1;
   }
+  std::cerr <<errori <<std::flush;
   return;
 }
+
+
+/*!
+  \fn int esegui_batch(const vector<const char*>& file, const Opzioni& opzioni, const unsigned int& lavori)
+  \brief Esegue i programmi di <tt>--batch</tt> in piu` thread
+  \param file nomi dei file dei programmi, nell'ordine dato
+  \param opzioni opzioni della riga di comando
+  \param lavori numero di thread (0: il numero di processori)
+  \return 1 se almeno un programma e` terminato con un errore, altrimenti 0
+
+  Crea al piu` <tt>lavori</tt> thread, che prendono i programmi da una coda
+  comune e li eseguono con esegui_programma(), ciascuno con la sua macchina
+  sull'immagine condivisa del suo file (vedi immagine_condivisa()), la
+  stampa raccolta in una stringa (vedi OutputBuffer::capture()), lo
+  standard error in un'altra e l'ingresso vuoto. Il thread principale
+  scrive i risultati nell'ordine dei file (vedi \ref batch_sec), appena un
+  programma e` terminato e lo sono tutti i precedenti. Con
+  <tt>--sample</tt> i programmi vengono eseguiti uno alla volta dal thread
+  principale, perche' il timer del campionamento e` unico per il processo
+  (vedi Sampler); lo stesso avviene se non si possono creare thread.
+*/
+int esegui_batch(const vector<const char*>& file, const Opzioni& opzioni,
+    const unsigned int& lavori) {
+  unsigned int massimo = lavori;
+  if(massimo == 0)
+    massimo = std::thread::hardware_concurrency();
+  if(massimo == 0)
+    massimo = 1;
+  if(massimo > file.size())
+    massimo = static_cast<unsigned int>(file.size());
+
+  Batch batch(file, opzioni);
+  vector<std::thread> thread;
+  for(unsigned int k = 0; k < massimo && !opzioni.campionamento; ++k) {
+    try {
+      thread.push_back(std::thread(lavoratore, &batch));
+    }
+    catch(const std::system_error&) {
+      // bastano i thread gia` creati
+      break;
+    }
+  }
+
+  // stampa, nell'ordine dei file, i programmi terminati
+  int stato = 0;
+  for(unsigned int k = 0; k < file.size(); ++k) {
+    if(thread.empty())
+      esegui_lavoro(batch, k);
+    Risultato risultato;
+    {
+      std::unique_lock<std::mutex> blocco(batch.mutex);
+      while(!batch.risultati[k].finito)
+        batch.terminato.wait(blocco);
+      risultato = std::move(batch.risultati[k]);
+    }
+    stampa_risultato(file[k], risultato);
+    if(risultato.stato != 0)
+      stato = 1;
+  }
+  for(unsigned int k = 0; k < thread.size(); ++k)
+    thread[k].join();
+  return stato;
+} // end esegui_batch(...)
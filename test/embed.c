@@ -0,0 +1,338 @@
+/*!
+  \file embed.c
+  \brief Prova dell'interfaccia C della libreria della macchina astratta
+  \author Andrea Zanelli
+  \date 17-10-2026
+
+  Usa la libreria (vedi libmacchina.h) da un programma C: carica un
+  programma dalla memoria, chiama le sue funzioni con parametri int e long e
+  ne controlla i valori restituiti, passa le stampe e le letture del
+  programma a funzioni di questo file e controlla che il limite di istruzioni
+  e il limite di tempo interrompano l'esecuzione, dopo la quale la macchina
+  deve poter essere usata di nuovo. Ogni prova viene eseguita sullo stack e
+  (tranne quelle con i limiti) con il codice a registri e con il compilatore
+  JIT, se disponibile.
+  Stampa una riga per ogni prova e termina con 1 se almeno una prova
+  fallisce.
+*/
+
+#include <stdio.h>
+#include <string.h>
+
+#include "libmacchina.h"
+
+
+//! Programma delle prove
+static const char PROGRAMMA[] =
+  ".class public Main\n"
+  ".super java/lang/Object\n"
+  "\n"
+  ".method public static fact (I)I\n"
+  "  iload 0\n"
+  "  ldc_w 1\n"
+  "  if_icmpgt l1\n"
+  "  ldc_w 1\n"
+  "  ireturn\n"
+  "  l1:\n"
+  "  iload 0\n"
+  "  iload 0\n"
+  "  ldc_w 1\n"
+  "  isub\n"
+  "  invokestatic Main/fact (I)I\n"
+  "  imul\n"
+  "  ireturn\n"
+  ".end method\n"
+  "\n"
+  ".method public static somma (JJ)J\n"
+  "  lload 0\n"
+  "  lload 2\n"
+  "  ladd\n"
+  "  lreturn\n"
+  ".end method\n"
+  "\n"
+  ".method public static saluta (I)V\n"
+  "  getstatic java/lang/System/out Ljava/io/PrintStream;\n"
+  "  ldc_w \"ciao \"\n"
+  "  invokevirtual java/io/PrintStream/print (Ljava/lang/String;)V\n"
+  "  getstatic java/lang/System/out Ljava/io/PrintStream;\n"
+  "  iload 0\n"
+  "  invokevirtual java/io/PrintStream/print (I)V\n"
+  "  return\n"
+  ".end method\n"
+  "\n"
+  ".method public static leggi ()I\n"
+  "  new java/io/BufferedReader\n"
+  "  dup\n"
+  "  new java/io/InputStreamReader\n"
+  "  dup\n"
+  "  getstatic java/lang/System/in Ljava/io/InputStream;\n"
+  "  invokespecial java/io/InputStreamReader/<init> "
+  "(Ljava/io/InputStream;)V\n"
+  "  invokespecial java/io/BufferedReader/<init> (Ljava/io/Reader;)V\n"
+  "  invokevirtual java/io/BufferedReader/readLine ()Ljava/lang/String;\n"
+  "  invokestatic java/lang/Integer/parseInt (Ljava/lang/String;)I\n"
+  "  ldc_w 2\n"
+  "  imul\n"
+  "  ireturn\n"
+  ".end method\n"
+  "\n"
+  ".method public static ciclo ()V\n"
+  "  l1:\n"
+  "  nop\n"
+  "  goto l1\n"
+  ".end method\n"
+  "\n"
+  ".method public static main ([Ljava/lang/String;)V\n"
+  "  ldc_w 7\n"
+  "  invokestatic Main/saluta (I)V\n"
+  "  return\n"
+  ".end method\n"
+  "\n"
+  ".end class\n";
+
+//! Numero di prove fallite
+static int fallite = 0;
+
+
+/*!
+  \fn void controlla(int esito, const char* prova)
+  \brief Stampa l'esito di una prova e conta le prove fallite
+*/
+static void controlla(int esito, const char* prova) {
+  printf("%s: %s\n", esito ? "ok" : "ERRORE", prova);
+  if(!esito)
+    ++fallite;
+  return;
+}
+
+
+//! Stampe del programma ricevute da scrivi()
+static char stampe[256];
+
+
+/*!
+  \fn void scrivi(void* data, const char* str, size_t n)
+  \brief Aggiunge a stampe i caratteri stampati dal programma
+*/
+static void scrivi(void* data, const char* str, size_t n) {
+  size_t lunghezza = strlen(stampe);
+  (void) data;
+  if(lunghezza + n >= sizeof(stampe))
+    n = sizeof(stampe) - lunghezza - 1;
+  memcpy(stampe + lunghezza, str, n);
+  stampe[lunghezza + n] = '\0';
+  return;
+}
+
+
+/*!
+  \fn size_t leggi(void* data, char* buffer, size_t size)
+  \brief Passa al programma i caratteri della stringa puntata da data
+*/
+static size_t leggi(void* data, char* buffer, size_t size) {
+  const char** ingresso = (const char**) data;
+  size_t n = strlen(*ingresso);
+  if(n > size)
+    n = size;
+  memcpy(buffer, *ingresso, n);
+  *ingresso += n;
+  return n;
+}
+
+
+/*!
+  \fn void prova_chiamate(int opzioni, const char* modo)
+  \brief Prove delle chiamate, delle stampe e delle letture
+*/
+static void prova_chiamate(int opzioni, const char* modo) {
+  char errore[256];
+  char prova[128];
+  const char* ingresso = "21\n";
+  int64_t parametri[2];
+  int64_t risultato = 0;
+  ma_program* programma;
+  ma_machine* macchina;
+
+  programma = ma_program_load(PROGRAMMA, sizeof(PROGRAMMA) - 1, opzioni,
+      errore, sizeof(errore));
+  snprintf(prova, sizeof(prova), "%s: caricamento", modo);
+  controlla(programma != NULL, prova);
+  if(programma == NULL) {
+    fprintf(stderr, "%s\n", errore);
+    return;
+  }
+  macchina = ma_machine_new(programma);
+  // la macchina resta valida senza il programma
+  ma_program_free(programma);
+  snprintf(prova, sizeof(prova), "%s: creazione della macchina", modo);
+  controlla(macchina != NULL, prova);
+  if(macchina == NULL)
+    return;
+
+  parametri[0] = 10;
+  snprintf(prova, sizeof(prova), "%s: fact(10)", modo);
+  controlla(ma_call(macchina, "fact(I)I", parametri, 1, &risultato) &&
+      risultato == 3628800, prova);
+
+  parametri[0] = 5000000000LL;
+  parametri[1] = -7;
+  snprintf(prova, sizeof(prova), "%s: somma(5000000000, -7)", modo);
+  controlla(ma_call(macchina, "somma(JJ)J", parametri, 2, &risultato) &&
+      risultato == 4999999993LL, prova);
+
+  snprintf(prova, sizeof(prova), "%s: funzione inesistente", modo);
+  controlla(!ma_call(macchina, "manca()V", NULL, 0, NULL) &&
+      strlen(ma_error(macchina)) > 0, prova);
+
+  snprintf(prova, sizeof(prova), "%s: numero di parametri errato", modo);
+  controlla(!ma_call(macchina, "fact(I)I", NULL, 0, NULL), prova);
+
+  stampe[0] = '\0';
+  parametri[0] = 42;
+  snprintf(prova, sizeof(prova), "%s: stampa", modo);
+  controlla(ma_set_output(macchina, scrivi, NULL) &&
+      ma_call(macchina, "saluta(I)V", parametri, 1, NULL) &&
+      strcmp(stampe, "ciao 42") == 0, prova);
+
+  stampe[0] = '\0';
+  snprintf(prova, sizeof(prova), "%s: esecuzione del programma", modo);
+  controlla(ma_run(macchina) && strcmp(stampe, "ciao 7") == 0, prova);
+
+  snprintf(prova, sizeof(prova), "%s: lettura", modo);
+  controlla(ma_set_input(macchina, leggi, &ingresso) &&
+      ma_call(macchina, "leggi()I", NULL, 0, &risultato) &&
+      risultato == 42, prova);
+
+  // i limiti si usano solo senza il codice a registri: l'errore arriva
+  // subito e resta fino alla funzione successiva
+  snprintf(prova, sizeof(prova), "%s: limiti", modo);
+  if(opzioni & (MA_REGISTER_IR | MA_JIT))
+    controlla(!ma_set_instruction_limit(macchina, 1000) &&
+        !ma_set_time_limit(macchina, 1000) &&
+        strstr(ma_error(macchina), "limiti") != NULL &&
+        ma_set_instruction_limit(macchina, 0) &&
+        strlen(ma_error(macchina)) == 0, prova);
+  else
+    controlla(ma_set_instruction_limit(macchina, 1000) &&
+        ma_set_instruction_limit(macchina, 0), prova);
+
+  ma_machine_free(macchina);
+  return;
+}
+
+
+/*!
+  \fn void prova_limite_esatto(int opzioni, const char* modo)
+  \brief Controlla che fact(5), che esegue 49 istruzioni (compresi i nop
+  delle etichette), termini con il limite di 49 istruzioni ma non con
+  quello di 48: una superistruzione conta per tutte le istruzioni che
+  sostituisce, percio` il limite e` lo stesso con e senza la fusione
+*/
+static void prova_limite_esatto(int opzioni, const char* modo) {
+  char prova[128];
+  char errore[256];
+  int64_t parametri[1];
+  int64_t risultato = 0;
+  ma_program* programma;
+  ma_machine* macchina;
+
+  snprintf(prova, sizeof(prova), "limiti: limite esatto (%s)", modo);
+  programma = ma_program_load(PROGRAMMA, sizeof(PROGRAMMA) - 1, opzioni,
+      errore, sizeof(errore));
+  if(programma == NULL) {
+    controlla(0, prova);
+    fprintf(stderr, "%s\n", errore);
+    return;
+  }
+  macchina = ma_machine_new(programma);
+  ma_program_free(programma);
+  if(macchina == NULL) {
+    controlla(0, prova);
+    return;
+  }
+  parametri[0] = 5;
+  ma_set_instruction_limit(macchina, 49);
+  controlla(ma_call(macchina, "fact(I)I", parametri, 1, &risultato) &&
+      risultato == 120 && ma_set_instruction_limit(macchina, 48) &&
+      !ma_call(macchina, "fact(I)I", parametri, 1, &risultato) &&
+      strstr(ma_error(macchina), "istruzioni") != NULL, prova);
+  ma_machine_free(macchina);
+  return;
+}
+
+
+/*!
+  \fn void prova_limiti()
+  \brief Prove dei limiti di istruzioni e di tempo
+*/
+static void prova_limiti() {
+  char errore[256];
+  int64_t parametri[1];
+  int64_t risultato = 0;
+  ma_program* programma;
+  ma_machine* macchina;
+
+  programma = ma_program_load(PROGRAMMA, sizeof(PROGRAMMA) - 1, 0, errore,
+      sizeof(errore));
+  if(programma == NULL) {
+    controlla(0, "limiti: caricamento");
+    fprintf(stderr, "%s\n", errore);
+    return;
+  }
+  macchina = ma_machine_new(programma);
+  ma_program_free(programma);
+  if(macchina == NULL) {
+    controlla(0, "limiti: creazione della macchina");
+    return;
+  }
+
+  ma_set_instruction_limit(macchina, 100000);
+  controlla(!ma_call(macchina, "ciclo()V", NULL, 0, NULL) &&
+      strstr(ma_error(macchina), "istruzioni") != NULL,
+      "limiti: limite di istruzioni");
+
+  // la macchina e` di nuovo utilizzabile dopo l'errore
+  parametri[0] = 5;
+  controlla(ma_call(macchina, "fact(I)I", parametri, 1, &risultato) &&
+      risultato == 120, "limiti: chiamata dopo il limite");
+
+  ma_set_instruction_limit(macchina, 0);
+  ma_set_time_limit(macchina, 50);
+  controlla(!ma_call(macchina, "ciclo()V", NULL, 0, NULL) &&
+      strstr(ma_error(macchina), "tempo") != NULL,
+      "limiti: limite di tempo");
+
+  ma_machine_free(macchina);
+
+  prova_limite_esatto(0, "stack");
+  prova_limite_esatto(MA_NO_FUSION, "senza superistruzioni");
+  return;
+}
+
+
+/*!
+  \fn int main()
+  \brief Esegue tutte le prove
+*/
+int main() {
+  char errore[256];
+  ma_program* programma;
+
+  prova_chiamate(0, "stack");
+  prova_chiamate(MA_NO_FUSION, "senza superistruzioni");
+  prova_chiamate(MA_REGISTER_IR, "register-ir");
+  programma = ma_program_load(PROGRAMMA, sizeof(PROGRAMMA) - 1, MA_JIT,
+      errore, sizeof(errore));
+  if(programma != NULL) {
+    ma_program_free(programma);
+    prova_chiamate(MA_JIT, "jit");
+  }
+  prova_limiti();
+
+  programma = ma_program_load("non e` un programma\n", 20, 0, errore,
+      sizeof(errore));
+  controlla(programma == NULL && strlen(errore) > 0,
+      "errore di caricamento");
+
+  return fallite > 0 ? 1 : 0;
+}
@@ -0,0 +1,372 @@
+/*!
+  \file stress.cc
+  \brief Prova di piu` macchine astratte eseguite contemporaneamente
+  \author Andrea Zanelli
+  \date 17-10-2026
+
+  Esegue ogni programma dato come argomento prima da solo e poi in
+  <em>n</em> thread contemporaneamente (opzione <tt>-j <em>n</em></tt>, 4 se
+  non e` data), ognuno con la sua macchina astratta (vedi Machine), e
+  controlla che la stampa (e l'eventuale errore) di ogni esecuzione sia
+  uguale a quella dell'esecuzione da sola. Nell'esecuzione da sola il
+  programma viene caricato solo per quella macchina, mentre i thread
+  condividono un'unica immagine di ogni programma (vedi ProgramImage),
+  caricata una volta per ogni modo di esecuzione. I thread eseguono i
+  programmi in ordini diversi, cosi` che programmi diversi vengano eseguiti
+  insieme, e ogni programma viene eseguito sullo stack, con il codice a
+  registri e con il compilatore JIT. Lo standard input di ogni programma
+  <tt>nome.j</tt> e` il contenuto di <tt>nome.in</tt>, se esiste,
+  altrimenti e` vuoto. Prima dei programmi registra due metodi nativi (vedi
+  NativeMethod) e controlla la stampa di due programmi che li chiamano (il
+  secondo termina con un'eccezione del metodo nativo), in ogni modo di
+  esecuzione.
+  Termina con 1 se almeno un'esecuzione e` diversa.
+*/
+
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+#include <stdlib.h>
+
+#include "Machine.h"
+#include "NativeMethod.h"
+
+using std::shared_ptr;
+using std::string;
+using std::vector;
+
+
+//! Modi di esecuzione: sullo stack, con il codice a registri e con il JIT
+enum Modo {
+  MODO_STACK = 0,
+  MODO_REGISTRI,
+  MODO_JIT,
+  NUMERO_MODI
+};
+
+//! Nomi dei modi di esecuzione, per i messaggi
+static const char* const NOMI_MODI[NUMERO_MODI] = {
+  "stack", "register-ir", "jit"
+};
+
+//! Dimensione in byte dell'area del codice nativo di ogni macchina
+static const size_t DIMENSIONE_CODICE_NATIVO = 1024 * 1024;
+
+
+/*!
+  \fn shared_ptr<const ProgramImage> prepara(const shared_ptr<ProgramImage>& immagine, Modo modo)
+  \brief Prepara l'immagine di un programma gia` caricato
+  \param immagine immagine del programma
+  \param modo modo di esecuzione
+  \return l'immagine del programma
+
+  Prepara il programma come fa la macchina astratta (traduzione nel codice a
+  registri secondo <tt>modo</tt>, verifica dei tipi e superistruzioni).
+*/
+shared_ptr<const ProgramImage> prepara(
+    const shared_ptr<ProgramImage>& immagine, Modo modo) {
+  if(modo != MODO_STACK)
+    immagine->registers.compile(immagine->program);
+  immagine->program.verify();
+  immagine->program.fuse();
+  return immagine;
+}
+
+
+/*!
+  \fn shared_ptr<const ProgramImage> prepara(const string& file, Modo modo)
+  \brief Carica e prepara l'immagine di un programma
+  \param file nome del file del programma
+  \param modo modo di esecuzione
+  \return l'immagine del programma
+
+  Carica il programma e lo prepara con l'altra prepara(). In caso di errore lancia un'eccezione di tipo
+  std::string con la descrizione dell'errore.
+*/
+shared_ptr<const ProgramImage> prepara(const string& file, Modo modo) {
+  shared_ptr<ProgramImage> immagine(new ProgramImage());
+  immagine->load(file);
+  return prepara(immagine, modo);
+}
+
+
+/*!
+  \fn string esegui(const shared_ptr<const ProgramImage>& immagine, const string& ingresso, Modo modo)
+  \brief Esegue un programma con una nuova macchina astratta
+  \param immagine immagine del programma, gia` preparata con prepara()
+  \param ingresso standard input del programma
+  \param modo modo di esecuzione
+  \return la stampa del programma, seguita dall'eventuale errore
+
+  Esegue il programma con una nuova macchina (con il compilatore JIT se
+  <tt>modo</tt> e` MODO_JIT), raccogliendo la stampa in una stringa.
+*/
+string esegui(const shared_ptr<const ProgramImage>& immagine,
+    const string& ingresso, Modo modo) {
+  Machine macchina(immagine);
+  string uscita;
+  std::istringstream in(ingresso);
+  macchina.input = &in;
+  macchina.output.capture(&uscita);
+  try {
+    if(modo == MODO_JIT && NativeCode::available())
+      macchina.native.enable(macchina, 1, DIMENSIONE_CODICE_NATIVO);
+    macchina.run();
+    macchina.output.flush();
+  }
+  catch(string e) {
+    macchina.output.flush();
+    uscita += "\nErrore: " + e + "\n";
+  }
+  catch(const std::exception& e) {
+    macchina.output.flush();
+    uscita += "\nEccezione: " + string(e.what()) + "\n";
+  }
+  return uscita;
+}
+
+
+/*!
+  \fn string leggi_ingresso(const string& file)
+  \brief Restituisce lo standard input del programma
+  \param file nome del file del programma (<tt>nome.j</tt>)
+  \return il contenuto di <tt>nome.in</tt>, o la stringa vuota se non esiste
+*/
+string leggi_ingresso(const string& file) {
+  string nome(file);
+  if(nome.size() > 2 && nome.substr(nome.size()-2) == ".j")
+    nome.erase(nome.size()-2);
+  std::ifstream in((nome + ".in").c_str());
+  std::ostringstream contenuto;
+  contenuto <<in.rdbuf();
+  return contenuto.str();
+}
+
+
+//! Programma che chiama i metodi nativi registrati da prova_metodi_nativi()
+static const char PROGRAMMA_NATIVI[] =
+  ".class public Main\n"
+  ".super java/lang/Object\n"
+  "\n"
+  ".method public static main ([Ljava/lang/String;)V\n"
+  "  ldc_w 0\n"
+  "  istore 1\n"
+  "  l1:\n"
+  "  getstatic java/lang/System/out Ljava/io/PrintStream;\n"
+  "  iload 1\n"
+  "  iload 1\n"
+  "  imul\n"
+  "  ldc_w 1\n"
+  "  iadd\n"
+  "  invokestatic util/Math/isqrt (I)I\n"
+  "  invokevirtual java/io/PrintStream/print (I)V\n"
+  "  getstatic java/lang/System/out Ljava/io/PrintStream;\n"
+  "  iload 1\n"
+  "  i2l\n"
+  "  invokestatic util/Math/cube (J)J\n"
+  "  invokevirtual java/io/PrintStream/print (J)V\n"
+  "  getstatic java/lang/System/out Ljava/io/PrintStream;\n"
+  "  ldc_w \" \"\n"
+  "  invokevirtual java/io/PrintStream/print (Ljava/lang/String;)V\n"
+  "  iload 1\n"
+  "  ldc_w 1\n"
+  "  iadd\n"
+  "  istore 1\n"
+  "  iload 1\n"
+  "  ldc_w 5\n"
+  "  if_icmplt l1\n"
+  "  return\n"
+  ".end method\n"
+  "\n"
+  ".end class\n";
+
+//! Programma che chiama util/Math/isqrt(I)I con 3, 2, 1, 0 e -1: l'ultima
+//! chiamata lancia std::domain_error (nel codice nativo, dopo il ciclo)
+static const char PROGRAMMA_ECCEZIONE[] =
+  ".class public Main\n"
+  ".super java/lang/Object\n"
+  "\n"
+  ".method public static main ([Ljava/lang/String;)V\n"
+  "  ldc_w 3\n"
+  "  istore 1\n"
+  "  l1:\n"
+  "  getstatic java/lang/System/out Ljava/io/PrintStream;\n"
+  "  iload 1\n"
+  "  invokestatic util/Math/isqrt (I)I\n"
+  "  invokevirtual java/io/PrintStream/print (I)V\n"
+  "  iload 1\n"
+  "  ldc_w 1\n"
+  "  isub\n"
+  "  istore 1\n"
+  "  iload 1\n"
+  "  ldc_w -2\n"
+  "  if_icmpgt l1\n"
+  "  return\n"
+  ".end method\n"
+  "\n"
+  ".end class\n";
+
+
+/*!
+  \fn void radice(Machine& m)
+  \brief Metodo nativo <tt>util/Math/isqrt(I)I</tt>: radice quadrata intera
+  (lancia std::domain_error con un numero negativo)
+*/
+static void radice(Machine& m) {
+  const int32_t n = m.stack.op_stack_top_int<false>();
+  if(n < 0)
+    throw std::domain_error("radice di un numero negativo");
+  int32_t r = 0;
+  while((r + 1) * (r + 1) <= n)
+    ++r;
+  m.stack.op_stack_pop<false>();
+  m.stack.op_stack_push_int<false>(r);
+  return;
+}
+
+
+/*!
+  \fn void cubo(Machine& m)
+  \brief Metodo nativo <tt>util/Math/cube(J)J</tt>: cubo di un long
+*/
+static void cubo(Machine& m) {
+  const int64_t n = m.stack.op_stack_top_long<false>();
+  m.stack.op_stack_pop2<false>();
+  m.stack.op_stack_push_long<false>(n * n * n);
+  return;
+}
+
+
+/*!
+  \fn int prova_metodi_nativi()
+  \brief Registra i metodi nativi e controlla i programmi che li chiamano
+  \return 0 se le stampe sono quelle attese in tutti i modi, altrimenti 1
+
+  L'eccezione di PROGRAMMA_ECCEZIONE, che non e` di tipo std::string, deve
+  arrivare al chiamante di Machine::run() anche dal codice nativo.
+*/
+int prova_metodi_nativi() {
+  const char* const programma[2] = { PROGRAMMA_NATIVI, PROGRAMMA_ECCEZIONE };
+  const size_t dimensione[2] = {
+    sizeof(PROGRAMMA_NATIVI) - 1, sizeof(PROGRAMMA_ECCEZIONE) - 1
+  };
+  const string attesa[2] = {
+    "10 11 28 327 464 ",
+    "1110\nEccezione: radice di un numero negativo\n"
+  };
+  const char* const nome[2] = { "metodi nativi", "eccezione nativa" };
+  int errori = 0;
+  try {
+    register_native_method("util/Math/isqrt(I)I", radice);
+    register_native_method("util/Math/cube (J)J", cubo);
+  }
+  catch(string e) {
+    std::cout <<"ERRORE:   metodi nativi: " <<e <<std::endl;
+    return 1;
+  }
+  for(unsigned int p = 0; p < 2; ++p) {
+    for(unsigned int modo = 0; modo < NUMERO_MODI; ++modo) {
+      string uscita;
+      try {
+        const Modo m = static_cast<Modo>(modo);
+        shared_ptr<ProgramImage> immagine(new ProgramImage());
+        immagine->load_data(programma[p], dimensione[p]);
+        uscita = esegui(prepara(immagine, m), "", m);
+      }
+      catch(string e) {
+        uscita = "\nErrore: " + e + "\n";
+      }
+      if(uscita == attesa[p])
+        std::cout <<"ok:       ";
+      else {
+        std::cout <<"DIVERSO:  ";
+        errori = 1;
+      }
+      std::cout <<nome[p] <<" (" <<NOMI_MODI[modo] <<")" <<std::endl;
+    }
+  }
+  return errori;
+}
+
+
+/*!
+  \fn int main(int argc, char **argv)
+  \brief Esegue la prova sui programmi dati come argomento
+  \return 0: tutte le esecuzioni sono uguali a quelle da sole
+  \return 1: almeno un'esecuzione e` diversa, o argomenti non validi
+*/
+int main(int argc, char **argv) {
+  unsigned int thread = 4;
+  vector<string> file;
+  for(int i = 1; i < argc; ++i) {
+    if(string(argv[i]) == "-j" && i+1 < argc)
+      thread = static_cast<unsigned int>(atoi(argv[++i]));
+    else
+      file.push_back(argv[i]);
+  }
+  if(file.empty() || thread == 0) {
+    std::cerr <<"Uso: stress [-j n] file.j ..." <<std::endl;
+    return 1;
+  }
+  int errori = prova_metodi_nativi();
+
+  // esecuzioni da sole, di riferimento, ognuna con il suo caricamento; poi
+  // l'immagine condivisa dai thread (se il caricamento fallisce l'esito
+  // atteso e` l'errore)
+  vector<string> ingresso(file.size());
+  vector< vector<string> > atteso(file.size(), vector<string>(NUMERO_MODI));
+  vector< vector< shared_ptr<const ProgramImage> > > immagine(file.size(),
+      vector< shared_ptr<const ProgramImage> >(NUMERO_MODI));
+  for(unsigned int f = 0; f < file.size(); ++f) {
+    ingresso[f] = leggi_ingresso(file[f]);
+    for(unsigned int modo = 0; modo < NUMERO_MODI; ++modo) {
+      try {
+        const Modo m = static_cast<Modo>(modo);
+        atteso[f][modo] = esegui(prepara(file[f], m), ingresso[f], m);
+        immagine[f][modo] = prepara(file[f], m);
+      }
+      catch(string e) {
+        atteso[f][modo] = "\nErrore: " + e + "\n";
+      }
+    }
+  }
+
+  // esecuzioni contemporanee: il thread t inizia dal programma t, nel modo
+  // t (modulo il numero di modi), e prosegue con i successivi
+  vector< vector<string> > ottenuto(thread, vector<string>(file.size()));
+  vector<std::thread> esecutori;
+  for(unsigned int t = 0; t < thread; ++t) {
+    esecutori.push_back(std::thread([&, t]() {
+      for(unsigned int k = 0; k < file.size(); ++k) {
+        const unsigned int f = (t + k) % file.size();
+        const Modo modo = static_cast<Modo>(t % NUMERO_MODI);
+        if(immagine[f][modo])
+          ottenuto[t][f] = esegui(immagine[f][modo], ingresso[f], modo);
+        else
+          ottenuto[t][f] = atteso[f][modo];
+      }
+    }));
+  }
+  for(unsigned int t = 0; t < thread; ++t)
+    esecutori[t].join();
+
+  for(unsigned int f = 0; f < file.size(); ++f) {
+    bool uguale = true;
+    for(unsigned int t = 0; t < thread; ++t) {
+      if(ottenuto[t][f] != atteso[f][t % NUMERO_MODI]) {
+        std::cout <<"DIVERSO:  " <<file[f] <<" (thread " <<t <<", "
+                  <<NOMI_MODI[t % NUMERO_MODI] <<")" <<std::endl;
+        uguale = false;
+        errori = 1;
+      }
+    }
+    if(uguale)
+      std::cout <<"ok:       " <<file[f] <<std::endl;
+  }
+  return errori;
+}